@@ -31,7 +31,7 @@ const map<string,AttachmentNode::Usage> AttachmentNode::USAGES_BY_NAME = Attachm
  * @param usage What kind of attachment this node should be used as, e.g. `COLOR`
  */
 AttachmentNode::AttachmentNode(const Usage usage) : usage(usage) {
-    // empty
+    setHooks(0);
 }
 
 /**
@@ -67,13 +67,13 @@ Unmarshaller* AttachmentNodeUnmarshaller::findDelegate(const string& type) {
 }
 
 /**
- * Returns the value of the _link_ attribute in a map.
+ * Returns the value of the _link_ attribute.
  *
- * @param attributes Map to get value from
+ * @param attributes Attributes to get value from
  * @return Value of the attribute
  * @throws std::runtime_error if value is unspecified
  */
-string AttachmentNodeUnmarshaller::getLink(const map<string,string>& attributes) {
+string AttachmentNodeUnmarshaller::getLink(const AttributeView& attributes) {
     const string value = findValue(attributes, "link");
     if (value.empty()) {
         throw std::runtime_error("[AttachmentNodeUnmarshaller] Link is unspecified!");
@@ -83,13 +83,13 @@ string AttachmentNodeUnmarshaller::getLink(const map<string,string>& attributes)
 }
 
 /**
- * Returns the value of the _type_ attribute in a map.
+ * Returns the value of the _type_ attribute.
  *
- * @param attributes Map to get value from
+ * @param attributes Attributes to get value from
  * @return Value of _type_ attribute
  * @throws std::runtime_error if type is unspecified
  */
-string AttachmentNodeUnmarshaller::getType(const map<string,string>& attributes) {
+string AttachmentNodeUnmarshaller::getType(const AttributeView& attributes) {
     const string type = findValue(attributes, "type");
     if (type.empty()) {
         throw std::runtime_error("[AttachmentNodeUnmarshaller] Type is unspecified!");
@@ -99,13 +99,13 @@ string AttachmentNodeUnmarshaller::getType(const map<string,string>& attributes)
 }
 
 /**
- * Returns the value of the _usage_ attribute in a map.
+ * Returns the value of the _usage_ attribute.
  *
- * @param attributes Map to get value from
+ * @param attributes Attributes to get value from
  * @return Value of the attribute
  * @throws std::runtime_error if value is unspecified
  */
-AttachmentNode::Usage AttachmentNodeUnmarshaller::getUsage(const map<string,string>& attributes) {
+AttachmentNode::Usage AttachmentNodeUnmarshaller::getUsage(const AttributeView& attributes) {
 
     // Find value
     const string value = findValue(attributes, "usage");
@@ -121,19 +121,19 @@ AttachmentNode::Usage AttachmentNodeUnmarshaller::getUsage(const map<string,stri
     }
 }
 
-Node* AttachmentNodeUnmarshaller::RenderbufferAttachmentNodeUnmarshaller::unmarshal(const map<string,string>& a) {
+Node* AttachmentNodeUnmarshaller::RenderbufferAttachmentNodeUnmarshaller::unmarshal(const AttributeView& a) {
     const AttachmentNode::Usage usage = getUsage(a);
     const std::string link = getLink(a);
     return new RenderbufferAttachmentNode(usage, link);
 }
 
-Node* AttachmentNodeUnmarshaller::TextureAttachmentNodeUnmarshaller::unmarshal(const map<string,string>& attributes) {
+Node* AttachmentNodeUnmarshaller::TextureAttachmentNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
     const AttachmentNode::Usage usage = getUsage(attributes);
     const std::string link = getLink(attributes);
     return new TextureAttachmentNode(usage, link);
 }
 
-Node* AttachmentNodeUnmarshaller::unmarshal(const map<std::string,std::string>& attributes) {
+Node* AttachmentNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
 
     // Get the type
     const string type = getType(attributes);
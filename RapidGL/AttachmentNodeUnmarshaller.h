@@ -36,25 +36,25 @@ public:
 // Methods
     AttachmentNodeUnmarshaller();
     virtual ~AttachmentNodeUnmarshaller();
-    virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+    virtual Node* unmarshal(const AttributeView& attributes);
 private:
 // Types
     class TextureAttachmentNodeUnmarshaller : public Unmarshaller {
     public:
-        virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+        virtual Node* unmarshal(const AttributeView& attributes);
     };
     class RenderbufferAttachmentNodeUnmarshaller : public Unmarshaller {
     public:
-        virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+        virtual Node* unmarshal(const AttributeView& attributes);
     };
 // Constants
     static const std::map<std::string,Unmarshaller*> DELEGATES;
 // Methods
     static std::map<std::string,Unmarshaller*> createDelegates();
     static Unmarshaller* findDelegate(const std::string& type);
-    static std::string getLink(const std::map<std::string,std::string>& attributes);
-    static std::string getType(const std::map<std::string,std::string>& attributes);
-    static AttachmentNode::Usage getUsage(const std::map<std::string,std::string>& attributes);
+    static std::string getLink(const AttributeView& attributes);
+    static std::string getType(const AttributeView& attributes);
+    static AttachmentNode::Usage getUsage(const AttributeView& attributes);
 };
 
 } /* namespace RapidGL */
@@ -46,6 +46,9 @@ AttributeNode::AttributeNode(const std::string& name, const Usage usage, const G
     if ((location < -1) || (location >= getMaxVertexAttribs())) {
         throw std::invalid_argument("[AttributeNode] Location is out of range!");
     }
+
+    // Only prepares before being visited
+    setHooks(PRE_VISIT);
 }
 
 /**
@@ -65,6 +68,7 @@ std::map<std::string,AttributeNode::Usage> AttributeNode::createUsagesByName() {
     usagesByName["COLOR"] = COLOR;
     usagesByName["TEXCOORD0"] = TEXCOORD0;
     usagesByName["TEXCOORD1"] = TEXCOORD1;
+    usagesByName["INSTANCE_MODEL"] = INSTANCE_MODEL;
     return usagesByName;
 }
 
@@ -86,6 +90,8 @@ std::string AttributeNode::formatUsage(const Usage usage) {
         return "TEXCOORD0";
     case TEXCOORD1:
         return "TEXCOORD1";
+    case INSTANCE_MODEL:
+        return "INSTANCE_MODEL";
     default:
         throw std::runtime_error("[AttributeNode] Unexpected enumeration!");
     }
@@ -146,7 +152,7 @@ AttributeNode::Usage AttributeNode::parseUsage(const std::string& str) {
     }
 }
 
-void AttributeNode::preVisit(State& state) {
+void AttributeNode::prepare(State& state) {
 
     // Skip if already prepared
     if (prepared) {
@@ -161,6 +167,14 @@ void AttributeNode::preVisit(State& state) {
 
     // Sucessfully prepared
     prepared = true;
+    setHooks(getHooks() & ~PRE_VISIT);
+}
+
+/**
+ * Prepares this node if it was not prepared before being visited.
+ */
+void AttributeNode::preVisit(State& state) {
+    prepare(state);
 }
 
 void AttributeNode::visit(State& state) {
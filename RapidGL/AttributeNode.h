@@ -38,7 +38,8 @@ public:
         NORMAL, ///< As a normal
         COLOR, ///< As a color
         TEXCOORD0, ///< As primary texture coordinate
-        TEXCOORD1 ///< As secondary texture coordinate
+        TEXCOORD1, ///< As secondary texture coordinate
+        INSTANCE_MODEL ///< As the model matrix of each instance, taking four locations
     };
 // Methods
     AttributeNode(const std::string& name, Usage usage, GLint location);
@@ -48,6 +49,7 @@ public:
     std::string getName() const;
     Usage getUsage() const;
     static Usage parseUsage(const std::string& str);
+    virtual void prepare(State& state);
     virtual void preVisit(State& state);
     virtual void visit(State& state);
 private:
@@ -107,6 +107,13 @@ public:
         CPPUNIT_ASSERT_EQUAL(std::string("COLOR"), AttributeNode::formatUsage(AttributeNode::COLOR));
     }
 
+    /**
+     * Ensures `AttributeNode::formatUsage` works for `INSTANCE_MODEL`.
+     */
+    void testFormatUsageWithInstanceModel() {
+        CPPUNIT_ASSERT_EQUAL(std::string("INSTANCE_MODEL"), AttributeNode::formatUsage(AttributeNode::INSTANCE_MODEL));
+    }
+
     /**
      * Ensures `AttributeNode::formatUsage` works for `TEXCOORD0`.
      */
@@ -144,6 +151,15 @@ public:
         CPPUNIT_ASSERT_EQUAL(expected, actual);
     }
 
+    /**
+     * Ensures `AttributeNode::parseUsage` works for 'INSTANCE_MODEL'.
+     */
+    void testParseUsageWithInstanceModel() {
+        const AttributeNode::Usage expected = AttributeNode::INSTANCE_MODEL;
+        const AttributeNode::Usage actual = AttributeNode::parseUsage("INSTANCE_MODEL");
+        CPPUNIT_ASSERT_EQUAL(expected, actual);
+    }
+
     /**
      * Ensures `AttributeNode::parseUsage` works for 'TEXCOORD0'.
      */
@@ -227,11 +243,13 @@ int main(int argc, char* argv[]) {
         test.testAttributeNodeWhenLocationIsMinMinusOne();
         test.testAttributeNodeWhenNameIsEmpty();
         test.testFormatUsageWithColor();
+        test.testFormatUsageWithInstanceModel();
         test.testFormatUsageWithTexCoord0();
         test.testFormatUsageWithTexCoord1();
         test.testFormatUsageWithNormal();
         test.testFormatUsageWithPosition();
         test.testParseUsageWithColor();
+        test.testParseUsageWithInstanceModel();
         test.testParseUsageWithTexCoord0();
         test.testParseUsageWithTexCoord1();
         test.testParseUsageWithInvalidString();
@@ -36,13 +36,13 @@ AttributeNodeUnmarshaller::~AttributeNodeUnmarshaller() {
 }
 
 /**
- * Returns the value of _location_ attribute in a map.
+ * Returns the value of _location_ attribute.
  *
- * @param attributes Map of attributes to look in
- * @return Value of the attribute in map
+ * @param attributes Attributes to look in
+ * @return Value of the attribute
  * @throws std::runtime_error if value is unspecified
  */
-GLint AttributeNodeUnmarshaller::getLocation(const std::map<std::string,std::string>& attributes) {
+GLint AttributeNodeUnmarshaller::getLocation(const AttributeView& attributes) {
 
     // Find value
     const std::string value = findValue(attributes, "location");
@@ -81,13 +81,13 @@ GLint AttributeNodeUnmarshaller::getMaxVertexAttribs() {
 }
 
 /**
- * Returns the value of the _name_ attribute in a map.
+ * Returns the value of the _name_ attribute.
  *
- * @param attributes Map of attributes to look in
- * @return Value of _name_ attribute in map
+ * @param attributes Attributes to look in
+ * @return Value of _name_ attribute
  * @throws runtime_error if value is unspecified
  */
-std::string AttributeNodeUnmarshaller::getName(const std::map<std::string,std::string>& attributes) {
+std::string AttributeNodeUnmarshaller::getName(const AttributeView& attributes) {
     const std::string name = findValue(attributes, "name");
     if (name.empty()) {
         throw std::runtime_error("[AttributeNodeUnmarshaller] Name is unspecified!");
@@ -96,13 +96,13 @@ std::string AttributeNodeUnmarshaller::getName(const std::map<std::string,std::s
 }
 
 /**
- * Returns the value of the _usage_ attribute in a map.
+ * Returns the value of the _usage_ attribute.
  *
- * @param attributes Map of attributes to look in
- * @return Value of _usage_ attribute in map
+ * @param attributes Attributes to look in
+ * @return Value of _usage_ attribute
  * @throws runtime_error if value is unspecified
  */
-AttributeNode::Usage AttributeNodeUnmarshaller::getUsage(const std::map<std::string,std::string>& attributes) {
+AttributeNode::Usage AttributeNodeUnmarshaller::getUsage(const AttributeView& attributes) {
 
     // Get usage as string
     const std::string usage = findValue(attributes, "usage");
@@ -118,7 +118,7 @@ AttributeNode::Usage AttributeNodeUnmarshaller::getUsage(const std::map<std::str
     }
 }
 
-Node* AttributeNodeUnmarshaller::unmarshal(const std::map<std::string,std::string>& attributes) {
+Node* AttributeNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
     const std::string name = getName(attributes);
     const AttributeNode::Usage usage = getUsage(attributes);
     const GLint location = getLocation(attributes);
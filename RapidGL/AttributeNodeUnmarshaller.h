@@ -34,13 +34,13 @@ public:
 // Methods
     AttributeNodeUnmarshaller();
     virtual ~AttributeNodeUnmarshaller();
-    virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+    virtual Node* unmarshal(const AttributeView& attributes);
 private:
 // Methods
-    static GLint getLocation(const std::map<std::string,std::string>& attributes);
+    static GLint getLocation(const AttributeView& attributes);
     static GLint getMaxVertexAttribs();
-    static std::string getName(const std::map<std::string,std::string>& attributes);
-    static AttributeNode::Usage getUsage(const std::map<std::string,std::string>& attributes);
+    static std::string getName(const AttributeView& attributes);
+    static AttributeNode::Usage getUsage(const AttributeView& attributes);
 };
 
 } /* namespace RapidGL */
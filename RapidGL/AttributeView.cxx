@@ -0,0 +1,97 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include "RapidGL/AttributeView.h"
+namespace RapidGL {
+
+/**
+ * Constructs a view of the attributes from a SAX parser.
+ *
+ * @param attributes Attributes to look at, which must outlive the view
+ */
+AttributeView::AttributeView(const Poco::XML::Attributes& attributes) : attributes(&attributes), map(NULL) {
+    // empty
+}
+
+/**
+ * Constructs a view of a map of keys to values.
+ *
+ * @param map Map to look at, which must outlive the view
+ */
+AttributeView::AttributeView(const std::map<std::string,std::string>& map) : attributes(NULL), map(&map) {
+    // empty
+}
+
+/**
+ * Checks if an attribute is in the view.
+ *
+ * @param key Name of attribute
+ * @return `true` if the attribute is in the view
+ */
+bool AttributeView::contains(const char* const key) const {
+    return find(key) != NULL;
+}
+
+/**
+ * Checks if an attribute is in the view.
+ *
+ * @param key Name of attribute
+ * @return `true` if the attribute is in the view
+ */
+bool AttributeView::contains(const std::string& key) const {
+    return find(key) != NULL;
+}
+
+/**
+ * Finds the value of an attribute.
+ *
+ * Elements only have a few attributes, so they are compared one by one in
+ * place rather than copied into something faster to search.
+ *
+ * @param key Name of attribute
+ * @return Pointer to the value of the attribute, or `NULL` if it is not in the view
+ */
+const std::string* AttributeView::find(const char* const key) const {
+    if (attributes != NULL) {
+        const int length = attributes->getLength();
+        for (int i = 0; i < length; ++i) {
+            if (attributes->getLocalName(i) == key) {
+                return &attributes->getValue(i);
+            }
+        }
+        return NULL;
+    }
+    const std::map<std::string,std::string>::const_iterator it = map->find(key);
+    return (it == map->end()) ? NULL : &it->second;
+}
+
+/**
+ * Finds the value of an attribute.
+ *
+ * @param key Name of attribute
+ * @return Pointer to the value of the attribute, or `NULL` if it is not in the view
+ */
+const std::string* AttributeView::find(const std::string& key) const {
+    if (attributes != NULL) {
+        return find(key.c_str());
+    }
+    const std::map<std::string,std::string>::const_iterator it = map->find(key);
+    return (it == map->end()) ? NULL : &it->second;
+}
+
+} /* namespace RapidGL */
@@ -0,0 +1,51 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RAPIDGL_ATTRIBUTE_VIEW_H
+#define RAPIDGL_ATTRIBUTE_VIEW_H
+#include <map>
+#include <string>
+#include "Poco/SAX/Attributes.h"
+#include "RapidGL/common.h"
+namespace RapidGL {
+
+
+/**
+ * Read-only view of the attributes of an XML element, without copying them.
+ *
+ * A view can look at the attributes a SAX parser passes to its handler, or at
+ * a map of keys to values, which is handy when making nodes without a file.
+ * Values found are references into whatever the view looks at, so they are
+ * only valid as long as it is, e.g. until the parser moves to the next element.
+ */
+class AttributeView {
+public:
+// Methods
+    AttributeView(const Poco::XML::Attributes& attributes);
+    AttributeView(const std::map<std::string,std::string>& map);
+    bool contains(const char* key) const;
+    bool contains(const std::string& key) const;
+    const std::string* find(const char* key) const;
+    const std::string* find(const std::string& key) const;
+private:
+// Attributes
+    const Poco::XML::Attributes* const attributes;
+    const std::map<std::string,std::string>* const map;
+};
+
+} /* namespace RapidGL */
+#endif
@@ -0,0 +1,83 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <map>
+#include <string>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "Poco/SAX/AttributesImpl.h"
+#include "RapidGL/AttributeView.h"
+
+
+/**
+ * Unit test for `AttributeView`.
+ */
+class AttributeViewTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Ensures a view of SAX attributes finds values without copying them.
+     */
+    void testFindWithAttributes() {
+
+        // Make attributes
+        Poco::XML::AttributesImpl attributes;
+        attributes.addAttribute("", "id", "id", "CDATA", "foo");
+        attributes.addAttribute("", "value", "value", "CDATA", "1 2 3");
+
+        // Find values
+        const RapidGL::AttributeView view(attributes);
+        const std::string* const id = view.find("id");
+        CPPUNIT_ASSERT(id != NULL);
+        CPPUNIT_ASSERT_EQUAL(std::string("foo"), *id);
+        CPPUNIT_ASSERT_EQUAL(&attributes.getValue(1), view.find(std::string("value")));
+        CPPUNIT_ASSERT(view.find("name") == NULL);
+        CPPUNIT_ASSERT(view.contains("value"));
+        CPPUNIT_ASSERT(!view.contains("name"));
+    }
+
+    /**
+     * Ensures a view of a map finds values in the map.
+     */
+    void testFindWithMap() {
+
+        // Make map
+        std::map<std::string,std::string> map;
+        map["id"] = "foo";
+
+        // Find values
+        const RapidGL::AttributeView view(map);
+        CPPUNIT_ASSERT_EQUAL(&map["id"], view.find("id"));
+        CPPUNIT_ASSERT(view.find(std::string("name")) == NULL);
+        CPPUNIT_ASSERT(view.contains(std::string("id")));
+        CPPUNIT_ASSERT(!view.contains("name"));
+    }
+
+    CPPUNIT_TEST_SUITE(AttributeViewTest);
+    CPPUNIT_TEST(testFindWithAttributes);
+    CPPUNIT_TEST(testFindWithMap);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(AttributeViewTest::suite());
+    runner.run();
+    return 0;
+}
@@ -0,0 +1,151 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <stdexcept>
+#include <m3d/Vec4.h>
+#include "RapidGL/BoundingBox.h"
+namespace RapidGL {
+
+/**
+ * Constructs an empty bounding box.
+ */
+BoundingBox::BoundingBox() : empty(true), unbounded(false) {
+    // empty
+}
+
+/**
+ * Constructs a bounding box from its corners.
+ *
+ * @param min Corner with the smallest coordinates
+ * @param max Corner with the largest coordinates
+ * @throws invalid_argument if any coordinate of min is larger than in max
+ */
+BoundingBox::BoundingBox(const M3d::Vec3& min, const M3d::Vec3& max) :
+        min(min),
+        max(max),
+        empty(false),
+        unbounded(false) {
+    if ((min.x > max.x) || (min.y > max.y) || (min.z > max.z)) {
+        throw std::invalid_argument("[BoundingBox] Minimum is larger than maximum!");
+    }
+}
+
+/**
+ * Grows this box to also enclose another box.
+ *
+ * @param box Box to enclose
+ */
+void BoundingBox::add(const BoundingBox& box) {
+    if (unbounded || box.empty) {
+        return;
+    } else if (box.unbounded) {
+        unbounded = true;
+        empty = false;
+    } else if (empty) {
+        min = box.min;
+        max = box.max;
+        empty = false;
+    } else {
+        min.x = std::min(min.x, box.min.x);
+        min.y = std::min(min.y, box.min.y);
+        min.z = std::min(min.z, box.min.z);
+        max.x = std::max(max.x, box.max.x);
+        max.y = std::max(max.y, box.max.y);
+        max.z = std::max(max.z, box.max.z);
+    }
+}
+
+/**
+ * Returns the corner of this box with the largest coordinates.
+ *
+ * @return Corner with the largest coordinates, meaningless if box is empty or infinite
+ */
+M3d::Vec3 BoundingBox::getMax() const {
+    return max;
+}
+
+/**
+ * Returns the corner of this box with the smallest coordinates.
+ *
+ * @return Corner with the smallest coordinates, meaningless if box is empty or infinite
+ */
+M3d::Vec3 BoundingBox::getMin() const {
+    return min;
+}
+
+/**
+ * Makes a box enclosing everything.
+ *
+ * @return Infinite box
+ */
+BoundingBox BoundingBox::infinite() {
+    BoundingBox box;
+    box.empty = false;
+    box.unbounded = true;
+    return box;
+}
+
+/**
+ * Checks if this box encloses nothing.
+ *
+ * @return `true` if this box encloses nothing
+ */
+bool BoundingBox::isEmpty() const {
+    return empty;
+}
+
+/**
+ * Checks if this box encloses everything.
+ *
+ * @return `true` if this box encloses everything
+ */
+bool BoundingBox::isInfinite() const {
+    return unbounded;
+}
+
+/**
+ * Computes the box enclosing this box after it is transformed.
+ *
+ * Each of the eight corners is transformed, so the result may be larger than
+ * the transformed contents really are, but it never misses any of them.
+ *
+ * @param matrix Affine transformation to apply
+ * @return Box enclosing the transformed box
+ */
+BoundingBox BoundingBox::transform(const M3d::Mat4& matrix) const {
+
+    if (empty || unbounded) {
+        return *this;
+    }
+
+    BoundingBox box;
+    for (int i = 0; i < 8; ++i) {
+        const M3d::Vec4 corner(
+                (i & 1) ? max.x : min.x,
+                (i & 2) ? max.y : min.y,
+                (i & 4) ? max.z : min.z,
+                1);
+        const M3d::Vec4 p = matrix * corner;
+        const M3d::Vec3 point(p.x, p.y, p.z);
+        box.add(BoundingBox(point, point));
+    }
+    return box;
+}
+
+} /* namespace RapidGL */
@@ -0,0 +1,55 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RAPIDGL_BOUNDING_BOX_H
+#define RAPIDGL_BOUNDING_BOX_H
+#include <m3d/Mat4.h>
+#include <m3d/Vec3.h>
+#include "RapidGL/common.h"
+namespace RapidGL {
+
+
+/**
+ * Axis-aligned box enclosing a subtree of nodes.
+ *
+ * A box may also be empty, meaning there is nothing to enclose, or infinite,
+ * meaning what is enclosed could be anywhere.  Adding anything to an infinite
+ * box leaves it infinite, and transforming an empty or infinite box leaves it
+ * as it was.
+ */
+class BoundingBox {
+public:
+// Methods
+    BoundingBox();
+    BoundingBox(const M3d::Vec3& min, const M3d::Vec3& max);
+    void add(const BoundingBox& box);
+    M3d::Vec3 getMax() const;
+    M3d::Vec3 getMin() const;
+    static BoundingBox infinite();
+    bool isEmpty() const;
+    bool isInfinite() const;
+    BoundingBox transform(const M3d::Mat4& matrix) const;
+private:
+// Attributes
+    M3d::Vec3 min;
+    M3d::Vec3 max;
+    bool empty;
+    bool unbounded;
+};
+
+} /* namespace RapidGL */
+#endif
@@ -0,0 +1,135 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include <m3d/Mat4.h>
+#include <m3d/Vec3.h>
+#include <m3d/Vec4.h>
+#include "RapidGL/BoundingBox.h"
+
+
+/**
+ * Unit test for `BoundingBox`.
+ */
+class BoundingBoxTest : public CppUnit::TestFixture {
+public:
+
+    // Threshold for floating-point comparisons
+    static const double TOLERANCE = 1e-6;
+
+    /**
+     * Ensures `BoundingBox::add` grows a box to enclose another box.
+     */
+    void testAdd() {
+        RapidGL::BoundingBox box(M3d::Vec3(0, 0, 0), M3d::Vec3(1, 1, 1));
+        box.add(RapidGL::BoundingBox(M3d::Vec3(-1, 0.5, 0), M3d::Vec3(0.5, 0.5, 3)));
+        CPPUNIT_ASSERT(M3d::Vec3(-1, 0, 0) == box.getMin());
+        CPPUNIT_ASSERT(M3d::Vec3(1, 1, 3) == box.getMax());
+    }
+
+    /**
+     * Ensures `BoundingBox::add` makes an empty box the same as the box added to it.
+     */
+    void testAddToEmpty() {
+        RapidGL::BoundingBox box;
+        box.add(RapidGL::BoundingBox(M3d::Vec3(1, 2, 3), M3d::Vec3(4, 5, 6)));
+        CPPUNIT_ASSERT(!box.isEmpty());
+        CPPUNIT_ASSERT(M3d::Vec3(1, 2, 3) == box.getMin());
+        CPPUNIT_ASSERT(M3d::Vec3(4, 5, 6) == box.getMax());
+    }
+
+    /**
+     * Ensures `BoundingBox::add` makes a box infinite if the box added to it is infinite.
+     */
+    void testAddWithInfinite() {
+        RapidGL::BoundingBox box(M3d::Vec3(0, 0, 0), M3d::Vec3(1, 1, 1));
+        box.add(RapidGL::BoundingBox::infinite());
+        box.add(RapidGL::BoundingBox(M3d::Vec3(0, 0, 0), M3d::Vec3(1, 1, 1)));
+        CPPUNIT_ASSERT(box.isInfinite());
+    }
+
+    /**
+     * Ensures `BoundingBox::BoundingBox` throws if the minimum is larger than the maximum.
+     */
+    void testBoundingBoxWithBadCorners() {
+        CPPUNIT_ASSERT_THROW(
+                RapidGL::BoundingBox(M3d::Vec3(0, 2, 0), M3d::Vec3(1, 1, 1)),
+                std::invalid_argument);
+    }
+
+    /**
+     * Ensures `BoundingBox::BoundingBox` makes an empty box by default.
+     */
+    void testBoundingBoxWithNoArguments() {
+        const RapidGL::BoundingBox box;
+        CPPUNIT_ASSERT(box.isEmpty());
+        CPPUNIT_ASSERT(!box.isInfinite());
+    }
+
+    /**
+     * Ensures `BoundingBox::transform` encloses every corner of a rotated box.
+     */
+    void testTransform() {
+
+        // Rotate 90 degrees around Z and move up
+        M3d::Mat4 matrix(1);
+        matrix[0] = M3d::Vec4(0, 1, 0, 0);
+        matrix[1] = M3d::Vec4(-1, 0, 0, 0);
+        matrix[3] = M3d::Vec4(0, 10, 0, 1);
+
+        const RapidGL::BoundingBox box(M3d::Vec3(0, 0, 0), M3d::Vec3(2, 1, 1));
+        const RapidGL::BoundingBox result = box.transform(matrix);
+        const M3d::Vec3 min = result.getMin();
+        const M3d::Vec3 max = result.getMax();
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(-1, min.x, TOLERANCE);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(10, min.y, TOLERANCE);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(0, min.z, TOLERANCE);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(0, max.x, TOLERANCE);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(12, max.y, TOLERANCE);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(1, max.z, TOLERANCE);
+    }
+
+    /**
+     * Ensures `BoundingBox::transform` leaves empty and infinite boxes alone.
+     */
+    void testTransformWithEmptyAndInfinite() {
+        M3d::Mat4 matrix(2);
+        CPPUNIT_ASSERT(RapidGL::BoundingBox().transform(matrix).isEmpty());
+        CPPUNIT_ASSERT(RapidGL::BoundingBox::infinite().transform(matrix).isInfinite());
+    }
+
+    CPPUNIT_TEST_SUITE(BoundingBoxTest);
+    CPPUNIT_TEST(testAdd);
+    CPPUNIT_TEST(testAddToEmpty);
+    CPPUNIT_TEST(testAddWithInfinite);
+    CPPUNIT_TEST(testBoundingBoxWithBadCorners);
+    CPPUNIT_TEST(testBoundingBoxWithNoArguments);
+    CPPUNIT_TEST(testTransform);
+    CPPUNIT_TEST(testTransformWithEmptyAndInfinite);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(BoundingBoxTest::suite());
+    runner.run();
+    return 0;
+}
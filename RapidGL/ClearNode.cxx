@@ -38,6 +38,7 @@ ClearNode::ClearNode(const GLbitfield mask,
     if (!isMask(mask)) {
         throw std::invalid_argument("[ClearNode] Mask is invalid!");
     }
+    setHooks(VISIT);
 }
 
 /**
@@ -47,6 +48,15 @@ ClearNode::~ClearNode() {
     // empty
 }
 
+/**
+ * Returns an infinite box, since clearing affects everything drawn after this node.
+ *
+ * @return Infinite box
+ */
+BoundingBox ClearNode::computeBounds() {
+    return BoundingBox::infinite();
+}
+
 /**
  * Clamps a value to between zero and one.
  *
@@ -118,11 +128,18 @@ bool ClearNode::isMask(const GLbitfield bitfield) {
 }
 
 void ClearNode::visit(State& state) {
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    if (renderQueue != NULL) {
+        renderQueue->addBarrier(this, VISIT);
+        return;
+    }
+
+    GLStateCache& glStateCache = state.getGLStateCache();
     if (mask & GL_COLOR_BUFFER_BIT) {
-        glClearColor(color.r, color.g, color.b, color.a);
+        glStateCache.setClearColor(color);
     }
     if (mask & GL_DEPTH_BUFFER_BIT) {
-        glClearDepth(depth);
+        glStateCache.setClearDepth(depth);
     }
     glClear(mask);
 }
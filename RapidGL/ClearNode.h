@@ -20,7 +20,9 @@
 #include <set>
 #include <glycerin/Color.hxx>
 #include "RapidGL/common.h"
+#include "RapidGL/BoundingBox.h"
 #include "RapidGL/Node.h"
+#include "RapidGL/RenderQueue.h"
 #include "RapidGL/State.h"
 namespace RapidGL {
 
@@ -37,6 +39,9 @@ public:
     GLfloat getDepth() const;
     GLbitfield getMask() const;
     virtual void visit(State& state);
+protected:
+// Methods
+    virtual BoundingBox computeBounds();
 private:
 // Constants
     static const std::set<GLbitfield> MASKS;
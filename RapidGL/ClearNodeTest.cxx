@@ -169,6 +169,7 @@ public:
 
         // Reset the clear color
         glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        state.getGLStateCache().invalidate();
     }
 
     /**
@@ -191,6 +192,7 @@ public:
         // Reset the clear values
         glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
         glClearDepth(1.0f);
+        state.getGLStateCache().invalidate();
     }
 
     /**
@@ -212,6 +214,7 @@ public:
 
         // Reset the clear depth
         glClearDepth(1.0f);
+        state.getGLStateCache().invalidate();
     }
 };
 
@@ -17,7 +17,6 @@
  */
 #include "config.h"
 #include <stdexcept>
-#include <vector>
 #include "RapidGL/ClearNodeUnmarshaller.h"
 using namespace std;
 namespace RapidGL {
@@ -37,13 +36,13 @@ ClearNodeUnmarshaller::~ClearNodeUnmarshaller() {
 }
 
 /**
- * Returns the value of the _color_ attribute in a map.
+ * Returns the value of the _color_ attribute.
  *
- * @param attributes Map of attributes to look in
+ * @param attributes Attributes to look in
  * @return Value of the attribute
  * @throws std::runtime_error if value is unspecifed or invalid
  */
-Glycerin::Color ClearNodeUnmarshaller::getColor(const map<string,string>& attributes) {
+Glycerin::Color ClearNodeUnmarshaller::getColor(const AttributeView& attributes) {
 
     // Get value
     const string value = findValue(attributes, "color");
@@ -51,34 +50,30 @@ Glycerin::Color ClearNodeUnmarshaller::getColor(const map<string,string>& attrib
         throw std::runtime_error("[ClearNodeUnmarshaller] Color is unspecifed!");
     }
 
-    // Tokenize the value
-    const vector<string> tokens = tokenize(value);
-    if (tokens.size() != 4) {
-        throw std::runtime_error("[ClearNodeUnmarshaller] Color must have four components!");
-    }
-
-    // Parse the tokens
-    vector<GLfloat> components;
+    // Parse the value
+    GLfloat components[4];
+    size_t count;
     try {
-        for (vector<string>::const_iterator it = tokens.begin(); it != tokens.end(); ++it) {
-            components.push_back(parseFloat(*it));
-        }
+        count = parseFloats(value, components, 4);
     } catch (std::invalid_argument& e) {
         throw std::runtime_error("[ClearNodeUnmarshaller] Color component is invalid!");
     }
+    if (count != 4) {
+        throw std::runtime_error("[ClearNodeUnmarshaller] Color must have four components!");
+    }
 
     // Return the color
     return Glycerin::Color(components[0], components[1], components[2], components[3]);
 }
 
 /**
- * Returns the value of the _depth_ attribute in a map.
+ * Returns the value of the _depth_ attribute.
  *
- * @param attributes Map of attributes to look in
+ * @param attributes Attributes to look in
  * @return Value of the attribute
  * @throws std::runtime_error if value is unspecifed or invalid
  */
-GLfloat ClearNodeUnmarshaller::getDepth(const map<string,string>& attributes) {
+GLfloat ClearNodeUnmarshaller::getDepth(const AttributeView& attributes) {
 
     // Get value
     const string value = findValue(attributes, "depth");
@@ -95,32 +90,32 @@ GLfloat ClearNodeUnmarshaller::getDepth(const map<string,string>& attributes) {
 }
 
 /**
- * Checks if a map of attributes contains a color.
+ * Checks if attributes contain a color.
  *
- * @param attributes Map of attributes to look in
- * @return `true` if map contains a color attribute
+ * @param attributes Attributes to look in
+ * @return `true` if attributes contain a color attribute
  */
-bool ClearNodeUnmarshaller::hasColor(const map<string,string>& attributes) {
-    return attributes.count("color") > 0;
+bool ClearNodeUnmarshaller::hasColor(const AttributeView& attributes) {
+    return attributes.contains("color");
 }
 
 /**
- * Checks if a map of attributes contains a depth.
+ * Checks if attributes contain a depth.
  *
- * @param attributes Map of attributes to look in
- * @return `true` if map contains a depth attribute
+ * @param attributes Attributes to look in
+ * @return `true` if attributes contain a depth attribute
  */
-bool ClearNodeUnmarshaller::hasDepth(const map<string,string>& attributes) {
-    return attributes.count("depth") > 0;
+bool ClearNodeUnmarshaller::hasDepth(const AttributeView& attributes) {
+    return attributes.contains("depth");
 }
 
 /**
- * Creates a node from a map of XML attributes.
+ * Creates a node from XML attributes.
  *
- * @param attributes Map of XML attributes
+ * @param attributes Attributes of XML element
  * @return Resulting ClearNode instance
  */
-Node* ClearNodeUnmarshaller::unmarshal(const std::map<std::string,std::string>& attributes) {
+Node* ClearNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
 
     // Mask determining what gets cleared
     GLbitfield mask = 0;
@@ -35,13 +35,13 @@ public:
 // Methods
     ClearNodeUnmarshaller();
     virtual ~ClearNodeUnmarshaller();
-    virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+    virtual Node* unmarshal(const AttributeView& attributes);
 private:
 // Methods
-    static Glycerin::Color getColor(const std::map<std::string,std::string>&);
-    static GLfloat getDepth(const std::map<std::string,std::string>&);
-    static bool hasColor(const std::map<std::string,std::string>&);
-    static bool hasDepth(const std::map<std::string,std::string>&);
+    static Glycerin::Color getColor(const AttributeView&);
+    static GLfloat getDepth(const AttributeView&);
+    static bool hasColor(const AttributeView&);
+    static bool hasDepth(const AttributeView&);
 };
 
 } /* namespace RapidGL */
@@ -24,11 +24,11 @@
 #include "RapidGL/CubeNode.h"
 namespace RapidGL {
 
-// Array buffer target
-const Gloop::BufferTarget CubeNode::arrayBuffer = Gloop::BufferTarget::arrayBuffer();
+// Name of geometry shared by every cube
+const std::string CubeNode::GEOMETRY_NAME = "cube";
 
 // Indices determining which triangle vertices correspond to which corners
-const std::vector<int> CubeNode::INDICES = createIndices();
+const std::vector<GLushort> CubeNode::INDICES = createIndices();
 
 // Points for each corner
 const std::vector<M3d::Vec3> CubeNode::POINTS = createPoints();
@@ -45,39 +45,29 @@ CubeNode::CubeNode(const std::string& id) :
         Node(id),
         ready(false),
         boundingBox(createBoundingBox()),
-        layout(createBufferLayout()),
-        vbo(Gloop::BufferObject::generate()) {
+        geometry(Geometry::acquire(GEOMETRY_NAME, &createGeometry)),
+        vaoCache(geometry) {
 
-    // Bind buffer
-    arrayBuffer.bind(vbo);
-
-    // Create data
-    const int len = layout.sizeInBytes() / sizeof(GLfloat);
-    GLfloat data[len];
-    GLfloat* ptr = data;
-    for (int i = 0; i < VERTEX_COUNT; ++i) {
-        const int corner = INDICES[i];
-        *(ptr++) = POINTS[corner].x;
-        *(ptr++) = POINTS[corner].y;
-        *(ptr++) = POINTS[corner].z;
-        *(ptr++) = COORDS[corner].x;
-        *(ptr++) = COORDS[corner].y;
-        *(ptr++) = COORDS[corner].z;
-    }
-
-    // Load data
-    arrayBuffer.data(layout.sizeInBytes(), data, GL_STATIC_DRAW);
-
-    // Unbind buffer
-    arrayBuffer.unbind(vbo);
+    // Only draws when visited
+    setHooks(VISIT);
 }
 
 /**
  * Destructs a `CubeNode`.
  */
 CubeNode::~CubeNode() {
-    forEachValue(vaos, &disposeVertexArrayObject);
-    vbo.dispose();
+    Geometry::release(GEOMETRY_NAME);
+}
+
+/**
+ * Computes the bounds of the cube and any children of this node.
+ *
+ * @return Box enclosing the cube and any children
+ */
+BoundingBox CubeNode::computeBounds() {
+    BoundingBox box = Node::computeBounds();
+    box.add(BoundingBox(M3d::Vec3(-0.5, -0.5, -0.5), M3d::Vec3(0.5, 0.5, 0.5)));
+    return box;
 }
 
 /**
@@ -94,7 +84,7 @@ Glycerin::AxisAlignedBoundingBox CubeNode::createBoundingBox() {
  */
 Glycerin::BufferLayout CubeNode::createBufferLayout() {
     return Glycerin::BufferLayoutBuilder()
-            .count(VERTEX_COUNT)
+            .count(CORNER_COUNT)
             .interleaved(true)
             .components(3)
             .region("POSITION")
@@ -118,12 +108,35 @@ std::vector<M3d::Vec3> CubeNode::createCoords() {
     return coords;
 }
 
+/**
+ * Creates the geometry shared by every cube.
+ *
+ * @param name Name of geometry
+ */
+Geometry* CubeNode::createGeometry(const std::string& name) {
+
+    // Interleave points and coordinates of each corner
+    const Glycerin::BufferLayout layout = createBufferLayout();
+    std::vector<GLfloat> data;
+    data.reserve(layout.sizeInBytes() / sizeof(GLfloat));
+    for (int i = 0; i < CORNER_COUNT; ++i) {
+        data.push_back(POINTS[i].x);
+        data.push_back(POINTS[i].y);
+        data.push_back(POINTS[i].z);
+        data.push_back(COORDS[i].x);
+        data.push_back(COORDS[i].y);
+        data.push_back(COORDS[i].z);
+    }
+
+    return new Geometry(layout, &data[0], INDICES);
+}
+
 /**
  * Creates the list of indices determining which triangle vertices correspond to which corners.
  */
-std::vector<int> CubeNode::createIndices() {
+std::vector<GLushort> CubeNode::createIndices() {
 
-    int arr[] = {
+    GLushort arr[] = {
             3, 2, 0,
             0, 1, 3,
             2, 6, 4,
@@ -138,11 +151,7 @@ std::vector<int> CubeNode::createIndices() {
             4, 5, 1 };
 
 
-    std::vector<int> indices;
-    for (int i = 0; i < VERTEX_COUNT; ++i) {
-        indices.push_back(arr[i]);
-    }
-    return indices;
+    return std::vector<GLushort>(arr, arr + INDEX_COUNT);
 }
 
 /**
@@ -161,112 +170,40 @@ std::vector<M3d::Vec3> CubeNode::createPoints() {
     return points;
 }
 
-Gloop::VertexArrayObject CubeNode::createVertexArrayObject(const Gloop::Program& program) {
-
-    // Generate VAO
-    const Gloop::VertexArrayObject vao = Gloop::VertexArrayObject::generate();
-
-    // Find program node for program
-    const Node* root = findRoot(this);
-    const ProgramNode* programNode = findProgramNode(root, program);
-    if (programNode == NULL) {
-        throw std::runtime_error("[CubeNode] Could not find program node for program!");
-    }
-
-    // Find attribute locations by usage
-    std::map<AttributeNode::Usage,GLint> locationsByUsage;
-    const node_range_t children = programNode->getChildren();
-    for (node_iterator_t it = children.begin; it != children.end; ++it) {
-        const AttributeNode* attributeNode = dynamic_cast<AttributeNode*>(*it);
-        if (attributeNode != NULL) {
-            const GLint location = program.attribLocation(attributeNode->getName());
-            if (location != -1) {
-                locationsByUsage[attributeNode->getUsage()] = location;
-            }
-        }
-    }
-
-    // Bind VAO
-    vao.bind();
-
-    // Bind buffer
-    arrayBuffer.bind(vbo);
-
-    // Bind attributes
-    for (Glycerin::BufferLayout::const_iterator it = layout.begin(); it != layout.end(); ++it) {
-        const AttributeNode::Usage usage = AttributeNode::parseUsage(it->name());
-        if (containsKey(locationsByUsage, usage)) {
-            const GLint location = getValueOfKey(locationsByUsage, usage);
-            vao.enableVertexAttribArray(location);
-            vao.vertexAttribPointer(Gloop::VertexAttribPointer()
-                    .index(location)
-                    .size(it->components())
-                    .offset(it->offset())
-                    .stride(it->stride()));
-        }
-    }
-
-    // Unbind buffer
-    arrayBuffer.unbind(vbo);
-
-    // Unbind VAO
-    vao.unbind();
-
-    // Return VAO
-    return vao;
-}
-
-/**
- * Disposes of a vertex array object.
- *
- * @param vao Vertex Array Object to dispose of
- */
-void CubeNode::disposeVertexArrayObject(const Gloop::VertexArrayObject& vao) {
-    vao.dispose();
-}
-
-/**
- * Returns the vertex array object to use for a program.
- *
- * @param program Program to find vertex array object for
- * @return Vertex array object for program
- */
-Gloop::VertexArrayObject CubeNode::getVertexArrayObject(const Gloop::Program& program) {
-
-    // If VAO already made for the program just return it
-    std::map<Gloop::Program,Gloop::VertexArrayObject>::const_iterator it = vaos.find(program);
-    if (it != vaos.end()) {
-        return it->second;
-    }
-
-    // Otherwise create it
-    const Gloop::VertexArrayObject vao = createVertexArrayObject(program);
-
-    // Store it for next time
-    vaos.insert(std::pair<Gloop::Program,Gloop::VertexArrayObject>(program, vao));
-
-    // Return it
-    return vao;
-}
-
 double CubeNode::intersect(const Glycerin::Ray& ray) const {
     return boundingBox.intersect(ray);
 }
 
 void CubeNode::visit(State& state) {
 
+    // Draw every instance at once if a batch is being flushed
+    const InstanceBatcher* const instanceBatcher = state.getInstanceBatcher();
+    const GLsizei instanceCount = (instanceBatcher == NULL) ? 0 : instanceBatcher->getInstanceCount();
+
+    // Record into queue if there is one
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    if (renderQueue != NULL) {
+        const Gloop::VertexArrayObject vao = vaoCache.get(
+                this, renderQueue->getProgram(), state.getGLStateCache(), instanceBatcher);
+        renderQueue->addDrawElements(vao, GL_TRIANGLES, INDEX_COUNT, geometry->getIndexType(), state, instanceCount);
+        return;
+    }
+
     // Get current program
     const Gloop::Program program = Gloop::Program::current();
 
     // Get the VAO and bind it
-    const Gloop::VertexArrayObject vao = getVertexArrayObject(program);
-    vao.bind();
+    GLStateCache& glStateCache = state.getGLStateCache();
+    const Gloop::VertexArrayObject vao = vaoCache.get(this, program, glStateCache, instanceBatcher);
+    glStateCache.bindVertexArray(vao);
+    state.bindUniformBuffers();
 
     // Draw the cube
-    glDrawArrays(GL_TRIANGLES, 0, VERTEX_COUNT);
-
-    // Unbind the VAO
-    vao.unbind();
+    if (instanceCount > 0) {
+        glDrawElementsInstanced(GL_TRIANGLES, INDEX_COUNT, geometry->getIndexType(), NULL, instanceCount);
+    } else {
+        glDrawElements(GL_TRIANGLES, INDEX_COUNT, geometry->getIndexType(), NULL);
+    }
 }
 
 } /* namespace RapidGL */
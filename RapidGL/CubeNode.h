@@ -18,9 +18,9 @@
 #ifndef RAPIDGL_CUBE_NODE_H
 #define RAPIDGL_CUBE_NODE_H
 #include <map>
+#include <string>
+#include <utility>
 #include <vector>
-#include <gloop/BufferObject.hxx>
-#include <gloop/BufferTarget.hxx>
 #include <gloop/VertexArrayObject.hxx>
 #include <glycerin/AxisAlignedBoundingBox.hxx>
 #include <glycerin/BufferLayout.hxx>
@@ -28,16 +28,24 @@
 #include <m3d/Vec3.h>
 #include "RapidGL/common.h"
 #include "RapidGL/AttributeNode.h"
+#include "RapidGL/BoundingBox.h"
+#include "RapidGL/Geometry.h"
+#include "RapidGL/InstanceBatcher.h"
 #include "RapidGL/Intersectable.h"
 #include "RapidGL/Node.h"
 #include "RapidGL/ProgramNode.h"
+#include "RapidGL/RenderQueue.h"
 #include "RapidGL/State.h"
 #include "RapidGL/UseNode.h"
+#include "RapidGL/VertexArrayCache.h"
 namespace RapidGL {
 
 
 /**
  * Node that draws a cube.
+ *
+ * Every cube shares one `Geometry` holding its eight corners and the indices
+ * of its twelve triangles.
  */
 class CubeNode : public Node, public Intersectable {
 public:
@@ -46,28 +54,29 @@ public:
     virtual ~CubeNode();
     virtual double intersect(const Glycerin::Ray& ray) const;
     virtual void visit(State& state);
+protected:
+// Methods
+    virtual BoundingBox computeBounds();
 private:
 // Constants
-    static const int VERTEX_COUNT = 36;
-    static const Gloop::BufferTarget arrayBuffer;
-    static const std::vector<int> INDICES;
+    static const int CORNER_COUNT = 8;
+    static const int INDEX_COUNT = 36;
+    static const std::string GEOMETRY_NAME;
+    static const std::vector<GLushort> INDICES;
     static const std::vector<M3d::Vec3> POINTS;
     static const std::vector<M3d::Vec3> COORDS;
 // Attributes
     bool ready;
     const Glycerin::AxisAlignedBoundingBox boundingBox;
-    const Gloop::BufferObject vbo;
-    const Glycerin::BufferLayout layout;
-    std::map<Gloop::Program,Gloop::VertexArrayObject> vaos;
+    Geometry* const geometry;
+    VertexArrayCache vaoCache;
 // Methods
     static Glycerin::AxisAlignedBoundingBox createBoundingBox();
     static Glycerin::BufferLayout createBufferLayout();
     static std::vector<M3d::Vec3> createCoords();
-    static std::vector<int> createIndices();
+    static Geometry* createGeometry(const std::string& name);
+    static std::vector<GLushort> createIndices();
     static std::vector<M3d::Vec3> createPoints();
-    Gloop::VertexArrayObject createVertexArrayObject(const Gloop::Program& program);
-    static void disposeVertexArrayObject(const Gloop::VertexArrayObject& vao);
-    Gloop::VertexArrayObject getVertexArrayObject(const Gloop::Program& program);
 };
 
 } /* namespace RapidGL */
@@ -33,7 +33,7 @@ CubeNodeUnmarshaller::~CubeNodeUnmarshaller() {
     // empty
 }
 
-Node* CubeNodeUnmarshaller::unmarshal(const std::map<std::string,std::string>& attributes) {
+Node* CubeNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
     const std::string id = findValue(attributes, "id");
     return new CubeNode(id);
 }
@@ -41,6 +41,7 @@ CullNode::CullNode(const GLenum mode) : mode(mode) {
     if (!isMode(mode)) {
         throw std::invalid_argument("[CullNode] Mode is not valid!");
     }
+    setHooks(VISIT);
 }
 
 /**
@@ -50,6 +51,15 @@ CullNode::~CullNode() {
     // empty
 }
 
+/**
+ * Returns an infinite box, since the cull face affects everything drawn after this node.
+ *
+ * @return Infinite box
+ */
+BoundingBox CullNode::computeBounds() {
+    return BoundingBox::infinite();
+}
+
 /**
  * Returns the mode determining which, if any faces are culled.
  *
@@ -88,12 +98,13 @@ bool CullNode::isMode(const GLenum enumeration) {
 }
 
 void CullNode::visit(State& state) {
-    if (mode == GL_NONE) {
-        glDisable(GL_CULL_FACE);
-    } else {
-        glEnable(GL_CULL_FACE);
-        glCullFace(mode);
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    if (renderQueue != NULL) {
+        renderQueue->addBarrier(this, VISIT);
+        return;
     }
+
+    state.getGLStateCache().setCullFace(mode);
 }
 
 } /* namespace RapidGL */
@@ -18,7 +18,9 @@
 #ifndef RAPIDGL_CULL_NODE_H
 #define RAPIDGL_CULL_NODE_H
 #include "RapidGL/common.h"
+#include "RapidGL/BoundingBox.h"
 #include "RapidGL/Node.h"
+#include "RapidGL/RenderQueue.h"
 #include "RapidGL/State.h"
 namespace RapidGL {
 
@@ -33,6 +35,9 @@ public:
     virtual ~CullNode();
     GLenum getMode() const;
     virtual void visit(State& state);
+protected:
+// Methods
+    virtual BoundingBox computeBounds();
 private:
 // Attributes
     const GLenum mode;
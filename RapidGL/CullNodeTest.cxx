@@ -102,6 +102,7 @@ public:
         // Set up OpenGL state
         glDisable(GL_CULL_FACE);
         glCullFace(GL_FRONT);
+        state.getGLStateCache().invalidate();
 
         // Visit the node
         node.visit(state);
@@ -122,6 +123,7 @@ public:
         // Set up OpenGL state
         glDisable(GL_CULL_FACE);
         glCullFace(GL_BACK);
+        state.getGLStateCache().invalidate();
 
         // Visit the node
         node.visit(state);
@@ -142,6 +144,7 @@ public:
         // Set up OpenGL state
         glDisable(GL_CULL_FACE);
         glCullFace(GL_BACK);
+        state.getGLStateCache().invalidate();
 
         // Visit the node
         node.visit(state);
@@ -163,6 +166,7 @@ public:
         const GLenum mode = getRandomCullFaceMode();
         glEnable(GL_CULL_FACE);
         glCullFace(mode);
+        state.getGLStateCache().invalidate();
 
         // Visit the node
         node.visit(state);
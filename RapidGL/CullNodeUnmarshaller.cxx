@@ -49,13 +49,13 @@ std::map<std::string,GLenum> CullNodeUnmarshaller::createModesByValue() {
 }
 
 /**
- * Returns the value of the _mode_ attribute in a map.
+ * Returns the value of the _mode_ attribute.
  *
- * @param attributes Map of attributes to look in
- * @return Value of the _mode_ attribute in the given map
+ * @param attributes Attributes to look in
+ * @return Value of the _mode_ attribute
  * @throws std::runtime_error if value is unspecified or invalid
  */
-GLenum CullNodeUnmarshaller::getMode(const std::map<std::string,std::string>& attributes) {
+GLenum CullNodeUnmarshaller::getMode(const AttributeView& attributes) {
 
     // Find the value
     const std::string value = findValue(attributes, "mode");
@@ -73,7 +73,7 @@ GLenum CullNodeUnmarshaller::getMode(const std::map<std::string,std::string>& at
     }
 }
 
-Node* CullNodeUnmarshaller::unmarshal(const std::map<std::string,std::string>& attributes) {
+Node* CullNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
     const GLenum mode = getMode(attributes);
     return new CullNode(mode);
 }
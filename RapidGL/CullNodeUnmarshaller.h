@@ -34,13 +34,13 @@ public:
 // Methods
     CullNodeUnmarshaller();
     virtual ~CullNodeUnmarshaller();
-    virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+    virtual Node* unmarshal(const AttributeView& attributes);
 private:
 // Attributes
     const std::map<std::string,GLenum> modesByValue;
 // Methods
     static std::map<std::string,GLenum> createModesByValue();
-    GLenum getMode(const std::map<std::string,std::string>& attributes);
+    GLenum getMode(const AttributeView& attributes);
 };
 
 } /* namespace RapidGL */
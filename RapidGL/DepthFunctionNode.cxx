@@ -29,6 +29,7 @@ DepthFunctionNode::DepthFunctionNode(const GLenum function) : function(function)
     if (!isFunction(function)) {
         throw std::invalid_argument("Enumeration is not a valid depth function!");
     }
+    setHooks(VISIT);
 }
 
 /**
@@ -38,6 +39,15 @@ DepthFunctionNode::~DepthFunctionNode() {
     // empty
 }
 
+/**
+ * Returns an infinite box, since the depth function affects everything drawn after this node.
+ *
+ * @return Infinite box
+ */
+BoundingBox DepthFunctionNode::computeBounds() {
+    return BoundingBox::infinite();
+}
+
 /**
  * Returns the depth function this node applies when it's visited.
  *
@@ -70,7 +80,13 @@ bool DepthFunctionNode::isFunction(const GLenum enumeration) {
 }
 
 void DepthFunctionNode::visit(State& state) {
-    glDepthFunc(function);
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    if (renderQueue != NULL) {
+        renderQueue->addBarrier(this, VISIT);
+        return;
+    }
+
+    state.getGLStateCache().setDepthFunction(function);
 }
 
 } /* namespace RapidGL */
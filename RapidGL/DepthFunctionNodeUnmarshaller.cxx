@@ -57,12 +57,12 @@ map<string,GLenum> DepthFunctionNodeUnmarshaller::createFunctions() {
 }
 
 /**
- * Returns the value of the _function_ attribute in a map.
+ * Returns the value of the _function_ attribute.
  *
- * @param attributes Map of attributes to look in
+ * @param attributes Attributes to look in
  * @throws std::runtime_error if function is unspecified or invalid
  */
-GLenum DepthFunctionNodeUnmarshaller::getFunction(const map<string,string>& attributes) {
+GLenum DepthFunctionNodeUnmarshaller::getFunction(const AttributeView& attributes) {
 
     // Get value
     const string value = findValue(attributes, "function");
@@ -81,7 +81,7 @@ GLenum DepthFunctionNodeUnmarshaller::getFunction(const map<string,string>& attr
     return it->second;
 }
 
-Node* DepthFunctionNodeUnmarshaller::unmarshal(const map<string,string>& attributes) {
+Node* DepthFunctionNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
     const GLenum function = getFunction(attributes);
     return new DepthFunctionNode(function);
 }
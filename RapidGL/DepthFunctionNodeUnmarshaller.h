@@ -34,13 +34,13 @@ public:
 // Methods
     DepthFunctionNodeUnmarshaller();
     virtual ~DepthFunctionNodeUnmarshaller();
-    virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+    virtual Node* unmarshal(const AttributeView& attributes);
 private:
 // Constants
     static const std::map<std::string,GLenum> FUNCTIONS;
 // Methods
     static std::map<std::string,GLenum> createFunctions();
-    static GLenum getFunction(const std::map<std::string,std::string>& attributes);
+    static GLenum getFunction(const AttributeView& attributes);
 };
 
 } /* namespace RapidGL */
@@ -57,13 +57,23 @@ GLfloat FloatUniformNode::getValue() const {
  */
 void FloatUniformNode::setValue(const GLfloat value) {
     this->value = value;
+    invalidateUploads();
     fireNodeChangedEvent();
 }
 
 void FloatUniformNode::visit(State& state) {
-    const GLint location = getLocationInProgram(Gloop::Program::current());
-    if (location >= 0) {
-        glUniform1f(location, value);
+    const GLint location = getLocationInCurrentProgram(state);
+    if (location < 0) {
+        setValueInUniformBuffers(state, &value);
+        return;
+    }
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    if (renderQueue == NULL) {
+        if (isUploadNeeded(state)) {
+            glUniform1f(location, value);
+        }
+    } else {
+        renderQueue->setUniform(location, TYPE, &value);
     }
 }
 
@@ -37,6 +37,15 @@ FramebufferNode::~FramebufferNode() {
     // empty
 }
 
+/**
+ * Returns an infinite box, since what is drawn into the framebuffer is not seen through the frustum.
+ *
+ * @return Infinite box
+ */
+BoundingBox FramebufferNode::computeBounds() {
+    return BoundingBox::infinite();
+}
+
 /**
  * Constructs a default attacher.
  */
@@ -99,13 +108,18 @@ GLint FramebufferNode::getMaxColorAttachments() {
  * Unbinds the OpenGL framebuffer object represented by this node.
  */
 void FramebufferNode::postVisit(State& state) {
-    drawFramebuffer.unbind();
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    if (renderQueue != NULL) {
+        renderQueue->addBarrier(this, POST_VISIT);
+        return;
+    }
+    state.getGLStateCache().unbindDrawFramebuffer();
 }
 
 /**
  * Sets up the framebuffer object if it hasn't been already.
  */
-void FramebufferNode::preVisit(State& state) {
+void FramebufferNode::prepare(State& state) {
 
     // Skip if already ready
     if (ready) {
@@ -131,7 +145,8 @@ void FramebufferNode::preVisit(State& state) {
     }
 
     // Bind the FBO
-    drawFramebuffer.bind(fbo);
+    GLStateCache& glStateCache = state.getGLStateCache();
+    glStateCache.bindDrawFramebuffer(fbo);
 
     // Run each of the attachers
     for (map<AttachmentNode::Usage,Attacher>::iterator it = attachers.begin(); it != attachers.end(); ++it) {
@@ -144,15 +159,31 @@ void FramebufferNode::preVisit(State& state) {
         throw std::runtime_error(Gloop::FramebufferTarget::formatStatus(status));
     }
 
+    // Unbind until visited
+    glStateCache.unbindDrawFramebuffer();
+
     // Now ready
     ready = true;
+    setHooks(getHooks() & ~PRE_VISIT);
+}
+
+/**
+ * Prepares this node if it was not prepared before being visited.
+ */
+void FramebufferNode::preVisit(State& state) {
+    prepare(state);
 }
 
 /**
  * Binds the OpenGL framebuffer object represented by this node.
  */
 void FramebufferNode::visit(State& state) {
-    drawFramebuffer.bind(fbo);
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    if (renderQueue != NULL) {
+        renderQueue->addBarrier(this, VISIT);
+        return;
+    }
+    state.getGLStateCache().bindDrawFramebuffer(fbo);
 }
 
 } /* namespace RapidGL */
@@ -23,7 +23,9 @@
 #include <gloop/FramebufferTarget.hxx>
 #include "RapidGL/common.h"
 #include "RapidGL/AttachmentNode.h"
+#include "RapidGL/BoundingBox.h"
 #include "RapidGL/Node.h"
+#include "RapidGL/RenderQueue.h"
 #include "RapidGL/State.h"
 namespace RapidGL {
 
@@ -38,8 +40,12 @@ public:
     virtual ~FramebufferNode();
     Gloop::FramebufferObject getFramebufferObject() const;
     virtual void postVisit(State& state);
+    virtual void prepare(State& state);
     virtual void preVisit(State& state);
     virtual void visit(State& state);
+protected:
+// Methods
+    virtual BoundingBox computeBounds();
 private:
 // Types
     class Attacher {
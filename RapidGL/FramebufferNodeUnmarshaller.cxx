@@ -33,7 +33,7 @@ FramebufferNodeUnmarshaller::~FramebufferNodeUnmarshaller() {
     // empty
 }
 
-Node* FramebufferNodeUnmarshaller::unmarshal(const std::map<std::string,std::string>& attributes) {
+Node* FramebufferNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
     return new FramebufferNode();
 }
 
@@ -34,7 +34,7 @@ public:
 // Methods
     FramebufferNodeUnmarshaller();
     ~FramebufferNodeUnmarshaller();
-    Node* unmarshal(const std::map<std::string,std::string>& attributes);
+    Node* unmarshal(const AttributeView& attributes);
 };
 
 } /* namespace RapidGL */
@@ -0,0 +1,89 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include "RapidGL/Frustum.h"
+namespace RapidGL {
+
+/**
+ * Constructs a frustum from a projection matrix.
+ *
+ * Planes are ordered left, right, bottom, top, near and far.  Each is stored
+ * as `(a, b, c, d)` such that a point `p` is on the inside when
+ * `a * p.x + b * p.y + c * p.z + d` is not negative.
+ *
+ * @param matrix Matrix transforming to clip space, e.g. the view-projection matrix
+ */
+Frustum::Frustum(const M3d::Mat4& matrix) {
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            planes[i * 2][j] = matrix[j][3] + matrix[j][i];
+            planes[i * 2 + 1][j] = matrix[j][3] - matrix[j][i];
+        }
+    }
+}
+
+/**
+ * Checks if a box is entirely outside this frustum.
+ *
+ * A box is only excluded if it is completely behind one of the planes, so a
+ * few boxes near the corners of the frustum are kept even though they are
+ * outside it.  Empty boxes are always excluded and infinite boxes never are.
+ *
+ * @param box Box to check, in the same space as the frustum
+ * @return `true` if nothing in the box could be visible
+ */
+bool Frustum::excludes(const BoundingBox& box) const {
+
+    if (box.isEmpty()) {
+        return true;
+    } else if (box.isInfinite()) {
+        return false;
+    }
+
+    const M3d::Vec3 min = box.getMin();
+    const M3d::Vec3 max = box.getMax();
+    for (int i = 0; i < PLANE_COUNT; ++i) {
+
+        // Test the corner furthest along the plane's normal
+        const M3d::Vec4& plane = planes[i];
+        const double x = (plane.x >= 0) ? max.x : min.x;
+        const double y = (plane.y >= 0) ? max.y : min.y;
+        const double z = (plane.z >= 0) ? max.z : min.z;
+        if ((plane.x * x) + (plane.y * y) + (plane.z * z) + plane.w < 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Returns one of the planes of this frustum.
+ *
+ * @param i Index of plane, in the order left, right, bottom, top, near and far
+ * @return Plane as `(a, b, c, d)`, not normalized
+ * @throws out_of_range if index is not less than `PLANE_COUNT`
+ */
+M3d::Vec4 Frustum::getPlane(const int i) const {
+    if ((i < 0) || (i >= PLANE_COUNT)) {
+        throw std::out_of_range("[Frustum] Plane index is out of range!");
+    }
+    return planes[i];
+}
+
+} /* namespace RapidGL */
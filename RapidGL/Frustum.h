@@ -0,0 +1,48 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RAPIDGL_FRUSTUM_H
+#define RAPIDGL_FRUSTUM_H
+#include <m3d/Mat4.h>
+#include <m3d/Vec4.h>
+#include "RapidGL/common.h"
+#include "RapidGL/BoundingBox.h"
+namespace RapidGL {
+
+
+/**
+ * Volume visible through a projection, as six planes facing inward.
+ *
+ * The planes are pulled out of the rows of a matrix, so they are in whatever
+ * space the matrix transforms from.  Made from a view-projection matrix, the
+ * frustum is in world space.
+ */
+class Frustum {
+public:
+// Methods
+    Frustum(const M3d::Mat4& matrix);
+    bool excludes(const BoundingBox& box) const;
+    M3d::Vec4 getPlane(int i) const;
+// Constants
+    static const int PLANE_COUNT = 6;
+private:
+// Attributes
+    M3d::Vec4 planes[PLANE_COUNT];
+};
+
+} /* namespace RapidGL */
+#endif
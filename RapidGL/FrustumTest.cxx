@@ -0,0 +1,117 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include <m3d/Mat4.h>
+#include <m3d/Vec3.h>
+#include <m3d/Vec4.h>
+#include "RapidGL/BoundingBox.h"
+#include "RapidGL/Frustum.h"
+
+
+/**
+ * Unit test for `Frustum`.
+ */
+class FrustumTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Makes a box from its center and half its size.
+     *
+     * @param center Center of box
+     * @param radius Half the length of each side
+     * @return Box with that center and size
+     */
+    static RapidGL::BoundingBox makeBox(const M3d::Vec3& center, const double radius) {
+        return RapidGL::BoundingBox(center - M3d::Vec3(radius, radius, radius), center + M3d::Vec3(radius, radius, radius));
+    }
+
+    /**
+     * Makes a perspective projection looking down negative Z, like `gluPerspective` with a 90 degree field of view.
+     *
+     * @param near Distance to near plane
+     * @param far Distance to far plane
+     * @return Projection matrix
+     */
+    static M3d::Mat4 makePerspective(const double near, const double far) {
+        M3d::Mat4 matrix(1);
+        matrix[2][2] = (far + near) / (near - far);
+        matrix[2][3] = -1;
+        matrix[3][2] = (2 * far * near) / (near - far);
+        matrix[3][3] = 0;
+        return matrix;
+    }
+
+    /**
+     * Ensures `Frustum::excludes` excludes boxes outside an orthographic frustum.
+     */
+    void testExcludesWithIdentity() {
+        const RapidGL::Frustum frustum(M3d::Mat4(1));
+        CPPUNIT_ASSERT(!frustum.excludes(makeBox(M3d::Vec3(0, 0, 0), 0.5)));
+        CPPUNIT_ASSERT(!frustum.excludes(makeBox(M3d::Vec3(1.4, 0, 0), 0.5)));
+        CPPUNIT_ASSERT(frustum.excludes(makeBox(M3d::Vec3(1.6, 0, 0), 0.5)));
+        CPPUNIT_ASSERT(frustum.excludes(makeBox(M3d::Vec3(0, -1.6, 0), 0.5)));
+        CPPUNIT_ASSERT(frustum.excludes(makeBox(M3d::Vec3(0, 0, 1.6), 0.5)));
+    }
+
+    /**
+     * Ensures `Frustum::excludes` never excludes infinite boxes and always excludes empty ones.
+     */
+    void testExcludesWithEmptyAndInfinite() {
+        const RapidGL::Frustum frustum(M3d::Mat4(1));
+        CPPUNIT_ASSERT(frustum.excludes(RapidGL::BoundingBox()));
+        CPPUNIT_ASSERT(!frustum.excludes(RapidGL::BoundingBox::infinite()));
+    }
+
+    /**
+     * Ensures `Frustum::excludes` excludes boxes behind, beyond and beside a perspective frustum.
+     */
+    void testExcludesWithPerspective() {
+        const RapidGL::Frustum frustum(makePerspective(1, 100));
+        CPPUNIT_ASSERT(!frustum.excludes(makeBox(M3d::Vec3(0, 0, -10), 1)));
+        CPPUNIT_ASSERT(!frustum.excludes(makeBox(M3d::Vec3(9, 0, -10), 1)));
+        CPPUNIT_ASSERT(frustum.excludes(makeBox(M3d::Vec3(14, 0, -10), 1)));
+        CPPUNIT_ASSERT(frustum.excludes(makeBox(M3d::Vec3(0, 0, 10), 1)));
+        CPPUNIT_ASSERT(frustum.excludes(makeBox(M3d::Vec3(0, 0, -200), 1)));
+    }
+
+    /**
+     * Ensures `Frustum::getPlane` throws if the index is out of range.
+     */
+    void testGetPlaneWithBadIndex() {
+        const RapidGL::Frustum frustum(M3d::Mat4(1));
+        CPPUNIT_ASSERT_THROW(frustum.getPlane(RapidGL::Frustum::PLANE_COUNT), std::out_of_range);
+    }
+
+    CPPUNIT_TEST_SUITE(FrustumTest);
+    CPPUNIT_TEST(testExcludesWithEmptyAndInfinite);
+    CPPUNIT_TEST(testExcludesWithIdentity);
+    CPPUNIT_TEST(testExcludesWithPerspective);
+    CPPUNIT_TEST(testGetPlaneWithBadIndex);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(FrustumTest::suite());
+    runner.run();
+    return 0;
+}
@@ -0,0 +1,386 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include "RapidGL/GLStateCache.h"
+namespace RapidGL {
+
+/**
+ * Constructs a state cache with everything unknown.
+ */
+GLStateCache::GLStateCache() :
+        clearColor(0, 0, 0, 0),
+        clearDepth(0),
+        hitCount(0),
+        missCount(0) {
+    invalidate();
+}
+
+/**
+ * Destructs a state cache.
+ */
+GLStateCache::~GLStateCache() {
+    // empty
+}
+
+/**
+ * Binds a framebuffer object to the draw framebuffer target if it is not already.
+ *
+ * @param fbo Framebuffer object to bind
+ */
+void GLStateCache::bindDrawFramebuffer(const Gloop::FramebufferObject& fbo) {
+    bindDrawFramebuffer(fbo.id());
+}
+
+/**
+ * Binds a framebuffer to the draw framebuffer target if it is not already.
+ *
+ * @param id Name of framebuffer to bind, where zero is the default framebuffer
+ */
+void GLStateCache::bindDrawFramebuffer(const GLuint id) {
+    if (drawFramebuffer == id) {
+        ++hitCount;
+        return;
+    }
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, id);
+    drawFramebuffer = id;
+    ++missCount;
+}
+
+/**
+ * Binds a texture on a texture unit if it is not already.
+ *
+ * The unit is only activated if the texture needs to be bound.
+ *
+ * @param unit Texture unit to bind texture on
+ * @param target Target to bind texture to
+ * @param texture Texture to bind
+ */
+void GLStateCache::bindTexture(const Gloop::TextureUnit& unit,
+                               const Gloop::TextureTarget& target,
+                               const Gloop::TextureObject& texture) {
+
+    // Check if already bound
+    const size_t ordinal = unit.toOrdinal();
+    if (ordinal >= texturesByUnit.size()) {
+        texturesByUnit.resize(ordinal + 1);
+    }
+    std::map<GLenum,GLuint>& textures = texturesByUnit[ordinal];
+    const GLenum targetEnum = target.toEnum();
+    const GLuint id = texture.id();
+    const std::map<GLenum,GLuint>::const_iterator it = textures.find(targetEnum);
+    if ((it != textures.end()) && (it->second == id)) {
+        ++hitCount;
+        return;
+    }
+
+    // Activate unit and bind
+    const GLenum unitEnum = unit.toEnum();
+    if (activeUnit != unitEnum) {
+        glActiveTexture(unitEnum);
+        activeUnit = unitEnum;
+    }
+    glBindTexture(targetEnum, id);
+    textures[targetEnum] = id;
+    ++missCount;
+}
+
+/**
+ * Binds a range of a buffer to a uniform buffer binding point if it is not already.
+ *
+ * @param index Binding point to bind range to
+ * @param buffer Name of buffer holding range
+ * @param offset Offset of range in buffer
+ * @param size Size of range in bytes
+ */
+void GLStateCache::bindUniformBuffer(const GLuint index,
+                                     const GLuint buffer,
+                                     const GLintptr offset,
+                                     const GLsizeiptr size) {
+
+    // Check if already bound
+    if (index >= uniformBuffers.size()) {
+        const BufferRange unknown = { UNKNOWN, 0, 0 };
+        uniformBuffers.resize(index + 1, unknown);
+    }
+    BufferRange& range = uniformBuffers[index];
+    if ((range.buffer == buffer) && (range.offset == offset) && (range.size == size)) {
+        ++hitCount;
+        return;
+    }
+
+    // Bind
+    glBindBufferRange(GL_UNIFORM_BUFFER, index, buffer, offset, size);
+    range.buffer = buffer;
+    range.offset = offset;
+    range.size = size;
+    ++missCount;
+}
+
+/**
+ * Binds a vertex array object if it is not already.
+ *
+ * @param vao Vertex array object to bind
+ */
+void GLStateCache::bindVertexArray(const Gloop::VertexArrayObject& vao) {
+    bindVertexArray(vao.id());
+}
+
+/**
+ * Binds a vertex array if it is not already.
+ *
+ * @param id Name of vertex array to bind, where zero unbinds
+ */
+void GLStateCache::bindVertexArray(const GLuint id) {
+    if (vao == id) {
+        ++hitCount;
+        return;
+    }
+    glBindVertexArray(id);
+    vao = id;
+    ++missCount;
+}
+
+/**
+ * Records that a node is loading a uniform of a program.
+ *
+ * Does not change the hit or miss counts, since no OpenGL calls are issued.
+ *
+ * @param program Name of program with uniform
+ * @param location Location of uniform in program
+ * @param node Node loading the uniform
+ * @return `true` if the node was also the last to load the uniform
+ */
+bool GLStateCache::claimUniform(const GLuint program, const GLint location, const Node* const node) {
+
+    // Find the writers of the program's uniforms, checking the last program first
+    if ((lastUniformWriters == NULL) || (lastUniformProgram != program)) {
+        lastUniformProgram = program;
+        lastUniformWriters = &uniformWriters[program];
+    }
+    std::vector<const Node*>& writers = *lastUniformWriters;
+
+    // Swap in the node
+    if (location >= (GLint) writers.size()) {
+        writers.resize(location + 1, NULL);
+    }
+    const Node* const writer = writers[location];
+    writers[location] = node;
+    return writer == node;
+}
+
+/**
+ * Stops using any program if one is in use.
+ */
+void GLStateCache::clearProgram() {
+    useProgram(0);
+}
+
+/**
+ * Returns the number of requests that were dropped because they were already in effect.
+ *
+ * @return Number of requests that were dropped
+ */
+size_t GLStateCache::getHitCount() const {
+    return hitCount;
+}
+
+/**
+ * Returns the number of requests that had to be issued to OpenGL.
+ *
+ * @return Number of requests that had to be issued
+ */
+size_t GLStateCache::getMissCount() const {
+    return missCount;
+}
+
+/**
+ * Forgets all tracked state, so the next request for each piece is issued.
+ */
+void GLStateCache::invalidate() {
+    program = UNKNOWN;
+    activeUnit = UNKNOWN;
+    texturesByUnit.clear();
+    uniformBuffers.clear();
+    invalidateUniforms();
+    vao = UNKNOWN;
+    drawFramebuffer = UNKNOWN;
+    cullFaceEnabled = UNKNOWN;
+    cullFaceMode = UNKNOWN;
+    depthFunction = UNKNOWN;
+    polygonMode = UNKNOWN;
+    clearColorKnown = false;
+    clearDepthKnown = false;
+}
+
+/**
+ * Forgets which node last loaded each uniform, after uniforms were loaded without claiming them.
+ */
+void GLStateCache::invalidateUniforms() {
+    uniformWriters.clear();
+    lastUniformProgram = 0;
+    lastUniformWriters = NULL;
+}
+
+/**
+ * Sets the hit and miss counts back to zero.
+ */
+void GLStateCache::resetCounts() {
+    hitCount = 0;
+    missCount = 0;
+}
+
+/**
+ * Changes the color the color buffer is cleared with if it is different.
+ *
+ * @param color Color to clear the color buffer with
+ */
+void GLStateCache::setClearColor(const Glycerin::Color& color) {
+    if (clearColorKnown
+            && (clearColor.r == color.r)
+            && (clearColor.g == color.g)
+            && (clearColor.b == color.b)
+            && (clearColor.a == color.a)) {
+        ++hitCount;
+        return;
+    }
+    glClearColor(color.r, color.g, color.b, color.a);
+    clearColor = color;
+    clearColorKnown = true;
+    ++missCount;
+}
+
+/**
+ * Changes the depth the depth buffer is cleared with if it is different.
+ *
+ * @param depth Depth to clear the depth buffer with
+ */
+void GLStateCache::setClearDepth(const GLfloat depth) {
+    if (clearDepthKnown && (clearDepth == depth)) {
+        ++hitCount;
+        return;
+    }
+    glClearDepth(depth);
+    clearDepth = depth;
+    clearDepthKnown = true;
+    ++missCount;
+}
+
+/**
+ * Changes which faces are culled if it is different.
+ *
+ * @param mode Faces to cull, e.g. `GL_BACK`, or `GL_NONE` to disable culling
+ */
+void GLStateCache::setCullFace(const GLenum mode) {
+
+    // Disable
+    if (mode == GL_NONE) {
+        if (cullFaceEnabled == GL_FALSE) {
+            ++hitCount;
+            return;
+        }
+        glDisable(GL_CULL_FACE);
+        cullFaceEnabled = GL_FALSE;
+        ++missCount;
+        return;
+    }
+
+    // Enable and change mode
+    if ((cullFaceEnabled == GL_TRUE) && (cullFaceMode == mode)) {
+        ++hitCount;
+        return;
+    }
+    if (cullFaceEnabled != GL_TRUE) {
+        glEnable(GL_CULL_FACE);
+        cullFaceEnabled = GL_TRUE;
+    }
+    if (cullFaceMode != mode) {
+        glCullFace(mode);
+        cullFaceMode = mode;
+    }
+    ++missCount;
+}
+
+/**
+ * Changes the depth function if it is different.
+ *
+ * @param function Depth function to use, e.g. `GL_LESS`
+ */
+void GLStateCache::setDepthFunction(const GLenum function) {
+    if (depthFunction == function) {
+        ++hitCount;
+        return;
+    }
+    glDepthFunc(function);
+    depthFunction = function;
+    ++missCount;
+}
+
+/**
+ * Changes how front and back facing polygons are drawn if it is different.
+ *
+ * @param mode How to draw polygons, i.e. `GL_POINT`, `GL_LINE`, or `GL_FILL`
+ */
+void GLStateCache::setPolygonMode(const GLenum mode) {
+    if (polygonMode == mode) {
+        ++hitCount;
+        return;
+    }
+    glPolygonMode(GL_FRONT_AND_BACK, mode);
+    polygonMode = mode;
+    ++missCount;
+}
+
+/**
+ * Binds the default framebuffer to the draw framebuffer target if it is not already.
+ */
+void GLStateCache::unbindDrawFramebuffer() {
+    bindDrawFramebuffer(0);
+}
+
+/**
+ * Unbinds the current vertex array object if one is bound.
+ */
+void GLStateCache::unbindVertexArray() {
+    bindVertexArray(0);
+}
+
+/**
+ * Uses a program if it is not already in use.
+ *
+ * @param program Program to use
+ */
+void GLStateCache::useProgram(const Gloop::Program& program) {
+    useProgram(program.id());
+}
+
+/**
+ * Uses a program if it is not already in use.
+ *
+ * @param id Name of program to use, where zero stops using any program
+ */
+void GLStateCache::useProgram(const GLuint id) {
+    if (program == id) {
+        ++hitCount;
+        return;
+    }
+    glUseProgram(id);
+    program = id;
+    ++missCount;
+}
+
+} /* namespace RapidGL */
@@ -0,0 +1,127 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RAPIDGL_GL_STATE_CACHE_H
+#define RAPIDGL_GL_STATE_CACHE_H
+#include <map>
+#include <vector>
+#include <gloop/FramebufferObject.hxx>
+#include <gloop/Program.hxx>
+#include <gloop/TextureObject.hxx>
+#include <gloop/TextureTarget.hxx>
+#include <gloop/TextureUnit.hxx>
+#include <gloop/VertexArrayObject.hxx>
+#include <glycerin/Color.hxx>
+#include "RapidGL/common.h"
+namespace RapidGL {
+
+class Node;
+
+
+/**
+ * Shadow copy of OpenGL state that drops calls which would not change it.
+ *
+ * Tracks the current program, the textures bound on each texture unit, the
+ * ranges bound to each uniform buffer binding point, the vertex array object,
+ * the draw framebuffer, face culling, the depth function,
+ * the polygon mode, and the clear color and depth.  Each request either
+ * matches what is already in effect and is counted as a hit, or issues the
+ * OpenGL calls needed and is counted as a miss.
+ *
+ * Everything starts out unknown, so the first request for each piece of state
+ * is always issued.  Code that changes tracked state without going through
+ * the cache must either put it back afterwards, as `TextureNodeUnmarshaller`
+ * does, or call `invalidate` before the cache is used again, for example after
+ * deleting an object that may still be bound.  `ParallelRecorder::invalidate`
+ * does so for the caches of its jobs.
+ *
+ * OpenGL state belongs to the context, so every `State` drawing on a context
+ * should share one cache through `State::setGLStateCache`.  Otherwise only one
+ * state should issue OpenGL calls on the context, and if another state has
+ * been drawing, `invalidate` must be called before the cache is used again.
+ *
+ * The cache also remembers which node last loaded each uniform of each
+ * program, so a uniform node can tell whether the value it loaded before is
+ * still there.  Code loading uniforms some other way should call
+ * `invalidateUniforms` afterwards.
+ */
+class GLStateCache {
+public:
+// Methods
+    GLStateCache();
+    virtual ~GLStateCache();
+    void bindDrawFramebuffer(const Gloop::FramebufferObject& fbo);
+    void bindTexture(const Gloop::TextureUnit& unit,
+                     const Gloop::TextureTarget& target,
+                     const Gloop::TextureObject& texture);
+    void bindUniformBuffer(GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+    void bindVertexArray(const Gloop::VertexArrayObject& vao);
+    bool claimUniform(GLuint program, GLint location, const Node* node);
+    void clearProgram();
+    size_t getHitCount() const;
+    size_t getMissCount() const;
+    void invalidate();
+    void invalidateUniforms();
+    void resetCounts();
+    void setClearColor(const Glycerin::Color& color);
+    void setClearDepth(GLfloat depth);
+    void setCullFace(GLenum mode);
+    void setDepthFunction(GLenum function);
+    void setPolygonMode(GLenum mode);
+    void unbindDrawFramebuffer();
+    void unbindVertexArray();
+    void useProgram(const Gloop::Program& program);
+private:
+// Types
+    /**
+     * Range of a buffer bound to an indexed binding point.
+     */
+    struct BufferRange {
+        GLuint buffer;
+        GLintptr offset;
+        GLsizeiptr size;
+    };
+// Constants
+    static const GLuint UNKNOWN = 0xFFFFFFFF;
+// Attributes
+    GLuint program;
+    GLenum activeUnit;
+    std::vector< std::map<GLenum,GLuint> > texturesByUnit;
+    std::vector<BufferRange> uniformBuffers;
+    std::map< GLuint,std::vector<const Node*> > uniformWriters;
+    GLuint lastUniformProgram;
+    std::vector<const Node*>* lastUniformWriters;
+    GLuint vao;
+    GLuint drawFramebuffer;
+    GLenum cullFaceEnabled;
+    GLenum cullFaceMode;
+    GLenum depthFunction;
+    GLenum polygonMode;
+    bool clearColorKnown;
+    Glycerin::Color clearColor;
+    bool clearDepthKnown;
+    GLfloat clearDepth;
+    size_t hitCount;
+    size_t missCount;
+// Methods
+    void bindDrawFramebuffer(GLuint id);
+    void bindVertexArray(GLuint id);
+    void useProgram(GLuint id);
+};
+
+} /* namespace RapidGL */
+#endif
@@ -0,0 +1,318 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <cppunit/extensions/HelperMacros.h>
+#include <GL/glfw.h>
+#include <gloop/BufferObject.hxx>
+#include <gloop/BufferTarget.hxx>
+#include <gloop/TextureObject.hxx>
+#include <gloop/TextureTarget.hxx>
+#include <gloop/TextureUnit.hxx>
+#include <gloop/VertexArrayObject.hxx>
+#include <glycerin/Color.hxx>
+#include "RapidGL/GLStateCache.h"
+#include "RapidGL/GroupNode.h"
+
+
+/**
+ * Unit test for `GLStateCache`.
+ */
+class GLStateCacheTest {
+public:
+
+    /**
+     * Returns the value of an OpenGL integer state.
+     *
+     * @param name Name of state, e.g. `GL_DEPTH_FUNC`
+     * @return Value of state
+     */
+    static GLint getInteger(const GLenum name) {
+        GLint value;
+        glGetIntegerv(name, &value);
+        return value;
+    }
+
+    /**
+     * Ensures `GLStateCache::bindTexture` only binds textures that are not already bound.
+     */
+    void testBindTexture() {
+
+        // Make textures
+        const Gloop::TextureObject first = Gloop::TextureObject::generate();
+        const Gloop::TextureObject second = Gloop::TextureObject::generate();
+        const Gloop::TextureTarget target = Gloop::TextureTarget::texture2d();
+        const Gloop::TextureUnit unit0 = Gloop::TextureUnit::fromOrdinal(0);
+        const Gloop::TextureUnit unit1 = Gloop::TextureUnit::fromOrdinal(1);
+
+        // Bind on two units, then again
+        RapidGL::GLStateCache cache;
+        cache.bindTexture(unit0, target, first);
+        cache.bindTexture(unit1, target, second);
+        cache.bindTexture(unit0, target, first);
+        cache.bindTexture(unit1, target, second);
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, cache.getMissCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, cache.getHitCount());
+
+        // Check bindings
+        glActiveTexture(GL_TEXTURE0);
+        CPPUNIT_ASSERT_EQUAL((GLint) first.id(), getInteger(GL_TEXTURE_BINDING_2D));
+        glActiveTexture(GL_TEXTURE1);
+        CPPUNIT_ASSERT_EQUAL((GLint) second.id(), getInteger(GL_TEXTURE_BINDING_2D));
+
+        // Clean up
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        first.dispose();
+        second.dispose();
+    }
+
+    /**
+     * Ensures `GLStateCache::bindUniformBuffer` only binds a range that is not already bound.
+     */
+    void testBindUniformBuffer() {
+
+        // Make buffer
+        const Gloop::BufferObject ubo = Gloop::BufferObject::generate();
+        const Gloop::BufferTarget target = Gloop::BufferTarget::uniformBuffer();
+        target.bind(ubo);
+        target.data(512, NULL, GL_STREAM_DRAW);
+        target.unbind(ubo);
+
+        // Bind same range twice, then a different one
+        RapidGL::GLStateCache cache;
+        cache.bindUniformBuffer(1, ubo.id(), 0, 64);
+        cache.bindUniformBuffer(1, ubo.id(), 0, 64);
+        cache.bindUniformBuffer(1, ubo.id(), 256, 64);
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, cache.getMissCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, cache.getHitCount());
+
+        // Check binding
+        GLint value;
+        glGetIntegeri_v(GL_UNIFORM_BUFFER_START, 1, &value);
+        CPPUNIT_ASSERT_EQUAL((GLint) 256, value);
+
+        // Clean up
+        glBindBufferBase(GL_UNIFORM_BUFFER, 1, 0);
+        ubo.dispose();
+    }
+
+    /**
+     * Ensures `GLStateCache::bindVertexArray` only binds a vertex array object that is not already bound.
+     */
+    void testBindVertexArray() {
+
+        const Gloop::VertexArrayObject vao = Gloop::VertexArrayObject::generate();
+        RapidGL::GLStateCache cache;
+        cache.bindVertexArray(vao);
+        cache.bindVertexArray(vao);
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, cache.getMissCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, cache.getHitCount());
+        CPPUNIT_ASSERT_EQUAL((GLint) vao.id(), getInteger(GL_VERTEX_ARRAY_BINDING));
+
+        cache.unbindVertexArray();
+        CPPUNIT_ASSERT_EQUAL((GLint) 0, getInteger(GL_VERTEX_ARRAY_BINDING));
+        vao.dispose();
+    }
+
+    /**
+     * Ensures `GLStateCache::claimUniform` tells a node whether another node loaded the uniform since it did.
+     */
+    void testClaimUniform() {
+
+        RapidGL::GroupNode first("first");
+        RapidGL::GroupNode second("second");
+        RapidGL::GLStateCache cache;
+
+        // Claim twice
+        CPPUNIT_ASSERT(!cache.claimUniform(1, 2, &first));
+        CPPUNIT_ASSERT(cache.claimUniform(1, 2, &first));
+
+        // Claim with another node or in another program
+        CPPUNIT_ASSERT(!cache.claimUniform(1, 2, &second));
+        CPPUNIT_ASSERT(!cache.claimUniform(1, 2, &first));
+        CPPUNIT_ASSERT(!cache.claimUniform(3, 2, &first));
+        CPPUNIT_ASSERT(cache.claimUniform(1, 2, &first));
+
+        // Forget
+        cache.invalidateUniforms();
+        CPPUNIT_ASSERT(!cache.claimUniform(1, 2, &first));
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, cache.getMissCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, cache.getHitCount());
+    }
+
+    /**
+     * Ensures `GLStateCache::clearProgram` only stops using a program once.
+     */
+    void testClearProgram() {
+        RapidGL::GLStateCache cache;
+        cache.clearProgram();
+        cache.clearProgram();
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, cache.getMissCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, cache.getHitCount());
+        CPPUNIT_ASSERT_EQUAL((GLint) 0, getInteger(GL_CURRENT_PROGRAM));
+    }
+
+    /**
+     * Ensures `GLStateCache::invalidate` makes the next request be issued.
+     */
+    void testInvalidate() {
+
+        RapidGL::GLStateCache cache;
+        cache.setDepthFunction(GL_LESS);
+
+        // Change state behind cache's back
+        glDepthFunc(GL_ALWAYS);
+        cache.invalidate();
+
+        // Request again
+        cache.setDepthFunction(GL_LESS);
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, cache.getMissCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, cache.getHitCount());
+        CPPUNIT_ASSERT_EQUAL((GLint) GL_LESS, getInteger(GL_DEPTH_FUNC));
+    }
+
+    /**
+     * Ensures `GLStateCache::resetCounts` sets the counts back to zero.
+     */
+    void testResetCounts() {
+        RapidGL::GLStateCache cache;
+        cache.setPolygonMode(GL_FILL);
+        cache.setPolygonMode(GL_FILL);
+        cache.resetCounts();
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, cache.getMissCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, cache.getHitCount());
+    }
+
+    /**
+     * Ensures `GLStateCache::setClearColor` only changes the clear color if it is different.
+     */
+    void testSetClearColor() {
+
+        RapidGL::GLStateCache cache;
+        cache.setClearColor(Glycerin::Color(0.1f, 0.2f, 0.3f, 0.4f));
+        cache.setClearColor(Glycerin::Color(0.1f, 0.2f, 0.3f, 0.4f));
+        cache.setClearColor(Glycerin::Color(0.0f, 0.0f, 0.0f, 0.0f));
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, cache.getMissCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, cache.getHitCount());
+
+        GLfloat color[4];
+        glGetFloatv(GL_COLOR_CLEAR_VALUE, color);
+        CPPUNIT_ASSERT_EQUAL(0.0f, color[0]);
+    }
+
+    /**
+     * Ensures `GLStateCache::setCullFace` enables, disables and changes culling only when needed.
+     */
+    void testSetCullFace() {
+
+        RapidGL::GLStateCache cache;
+
+        // Disable
+        cache.setCullFace(GL_NONE);
+        cache.setCullFace(GL_NONE);
+        CPPUNIT_ASSERT(!glIsEnabled(GL_CULL_FACE));
+
+        // Enable
+        cache.setCullFace(GL_FRONT);
+        cache.setCullFace(GL_FRONT);
+        CPPUNIT_ASSERT(glIsEnabled(GL_CULL_FACE));
+        CPPUNIT_ASSERT_EQUAL((GLint) GL_FRONT, getInteger(GL_CULL_FACE_MODE));
+
+        // Change mode
+        cache.setCullFace(GL_BACK);
+        CPPUNIT_ASSERT_EQUAL((GLint) GL_BACK, getInteger(GL_CULL_FACE_MODE));
+
+        // Check counts
+        CPPUNIT_ASSERT_EQUAL((size_t) 3, cache.getMissCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, cache.getHitCount());
+        glDisable(GL_CULL_FACE);
+    }
+
+    /**
+     * Ensures `GLStateCache::setDepthFunction` only changes the depth function if it is different.
+     */
+    void testSetDepthFunction() {
+        RapidGL::GLStateCache cache;
+        cache.setDepthFunction(GL_LEQUAL);
+        cache.setDepthFunction(GL_LEQUAL);
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, cache.getMissCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, cache.getHitCount());
+        CPPUNIT_ASSERT_EQUAL((GLint) GL_LEQUAL, getInteger(GL_DEPTH_FUNC));
+        glDepthFunc(GL_LESS);
+    }
+
+    /**
+     * Ensures `GLStateCache::setPolygonMode` only changes the polygon mode if it is different.
+     */
+    void testSetPolygonMode() {
+
+        RapidGL::GLStateCache cache;
+        cache.setPolygonMode(GL_LINE);
+        cache.setPolygonMode(GL_LINE);
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, cache.getMissCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, cache.getHitCount());
+
+        GLint value[2];
+        glGetIntegerv(GL_POLYGON_MODE, value);
+        CPPUNIT_ASSERT_EQUAL((GLint) GL_LINE, value[0]);
+        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    }
+};
+
+int main(int argc, char* argv[]) {
+
+    // Initialize
+    if (!glfwInit()) {
+        throw std::runtime_error("Could not initialize GLFW!");
+    }
+
+    // Open window
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MAJOR, 3);
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MINOR, 2);
+    glfwOpenWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (!glfwOpenWindow(512, 512, 0, 0, 0, 0, 0, 0, GLFW_WINDOW)) {
+        throw std::runtime_error("Could not open window!");
+    }
+
+    // Run test
+    try {
+        GLStateCacheTest test;
+        test.testBindTexture();
+        test.testBindUniformBuffer();
+        test.testBindVertexArray();
+        test.testClaimUniform();
+        test.testClearProgram();
+        test.testInvalidate();
+        test.testResetCounts();
+        test.testSetClearColor();
+        test.testSetCullFace();
+        test.testSetDepthFunction();
+        test.testSetPolygonMode();
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        throw;
+    }
+
+    // Exit
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,295 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include "RapidGL/Geometry.h"
+namespace RapidGL {
+
+// Target to bind vertex buffers to
+const Gloop::BufferTarget Geometry::arrayBuffer = Gloop::BufferTarget::arrayBuffer();
+
+// Target to bind index buffers to
+const Gloop::BufferTarget Geometry::elementArrayBuffer = Gloop::BufferTarget::elementArrayBuffer();
+
+/**
+ * Constructs geometry with 16-bit indices, loading its vertices and indices into new buffers.
+ *
+ * @param layout Layout of vertices in buffer
+ * @param vertices Vertices to load, laid out as described by layout
+ * @param indices Indices of vertices to draw, in order
+ * @param bounds Box enclosing the vertices, or an empty box if unknown
+ * @throws invalid_argument if vertices is `NULL` or indices is empty
+ */
+Geometry::Geometry(const Glycerin::BufferLayout& layout,
+                   const GLvoid* const vertices,
+                   const std::vector<GLushort>& indices,
+                   const BoundingBox& bounds) :
+        layout(layout),
+        vbo(Gloop::BufferObject::generate()),
+        ebo(Gloop::BufferObject::generate()),
+        indexCount(indices.size()),
+        indexType(GL_UNSIGNED_SHORT),
+        bounds(bounds) {
+    load(vertices, indices.empty() ? NULL : &indices[0], indices.size() * sizeof(GLushort));
+}
+
+/**
+ * Constructs geometry with 32-bit indices, loading its vertices and indices into new buffers.
+ *
+ * @param layout Layout of vertices in buffer
+ * @param vertices Vertices to load, laid out as described by layout
+ * @param indices Indices of vertices to draw, in order
+ * @param bounds Box enclosing the vertices, or an empty box if unknown
+ * @throws invalid_argument if vertices is `NULL` or indices is empty
+ */
+Geometry::Geometry(const Glycerin::BufferLayout& layout,
+                   const GLvoid* const vertices,
+                   const std::vector<GLuint>& indices,
+                   const BoundingBox& bounds) :
+        layout(layout),
+        vbo(Gloop::BufferObject::generate()),
+        ebo(Gloop::BufferObject::generate()),
+        indexCount(indices.size()),
+        indexType(GL_UNSIGNED_INT),
+        bounds(bounds) {
+    load(vertices, indices.empty() ? NULL : &indices[0], indices.size() * sizeof(GLuint));
+}
+
+/**
+ * Constructs geometry from indices of any type, loading its vertices and indices into new buffers.
+ *
+ * Vertices and indices are loaded straight from the memory given, so they may be mapped from a file.
+ *
+ * @param layout Layout of vertices in buffer
+ * @param vertices Vertices to load, laid out as described by layout
+ * @param indices Indices of vertices to draw, in order
+ * @param indexCount Number of indices
+ * @param indexType Type of indices, i.e. `GL_UNSIGNED_BYTE`, `GL_UNSIGNED_SHORT` or `GL_UNSIGNED_INT`
+ * @param bounds Box enclosing the vertices, or an empty box if unknown
+ * @throws invalid_argument if vertices or indices is `NULL`, or index type is invalid
+ */
+Geometry::Geometry(const Glycerin::BufferLayout& layout,
+                   const GLvoid* const vertices,
+                   const GLvoid* const indices,
+                   const GLsizei indexCount,
+                   const GLenum indexType,
+                   const BoundingBox& bounds) :
+        layout(layout),
+        vbo(Gloop::BufferObject::generate()),
+        ebo(Gloop::BufferObject::generate()),
+        indexCount(indexCount),
+        indexType(indexType),
+        bounds(bounds) {
+    const GLsizeiptr indexSize = getIndexSize(indexType);
+    if (indexSize == 0) {
+        vbo.dispose();
+        ebo.dispose();
+        throw std::invalid_argument("[Geometry] Index type is invalid!");
+    }
+    load(vertices, (indexCount > 0) ? indices : NULL, indexCount * indexSize);
+}
+
+/**
+ * Destructs geometry, disposing of its buffers.
+ */
+Geometry::~Geometry() {
+    vbo.dispose();
+    ebo.dispose();
+}
+
+/**
+ * Returns the geometry with a name, making it if it has not been made yet.
+ *
+ * @param name Name of geometry, e.g. `"cube"`
+ * @param factory Function making the geometry if needed
+ * @return Geometry with the name, which should be released when done with
+ * @throws invalid_argument if name is empty or factory is `NULL`
+ * @throws runtime_error if the factory returned `NULL`
+ */
+Geometry* Geometry::acquire(const std::string& name, const factory_t factory) {
+
+    if (name.empty()) {
+        throw std::invalid_argument("[Geometry] Name is empty!");
+    } else if (factory == NULL) {
+        throw std::invalid_argument("[Geometry] Factory is NULL!");
+    }
+
+    // Use existing geometry if there is some
+    std::map<std::string,Entry>& registry = getRegistry();
+    const std::map<std::string,Entry>::iterator it = registry.find(name);
+    if (it != registry.end()) {
+        ++(it->second.references);
+        return it->second.geometry;
+    }
+
+    // Otherwise make it
+    Geometry* const geometry = factory(name);
+    if (geometry == NULL) {
+        throw std::runtime_error("[Geometry] Factory returned NULL!");
+    }
+    const Entry entry = { geometry, 1 };
+    registry.insert(std::pair<std::string,Entry>(name, entry));
+    return geometry;
+}
+
+/**
+ * Binds the vertex buffer to the array buffer target and the index buffer to the element array buffer target.
+ *
+ * The index buffer stays bound to the vertex array object that is bound.
+ */
+void Geometry::bind() const {
+    arrayBuffer.bind(vbo);
+    elementArrayBuffer.bind(ebo);
+}
+
+/**
+ * Returns the box enclosing the vertices.
+ *
+ * @return Box enclosing the vertices, which is empty if it was not given
+ */
+BoundingBox Geometry::getBounds() const {
+    return bounds;
+}
+
+/**
+ * Returns the number of indices to draw.
+ *
+ * @return Number of indices to draw
+ */
+GLsizei Geometry::getIndexCount() const {
+    return indexCount;
+}
+
+/**
+ * Returns the size of an index.
+ *
+ * @param indexType Type of index, e.g. `GL_UNSIGNED_SHORT`
+ * @return Size of index in bytes, or zero if type is not an index type
+ */
+GLsizeiptr Geometry::getIndexSize(const GLenum indexType) {
+    switch (indexType) {
+    case GL_UNSIGNED_BYTE:
+        return sizeof(GLubyte);
+    case GL_UNSIGNED_SHORT:
+        return sizeof(GLushort);
+    case GL_UNSIGNED_INT:
+        return sizeof(GLuint);
+    default:
+        return 0;
+    }
+}
+
+/**
+ * Returns the type of the indices.
+ *
+ * @return Type of the indices, e.g. `GL_UNSIGNED_SHORT` or `GL_UNSIGNED_INT`
+ */
+GLenum Geometry::getIndexType() const {
+    return indexType;
+}
+
+/**
+ * Returns the layout of the vertices in the vertex buffer.
+ *
+ * @return Layout of the vertices in the vertex buffer
+ */
+const Glycerin::BufferLayout& Geometry::getLayout() const {
+    return layout;
+}
+
+/**
+ * Returns the number of times geometry has been acquired without being released.
+ *
+ * @param name Name of geometry
+ * @return Number of references to geometry, or zero if it has not been made
+ */
+int Geometry::getReferenceCount(const std::string& name) {
+    const std::map<std::string,Entry>& registry = getRegistry();
+    const std::map<std::string,Entry>::const_iterator it = registry.find(name);
+    return (it == registry.end()) ? 0 : it->second.references;
+}
+
+/**
+ * Returns the geometry made so far, which is made the first time it's needed.
+ *
+ * @return Map of geometry and reference counts by name
+ */
+std::map<std::string,Geometry::Entry>& Geometry::getRegistry() {
+    static std::map<std::string,Entry> registry;
+    return registry;
+}
+
+/**
+ * Loads vertices and indices into the buffers, disposing of them if either is missing.
+ *
+ * @param vertices Vertices to load, laid out as described by the layout
+ * @param indices Indices to load, or `NULL` if there are none
+ * @param indicesSizeInBytes Size of indices in bytes
+ * @throws invalid_argument if vertices or indices is `NULL`
+ */
+void Geometry::load(const GLvoid* const vertices, const GLvoid* const indices, const GLsizeiptr indicesSizeInBytes) {
+
+    if (vertices == NULL) {
+        vbo.dispose();
+        ebo.dispose();
+        throw std::invalid_argument("[Geometry] Vertices is NULL!");
+    } else if (indices == NULL) {
+        vbo.dispose();
+        ebo.dispose();
+        throw std::invalid_argument("[Geometry] Indices is empty!");
+    }
+
+    // Load vertices
+    arrayBuffer.bind(vbo);
+    arrayBuffer.data(layout.sizeInBytes(), vertices, GL_STATIC_DRAW);
+    arrayBuffer.unbind(vbo);
+
+    // Load indices, through the array buffer so a bound VAO doesn't pick them up
+    arrayBuffer.bind(ebo);
+    arrayBuffer.data(indicesSizeInBytes, indices, GL_STATIC_DRAW);
+    arrayBuffer.unbind(ebo);
+}
+
+/**
+ * Releases geometry acquired before, deleting it if nothing else has acquired it.
+ *
+ * @param name Name of geometry
+ * @throws invalid_argument if geometry with name has not been acquired
+ */
+void Geometry::release(const std::string& name) {
+
+    std::map<std::string,Entry>& registry = getRegistry();
+    const std::map<std::string,Entry>::iterator it = registry.find(name);
+    if (it == registry.end()) {
+        throw std::invalid_argument("[Geometry] Geometry has not been acquired!");
+    }
+
+    if (--(it->second.references) == 0) {
+        delete it->second.geometry;
+        registry.erase(it);
+    }
+}
+
+/**
+ * Unbinds the vertex buffer from the array buffer target, leaving the index buffer bound.
+ */
+void Geometry::unbind() const {
+    arrayBuffer.unbind(vbo);
+}
+
+} /* namespace RapidGL */
@@ -0,0 +1,103 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RAPIDGL_GEOMETRY_H
+#define RAPIDGL_GEOMETRY_H
+#include <map>
+#include <string>
+#include <vector>
+#include <gloop/BufferObject.hxx>
+#include <gloop/BufferTarget.hxx>
+#include <glycerin/BufferLayout.hxx>
+#include "RapidGL/common.h"
+#include "RapidGL/BoundingBox.h"
+namespace RapidGL {
+
+
+/**
+ * Indexed vertices shared by every node drawing the same shape.
+ *
+ * Geometry is kept in a registry by name and counts how many times it has
+ * been acquired.  `acquire` makes it with a factory the first time a name is
+ * asked for, passing the factory the name, and returns the same geometry after
+ * that, while `release` deletes it, along with its buffers, once it has been
+ * released as many times as it was acquired.  Nodes should acquire their
+ * geometry when they are constructed and release it when they are destructed,
+ * on the thread with the OpenGL context.
+ *
+ * To draw geometry, call `bind` with a vertex array object bound so it records
+ * the index buffer, point the attributes at the regions of the layout, and
+ * then draw `getIndexCount` indices of type `getIndexType`.
+ */
+class Geometry {
+public:
+// Types
+    typedef Geometry* (*factory_t)(const std::string& name);
+// Methods
+    Geometry(const Glycerin::BufferLayout& layout,
+             const GLvoid* vertices,
+             const std::vector<GLushort>& indices,
+             const BoundingBox& bounds = BoundingBox());
+    Geometry(const Glycerin::BufferLayout& layout,
+             const GLvoid* vertices,
+             const std::vector<GLuint>& indices,
+             const BoundingBox& bounds = BoundingBox());
+    Geometry(const Glycerin::BufferLayout& layout,
+             const GLvoid* vertices,
+             const GLvoid* indices,
+             GLsizei indexCount,
+             GLenum indexType,
+             const BoundingBox& bounds = BoundingBox());
+    virtual ~Geometry();
+    static Geometry* acquire(const std::string& name, factory_t factory);
+    void bind() const;
+    BoundingBox getBounds() const;
+    GLsizei getIndexCount() const;
+    GLenum getIndexType() const;
+    const Glycerin::BufferLayout& getLayout() const;
+    static int getReferenceCount(const std::string& name);
+    static void release(const std::string& name);
+    void unbind() const;
+private:
+// Types
+    /**
+     * Geometry in the registry and how many times it has been acquired.
+     */
+    struct Entry {
+        Geometry* geometry;
+        int references;
+    };
+// Constants
+    static const Gloop::BufferTarget arrayBuffer;
+    static const Gloop::BufferTarget elementArrayBuffer;
+// Attributes
+    const Glycerin::BufferLayout layout;
+    const Gloop::BufferObject vbo;
+    const Gloop::BufferObject ebo;
+    const GLsizei indexCount;
+    const GLenum indexType;
+    const BoundingBox bounds;
+// Methods
+    Geometry(const Geometry&);
+    Geometry& operator=(const Geometry&);
+    static std::map<std::string,Entry>& getRegistry();
+    static GLsizeiptr getIndexSize(GLenum indexType);
+    void load(const GLvoid* vertices, const GLvoid* indices, GLsizeiptr indicesSizeInBytes);
+};
+
+} /* namespace RapidGL */
+#endif
@@ -0,0 +1,154 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cppunit/extensions/HelperMacros.h>
+#include <GL/glfw.h>
+#include <glycerin/BufferLayout.hxx>
+#include <glycerin/BufferLayoutBuilder.hxx>
+#include "RapidGL/Geometry.h"
+
+
+/**
+ * Unit test for `Geometry`.
+ */
+class GeometryTest {
+public:
+
+    // Number of times `createTriangle` has been called
+    static int createCount;
+
+    /**
+     * Makes geometry for a triangle.
+     *
+     * @param name Name of geometry
+     */
+    static RapidGL::Geometry* createTriangle(const std::string& name) {
+        ++createCount;
+        const Glycerin::BufferLayout layout = Glycerin::BufferLayoutBuilder()
+                .count(3)
+                .components(2)
+                .region("POSITION")
+                .build();
+        const GLfloat points[] = { 0, 0, 1, 0, 0, 1 };
+        std::vector<GLushort> indices;
+        indices.push_back(0);
+        indices.push_back(1);
+        indices.push_back(2);
+        return new RapidGL::Geometry(layout, points, indices);
+    }
+
+    /**
+     * Ensures `Geometry::acquire` only makes geometry once until it is released as many times as it was acquired.
+     */
+    void testAcquire() {
+
+        // Acquire twice
+        createCount = 0;
+        RapidGL::Geometry* first = RapidGL::Geometry::acquire("triangle", &createTriangle);
+        RapidGL::Geometry* second = RapidGL::Geometry::acquire("triangle", &createTriangle);
+        CPPUNIT_ASSERT_EQUAL(first, second);
+        CPPUNIT_ASSERT_EQUAL(1, createCount);
+        CPPUNIT_ASSERT_EQUAL(2, RapidGL::Geometry::getReferenceCount("triangle"));
+        CPPUNIT_ASSERT_EQUAL((GLsizei) 3, first->getIndexCount());
+
+        // Release twice
+        RapidGL::Geometry::release("triangle");
+        CPPUNIT_ASSERT_EQUAL(1, RapidGL::Geometry::getReferenceCount("triangle"));
+        RapidGL::Geometry::release("triangle");
+        CPPUNIT_ASSERT_EQUAL(0, RapidGL::Geometry::getReferenceCount("triangle"));
+
+        // Acquire again
+        RapidGL::Geometry::acquire("triangle", &createTriangle);
+        CPPUNIT_ASSERT_EQUAL(2, createCount);
+        RapidGL::Geometry::release("triangle");
+    }
+
+    /**
+     * Ensures `Geometry::acquire` throws if passed an empty name.
+     */
+    void testAcquireWithEmptyName() {
+        CPPUNIT_ASSERT_THROW(RapidGL::Geometry::acquire("", &createTriangle), std::invalid_argument);
+    }
+
+    /**
+     * Ensures `Geometry::acquire` throws if passed a `NULL` factory.
+     */
+    void testAcquireWithNullFactory() {
+        CPPUNIT_ASSERT_THROW(RapidGL::Geometry::acquire("triangle", NULL), std::invalid_argument);
+    }
+
+    /**
+     * Ensures `Geometry` constructor throws if passed no indices.
+     */
+    void testGeometryWithEmptyIndices() {
+        const Glycerin::BufferLayout layout = Glycerin::BufferLayoutBuilder()
+                .count(1)
+                .components(2)
+                .region("POSITION")
+                .build();
+        const GLfloat points[] = { 0, 0 };
+        CPPUNIT_ASSERT_THROW(RapidGL::Geometry(layout, points, std::vector<GLushort>()), std::invalid_argument);
+    }
+
+    /**
+     * Ensures `Geometry::release` throws if geometry has not been acquired.
+     */
+    void testReleaseWithoutAcquire() {
+        CPPUNIT_ASSERT_THROW(RapidGL::Geometry::release("triangle"), std::invalid_argument);
+    }
+};
+
+int GeometryTest::createCount = 0;
+
+int main(int argc, char* argv[]) {
+
+    // Initialize
+    if (!glfwInit()) {
+        throw std::runtime_error("Could not initialize GLFW!");
+    }
+
+    // Open window
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MAJOR, 3);
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MINOR, 2);
+    glfwOpenWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (!glfwOpenWindow(512, 512, 0, 0, 0, 0, 0, 0, GLFW_WINDOW)) {
+        throw std::runtime_error("Could not open window!");
+    }
+
+    // Run test
+    try {
+        GeometryTest test;
+        test.testAcquire();
+        test.testAcquireWithEmptyName();
+        test.testAcquireWithNullFactory();
+        test.testGeometryWithEmptyIndices();
+        test.testReleaseWithoutAcquire();
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        throw;
+    }
+
+    // Exit
+    glfwTerminate();
+    return 0;
+}
@@ -30,6 +30,7 @@ GroupNode::GroupNode(const std::string& id) : Node(id) {
     if (id.empty()) {
         throw std::invalid_argument("[GroupNode] Identifier is empty!");
     }
+    setHooks(0);
 }
 
 /**
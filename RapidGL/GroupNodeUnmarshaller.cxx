@@ -34,7 +34,7 @@ GroupNodeUnmarshaller::~GroupNodeUnmarshaller() {
     // empty
 }
 
-std::string GroupNodeUnmarshaller::getId(const std::map<std::string,std::string>& attributes) {
+std::string GroupNodeUnmarshaller::getId(const AttributeView& attributes) {
     const std::string value = findValue(attributes, "id");
     if (value.empty()) {
         throw std::runtime_error("[GroupNodeUnmarshaller] Id is unspecified!");
@@ -42,7 +42,7 @@ std::string GroupNodeUnmarshaller::getId(const std::map<std::string,std::string>
     return value;
 }
 
-Node* GroupNodeUnmarshaller::unmarshal(const std::map<std::string,std::string>& attributes) {
+Node* GroupNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
     const std::string id = getId(attributes);
     return new GroupNode(id);
 }
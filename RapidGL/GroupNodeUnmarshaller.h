@@ -34,10 +34,10 @@ public:
 // Methods
     GroupNodeUnmarshaller();
     virtual ~GroupNodeUnmarshaller();
-    virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+    virtual Node* unmarshal(const AttributeView& attributes);
 private:
 // Methods
-    std::string getId(const std::map<std::string,std::string>& attributes);
+    std::string getId(const AttributeView& attributes);
 };
 
 } /* namespace RapidGL */
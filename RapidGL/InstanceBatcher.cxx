@@ -0,0 +1,281 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include <gloop/VertexAttribPointer.hxx>
+#include <m3d/Mat4.h>
+#include "RapidGL/AttributeNode.h"
+#include "RapidGL/InstanceBatcher.h"
+#include "RapidGL/ProgramNode.h"
+#include "RapidGL/RenderQueue.h"
+#include "RapidGL/SimdMat4.h"
+namespace RapidGL {
+
+// Array buffer target
+const Gloop::BufferTarget InstanceBatcher::arrayBuffer = Gloop::BufferTarget::arrayBuffer();
+
+/**
+ * Constructs an instance batcher without any batches.
+ */
+InstanceBatcher::InstanceBatcher() : current(NULL), visitor(NULL), batchCount(0) {
+    // empty
+}
+
+/**
+ * Destructs an instance batcher, deleting the buffers of its batches.
+ */
+InstanceBatcher::~InstanceBatcher() {
+    for (std::vector<Batch*>::iterator it = batches.begin(); it != batches.end(); ++it) {
+        (*it)->buffer.dispose();
+        delete (*it);
+    }
+    delete visitor;
+}
+
+/**
+ * Constructs a batch.
+ *
+ * @param groupNode Group being instanced
+ * @param program Program the group is drawn with
+ * @param location First location of the program's `INSTANCE_MODEL` attribute
+ */
+InstanceBatcher::Batch::Batch(GroupNode* const groupNode, const Gloop::Program& program, const GLint location) :
+        groupNode(groupNode),
+        program(program),
+        location(location),
+        buffer(Gloop::BufferObject::generate()) {
+    // empty
+}
+
+/**
+ * Adds an instance of a group at the current model matrix, if it can be batched.
+ *
+ * Instances visited while a batch is being flushed are never batched, so
+ * instances inside a batched group are drawn as part of it.
+ *
+ * @param groupNode Group being instanced
+ * @param state State with the program in use and the model matrix of the instance
+ * @return `true` if the instance was batched, or `false` if the group should be visited
+ * @throws invalid_argument if group node is `NULL`
+ */
+bool InstanceBatcher::add(GroupNode* const groupNode, State& state) {
+
+    if (groupNode == NULL) {
+        throw std::invalid_argument("[InstanceBatcher] Group node is NULL!");
+    } else if (current != NULL) {
+        return false;
+    }
+
+    // Find the program in use
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    if ((renderQueue != NULL) && !renderQueue->hasProgram()) {
+        return false;
+    }
+    const Gloop::Program program = (renderQueue != NULL) ? renderQueue->getProgram() : Gloop::Program::current();
+    if (program.id() == 0) {
+        return false;
+    }
+
+    // Only batch if the program takes a model matrix for each instance
+    const GLint location = findLocation(groupNode, program);
+    if (location < 0) {
+        return false;
+    }
+
+    // Add the model matrix to the batch
+    Batch* const batch = findBatch(groupNode, program, location);
+    const size_t offset = batch->matrices.size();
+    batch->matrices.resize(offset + MATRIX_SIZE);
+    state.getSimdModelMatrix().toArrayInColumnMajor(&batch->matrices[offset]);
+    return true;
+}
+
+/**
+ * Points the `INSTANCE_MODEL` attribute of a vertex array object at the batch being flushed.
+ *
+ * The vertex array object must be bound.  Since it then refers to the batch's
+ * buffer, it should only be used again to draw the same batch.
+ *
+ * @param vao Vertex array object to change
+ * @throws runtime_error if no batch is being flushed
+ */
+void InstanceBatcher::bindMatrices(const Gloop::VertexArrayObject& vao) const {
+
+    if (current == NULL) {
+        throw std::runtime_error("[InstanceBatcher] No batch is being flushed!");
+    }
+
+    // Point each column at the buffer, advancing once per instance
+    arrayBuffer.bind(current->buffer);
+    for (int i = 0; i < 4; ++i) {
+        const GLint location = current->location + i;
+        vao.enableVertexAttribArray(location);
+        vao.vertexAttribPointer(Gloop::VertexAttribPointer()
+                .index(location)
+                .size(4)
+                .stride(MATRIX_SIZE * sizeof(GLfloat))
+                .offset(i * 4 * sizeof(GLfloat)));
+        glVertexAttribDivisor(location, 1);
+    }
+    arrayBuffer.unbind(current->buffer);
+}
+
+/**
+ * Finds or makes the batch for a group and program.
+ *
+ * @param groupNode Group being instanced
+ * @param program Program the group is drawn with
+ * @param location First location of the program's `INSTANCE_MODEL` attribute
+ * @return Batch for the group and program
+ */
+InstanceBatcher::Batch* InstanceBatcher::findBatch(GroupNode* const groupNode,
+                                                   const Gloop::Program& program,
+                                                   const GLint location) {
+
+    const std::pair<GroupNode*,GLuint> key(groupNode, program.id());
+    const std::map<std::pair<GroupNode*,GLuint>,Batch*>::const_iterator it = batchesByKey.find(key);
+    if (it != batchesByKey.end()) {
+        return it->second;
+    }
+
+    Batch* const batch = new Batch(groupNode, program, location);
+    batches.push_back(batch);
+    batchesByKey[key] = batch;
+    return batch;
+}
+
+/**
+ * Finds the location of a program's `INSTANCE_MODEL` attribute.
+ *
+ * @param node Node in the same scene as the program's node
+ * @param program Program to find attribute in
+ * @return First location of attribute, or `-1` if the program does not have one
+ */
+GLint InstanceBatcher::findLocation(Node* const node, const Gloop::Program& program) {
+
+    // Use the location found before if there is one
+    const std::map<GLuint,GLint>::const_iterator it = locationsByProgram.find(program.id());
+    if (it != locationsByProgram.end()) {
+        return it->second;
+    }
+
+    // Otherwise look through the attributes of the program's node
+    GLint location = -1;
+    const ProgramNode* const programNode = findProgramNode(findRoot(node), program);
+    if (programNode != NULL) {
+        const Node::node_range_t children = programNode->getChildren();
+        for (Node::node_iterator_t child = children.begin; child != children.end; ++child) {
+            const AttributeNode* const attributeNode = dynamic_cast<AttributeNode*>(*child);
+            if ((attributeNode != NULL) && (attributeNode->getUsage() == AttributeNode::INSTANCE_MODEL)) {
+                location = program.attribLocation(attributeNode->getName());
+                break;
+            }
+        }
+    }
+
+    // Store it for next time
+    locationsByProgram[program.id()] = location;
+    return location;
+}
+
+/**
+ * Draws and empties every batch that has instances.
+ *
+ * @param state State to draw with
+ */
+void InstanceBatcher::flush(State& state) {
+
+    // Reuse visitor unless the state changed
+    if ((visitor == NULL) || (visitor->getState() != &state)) {
+        delete visitor;
+        visitor = NULL;
+        visitor = new Visitor(&state);
+    }
+
+    // Instances are drawn relative to their own model matrices
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    GLStateCache& glStateCache = state.getGLStateCache();
+    state.pushModelMatrix();
+    state.setModelMatrix(SimdMat4());
+    batchCount = 0;
+
+    try {
+        for (std::vector<Batch*>::const_iterator it = batches.begin(); it != batches.end(); ++it) {
+
+            Batch* const batch = (*it);
+            if (batch->matrices.empty()) {
+                continue;
+            }
+
+            // Upload the matrices
+            arrayBuffer.bind(batch->buffer);
+            arrayBuffer.data(batch->matrices.size() * sizeof(GLfloat), &batch->matrices[0], GL_STREAM_DRAW);
+            arrayBuffer.unbind(batch->buffer);
+
+            // Draw the group once with the batch's program
+            if (renderQueue != NULL) {
+                renderQueue->useProgram(batch->program);
+            } else {
+                glStateCache.useProgram(batch->program);
+            }
+            current = batch;
+            visitor->visit(batch->groupNode);
+            current = NULL;
+            batch->matrices.clear();
+            ++batchCount;
+        }
+    } catch (...) {
+        current = NULL;
+        for (std::vector<Batch*>::const_iterator it = batches.begin(); it != batches.end(); ++it) {
+            (*it)->matrices.clear();
+        }
+        state.popModelMatrix();
+        throw;
+    }
+
+    state.popModelMatrix();
+}
+
+/**
+ * Returns the number of batches drawn by the last flush.
+ *
+ * @return Number of batches drawn by the last flush
+ */
+size_t InstanceBatcher::getBatchCount() const {
+    return batchCount;
+}
+
+/**
+ * Returns the buffer holding the matrices of the batch being flushed.
+ *
+ * @return Identifier of buffer, or zero if no batch is being flushed
+ */
+GLuint InstanceBatcher::getInstanceBuffer() const {
+    return (current == NULL) ? 0 : current->buffer.id();
+}
+
+/**
+ * Returns the number of instances in the batch being flushed.
+ *
+ * @return Number of instances in the batch, or zero if no batch is being flushed
+ */
+GLsizei InstanceBatcher::getInstanceCount() const {
+    return (current == NULL) ? 0 : (GLsizei) (current->matrices.size() / MATRIX_SIZE);
+}
+
+} /* namespace RapidGL */
@@ -0,0 +1,100 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RAPIDGL_INSTANCE_BATCHER_H
+#define RAPIDGL_INSTANCE_BATCHER_H
+#include <map>
+#include <utility>
+#include <vector>
+#include <gloop/BufferObject.hxx>
+#include <gloop/BufferTarget.hxx>
+#include <gloop/Program.hxx>
+#include <gloop/VertexArrayObject.hxx>
+#include "RapidGL/common.h"
+#include "RapidGL/GroupNode.h"
+#include "RapidGL/Node.h"
+#include "RapidGL/State.h"
+#include "RapidGL/Visitor.h"
+namespace RapidGL {
+
+
+/**
+ * Utility for drawing every instance of a group with one draw per geometry node.
+ *
+ * When a batcher is set on the `State`, an `InstanceNode` visited while the
+ * program in use has an `INSTANCE_MODEL` attribute adds the current model
+ * matrix to the batch for its group and that program, instead of visiting the
+ * group.  Instances under other programs are visited as usual.
+ *
+ * Calling `flush` after the scene has been traversed uploads each batch's
+ * matrices into a buffer and visits its group once, with the batch's program
+ * in use and the model matrix reset to identity.  While a batch is being
+ * flushed, `CubeNode` and `SquareNode` point the `INSTANCE_MODEL` attribute at
+ * the buffer and draw every instance at once.  The shader should multiply by
+ * the attribute after any model matrix uniform, which then only holds the
+ * transformations inside the group.  With a render queue on the state, the
+ * instanced draws are recorded into it, so `flush` must come before `submit`.
+ *
+ * Instances in a batch are assumed to differ only in their model matrices.
+ * They are drawn after the rest of the scene, with the view and projection
+ * matrices and any uniforms set outside the group as they are when `flush` is
+ * called, so a batcher should be flushed once per pass.  Programs with an
+ * `INSTANCE_MODEL` attribute should only draw through a batcher.
+ */
+class InstanceBatcher {
+public:
+// Methods
+    InstanceBatcher();
+    virtual ~InstanceBatcher();
+    bool add(GroupNode* groupNode, State& state);
+    void bindMatrices(const Gloop::VertexArrayObject& vao) const;
+    void flush(State& state);
+    size_t getBatchCount() const;
+    GLuint getInstanceBuffer() const;
+    GLsizei getInstanceCount() const;
+private:
+// Types
+    /**
+     * Instances of one group drawn with one program.
+     */
+    struct Batch {
+        GroupNode* groupNode;
+        Gloop::Program program;
+        GLint location;
+        Gloop::BufferObject buffer;
+        std::vector<GLfloat> matrices;
+        Batch(GroupNode* groupNode, const Gloop::Program& program, GLint location);
+    };
+// Constants
+    static const int MATRIX_SIZE = 16;
+    static const Gloop::BufferTarget arrayBuffer;
+// Attributes
+    std::vector<Batch*> batches;
+    std::map<std::pair<GroupNode*,GLuint>,Batch*> batchesByKey;
+    std::map<GLuint,GLint> locationsByProgram;
+    Batch* current;
+    Visitor* visitor;
+    size_t batchCount;
+// Methods
+    InstanceBatcher(const InstanceBatcher&);
+    InstanceBatcher& operator=(const InstanceBatcher&);
+    Batch* findBatch(GroupNode* groupNode, const Gloop::Program& program, GLint location);
+    GLint findLocation(Node* node, const Gloop::Program& program);
+};
+
+} /* namespace RapidGL */
+#endif
@@ -0,0 +1,145 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "RapidGL/GroupNode.h"
+#include "RapidGL/InstanceBatcher.h"
+#include "RapidGL/InstanceNode.h"
+#include "RapidGL/RenderQueue.h"
+#include "RapidGL/SceneNode.h"
+#include "RapidGL/State.h"
+
+
+/**
+ * Unit test for `InstanceBatcher`.
+ */
+class InstanceBatcherTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Fake node that counts how many times it was visited.
+     */
+    class FakeNode : public RapidGL::Node {
+    public:
+
+        int visitCount;
+
+        FakeNode() : visitCount(0) {
+            setHooks(VISIT);
+        }
+
+        virtual void visit(RapidGL::State& state) {
+            ++visitCount;
+        }
+    };
+
+    // Nodes
+    RapidGL::SceneNode sceneNode;
+    RapidGL::GroupNode groupNode;
+    FakeNode fakeNode;
+
+    // State to batch with
+    RapidGL::State state;
+
+    // Queue without a program in use
+    RapidGL::RenderQueue renderQueue;
+
+    /**
+     * Constructs the test, making a scene with a group.
+     */
+    InstanceBatcherTest() : groupNode("foo") {
+        sceneNode.addChild(&groupNode);
+        groupNode.addChild(&fakeNode);
+        state.setRenderQueue(&renderQueue);
+    }
+
+    /**
+     * Ensures `InstanceBatcher::add` throws if passed `NULL`.
+     */
+    void testAddWithNull() {
+        RapidGL::InstanceBatcher instanceBatcher;
+        CPPUNIT_ASSERT_THROW(instanceBatcher.add(NULL, state), std::invalid_argument);
+    }
+
+    /**
+     * Ensures `InstanceBatcher::add` does not batch an instance if no program is in use.
+     */
+    void testAddWithoutProgram() {
+        RapidGL::InstanceBatcher instanceBatcher;
+        CPPUNIT_ASSERT(!instanceBatcher.add(&groupNode, state));
+    }
+
+    /**
+     * Ensures `InstanceBatcher::flush` does nothing if no instances were batched.
+     */
+    void testFlushWithoutInstances() {
+        RapidGL::InstanceBatcher instanceBatcher;
+        instanceBatcher.flush(state);
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, instanceBatcher.getBatchCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, state.getModelMatrixStackSize());
+        CPPUNIT_ASSERT_EQUAL(0, fakeNode.visitCount);
+    }
+
+    /**
+     * Ensures `InstanceBatcher::getInstanceCount` is zero when no batch is being flushed.
+     */
+    void testGetInstanceCount() {
+        RapidGL::InstanceBatcher instanceBatcher;
+        CPPUNIT_ASSERT_EQUAL((GLsizei) 0, instanceBatcher.getInstanceCount());
+        CPPUNIT_ASSERT_EQUAL((GLuint) 0, instanceBatcher.getInstanceBuffer());
+    }
+
+    /**
+     * Ensures `InstanceNode::visit` visits its group if the instance could not be batched.
+     */
+    void testVisitWhenNotBatched() {
+
+        // Make instance
+        RapidGL::InstanceNode instanceNode("foo");
+        sceneNode.addChild(&instanceNode);
+        instanceNode.prepare(state);
+
+        // Visit with a batcher
+        RapidGL::InstanceBatcher instanceBatcher;
+        state.setInstanceBatcher(&instanceBatcher);
+        instanceNode.visit(state);
+        state.setInstanceBatcher(NULL);
+        sceneNode.removeChild(&instanceNode);
+
+        // Check
+        CPPUNIT_ASSERT_EQUAL(1, fakeNode.visitCount);
+    }
+
+    CPPUNIT_TEST_SUITE(InstanceBatcherTest);
+    CPPUNIT_TEST(testAddWithNull);
+    CPPUNIT_TEST(testAddWithoutProgram);
+    CPPUNIT_TEST(testFlushWithoutInstances);
+    CPPUNIT_TEST(testGetInstanceCount);
+    CPPUNIT_TEST(testVisitWhenNotBatched);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(InstanceBatcherTest::suite());
+    runner.run();
+    return 0;
+}
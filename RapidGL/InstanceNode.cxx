@@ -17,6 +17,7 @@
  */
 #include "config.h"
 #include <stdexcept>
+#include "RapidGL/InstanceBatcher.h"
 #include "RapidGL/InstanceNode.h"
 namespace RapidGL {
 
@@ -26,10 +27,15 @@ namespace RapidGL {
  * @param link Identifier of group to instance
  * @throws std::invalid_argument if link is empty
  */
-InstanceNode::InstanceNode(const std::string& link) : link(link), groupNode(NULL), ready(false) {
+InstanceNode::InstanceNode(const std::string& link) :
+        link(link),
+        groupNode(NULL),
+        ready(false),
+        compiled(false) {
     if (link.empty()) {
         throw std::invalid_argument("[InstanceNode] Link is empty!");
     }
+    setHooks(PRE_VISIT | VISIT);
 }
 
 /**
@@ -39,6 +45,15 @@ InstanceNode::~InstanceNode() {
     // empty
 }
 
+/**
+ * Returns an infinite box, since the group may be instanced anywhere else in the scene.
+ *
+ * @return Infinite box
+ */
+BoundingBox InstanceNode::computeBounds() {
+    return BoundingBox::infinite();
+}
+
 /**
  * Returns the identifier of the group being instanced.
  *
@@ -48,7 +63,7 @@ std::string InstanceNode::getLink() const {
     return link;
 }
 
-void InstanceNode::preVisit(State& state) {
+void InstanceNode::prepare(State& state) {
 
     // Skip if already ready
     if (ready) {
@@ -72,11 +87,32 @@ void InstanceNode::preVisit(State& state) {
 
     // Now ready
     ready = true;
+    setHooks(getHooks() & ~PRE_VISIT);
+}
+
+/**
+ * Prepares this node if it was not prepared before being visited.
+ */
+void InstanceNode::preVisit(State& state) {
+    prepare(state);
 }
 
 void InstanceNode::visit(State& state) {
-    Visitor visitor(&state);
-    visitor.visit(groupNode);
+
+    // Let the batcher draw the group later if it can
+    InstanceBatcher* const instanceBatcher = state.getInstanceBatcher();
+    if ((instanceBatcher != NULL) && instanceBatcher->add(groupNode, state)) {
+        return;
+    }
+
+    // Compile the group the first time
+    if (!compiled) {
+        renderList.compile(groupNode);
+        compiled = true;
+    }
+
+    // Replay it
+    renderList.replay(state);
 }
 
 } /* namespace RapidGL */
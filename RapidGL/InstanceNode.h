@@ -19,15 +19,27 @@
 #define RAPIDGL_INSTANCE_NODE_H
 #include <string>
 #include "RapidGL/common.h"
+#include "RapidGL/BoundingBox.h"
 #include "RapidGL/GroupNode.h"
 #include "RapidGL/Node.h"
+#include "RapidGL/RenderList.h"
 #include "RapidGL/State.h"
-#include "RapidGL/Visitor.h"
 namespace RapidGL {
 
 
 /**
  * Node revisiting a group.
+ *
+ * The group is compiled into a `RenderList` the first time this node is
+ * visited, and replayed each time after that instead of being traversed.  The
+ * list listens to the group's nodes, so only the parts of it whose structure
+ * changed are recompiled, while values like uniforms and transformations are
+ * read again on every replay.  Since the list stops listening when this node
+ * is destroyed, instance nodes should be destroyed before the group they link
+ * to.
+ *
+ * If the state has an `InstanceBatcher`, the group may instead be drawn later
+ * along with its other instances.
  */
 class InstanceNode : public Node {
 public:
@@ -35,13 +47,19 @@ public:
     InstanceNode(const std::string& id);
     virtual ~InstanceNode();
     std::string getLink() const;
+    virtual void prepare(State& state);
     virtual void preVisit(State& state);
     virtual void visit(State& state);
+protected:
+// Methods
+    virtual BoundingBox computeBounds();
 private:
 // Attributes
     const std::string link;
     GroupNode* groupNode;
     bool ready;
+    bool compiled;
+    RenderList renderList;
 };
 
 } /* namespace RapidGL */
@@ -38,11 +38,12 @@ public:
      */
     class FakeNode : public RapidGL::Node {
     private:
-        bool visited;
+        int visits;
     public:
-        FakeNode() : visited(false) { }
-        virtual void visit(RapidGL::State& state) { visited = true; }
-        bool isVisited() { return visited; }
+        FakeNode() : visits(0) { }
+        virtual void visit(RapidGL::State& state) { ++visits; }
+        int getVisits() { return visits; }
+        bool isVisited() { return visits > 0; }
     };
 
     // Reusable state since `InstanceNode` doesn't use it
@@ -123,12 +124,43 @@ public:
         CPPUNIT_ASSERT(fakeNode.isVisited());
     }
 
+    /**
+     * Ensures `InstanceNode::visit` visits the group each time, including children added after the first visit.
+     */
+    void testVisitAfterGroupChanges() {
+
+        // Make nodes
+        RapidGL::SceneNode sceneNode;
+        RapidGL::GroupNode groupNode("foo");
+        FakeNode first;
+        FakeNode second;
+        RapidGL::InstanceNode instanceNode("foo");
+
+        // Connect nodes
+        sceneNode.addChild(&groupNode);
+        groupNode.addChild(&first);
+        sceneNode.addChild(&instanceNode);
+
+        // Visit instance node twice
+        instanceNode.preVisit(state);
+        instanceNode.visit(state);
+        instanceNode.visit(state);
+        CPPUNIT_ASSERT_EQUAL(2, first.getVisits());
+
+        // Add to group and visit again
+        groupNode.addChild(&second);
+        instanceNode.visit(state);
+        CPPUNIT_ASSERT_EQUAL(3, first.getVisits());
+        CPPUNIT_ASSERT_EQUAL(1, second.getVisits());
+    }
+
     CPPUNIT_TEST_SUITE(InstanceNodeTest);
     CPPUNIT_TEST(testInstanceNodeWithEmptyLink);
     CPPUNIT_TEST(testInstanceNodeWithValidLink);
     CPPUNIT_TEST(testPreVisitWhenGroupIsAbsent);
     CPPUNIT_TEST(testPreVisitWhenGroupIsPresent);
     CPPUNIT_TEST(testVisit);
+    CPPUNIT_TEST(testVisitAfterGroupChanges);
     CPPUNIT_TEST_SUITE_END();
 };
 
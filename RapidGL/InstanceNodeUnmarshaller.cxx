@@ -34,7 +34,7 @@ InstanceNodeUnmarshaller::~InstanceNodeUnmarshaller() {
     // empty
 }
 
-std::string InstanceNodeUnmarshaller::getLink(const std::map<std::string,std::string>& attributes) {
+std::string InstanceNodeUnmarshaller::getLink(const AttributeView& attributes) {
     const std::string value = findValue(attributes, "link");
     if (value.empty()) {
         throw std::runtime_error("[InstanceNodeUnmarshaller] Link is unspecified!");
@@ -42,7 +42,7 @@ std::string InstanceNodeUnmarshaller::getLink(const std::map<std::string,std::st
     return value;
 }
 
-Node* InstanceNodeUnmarshaller::unmarshal(const std::map<std::string,std::string>& attributes) {
+Node* InstanceNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
     const std::string link = getLink(attributes);
     return new InstanceNode(link);
 }
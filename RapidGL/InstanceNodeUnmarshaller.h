@@ -34,10 +34,10 @@ public:
 // Methods
     InstanceNodeUnmarshaller();
     virtual ~InstanceNodeUnmarshaller();
-    virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+    virtual Node* unmarshal(const AttributeView& attributes);
 private:
 // Methods
-    std::string getLink(const std::map<std::string,std::string>& attributes);
+    std::string getLink(const AttributeView& attributes);
 };
 
 } /* namespace RapidGL */
@@ -0,0 +1,198 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <stdexcept>
+#include <m3d/Mat4.h>
+#include <m3d/Vec3.h>
+#include <m3d/Vec4.h>
+#include "RapidGL/BoundingBox.h"
+#include "RapidGL/LodNode.h"
+namespace RapidGL {
+
+// Smallest clip-space _w_ used when measuring coverage, so bounds around or behind the eye look huge
+const double LodNode::MIN_CLIP_W = 1e-6;
+
+/**
+ * Constructs a `LodNode`.
+ *
+ * Distance thresholds must increase, since farther levels are less detailed,
+ * while coverage thresholds must decrease.  Coverage is the fraction of the
+ * viewport's height covered by the sphere around the node's bounds.
+ *
+ * @param mode Measure of the node's bounds to compare against the thresholds
+ * @param thresholds Values where each level switches to the next, one less than the number of levels
+ * @param hysteresis Fraction of a threshold to move it by away from the current level, from 0 to 1
+ * @throws invalid_argument if mode is invalid, thresholds are negative or out of order, or hysteresis is out of range
+ */
+LodNode::LodNode(const Mode mode, const std::vector<float>& thresholds, const float hysteresis) :
+        mode(mode),
+        thresholds(thresholds),
+        hysteresis(hysteresis),
+        level(0) {
+
+    if ((mode != DISTANCE) && (mode != COVERAGE)) {
+        throw std::invalid_argument("[LodNode] Mode is invalid!");
+    } else if ((hysteresis < 0) || (hysteresis >= 1)) {
+        throw std::invalid_argument("[LodNode] Hysteresis is out of range!");
+    }
+    for (size_t i = 0; i < thresholds.size(); ++i) {
+        if (thresholds[i] < 0) {
+            throw std::invalid_argument("[LodNode] Threshold is negative!");
+        } else if (i == 0) {
+            continue;
+        } else if ((mode == DISTANCE) && (thresholds[i] <= thresholds[i - 1])) {
+            throw std::invalid_argument("[LodNode] Distance thresholds do not increase!");
+        } else if ((mode == COVERAGE) && (thresholds[i] >= thresholds[i - 1])) {
+            throw std::invalid_argument("[LodNode] Coverage thresholds do not decrease!");
+        }
+    }
+
+    setHooks(SELECT);
+}
+
+/**
+ * Destructs a `LodNode`.
+ */
+LodNode::~LodNode() {
+    // empty
+}
+
+/**
+ * Returns the fraction of a threshold it is moved by away from the current level.
+ *
+ * @return Fraction of a threshold it is moved by away from the current level
+ */
+float LodNode::getHysteresis() const {
+    return hysteresis;
+}
+
+/**
+ * Returns the level chosen the last time this node was traversed.
+ *
+ * @return Level chosen the last time this node was traversed, before being limited to the children
+ */
+size_t LodNode::getLevel() const {
+    return level;
+}
+
+/**
+ * Returns the measure of the node's bounds compared against the thresholds.
+ *
+ * @return Measure of the node's bounds compared against the thresholds
+ */
+LodNode::Mode LodNode::getMode() const {
+    return mode;
+}
+
+/**
+ * Returns a copy of the values where each level switches to the next.
+ *
+ * @return Copy of the values where each level switches to the next
+ */
+std::vector<float> LodNode::getThresholds() const {
+    return thresholds;
+}
+
+/**
+ * Checks if a measure is on the more detailed side of a threshold.
+ *
+ * @param metric Measure of the node's bounds
+ * @param boundary Index of threshold between level `boundary` and the next
+ * @return `true` if the level should be `boundary` or less
+ */
+bool LodNode::isFiner(const double metric, const size_t boundary) const {
+    const bool coarser = (level > boundary);
+    const double threshold = thresholds[boundary];
+    if (mode == DISTANCE) {
+        return metric < threshold * (coarser ? (1 - hysteresis) : (1 + hysteresis));
+    } else {
+        return metric >= threshold * (coarser ? (1 + hysteresis) : (1 - hysteresis));
+    }
+}
+
+/**
+ * Measures this node's bounds as seen from the eye.
+ *
+ * @param state State with the current model-view and projection matrices
+ * @return Distance to the center of the bounds, or fraction of the viewport's height they cover
+ */
+double LodNode::measure(State& state) {
+
+    // Find the sphere around the bounds in eye space
+    const BoundingBox box = getBounds().transform(state.getModelViewMatrix());
+    const M3d::Vec3 min = box.getMin();
+    const M3d::Vec3 max = box.getMax();
+    const M3d::Vec3 center = (min + max) * 0.5;
+    if (mode == DISTANCE) {
+        return M3d::length(center);
+    }
+    const double radius = M3d::length(max - min) * 0.5;
+
+    // Project its radius at its center
+    const M3d::Mat4 projection = state.getProjectionMatrix();
+    const M3d::Vec4 clip = projection * M3d::Vec4(center, 1);
+    return (radius * projection[1][1]) / std::max(clip.w, MIN_CLIP_W);
+}
+
+/**
+ * Chooses the child for the level of detail the node's bounds need.
+ *
+ * Nodes without bounds, or with infinite bounds, always use the first child.
+ *
+ * @param state State with the current model-view and projection matrices
+ * @return Range holding the chosen child, or nothing if this node has no children
+ */
+Node::node_range_t LodNode::select(State& state) {
+
+    const node_range_t children = getChildren();
+    if (children.begin == children.end) {
+        return children;
+    }
+
+    // Find the first level whose threshold the measure is on the detailed side of
+    const BoundingBox bounds = getBounds();
+    if (bounds.isEmpty() || bounds.isInfinite()) {
+        level = 0;
+    } else {
+        const double metric = measure(state);
+        size_t next = 0;
+        while ((next < thresholds.size()) && !isFiner(metric, next)) {
+            ++next;
+        }
+        level = next;
+    }
+
+    // Use the last child for levels past the end
+    const size_t index = std::min(level, (size_t) (children.end - children.begin) - 1);
+    return node_range_t(children.begin + index, children.begin + index + 1);
+}
+
+/**
+ * Does nothing, since this node only picks a child in `select`.
+ *
+ * Only overridden because `Node::visit` is pure.  The node's hooks do not
+ * include `VISIT`, so traversals never call it.
+ *
+ * @param state State shared between nodes
+ */
+void LodNode::visit(State& state) {
+    // empty
+}
+
+} /* namespace RapidGL */
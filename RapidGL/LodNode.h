@@ -0,0 +1,73 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RAPIDGL_LOD_NODE_H
+#define RAPIDGL_LOD_NODE_H
+#include <vector>
+#include "RapidGL/common.h"
+#include "RapidGL/Node.h"
+#include "RapidGL/State.h"
+namespace RapidGL {
+
+
+/**
+ * Node that traverses only one of its children, depending on how big it looks.
+ *
+ * Children are levels of detail, from most to least detailed.  The level is
+ * chosen each time the node is traversed by comparing a measure of the node's
+ * bounds against its thresholds, either the distance from the eye to their
+ * center, or how much of the viewport's height they cover.  There is one less
+ * threshold than levels, and if there are fewer children than levels, the last
+ * child is used for the rest.
+ *
+ * To keep objects near a threshold from switching back and forth every frame,
+ * the threshold to cross is moved away from the current level by a fraction of
+ * itself.  The current level is kept by the node, so instances of the node
+ * share it.
+ */
+class LodNode : public Node {
+public:
+// Types
+    /// Measure of the node's bounds compared against the thresholds
+    enum Mode {
+        DISTANCE,
+        COVERAGE
+    };
+// Methods
+    LodNode(Mode mode, const std::vector<float>& thresholds, float hysteresis = 0);
+    virtual ~LodNode();
+    float getHysteresis() const;
+    size_t getLevel() const;
+    Mode getMode() const;
+    std::vector<float> getThresholds() const;
+    virtual node_range_t select(State& state);
+    virtual void visit(State& state);
+private:
+// Constants
+    static const double MIN_CLIP_W;
+// Attributes
+    const Mode mode;
+    const std::vector<float> thresholds;
+    const float hysteresis;
+    size_t level;
+// Methods
+    bool isFiner(double metric, size_t boundary) const;
+    double measure(State& state);
+};
+
+} /* namespace RapidGL */
+#endif
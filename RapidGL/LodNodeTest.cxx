@@ -0,0 +1,231 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include <m3d/Mat4.h>
+#include <m3d/Vec3.h>
+#include "RapidGL/BoundingBox.h"
+#include "RapidGL/LodNode.h"
+#include "RapidGL/Node.h"
+#include "RapidGL/State.h"
+#include "RapidGL/Visitor.h"
+
+
+/**
+ * Unit test for `LodNode`.
+ */
+class LodNodeTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Fake node that records when it is visited and has a cube from -1 to 1 as its bounds.
+     */
+    class FakeNode : public RapidGL::Node {
+    public:
+
+        std::vector<std::string>* calls;
+
+        FakeNode(const std::string& id, std::vector<std::string>* calls) : RapidGL::Node(id), calls(calls) {
+            setHooks(VISIT);
+        }
+
+        virtual RapidGL::BoundingBox computeBounds() {
+            return RapidGL::BoundingBox(M3d::Vec3(-1, -1, -1), M3d::Vec3(1, 1, 1));
+        }
+
+        virtual void visit(RapidGL::State& state) {
+            calls->push_back(getId());
+        }
+    };
+
+    // Calls made on nodes
+    std::vector<std::string> calls;
+
+    // Levels of detail
+    FakeNode high;
+    FakeNode medium;
+    FakeNode low;
+
+    // State shared between nodes
+    RapidGL::State state;
+
+    /**
+     * Constructs the test.
+     */
+    LodNodeTest() : high("high", &calls), medium("medium", &calls), low("low", &calls) {
+        // empty
+    }
+
+    /**
+     * Makes a list of thresholds.
+     *
+     * @param first First threshold
+     * @param second Second threshold
+     * @return List of the two thresholds
+     */
+    static std::vector<float> makeThresholds(const float first, const float second) {
+        std::vector<float> thresholds;
+        thresholds.push_back(first);
+        thresholds.push_back(second);
+        return thresholds;
+    }
+
+    /**
+     * Adds the levels of detail to a node, from most to least detailed.
+     *
+     * @param node Node to add levels to
+     */
+    void addLevels(RapidGL::LodNode& node) {
+        node.addChild(&high);
+        node.addChild(&medium);
+        node.addChild(&low);
+    }
+
+    /**
+     * Moves the eye away from the origin and visits a node.
+     *
+     * @param node Node to visit
+     * @param distance Distance from the eye to the origin
+     * @return Identifier of the only child visited
+     */
+    std::string visitAt(RapidGL::LodNode& node, const double distance) {
+
+        // Look down the negative Z axis from the distance
+        M3d::Mat4 view(1);
+        view[3][2] = -distance;
+        state.setViewMatrix(view);
+
+        // Visit
+        RapidGL::Visitor visitor(&state);
+        calls.clear();
+        visitor.visit(&node);
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, calls.size());
+        return calls[0];
+    }
+
+    /**
+     * Ensures `LodNode::LodNode` throws if hysteresis is not from 0 to 1.
+     */
+    void testLodNodeWithInvalidHysteresis() {
+        const std::vector<float> thresholds = makeThresholds(10, 20);
+        CPPUNIT_ASSERT_THROW(RapidGL::LodNode(RapidGL::LodNode::DISTANCE, thresholds, -0.1f), std::invalid_argument);
+        CPPUNIT_ASSERT_THROW(RapidGL::LodNode(RapidGL::LodNode::DISTANCE, thresholds, 1.0f), std::invalid_argument);
+    }
+
+    /**
+     * Ensures `LodNode::LodNode` throws if thresholds go from coarse to fine.
+     */
+    void testLodNodeWithUnorderedThresholds() {
+        CPPUNIT_ASSERT_THROW(
+                RapidGL::LodNode(RapidGL::LodNode::DISTANCE, makeThresholds(20, 10)),
+                std::invalid_argument);
+        CPPUNIT_ASSERT_THROW(
+                RapidGL::LodNode(RapidGL::LodNode::COVERAGE, makeThresholds(0.1f, 0.5f)),
+                std::invalid_argument);
+    }
+
+    /**
+     * Ensures `LodNode::select` chooses children by how much of the viewport they cover.
+     */
+    void testSelectWithCoverage() {
+
+        // Use a perspective projection with a 90 degree field of view
+        M3d::Mat4 projection(1);
+        projection[2][3] = -1;
+        projection[3][3] = 0;
+        state.setProjectionMatrix(projection);
+
+        // Cube has a radius of about 1.73, so it covers 0.87, 0.17 and 0.04 of the viewport
+        RapidGL::LodNode node(RapidGL::LodNode::COVERAGE, makeThresholds(0.5f, 0.1f));
+        addLevels(node);
+        CPPUNIT_ASSERT_EQUAL(std::string("high"), visitAt(node, 2));
+        CPPUNIT_ASSERT_EQUAL(std::string("medium"), visitAt(node, 10));
+        CPPUNIT_ASSERT_EQUAL(std::string("low"), visitAt(node, 40));
+    }
+
+    /**
+     * Ensures `LodNode::select` chooses children by distance from the eye.
+     */
+    void testSelectWithDistance() {
+        RapidGL::LodNode node(RapidGL::LodNode::DISTANCE, makeThresholds(10, 20));
+        addLevels(node);
+        CPPUNIT_ASSERT_EQUAL(std::string("high"), visitAt(node, 5));
+        CPPUNIT_ASSERT_EQUAL(std::string("medium"), visitAt(node, 15));
+        CPPUNIT_ASSERT_EQUAL(std::string("low"), visitAt(node, 25));
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, node.getLevel());
+    }
+
+    /**
+     * Ensures `LodNode::select` uses the last child for levels past the children.
+     */
+    void testSelectWithFewerChildren() {
+        RapidGL::LodNode node(RapidGL::LodNode::DISTANCE, makeThresholds(10, 20));
+        node.addChild(&high);
+        node.addChild(&medium);
+        CPPUNIT_ASSERT_EQUAL(std::string("medium"), visitAt(node, 25));
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, node.getLevel());
+    }
+
+    /**
+     * Ensures `LodNode::select` keeps the current level until a threshold is passed by the hysteresis.
+     */
+    void testSelectWithHysteresis() {
+
+        RapidGL::LodNode node(RapidGL::LodNode::DISTANCE, makeThresholds(10, 20), 0.2f);
+        addLevels(node);
+
+        // Going out, the first threshold is moved to 12
+        CPPUNIT_ASSERT_EQUAL(std::string("high"), visitAt(node, 11));
+        CPPUNIT_ASSERT_EQUAL(std::string("medium"), visitAt(node, 13));
+
+        // Coming back in, it is moved to 8
+        CPPUNIT_ASSERT_EQUAL(std::string("medium"), visitAt(node, 9));
+        CPPUNIT_ASSERT_EQUAL(std::string("high"), visitAt(node, 7));
+    }
+
+    /**
+     * Ensures `LodNode::select` returns an empty range if the node has no children.
+     */
+    void testSelectWithoutChildren() {
+        RapidGL::LodNode node(RapidGL::LodNode::DISTANCE, makeThresholds(10, 20));
+        const RapidGL::Node::node_range_t children = node.select(state);
+        CPPUNIT_ASSERT(children.begin == children.end);
+    }
+
+    CPPUNIT_TEST_SUITE(LodNodeTest);
+    CPPUNIT_TEST(testLodNodeWithInvalidHysteresis);
+    CPPUNIT_TEST(testLodNodeWithUnorderedThresholds);
+    CPPUNIT_TEST(testSelectWithCoverage);
+    CPPUNIT_TEST(testSelectWithDistance);
+    CPPUNIT_TEST(testSelectWithFewerChildren);
+    CPPUNIT_TEST(testSelectWithHysteresis);
+    CPPUNIT_TEST(testSelectWithoutChildren);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(LodNodeTest::suite());
+    runner.run();
+    return 0;
+}
@@ -0,0 +1,100 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include "RapidGL/LodNodeUnmarshaller.h"
+namespace RapidGL {
+
+/**
+ * Constructs a `LodNodeUnmarshaller`.
+ */
+LodNodeUnmarshaller::LodNodeUnmarshaller() {
+    // empty
+}
+
+/**
+ * Destructs a `LodNodeUnmarshaller`.
+ */
+LodNodeUnmarshaller::~LodNodeUnmarshaller() {
+    // empty
+}
+
+/**
+ * Returns the value of the _hysteresis_ attribute.
+ *
+ * @param attributes Attributes to look in
+ * @return Value of the _hysteresis_ attribute, or zero if unspecified
+ * @throws std::runtime_error if value is invalid
+ */
+float LodNodeUnmarshaller::getHysteresis(const AttributeView& attributes) {
+
+    const std::string value = findValue(attributes, "hysteresis");
+    if (value.empty()) {
+        return 0;
+    }
+
+    try {
+        return parseFloat(value);
+    } catch (std::invalid_argument& e) {
+        throw std::runtime_error("[LodNodeUnmarshaller] Hysteresis is invalid!");
+    }
+}
+
+/**
+ * Converts a space-separated list of thresholds.
+ *
+ * @param value List of thresholds
+ * @return Thresholds in the list
+ * @throws std::runtime_error if a threshold is not a number
+ */
+std::vector<float> LodNodeUnmarshaller::parseThresholds(const std::string& value) {
+    const std::vector<std::string> tokens = tokenize(value);
+    std::vector<float> thresholds;
+    for (std::vector<std::string>::const_iterator it = tokens.begin(); it != tokens.end(); ++it) {
+        try {
+            thresholds.push_back(parseFloat(*it));
+        } catch (std::invalid_argument& e) {
+            throw std::runtime_error("[LodNodeUnmarshaller] Threshold is invalid!");
+        }
+    }
+    return thresholds;
+}
+
+Node* LodNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
+
+    // Find the thresholds, which determine the mode
+    const std::string distances = findValue(attributes, "distances");
+    const std::string coverages = findValue(attributes, "coverages");
+    if (distances.empty() && coverages.empty()) {
+        throw std::runtime_error("[LodNodeUnmarshaller] Thresholds are unspecified!");
+    } else if (!distances.empty() && !coverages.empty()) {
+        throw std::runtime_error("[LodNodeUnmarshaller] Both distances and coverages are specified!");
+    }
+    const LodNode::Mode mode = distances.empty() ? LodNode::COVERAGE : LodNode::DISTANCE;
+    const std::vector<float> thresholds = parseThresholds(distances.empty() ? coverages : distances);
+
+    // Make node
+    const float hysteresis = getHysteresis(attributes);
+    try {
+        return new LodNode(mode, thresholds, hysteresis);
+    } catch (std::invalid_argument& e) {
+        throw std::runtime_error("[LodNodeUnmarshaller] Thresholds or hysteresis are out of range!");
+    }
+}
+
+} /* namespace RapidGL */
@@ -0,0 +1,133 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "RapidGL/LodNode.h"
+#include "RapidGL/LodNodeUnmarshaller.h"
+#include "RapidGL/Node.h"
+
+
+/**
+ * Unit test for `LodNodeUnmarshaller`.
+ */
+class LodNodeUnmarshallerTest : public CppUnit::TestFixture {
+public:
+
+    // Instance to use for testing
+    RapidGL::LodNodeUnmarshaller unmarshaller;
+
+    /**
+     * Ensures `LodNodeUnmarshaller::unmarshal` works with coverages.
+     */
+    void testUnmarshalWithCoverages() {
+
+        // Make map
+        std::map<std::string,std::string> attributes;
+        attributes["coverages"] = "0.5 0.1";
+
+        // Unmarshal
+        RapidGL::Node* node = unmarshaller.unmarshal(attributes);
+        RapidGL::LodNode* lodNode = dynamic_cast<RapidGL::LodNode*>(node);
+        CPPUNIT_ASSERT(lodNode != NULL);
+
+        // Check values
+        CPPUNIT_ASSERT_EQUAL(RapidGL::LodNode::COVERAGE, lodNode->getMode());
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, lodNode->getThresholds().size());
+        CPPUNIT_ASSERT_EQUAL(0.0f, lodNode->getHysteresis());
+        delete node;
+    }
+
+    /**
+     * Ensures `LodNodeUnmarshaller::unmarshal` works with distances and hysteresis.
+     */
+    void testUnmarshalWithDistances() {
+
+        // Make map
+        std::map<std::string,std::string> attributes;
+        attributes["distances"] = "10 20 40";
+        attributes["hysteresis"] = "0.25";
+
+        // Unmarshal
+        RapidGL::Node* node = unmarshaller.unmarshal(attributes);
+        RapidGL::LodNode* lodNode = dynamic_cast<RapidGL::LodNode*>(node);
+        CPPUNIT_ASSERT(lodNode != NULL);
+
+        // Check values
+        CPPUNIT_ASSERT_EQUAL(RapidGL::LodNode::DISTANCE, lodNode->getMode());
+        const std::vector<float> thresholds = lodNode->getThresholds();
+        CPPUNIT_ASSERT_EQUAL((size_t) 3, thresholds.size());
+        CPPUNIT_ASSERT_EQUAL(40.0f, thresholds[2]);
+        CPPUNIT_ASSERT_EQUAL(0.25f, lodNode->getHysteresis());
+        delete node;
+    }
+
+    /**
+     * Ensures `LodNodeUnmarshaller::unmarshal` throws if both distances and coverages are specified.
+     */
+    void testUnmarshalWithDistancesAndCoverages() {
+        std::map<std::string,std::string> attributes;
+        attributes["distances"] = "10 20";
+        attributes["coverages"] = "0.5 0.1";
+        CPPUNIT_ASSERT_THROW(unmarshaller.unmarshal(attributes), std::runtime_error);
+    }
+
+    /**
+     * Ensures `LodNodeUnmarshaller::unmarshal` throws if a threshold is not a number.
+     */
+    void testUnmarshalWithInvalidThreshold() {
+        std::map<std::string,std::string> attributes;
+        attributes["distances"] = "10 far";
+        CPPUNIT_ASSERT_THROW(unmarshaller.unmarshal(attributes), std::runtime_error);
+    }
+
+    /**
+     * Ensures `LodNodeUnmarshaller::unmarshal` throws if thresholds are out of order.
+     */
+    void testUnmarshalWithUnorderedThresholds() {
+        std::map<std::string,std::string> attributes;
+        attributes["distances"] = "20 10";
+        CPPUNIT_ASSERT_THROW(unmarshaller.unmarshal(attributes), std::runtime_error);
+    }
+
+    /**
+     * Ensures `LodNodeUnmarshaller::unmarshal` throws if no thresholds are specified.
+     */
+    void testUnmarshalWithoutThresholds() {
+        std::map<std::string,std::string> attributes;
+        CPPUNIT_ASSERT_THROW(unmarshaller.unmarshal(attributes), std::runtime_error);
+    }
+
+    CPPUNIT_TEST_SUITE(LodNodeUnmarshallerTest);
+    CPPUNIT_TEST(testUnmarshalWithCoverages);
+    CPPUNIT_TEST(testUnmarshalWithDistances);
+    CPPUNIT_TEST(testUnmarshalWithDistancesAndCoverages);
+    CPPUNIT_TEST(testUnmarshalWithInvalidThreshold);
+    CPPUNIT_TEST(testUnmarshalWithUnorderedThresholds);
+    CPPUNIT_TEST(testUnmarshalWithoutThresholds);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(LodNodeUnmarshallerTest::suite());
+    runner.run();
+    return 0;
+}
@@ -57,15 +57,28 @@ M3d::Mat3 Mat3UniformNode::getValue() const {
  */
 void Mat3UniformNode::setValue(const M3d::Mat3& value) {
     this->value = value;
+    invalidateUploads();
     fireNodeChangedEvent();
 }
 
 void Mat3UniformNode::visit(State& state) {
-    const GLint location = getLocationInProgram(Gloop::Program::current());
-    if (location >= 0) {
-        GLfloat arr[9];
-        value.toArrayInColumnMajor(arr);
-        glUniformMatrix3fv(location, 1, false, arr);
+    const GLint location = getLocationInCurrentProgram(state);
+    if ((location < 0) && state.getUniformBuffers().empty()) {
+        return;
+    }
+    GLfloat arr[9];
+    value.toArrayInColumnMajor(arr);
+    if (location < 0) {
+        setValueInUniformBuffers(state, arr);
+        return;
+    }
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    if (renderQueue == NULL) {
+        if (isUploadNeeded(state)) {
+            glUniformMatrix3fv(location, 1, false, arr);
+        }
+    } else {
+        renderQueue->setUniform(location, TYPE, arr);
     }
 }
 
@@ -32,7 +32,7 @@ std::map<std::string,Mat4UniformNode::Usage> Mat4UniformNode::usagesByName = cre
  */
 Mat4UniformNode::Mat4UniformNode(const std::string& name, const Usage usage) :
         UniformNode(name, TYPE),
-        value(M3d::Mat4(1)),
+        value(),
         usage(usage) {
     // empty
 }
@@ -57,27 +57,66 @@ std::map<std::string,Mat4UniformNode::Usage> Mat4UniformNode::createUsagesByName
  *
  * @param state State to get matrix value from
  * @param usage Usage determining what matrix to get
+ * @return Reference to the matrix in the state
  * @throws std::runtime_error if usage is unexpected
  */
-M3d::Mat4 Mat4UniformNode::getMatrixFromState(const State& state, const Usage usage) {
+const SimdMat4& Mat4UniformNode::getMatrixFromState(const State& state, const Usage usage) {
     switch (usage) {
     case MODEL:
-        return state.getModelMatrix();
+        return state.getSimdModelMatrix();
     case MODEL_VIEW:
-        return state.getModelViewMatrix();
+        return state.getSimdModelViewMatrix();
     case MODEL_VIEW_PROJECTION:
-        return state.getModelViewProjectionMatrix();
+        return state.getSimdModelViewProjectionMatrix();
     case PROJECTION:
-        return state.getProjectionMatrix();
+        return state.getSimdProjectionMatrix();
     case VIEW:
-        return state.getViewMatrix();
+        return state.getSimdViewMatrix();
     case VIEW_PROJECTION:
-        return state.getViewProjectionMatrix();
+        return state.getSimdViewProjectionMatrix();
     default:
         throw std::runtime_error("[Mat4UniformNode] Unexpected usage!");
     }
 }
 
+/**
+ * Returns the versions of the matrices in a `State` that a usage is computed from.
+ *
+ * @param state State to get matrix versions from
+ * @param usage Usage determining what matrices are used
+ * @return Versions of the matrices used, with zero for the others
+ */
+UniformNode::Stamp Mat4UniformNode::getStampFromState(const State& state, const Usage usage) {
+    Stamp stamp = { 0, 0, 0 };
+    switch (usage) {
+    case MODEL:
+        stamp.model = state.getModelMatrixVersion();
+        break;
+    case MODEL_VIEW:
+        stamp.model = state.getModelMatrixVersion();
+        stamp.view = state.getViewMatrixVersion();
+        break;
+    case MODEL_VIEW_PROJECTION:
+        stamp.model = state.getModelMatrixVersion();
+        stamp.view = state.getViewMatrixVersion();
+        stamp.projection = state.getProjectionMatrixVersion();
+        break;
+    case PROJECTION:
+        stamp.projection = state.getProjectionMatrixVersion();
+        break;
+    case VIEW:
+        stamp.view = state.getViewMatrixVersion();
+        break;
+    case VIEW_PROJECTION:
+        stamp.view = state.getViewMatrixVersion();
+        stamp.projection = state.getProjectionMatrixVersion();
+        break;
+    default:
+        break;
+    }
+    return stamp;
+}
+
 /**
  * Returns how the uniform node is used.
  *
@@ -93,7 +132,7 @@ Mat4UniformNode::Usage Mat4UniformNode::getUsage() const {
  * @return Copy of the uniform's value
  */
 M3d::Mat4 Mat4UniformNode::getValue() const {
-    return value;
+    return value.toMat4();
 }
 
 /**
@@ -115,9 +154,15 @@ Mat4UniformNode::Usage Mat4UniformNode::parseUsage(const std::string& str) {
 
 void Mat4UniformNode::visit(State& state) {
 
-    // Get the location
-    const GLint location = getLocationInProgram(Gloop::Program::current());
-    if (location < 0) {
+    // Get the location, unless the uniform may be in a block
+    const GLint location = getLocationInCurrentProgram(state);
+    if ((location < 0) && state.getUniformBuffers().empty()) {
+        return;
+    }
+
+    // Skip computing the value if the program already has it
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    if ((location >= 0) && (renderQueue == NULL) && !isUploadNeeded(state, getStampFromState(state, usage))) {
         return;
     }
 
@@ -129,7 +174,15 @@ void Mat4UniformNode::visit(State& state) {
     // Load the value
     GLfloat arr[16];
     value.toArrayInColumnMajor(arr);
-    glUniformMatrix4fv(location, 1, false, arr);
+    if (location < 0) {
+        setValueInUniformBuffers(state, arr);
+        return;
+    }
+    if (renderQueue == NULL) {
+        glUniformMatrix4fv(location, 1, false, arr);
+    } else {
+        renderQueue->setUniform(location, TYPE, arr);
+    }
 }
 
 } /* namespace RapidGL */
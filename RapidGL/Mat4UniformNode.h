@@ -20,6 +20,7 @@
 #include <string>
 #include <m3d/Mat4.h>
 #include "RapidGL/common.h"
+#include "RapidGL/SimdMat4.h"
 #include "RapidGL/UniformNode.h"
 namespace RapidGL {
 
@@ -52,10 +53,11 @@ private:
     static std::map<std::string,Usage> usagesByName;
 // Attributes
     const Usage usage;
-    M3d::Mat4 value;
+    SimdMat4 value;
 // Methods
     static std::map<std::string,Usage> createUsagesByName();
-    static M3d::Mat4 getMatrixFromState(const State& state, Usage usage);
+    static const SimdMat4& getMatrixFromState(const State& state, Usage usage);
+    static Stamp getStampFromState(const State& state, Usage usage);
 };
 
 } /* namespace RapidGL */
@@ -374,6 +374,47 @@ public:
         useNode.removeChild(&uniformNode);
     }
 
+    /**
+     * Ensures `Mat4UniformNode::visit` only loads the matrix again after it changes.
+     */
+    void testVisitWithUnchangedMatrix() {
+
+        // Add uniform node
+        RapidGL::Mat4UniformNode uniformNode("Matrix", RapidGL::Mat4UniformNode::MODEL_VIEW);
+        useNode.addChild(&uniformNode);
+
+        // Visit twice
+        RapidGL::State state;
+        RapidGL::Visitor visitor(&state);
+        state.setViewMatrix(getRandomMatrix());
+        visitor.visit(&sceneNode);
+        visitor.visit(&sceneNode);
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, uniformNode.getUploadCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, uniformNode.getSkipCount());
+
+        // Change model matrix and visit again
+        const M3d::Mat4 modelMatrix = getRandomMatrix();
+        state.setModelMatrix(modelMatrix);
+        visitor.visit(&sceneNode);
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, uniformNode.getUploadCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, uniformNode.getSkipCount());
+
+        // Check value
+        GLfloat expected[16];
+        const M3d::Mat4 modelViewMatrix = state.getViewMatrix() * modelMatrix;
+        modelViewMatrix.toArrayInColumnMajor(expected);
+        GLfloat actual[16];
+        const Gloop::Program program = programNode.getProgram();
+        const GLint location = program.uniformLocation(uniformNode.getName());
+        glGetUniformfv(program.id(), location, actual);
+        for (int i = 0; i < 16; ++i) {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(expected[i], actual[i], TOLERANCE);
+        }
+
+        // Remove uniform node
+        useNode.removeChild(&uniformNode);
+    }
+
     /**
      * Ensures `Mat4UniformNode::visit` works when usage is `VIEW`.
      */
@@ -482,6 +523,7 @@ int main(int argc, char* argv[]) {
         test.testVisitWithModelUsage();
         test.testVisitWithModelViewUsage();
         test.testVisitWithModelViewProjectionUsage();
+        test.testVisitWithUnchangedMatrix();
         test.testVisitWithViewUsage();
         test.testVisitWithProjectionUsage();
         test.testVisitWithViewProjectionUsage();
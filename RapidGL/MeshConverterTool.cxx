@@ -0,0 +1,86 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "RapidGL/MeshFile.h"
+#include "RapidGL/MeshReader.h"
+
+
+/**
+ * Command-line tool converting an OBJ or binary PLY file to a mesh file.
+ *
+ * The mesh is read with `MeshReader` and written with `MeshFile::write`, so
+ * `MeshNode` can later map it and upload it without parsing it again.
+ */
+class MeshConverterTool {
+public:
+
+    /**
+     * Converts a file.
+     *
+     * @param input Path to OBJ or binary PLY file to read
+     * @param output Path to mesh file to write
+     * @throws runtime_error if input could not be read or output could not be written
+     */
+    void run(const std::string& input, const std::string& output) {
+
+        // Read
+        RapidGL::MeshReader reader;
+        reader.read(input);
+
+        // Write
+        std::ofstream stream(output.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!stream) {
+            throw std::runtime_error("[MeshConverterTool] Could not open output file!");
+        }
+        RapidGL::MeshFile::write(
+                stream,
+                RapidGL::MeshReader::createBufferLayout(reader.getVertexCount()),
+                &(reader.getVertices()[0]),
+                reader.getIndices(),
+                reader.getBounds());
+
+        // Report
+        std::cout << input << " -> " << output << ": "
+                  << reader.getVertexCount() << " vertices, "
+                  << (reader.getIndices().size() / 3) << " triangles" << std::endl;
+    }
+};
+
+int main(int argc, char* argv[]) {
+
+    // Check arguments
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <input.obj|input.ply> <output.rmesh>" << std::endl;
+        return 1;
+    }
+
+    // Convert
+    try {
+        MeshConverterTool tool;
+        tool.run(argv[1], argv[2]);
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,384 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <glycerin/BufferLayoutBuilder.hxx>
+#include <m3d/Vec3.h>
+#include "RapidGL/MeshFile.h"
+namespace RapidGL {
+
+// Bytes every mesh file starts with
+const char MeshFile::MAGIC[8] = { 'R', 'G', 'L', 'M', 'E', 'S', 'H', '\0' };
+
+/**
+ * Constructs a `MeshFile` by mapping a file into memory.
+ *
+ * @param filename Path to mesh file
+ * @throws runtime_error if file could not be mapped or is not a valid mesh file
+ */
+MeshFile::MeshFile(const std::string& filename) : data(NULL), size(0), header(NULL), regions(NULL) {
+
+    // Open file
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("[MeshFile] Could not open file!");
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::runtime_error("[MeshFile] Could not determine size of file!");
+    } else if (((size_t) info.st_size) < sizeof(Header)) {
+        close(fd);
+        throw std::runtime_error("[MeshFile] File is too small!");
+    }
+
+    // Map it, then close it since the mapping keeps its own reference
+    void* const addr = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        throw std::runtime_error("[MeshFile] Could not map file!");
+    }
+    madvise(addr, info.st_size, MADV_WILLNEED);
+    data = (const char*) addr;
+    size = info.st_size;
+
+    // Check it
+    header = (const Header*) data;
+    regions = (const Region*) (data + sizeof(Header));
+    validate();
+}
+
+/**
+ * Destructs a `MeshFile`, unmapping its file.
+ */
+MeshFile::~MeshFile() {
+    if (data != NULL) {
+        munmap((void*) data, size);
+    }
+}
+
+/**
+ * Rounds an offset up to the next multiple of `ALIGNMENT`.
+ *
+ * @param offset Offset to round
+ * @return Smallest multiple of `ALIGNMENT` not less than offset
+ */
+uint64_t MeshFile::align(const uint64_t offset) {
+    return ((offset + ALIGNMENT - 1) / ALIGNMENT) * ALIGNMENT;
+}
+
+/**
+ * Unmaps the file and throws an exception.
+ *
+ * @param message Message of exception
+ * @throws runtime_error always
+ */
+void MeshFile::fail(const std::string& message) {
+    munmap((void*) data, size);
+    data = NULL;
+    throw std::runtime_error(message);
+}
+
+/**
+ * Returns the box enclosing the vertices of the mesh.
+ *
+ * @return Box enclosing the vertices of the mesh
+ */
+BoundingBox MeshFile::getBounds() const {
+    if (header->min[0] > header->max[0]) {
+        return BoundingBox();
+    }
+    return BoundingBox(
+            M3d::Vec3(header->min[0], header->min[1], header->min[2]),
+            M3d::Vec3(header->max[0], header->max[1], header->max[2]));
+}
+
+/**
+ * Returns the number of indices in the mesh.
+ *
+ * @return Number of indices in the mesh
+ */
+GLsizei MeshFile::getIndexCount() const {
+    return header->indexCount;
+}
+
+/**
+ * Returns the indices of the mesh, which are valid for as long as the file is.
+ *
+ * @return Pointer to the indices in the mapped file
+ */
+const GLvoid* MeshFile::getIndices() const {
+    return data + header->indicesOffset;
+}
+
+/**
+ * Returns the type of the indices of the mesh.
+ *
+ * @return Type of the indices, i.e. `GL_UNSIGNED_SHORT` or `GL_UNSIGNED_INT`
+ */
+GLenum MeshFile::getIndexType() const {
+    return header->indexType;
+}
+
+/**
+ * Returns the layout of the vertices of the mesh.
+ *
+ * @return Layout of the vertices of the mesh
+ */
+Glycerin::BufferLayout MeshFile::getLayout() const {
+    Glycerin::BufferLayoutBuilder builder;
+    builder.count(header->vertexCount);
+    builder.interleaved(header->interleaved != 0);
+    for (uint32_t i = 0; i < header->regionCount; ++i) {
+        const Region& region = regions[i];
+        builder.components(region.components);
+        builder.type(region.type);
+        builder.normalized(region.normalized != 0);
+        builder.region(std::string(region.name, strnlen(region.name, sizeof(region.name))));
+    }
+    return builder.build();
+}
+
+/**
+ * Returns the size of a value of a type that can be stored in a region.
+ *
+ * @param type Type of value, e.g. `GL_FLOAT`
+ * @return Size of value in bytes, or zero if type is unsupported
+ */
+size_t MeshFile::getTypeSize(const GLenum type) {
+    switch (type) {
+    case GL_BYTE:
+    case GL_UNSIGNED_BYTE:
+        return 1;
+    case GL_SHORT:
+    case GL_UNSIGNED_SHORT:
+        return 2;
+    case GL_INT:
+    case GL_UNSIGNED_INT:
+    case GL_FLOAT:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * Returns the vertices of the mesh, which are valid for as long as the file is.
+ *
+ * @return Pointer to the vertices in the mapped file, laid out as described by `getLayout`
+ */
+const GLvoid* MeshFile::getVertices() const {
+    return data + header->verticesOffset;
+}
+
+/**
+ * Checks the mapped file is a mesh file this machine can use, unmapping it if not.
+ *
+ * @throws runtime_error if file is not a valid mesh file
+ */
+void MeshFile::validate() {
+
+    // Check header
+    if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0) {
+        fail("[MeshFile] File is not a mesh file!");
+    } else if (header->version != VERSION) {
+        fail("[MeshFile] Version of file is unsupported!");
+    } else if (header->byteOrder != BYTE_ORDER_MARK) {
+        fail("[MeshFile] Byte order of file does not match this machine!");
+    } else if (header->regionCount == 0) {
+        fail("[MeshFile] File has no regions!");
+    } else if (header->indexType != GL_UNSIGNED_SHORT && header->indexType != GL_UNSIGNED_INT) {
+        fail("[MeshFile] Index type is invalid!");
+    }
+
+    // Check blobs are inside the file
+    const uint64_t regionsEnd = sizeof(Header) + ((uint64_t) header->regionCount) * sizeof(Region);
+    const uint64_t indexSize = (header->indexType == GL_UNSIGNED_SHORT) ? sizeof(GLushort) : sizeof(GLuint);
+    if (regionsEnd > size) {
+        fail("[MeshFile] Regions extend past end of file!");
+    } else if (header->verticesOffset < regionsEnd
+            || header->verticesOffset > size
+            || header->verticesSize > size - header->verticesOffset) {
+        fail("[MeshFile] Vertices extend past end of file!");
+    } else if (header->indicesOffset < regionsEnd
+            || header->indicesOffset > size
+            || header->indicesSize > size - header->indicesOffset) {
+        fail("[MeshFile] Indices extend past end of file!");
+    } else if (header->indicesOffset % indexSize != 0) {
+        fail("[MeshFile] Indices are not aligned!");
+    } else if (header->indicesSize != header->indexCount * indexSize) {
+        fail("[MeshFile] Size of indices does not match count!");
+    }
+
+    // Check regions and that layout describes vertices
+    for (uint32_t i = 0; i < header->regionCount; ++i) {
+        if (regions[i].components < 1 || regions[i].components > 4) {
+            fail("[MeshFile] Number of components in region is invalid!");
+        } else if (getTypeSize(regions[i].type) == 0) {
+            fail("[MeshFile] Type of region is unsupported!");
+        }
+    }
+    if (((uint64_t) getLayout().sizeInBytes()) != header->verticesSize) {
+        fail("[MeshFile] Size of vertices does not match layout!");
+    }
+
+    // Check indices only refer to vertices in the file
+    const char* const indices = data + header->indicesOffset;
+    if (header->indexType == GL_UNSIGNED_SHORT) {
+        const GLushort* const begin = (const GLushort*) indices;
+        const GLushort* const end = begin + header->indexCount;
+        if ((begin != end) && (*std::max_element(begin, end) >= header->vertexCount)) {
+            fail("[MeshFile] Index out of range!");
+        }
+    } else {
+        const GLuint* const begin = (const GLuint*) indices;
+        const GLuint* const end = begin + header->indexCount;
+        if ((begin != end) && (*std::max_element(begin, end) >= header->vertexCount)) {
+            fail("[MeshFile] Index out of range!");
+        }
+    }
+}
+
+/**
+ * Writes a mesh in the format read by `MeshFile`.
+ *
+ * Indices are stored as `GL_UNSIGNED_SHORT` if they all fit, otherwise as `GL_UNSIGNED_INT`.
+ *
+ * @param stream Stream to write to, which should be binary
+ * @param layout Layout of vertices
+ * @param vertices Vertices to write, laid out as described by layout
+ * @param indices Indices of vertices to draw, in order
+ * @param bounds Box enclosing the vertices
+ * @throws invalid_argument if vertices is `NULL`, indices is empty, or a region's name is too long or type is unsupported
+ * @throws runtime_error if stream could not be written to
+ */
+void MeshFile::write(std::ostream& stream,
+                     const Glycerin::BufferLayout& layout,
+                     const GLvoid* const vertices,
+                     const std::vector<GLuint>& indices,
+                     const BoundingBox& bounds) {
+
+    if (vertices == NULL) {
+        throw std::invalid_argument("[MeshFile] Vertices is NULL!");
+    } else if (indices.empty()) {
+        throw std::invalid_argument("[MeshFile] Indices is empty!");
+    }
+
+    // Describe regions
+    std::vector<Region> regions;
+    for (Glycerin::BufferLayout::const_iterator it = layout.begin(); it != layout.end(); ++it) {
+        const std::string name = it->name();
+        if (name.size() >= sizeof(Region().name)) {
+            throw std::invalid_argument("[MeshFile] Name of region is too long!");
+        }
+        Region region;
+        memset(&region, 0, sizeof(Region));
+        name.copy(region.name, name.size());
+        region.components = it->components();
+        region.type = it->type();
+        region.normalized = it->normalized() ? 1 : 0;
+        if (getTypeSize(region.type) == 0) {
+            throw std::invalid_argument("[MeshFile] Type of region is unsupported!");
+        }
+        regions.push_back(region);
+    }
+    if (regions.empty()) {
+        throw std::invalid_argument("[MeshFile] Layout has no regions!");
+    }
+
+    // Work out count from first region, and if regions are interleaved from where the second starts
+    Glycerin::BufferLayout::const_iterator first = layout.begin();
+    Glycerin::BufferLayout::const_iterator second = first;
+    ++second;
+    const GLsizei vertexCount = first->sizeInBytes() / (first->components() * getTypeSize(first->type()));
+    const bool interleaved = (second != layout.end()) && (second->offset() < first->sizeInBytes());
+
+    // Use the smallest index type that fits
+    GLuint maxIndex = 0;
+    for (std::vector<GLuint>::const_iterator it = indices.begin(); it != indices.end(); ++it) {
+        maxIndex = std::max(maxIndex, *it);
+    }
+    const bool shortIndices = (maxIndex <= 0xFFFF);
+
+    // Fill in header
+    Header header;
+    memset(&header, 0, sizeof(Header));
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.vertexCount = vertexCount;
+    header.interleaved = interleaved ? 1 : 0;
+    header.regionCount = regions.size();
+    header.indexCount = indices.size();
+    header.indexType = shortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    if (bounds.isEmpty()) {
+        header.min[0] = header.min[1] = header.min[2] = 1;
+        header.max[0] = header.max[1] = header.max[2] = -1;
+    } else {
+        const M3d::Vec3 min = bounds.getMin();
+        const M3d::Vec3 max = bounds.getMax();
+        for (int i = 0; i < 3; ++i) {
+            header.min[i] = min[i];
+            header.max[i] = max[i];
+        }
+    }
+    header.verticesOffset = align(sizeof(Header) + regions.size() * sizeof(Region));
+    header.verticesSize = layout.sizeInBytes();
+    header.indicesOffset = align(header.verticesOffset + header.verticesSize);
+    header.indicesSize = indices.size() * (shortIndices ? sizeof(GLushort) : sizeof(GLuint));
+
+    // Write header and regions
+    stream.write((const char*) &header, sizeof(Header));
+    stream.write((const char*) &regions[0], regions.size() * sizeof(Region));
+
+    // Write vertices
+    writePadding(stream, header.verticesOffset - sizeof(Header) - regions.size() * sizeof(Region));
+    stream.write((const char*) vertices, header.verticesSize);
+
+    // Write indices
+    writePadding(stream, header.indicesOffset - header.verticesOffset - header.verticesSize);
+    if (shortIndices) {
+        const std::vector<GLushort> shorts(indices.begin(), indices.end());
+        stream.write((const char*) &shorts[0], header.indicesSize);
+    } else {
+        stream.write((const char*) &indices[0], header.indicesSize);
+    }
+
+    if (!stream) {
+        throw std::runtime_error("[MeshFile] Could not write to stream!");
+    }
+}
+
+/**
+ * Writes zeros to a stream.
+ *
+ * @param stream Stream to write to
+ * @param count Number of zeros to write
+ */
+void MeshFile::writePadding(std::ostream& stream, const uint64_t count) {
+    const char zeros[ALIGNMENT] = { 0 };
+    stream.write(zeros, count);
+}
+
+} /* namespace RapidGL */
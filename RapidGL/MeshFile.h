@@ -0,0 +1,121 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RAPIDGL_MESH_FILE_H
+#define RAPIDGL_MESH_FILE_H
+#include <ostream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <glycerin/BufferLayout.hxx>
+#include "RapidGL/common.h"
+#include "RapidGL/BoundingBox.h"
+namespace RapidGL {
+
+
+/**
+ * Mesh stored in a binary file laid out the same as its OpenGL buffers.
+ *
+ * A mesh file starts with a fixed header giving the number of vertices, the
+ * regions of the vertex layout, the number and type of the indices, and the
+ * bounds of the mesh.  The vertices and indices follow as blobs that can be
+ * given to `glBufferData` as they are, each starting on a multiple of
+ * `ALIGNMENT` bytes.  Values are stored in the byte order of the machine that
+ * wrote the file, and files written on a machine with a different byte order
+ * are rejected.
+ *
+ * Constructing a `MeshFile` maps the file into memory rather than reading it,
+ * so `getVertices` and `getIndices` point straight at the mapped pages and
+ * nothing is parsed or copied before the data is uploaded.  The pointers are
+ * valid for as long as the `MeshFile` exists.  The indices are still scanned
+ * once when the file is opened, so a corrupt file cannot make OpenGL read
+ * past the end of the vertices.
+ *
+ * Mesh files are usually made from OBJ or PLY files with `MeshConverterTool`,
+ * which uses `write`.
+ */
+class MeshFile {
+public:
+// Methods
+    explicit MeshFile(const std::string& filename);
+    virtual ~MeshFile();
+    BoundingBox getBounds() const;
+    GLsizei getIndexCount() const;
+    const GLvoid* getIndices() const;
+    GLenum getIndexType() const;
+    Glycerin::BufferLayout getLayout() const;
+    const GLvoid* getVertices() const;
+    static void write(std::ostream& stream,
+                      const Glycerin::BufferLayout& layout,
+                      const GLvoid* vertices,
+                      const std::vector<GLuint>& indices,
+                      const BoundingBox& bounds);
+// Constants
+    static const size_t ALIGNMENT = 64;
+    static const uint32_t VERSION = 1;
+private:
+// Types
+    /**
+     * Fixed part at the start of a mesh file.
+     */
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t vertexCount;
+        uint32_t interleaved;
+        uint32_t regionCount;
+        uint32_t indexCount;
+        uint32_t indexType;
+        float min[3];
+        float max[3];
+        uint32_t reserved;
+        uint64_t verticesOffset;
+        uint64_t verticesSize;
+        uint64_t indicesOffset;
+        uint64_t indicesSize;
+    };
+    /**
+     * Description of a region of the vertex layout, following the header.
+     */
+    struct Region {
+        char name[24];
+        uint32_t components;
+        uint32_t type;
+        uint32_t normalized;
+        uint32_t reserved;
+    };
+// Constants
+    static const char MAGIC[8];
+    static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+// Attributes
+    const char* data;
+    size_t size;
+    const Header* header;
+    const Region* regions;
+// Methods
+    MeshFile(const MeshFile&);
+    MeshFile& operator=(const MeshFile&);
+    static uint64_t align(uint64_t offset);
+    void fail(const std::string& message);
+    static size_t getTypeSize(GLenum type);
+    void validate();
+    static void writePadding(std::ostream& stream, uint64_t count);
+};
+
+} /* namespace RapidGL */
+#endif
@@ -0,0 +1,220 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include <glycerin/BufferLayout.hxx>
+#include <m3d/Vec3.h>
+#include "RapidGL/MeshFile.h"
+#include "RapidGL/MeshReader.h"
+
+
+/**
+ * Unit test for `MeshFile`.
+ */
+class MeshFileTest : public CppUnit::TestFixture {
+public:
+
+    // Path of file written for each test
+    static const char* const FILE;
+
+    // Vertices of a square, each with a position, normal and texture coordinate
+    std::vector<GLfloat> vertices;
+
+    /**
+     * Makes the vertices of the square.
+     */
+    void setUp() {
+        const GLfloat square[] = {
+            -1, -1, 0, 0, 0, 1, 0, 0,
+            +1, -1, 0, 0, 0, 1, 1, 0,
+            +1, +1, 0, 0, 0, 1, 1, 1,
+            -1, +1, 0, 0, 0, 1, 0, 1 };
+        vertices.assign(square, square + 32);
+    }
+
+    /**
+     * Removes the file written.
+     */
+    void tearDown() {
+        std::remove(FILE);
+    }
+
+    /**
+     * Writes the square to the file.
+     *
+     * @param indices Indices to write
+     */
+    void writeSquare(const std::vector<GLuint>& indices) {
+        std::ofstream stream(FILE, std::ios::out | std::ios::binary);
+        RapidGL::MeshFile::write(
+                stream,
+                RapidGL::MeshReader::createBufferLayout(vertices.size() / 8),
+                &vertices[0],
+                indices,
+                RapidGL::BoundingBox(M3d::Vec3(-1, -1, 0), M3d::Vec3(1, 1, 0)));
+    }
+
+    /**
+     * Returns the indices of two triangles making the square.
+     */
+    static std::vector<GLuint> getSquareIndices() {
+        const GLuint indices[] = { 0, 1, 2, 0, 2, 3 };
+        return std::vector<GLuint>(indices, indices + 6);
+    }
+
+    /**
+     * Ensures a file written by `MeshFile::write` is read back the same.
+     */
+    void testWriteAndRead() {
+
+        writeSquare(getSquareIndices());
+        const RapidGL::MeshFile file(FILE);
+
+        // Check indices were narrowed
+        CPPUNIT_ASSERT_EQUAL((GLsizei) 6, file.getIndexCount());
+        CPPUNIT_ASSERT_EQUAL((GLenum) GL_UNSIGNED_SHORT, file.getIndexType());
+        const GLushort* const indices = (const GLushort*) file.getIndices();
+        CPPUNIT_ASSERT_EQUAL((GLushort) 0, indices[0]);
+        CPPUNIT_ASSERT_EQUAL((GLushort) 3, indices[5]);
+
+        // Check vertices and layout
+        const Glycerin::BufferLayout layout = file.getLayout();
+        CPPUNIT_ASSERT_EQUAL((GLsizei) (vertices.size() * sizeof(GLfloat)), layout.sizeInBytes());
+        const GLfloat* const data = (const GLfloat*) file.getVertices();
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            CPPUNIT_ASSERT_EQUAL(vertices[i], data[i]);
+        }
+        const Glycerin::BufferLayout expected = RapidGL::MeshReader::createBufferLayout(4);
+        Glycerin::BufferLayout::const_iterator it = layout.begin();
+        for (Glycerin::BufferLayout::const_iterator e = expected.begin(); e != expected.end(); ++e, ++it) {
+            CPPUNIT_ASSERT(it != layout.end());
+            CPPUNIT_ASSERT_EQUAL(e->name(), it->name());
+            CPPUNIT_ASSERT_EQUAL(e->offset(), it->offset());
+            CPPUNIT_ASSERT_EQUAL(e->stride(), it->stride());
+        }
+
+        // Check blobs are aligned
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, ((size_t) file.getVertices()) % RapidGL::MeshFile::ALIGNMENT);
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, ((size_t) file.getIndices()) % RapidGL::MeshFile::ALIGNMENT);
+
+        // Check bounds
+        const RapidGL::BoundingBox bounds = file.getBounds();
+        CPPUNIT_ASSERT_EQUAL(-1.0, (double) bounds.getMin().x);
+        CPPUNIT_ASSERT_EQUAL(1.0, (double) bounds.getMax().y);
+    }
+
+    /**
+     * Ensures `MeshFile::write` keeps 32-bit indices when they do not fit in 16 bits.
+     */
+    void testWriteWithLargeIndices() {
+        vertices.resize(70001 * 8, 0.0f);
+        std::vector<GLuint> indices = getSquareIndices();
+        indices[5] = 70000;
+        writeSquare(indices);
+        const RapidGL::MeshFile file(FILE);
+        CPPUNIT_ASSERT_EQUAL((GLenum) GL_UNSIGNED_INT, file.getIndexType());
+        CPPUNIT_ASSERT_EQUAL((GLuint) 70000, ((const GLuint*) file.getIndices())[5]);
+    }
+
+    /**
+     * Ensures `MeshFile::write` throws if there are no indices.
+     */
+    void testWriteWithNoIndices() {
+        std::ofstream stream(FILE, std::ios::out | std::ios::binary);
+        CPPUNIT_ASSERT_THROW(
+                RapidGL::MeshFile::write(
+                        stream,
+                        RapidGL::MeshReader::createBufferLayout(4),
+                        &vertices[0],
+                        std::vector<GLuint>(),
+                        RapidGL::BoundingBox()),
+                std::invalid_argument);
+    }
+
+    /**
+     * Ensures `MeshFile` throws if the file does not exist.
+     */
+    void testConstructWithMissingFile() {
+        CPPUNIT_ASSERT_THROW(RapidGL::MeshFile("MeshFileTest.missing"), std::runtime_error);
+    }
+
+    /**
+     * Ensures `MeshFile` throws if an index refers to a vertex past the last one.
+     */
+    void testConstructWithIndexOutOfRange() {
+        std::vector<GLuint> indices = getSquareIndices();
+        indices[5] = 4;
+        writeSquare(indices);
+        CPPUNIT_ASSERT_THROW(RapidGL::MeshFile file(FILE), std::runtime_error);
+    }
+
+    /**
+     * Ensures `MeshFile` throws if the file is not a mesh file.
+     */
+    void testConstructWithWrongMagic() {
+        std::ofstream stream(FILE, std::ios::out | std::ios::binary);
+        stream << std::string(256, 'x');
+        stream.close();
+        CPPUNIT_ASSERT_THROW(RapidGL::MeshFile file(FILE), std::runtime_error);
+    }
+
+    /**
+     * Ensures `MeshFile` throws if the file ends before its indices do.
+     */
+    void testConstructWithTruncatedFile() {
+
+        // Write then read all but the last byte
+        writeSquare(getSquareIndices());
+        std::ifstream in(FILE, std::ios::in | std::ios::binary);
+        const std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+
+        // Write it back
+        std::ofstream out(FILE, std::ios::out | std::ios::binary);
+        out.write(contents.data(), contents.size() - 1);
+        out.close();
+        CPPUNIT_ASSERT_THROW(RapidGL::MeshFile file(FILE), std::runtime_error);
+    }
+
+    CPPUNIT_TEST_SUITE(MeshFileTest);
+    CPPUNIT_TEST(testWriteAndRead);
+    CPPUNIT_TEST(testWriteWithLargeIndices);
+    CPPUNIT_TEST(testWriteWithNoIndices);
+    CPPUNIT_TEST(testConstructWithMissingFile);
+    CPPUNIT_TEST(testConstructWithIndexOutOfRange);
+    CPPUNIT_TEST(testConstructWithWrongMagic);
+    CPPUNIT_TEST(testConstructWithTruncatedFile);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+const char* const MeshFileTest::FILE = "MeshFileTest.rmesh";
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(MeshFileTest::suite());
+    runner.run();
+    return 0;
+}
@@ -0,0 +1,174 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <gloop/VertexAttribPointer.hxx>
+#include <m3d/Vec3.h>
+#include <m3d/Vec4.h>
+#include <Poco/Path.h>
+#include <Poco/String.h>
+#include "RapidGL/MeshFile.h"
+#include "RapidGL/MeshNode.h"
+#include "RapidGL/MeshReader.h"
+namespace RapidGL {
+
+// Prefix of names of geometry read from files, keeping them apart from built-in shapes like `"cube"`
+const std::string MeshNode::GEOMETRY_PREFIX = "mesh:";
+
+/**
+ * Constructs a `MeshNode`, reading its file unless another mesh node already has.
+ *
+ * @param file Path to an OBJ, binary PLY or mesh file
+ * @param id Identifier of node, which may be empty
+ * @throws invalid_argument if file is empty
+ * @throws runtime_error if file could not be read
+ */
+MeshNode::MeshNode(const std::string& file, const std::string& id) :
+        Node(id),
+        file(file),
+        geometry(Geometry::acquire(getGeometryName(file), &createGeometry)),
+        boundingBox(createBoundingBox(geometry->getBounds())),
+        vaoCache(geometry) {
+    setHooks(VISIT);
+}
+
+/**
+ * Destructs a `MeshNode`.
+ */
+MeshNode::~MeshNode() {
+    Geometry::release(getGeometryName(file));
+}
+
+/**
+ * Computes the bounds of the mesh and any children of this node.
+ *
+ * @return Box enclosing the mesh and any children
+ */
+BoundingBox MeshNode::computeBounds() {
+    BoundingBox box = Node::computeBounds();
+    box.add(geometry->getBounds());
+    return box;
+}
+
+/**
+ * Creates the bounding box the mesh delegates to for intersection testing.
+ *
+ * @param bounds Box enclosing the mesh
+ * @return Equivalent box for intersection testing
+ */
+Glycerin::AxisAlignedBoundingBox MeshNode::createBoundingBox(const BoundingBox& bounds) {
+    const M3d::Vec3 min = bounds.getMin();
+    const M3d::Vec3 max = bounds.getMax();
+    return Glycerin::AxisAlignedBoundingBox(M3d::Vec4(min, 1), M3d::Vec4(max, 1));
+}
+
+/**
+ * Reads a mesh file into new geometry.
+ *
+ * @param name Name of geometry, i.e. the path of the file with `GEOMETRY_PREFIX` in front of it
+ * @return Geometry holding the mesh
+ * @throws runtime_error if file could not be read
+ */
+Geometry* MeshNode::createGeometry(const std::string& name) {
+
+    // Strip prefix to get path
+    const std::string file = name.substr(GEOMETRY_PREFIX.length());
+
+    // Upload mesh files straight from the mapped file
+    if (Poco::icompare(Poco::Path(file).getExtension(), "rmesh") == 0) {
+        const MeshFile meshFile(file);
+        return new Geometry(
+                meshFile.getLayout(),
+                meshFile.getVertices(),
+                meshFile.getIndices(),
+                meshFile.getIndexCount(),
+                meshFile.getIndexType(),
+                meshFile.getBounds());
+    }
+
+    // Otherwise parse it
+    MeshReader reader;
+    reader.read(file);
+    return new Geometry(
+            MeshReader::createBufferLayout(reader.getVertexCount()),
+            &(reader.getVertices()[0]),
+            reader.getIndices(),
+            reader.getBounds());
+}
+
+/**
+ * Returns the path of the file the mesh was read from.
+ *
+ * @return Path of the file the mesh was read from
+ */
+std::string MeshNode::getFile() const {
+    return file;
+}
+
+/**
+ * Returns the name of the geometry read from a file.
+ *
+ * @param file Path to an OBJ, binary PLY or mesh file
+ * @return Name of geometry that mesh nodes reading the file share
+ * @throws invalid_argument if file is empty
+ */
+std::string MeshNode::getGeometryName(const std::string& file) {
+    if (file.empty()) {
+        throw std::invalid_argument("[MeshNode] File is empty!");
+    }
+    return GEOMETRY_PREFIX + file;
+}
+
+double MeshNode::intersect(const Glycerin::Ray& ray) const {
+    return boundingBox.intersect(ray);
+}
+
+void MeshNode::visit(State& state) {
+
+    // Draw every instance at once if a batch is being flushed
+    const InstanceBatcher* const instanceBatcher = state.getInstanceBatcher();
+    const GLsizei instanceCount = (instanceBatcher == NULL) ? 0 : instanceBatcher->getInstanceCount();
+    const GLsizei indexCount = geometry->getIndexCount();
+    const GLenum indexType = geometry->getIndexType();
+
+    // Record into queue if there is one
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    if (renderQueue != NULL) {
+        const Gloop::VertexArrayObject vao = vaoCache.get(
+                this, renderQueue->getProgram(), state.getGLStateCache(), instanceBatcher);
+        renderQueue->addDrawElements(vao, GL_TRIANGLES, indexCount, indexType, state, instanceCount);
+        return;
+    }
+
+    // Get the VAO for the current program and bind it
+    GLStateCache& glStateCache = state.getGLStateCache();
+    const Gloop::VertexArrayObject vao = vaoCache.get(this, Gloop::Program::current(), glStateCache, instanceBatcher);
+    glStateCache.bindVertexArray(vao);
+    state.bindUniformBuffers();
+
+    // Draw the mesh
+    if (instanceCount > 0) {
+        glDrawElementsInstanced(GL_TRIANGLES, indexCount, indexType, NULL, instanceCount);
+    } else {
+        glDrawElements(GL_TRIANGLES, indexCount, indexType, NULL);
+    }
+}
+
+} /* namespace RapidGL */
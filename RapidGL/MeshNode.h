@@ -0,0 +1,78 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RAPIDGL_MESH_NODE_H
+#define RAPIDGL_MESH_NODE_H
+#include <map>
+#include <string>
+#include <utility>
+#include <gloop/Program.hxx>
+#include <gloop/VertexArrayObject.hxx>
+#include <glycerin/AxisAlignedBoundingBox.hxx>
+#include <glycerin/Ray.hxx>
+#include "RapidGL/common.h"
+#include "RapidGL/AttributeNode.h"
+#include "RapidGL/BoundingBox.h"
+#include "RapidGL/Geometry.h"
+#include "RapidGL/InstanceBatcher.h"
+#include "RapidGL/Intersectable.h"
+#include "RapidGL/Node.h"
+#include "RapidGL/ProgramNode.h"
+#include "RapidGL/RenderQueue.h"
+#include "RapidGL/State.h"
+#include "RapidGL/VertexArrayCache.h"
+namespace RapidGL {
+
+
+/**
+ * Node drawing a triangle mesh read from an OBJ, binary PLY or mesh file.
+ *
+ * OBJ and PLY files are read by `MeshReader` into one interleaved buffer with
+ * _POSITION_, _NORMAL_ and _TEXCOORD0_ regions.  Files ending in _.rmesh_ are
+ * mapped by `MeshFile` and uploaded as they are, with whatever regions they
+ * were written with, which is much faster for large meshes.  Mesh nodes
+ * reading the same file share one `Geometry`, so the file is only read once.
+ */
+class MeshNode : public Node, public Intersectable {
+public:
+// Methods
+    MeshNode(const std::string& file, const std::string& id = "");
+    virtual ~MeshNode();
+    std::string getFile() const;
+    static std::string getGeometryName(const std::string& file);
+    virtual double intersect(const Glycerin::Ray& ray) const;
+    virtual void visit(State& state);
+protected:
+// Methods
+    virtual BoundingBox computeBounds();
+private:
+// Constants
+    static const std::string GEOMETRY_PREFIX;
+// Attributes
+    const std::string file;
+    Geometry* const geometry;
+    const Glycerin::AxisAlignedBoundingBox boundingBox;
+    VertexArrayCache vaoCache;
+// Methods
+    MeshNode(const MeshNode&);
+    MeshNode& operator=(const MeshNode&);
+    static Glycerin::AxisAlignedBoundingBox createBoundingBox(const BoundingBox& bounds);
+    static Geometry* createGeometry(const std::string& name);
+};
+
+} /* namespace RapidGL */
+#endif
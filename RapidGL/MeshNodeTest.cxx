@@ -0,0 +1,179 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <cppunit/extensions/HelperMacros.h>
+#include <glycerin/Ray.hxx>
+#include <m3d/Vec3.h>
+#include <m3d/Vec4.h>
+#include <GL/glfw.h>
+#include "RapidGL/BoundingBox.h"
+#include "RapidGL/Geometry.h"
+#include "RapidGL/MeshFile.h"
+#include "RapidGL/MeshNode.h"
+#include "RapidGL/MeshReader.h"
+
+
+/**
+ * Unit test for `MeshNode`.
+ */
+class MeshNodeTest {
+public:
+
+    // Path of file written for the test
+    static const char* const FILE;
+
+    // Path of mesh file written for the test
+    static const char* const MESH_FILE;
+
+    /**
+     * Writes a tetrahedron to an OBJ file.
+     */
+    static void writeFile() {
+        std::ofstream stream(FILE);
+        stream << "v 0 0 0\n"
+               << "v 1 0 0\n"
+               << "v 0 1 0\n"
+               << "v 0 0 1\n"
+               << "f 1 3 2\n"
+               << "f 1 2 4\n"
+               << "f 1 4 3\n"
+               << "f 2 3 4\n";
+    }
+
+    /**
+     * Ensures `MeshNode::getBounds` encloses the mesh.
+     */
+    void testGetBounds() {
+        writeFile();
+        RapidGL::MeshNode meshNode(FILE);
+        const RapidGL::BoundingBox bounds = meshNode.getBounds();
+        CPPUNIT_ASSERT_EQUAL(0.0, bounds.getMin().x);
+        CPPUNIT_ASSERT_EQUAL(1.0, bounds.getMax().z);
+        std::remove(FILE);
+    }
+
+    /**
+     * Ensures `MeshNode` reads a mesh file written from the same mesh.
+     */
+    void testGetBoundsWithMeshFile() {
+
+        // Convert OBJ file to mesh file
+        writeFile();
+        RapidGL::MeshReader reader;
+        reader.read(FILE);
+        std::remove(FILE);
+        std::ofstream stream(MESH_FILE, std::ios::out | std::ios::binary);
+        RapidGL::MeshFile::write(
+                stream,
+                RapidGL::MeshReader::createBufferLayout(reader.getVertexCount()),
+                &(reader.getVertices()[0]),
+                reader.getIndices(),
+                reader.getBounds());
+        stream.close();
+
+        // Read it
+        RapidGL::MeshNode meshNode(MESH_FILE);
+        const RapidGL::BoundingBox bounds = meshNode.getBounds();
+        CPPUNIT_ASSERT_EQUAL(0.0, bounds.getMin().x);
+        CPPUNIT_ASSERT_EQUAL(1.0, bounds.getMax().z);
+        std::remove(MESH_FILE);
+    }
+
+    /**
+     * Ensures `MeshNode::intersect` hits the box around the mesh.
+     */
+    void testIntersect() {
+        writeFile();
+        RapidGL::MeshNode meshNode(FILE);
+        const Glycerin::Ray ray(M3d::Vec4(0.5, 0.5, 5, 1), M3d::Vec4(0, 0, -1, 0));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(4.0, meshNode.intersect(ray), 1e-6);
+        std::remove(FILE);
+    }
+
+    /**
+     * Ensures mesh nodes reading the same file share geometry.
+     */
+    void testMeshNodeShareGeometry() {
+        writeFile();
+        RapidGL::MeshNode* first = new RapidGL::MeshNode(FILE);
+        std::remove(FILE);
+        RapidGL::MeshNode* second = new RapidGL::MeshNode(FILE, "foo");
+        CPPUNIT_ASSERT_EQUAL(2, RapidGL::Geometry::getReferenceCount(RapidGL::MeshNode::getGeometryName(FILE)));
+        CPPUNIT_ASSERT_EQUAL(std::string("foo"), second->getId());
+        delete first;
+        delete second;
+        CPPUNIT_ASSERT_EQUAL(0, RapidGL::Geometry::getReferenceCount(RapidGL::MeshNode::getGeometryName(FILE)));
+    }
+
+    /**
+     * Ensures `MeshNode` constructor throws if the file is empty.
+     */
+    void testMeshNodeWithEmptyFile() {
+        CPPUNIT_ASSERT_THROW(RapidGL::MeshNode(""), std::invalid_argument);
+    }
+
+    /**
+     * Ensures `MeshNode` constructor throws if the file doesn't exist.
+     */
+    void testMeshNodeWithMissingFile() {
+        CPPUNIT_ASSERT_THROW(RapidGL::MeshNode("MeshNodeTest-missing.obj"), std::runtime_error);
+    }
+};
+
+const char* const MeshNodeTest::FILE = "MeshNodeTest.obj";
+const char* const MeshNodeTest::MESH_FILE = "MeshNodeTest.rmesh";
+
+int main(int argc, char* argv[]) {
+
+    // Initialize
+    if (!glfwInit()) {
+        throw std::runtime_error("Could not initialize GLFW!");
+    }
+
+    // Open window
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MAJOR, 3);
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MINOR, 2);
+    glfwOpenWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (!glfwOpenWindow(512, 512, 0, 0, 0, 0, 0, 0, GLFW_WINDOW)) {
+        throw std::runtime_error("Could not open window!");
+    }
+
+    // Run test
+    try {
+        MeshNodeTest test;
+        test.testGetBounds();
+        test.testGetBoundsWithMeshFile();
+        test.testIntersect();
+        test.testMeshNodeShareGeometry();
+        test.testMeshNodeWithEmptyFile();
+        test.testMeshNodeWithMissingFile();
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        throw;
+    }
+
+    // Exit
+    glfwTerminate();
+    return 0;
+}
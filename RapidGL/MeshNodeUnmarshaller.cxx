@@ -0,0 +1,59 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include "RapidGL/MeshNodeUnmarshaller.h"
+namespace RapidGL {
+
+/**
+ * Constructs a `MeshNodeUnmarshaller`.
+ */
+MeshNodeUnmarshaller::MeshNodeUnmarshaller() {
+    // empty
+}
+
+/**
+ * Destructs a `MeshNodeUnmarshaller`.
+ */
+MeshNodeUnmarshaller::~MeshNodeUnmarshaller() {
+    // empty
+}
+
+/**
+ * Returns the value of the _file_ attribute.
+ *
+ * @param attributes Attributes to look in
+ * @return Value of _file_ attribute
+ * @throws runtime_error if _file_ attribute is unspecified
+ */
+std::string MeshNodeUnmarshaller::getFile(const AttributeView& attributes) {
+    const std::string value = findValue(attributes, "file");
+    if (value.empty()) {
+        throw std::runtime_error("[MeshNodeUnmarshaller] File is unspecified!");
+    } else {
+        return value;
+    }
+}
+
+Node* MeshNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
+    const std::string file = getFile(attributes);
+    const std::string id = findValue(attributes, "id");
+    return new MeshNode(file, id);
+}
+
+} /* namespace RapidGL */
@@ -0,0 +1,105 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <cppunit/extensions/HelperMacros.h>
+#include <GL/glfw.h>
+#include "RapidGL/MeshNode.h"
+#include "RapidGL/MeshNodeUnmarshaller.h"
+#include "RapidGL/Node.h"
+
+
+/**
+ * Unit test for `MeshNodeUnmarshaller`.
+ */
+class MeshNodeUnmarshallerTest {
+public:
+
+    // Instance to use for testing
+    RapidGL::MeshNodeUnmarshaller unmarshaller;
+
+    /**
+     * Ensures `MeshNodeUnmarshaller::unmarshal` works correctly.
+     */
+    void testUnmarshal() {
+
+        // Write file
+        const std::string file = "MeshNodeUnmarshallerTest.obj";
+        std::ofstream stream(file.c_str());
+        stream << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+        stream.close();
+
+        // Unmarshal
+        std::map<std::string,std::string> attributes;
+        attributes["id"] = "foo";
+        attributes["file"] = file;
+        RapidGL::Node* node = unmarshaller.unmarshal(attributes);
+        std::remove(file.c_str());
+
+        // Check
+        RapidGL::MeshNode* meshNode = dynamic_cast<RapidGL::MeshNode*>(node);
+        CPPUNIT_ASSERT(meshNode != NULL);
+        CPPUNIT_ASSERT_EQUAL(std::string("foo"), meshNode->getId());
+        CPPUNIT_ASSERT_EQUAL(file, meshNode->getFile());
+        delete node;
+    }
+
+    /**
+     * Ensures `MeshNodeUnmarshaller::unmarshal` throws if file is unspecified.
+     */
+    void testUnmarshalWithoutFile() {
+        std::map<std::string,std::string> attributes;
+        CPPUNIT_ASSERT_THROW(unmarshaller.unmarshal(attributes), std::runtime_error);
+    }
+};
+
+int main(int argc, char* argv[]) {
+
+    // Initialize GLFW
+    if (!glfwInit()) {
+        throw std::runtime_error("Could not initialize GLFW!");
+    }
+
+    // Open window
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MAJOR, 3);
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MINOR, 2);
+    glfwOpenWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (!glfwOpenWindow(512, 512, 0, 0, 0, 0, 0, 0, GLFW_WINDOW)) {
+        throw std::runtime_error("Could not open GLFW window!");
+    }
+
+    // Run test
+    try {
+        MeshNodeUnmarshallerTest test;
+        test.testUnmarshal();
+        test.testUnmarshalWithoutFile();
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        throw;
+    }
+
+    // Exit
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,773 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <stdint.h>
+#include <glycerin/BufferLayoutBuilder.hxx>
+#include <m3d/Vec3.h>
+#include <Poco/Path.h>
+#include <Poco/String.h>
+#include "RapidGL/MeshReader.h"
+namespace RapidGL {
+
+/**
+ * Constructs a `MeshReader`.
+ */
+MeshReader::MeshReader() : slotsUsed(0) {
+    // empty
+}
+
+/**
+ * Destructs a `MeshReader`.
+ */
+MeshReader::~MeshReader() {
+    // empty
+}
+
+/**
+ * Adds the polygon read last as triangles sharing its first vertex.
+ *
+ * @throws runtime_error if polygon has fewer than three vertices
+ */
+void MeshReader::addPolygon() {
+    if (polygon.size() < 3) {
+        throw std::runtime_error("[MeshReader] Face has fewer than three vertices!");
+    }
+    for (size_t i = 2; i < polygon.size(); ++i) {
+        indices.push_back(polygon[0]);
+        indices.push_back(polygon[i - 1]);
+        indices.push_back(polygon[i]);
+    }
+}
+
+/**
+ * Returns the index of the vertex made from OBJ attributes, making it if it hasn't been made yet.
+ *
+ * @param position Index of position
+ * @param coord Index of texture coordinate, or `-1` for none
+ * @param normal Index of normal, or `-1` for none
+ * @return Index of vertex
+ */
+GLuint MeshReader::addVertex(const int position, const int coord, const int normal) {
+
+    // Keep table at most half full
+    if ((slotsUsed + 1) * 2 > slots.size()) {
+        resizeSlots(std::max((size_t) MIN_SLOT_COUNT, slots.size() * 2));
+    }
+
+    // Look for vertex
+    const size_t mask = slots.size() - 1;
+    size_t i = hash(position, coord, normal) & mask;
+    while (slots[i].position >= 0) {
+        const Slot& slot = slots[i];
+        if ((slot.position == position) && (slot.coord == coord) && (slot.normal == normal)) {
+            return slot.index;
+        }
+        i = (i + 1) & mask;
+    }
+
+    // Make it
+    const GLuint index = vertices.size() / VERTEX_SIZE;
+    vertices.resize(vertices.size() + VERTEX_SIZE, 0.0f);
+    GLfloat* const vertex = &vertices[index * VERTEX_SIZE];
+    std::copy(&positions[position * 3], &positions[position * 3] + 3, vertex + POSITION_OFFSET);
+    if (normal >= 0) {
+        std::copy(&normals[normal * 3], &normals[normal * 3] + 3, vertex + NORMAL_OFFSET);
+    }
+    if (coord >= 0) {
+        std::copy(&coords[coord * 2], &coords[coord * 2] + 2, vertex + TEXCOORD_OFFSET);
+    }
+
+    // Remember it
+    const Slot slot = { position, coord, normal, index };
+    slots[i] = slot;
+    ++slotsUsed;
+    return index;
+}
+
+/**
+ * Forgets the last mesh read.
+ */
+void MeshReader::clear() {
+    vertices.clear();
+    indices.clear();
+    bounds = BoundingBox();
+    positions.clear();
+    coords.clear();
+    normals.clear();
+    slots.clear();
+    slotsUsed = 0;
+}
+
+/**
+ * Computes the box enclosing the positions of the vertices.
+ */
+void MeshReader::computeBounds() {
+    const size_t count = vertices.size() / VERTEX_SIZE;
+    for (size_t i = 0; i < count; ++i) {
+        const GLfloat* const p = &vertices[i * VERTEX_SIZE + POSITION_OFFSET];
+        const M3d::Vec3 point(p[0], p[1], p[2]);
+        bounds.add(BoundingBox(point, point));
+    }
+}
+
+/**
+ * Gives each vertex the average of the normals of the triangles around it, weighted by their areas.
+ */
+void MeshReader::computeNormals() {
+
+    // Reset normals
+    const size_t count = vertices.size() / VERTEX_SIZE;
+    for (size_t i = 0; i < count; ++i) {
+        std::fill_n(&vertices[i * VERTEX_SIZE + NORMAL_OFFSET], 3, 0.0f);
+    }
+
+    // Add normal of each triangle to its vertices, where its length is twice the triangle's area
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        const GLfloat* const a = &vertices[indices[i + 0] * VERTEX_SIZE + POSITION_OFFSET];
+        const GLfloat* const b = &vertices[indices[i + 1] * VERTEX_SIZE + POSITION_OFFSET];
+        const GLfloat* const c = &vertices[indices[i + 2] * VERTEX_SIZE + POSITION_OFFSET];
+        const GLfloat u[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+        const GLfloat v[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+        const GLfloat n[3] = { u[1] * v[2] - u[2] * v[1],
+                               u[2] * v[0] - u[0] * v[2],
+                               u[0] * v[1] - u[1] * v[0] };
+        for (int j = 0; j < 3; ++j) {
+            GLfloat* const normal = &vertices[indices[i + j] * VERTEX_SIZE + NORMAL_OFFSET];
+            normal[0] += n[0];
+            normal[1] += n[1];
+            normal[2] += n[2];
+        }
+    }
+
+    // Normalize
+    for (size_t i = 0; i < count; ++i) {
+        GLfloat* const normal = &vertices[i * VERTEX_SIZE + NORMAL_OFFSET];
+        const GLfloat length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (length > 0) {
+            normal[0] /= length;
+            normal[1] /= length;
+            normal[2] /= length;
+        }
+    }
+}
+
+/**
+ * Creates the layout of vertices returned by `getVertices`.
+ *
+ * @param count Number of vertices
+ * @return Interleaved layout with _POSITION_, _NORMAL_ and _TEXCOORD0_ regions
+ */
+Glycerin::BufferLayout MeshReader::createBufferLayout(const GLsizei count) {
+    return Glycerin::BufferLayoutBuilder()
+            .count(count)
+            .interleaved(true)
+            .components(3)
+            .region("POSITION")
+            .region("NORMAL")
+            .components(2)
+            .region("TEXCOORD0")
+            .build();
+}
+
+/**
+ * Returns where a property of a PLY vertex goes in a vertex.
+ *
+ * @param name Name of property, e.g. _x_ or _nx_
+ * @return Offset in a vertex, or `-1` if the property isn't used
+ */
+int MeshReader::findPlyOffset(const std::string& name) {
+    if (name == "x") {
+        return POSITION_OFFSET;
+    } else if (name == "y") {
+        return POSITION_OFFSET + 1;
+    } else if (name == "z") {
+        return POSITION_OFFSET + 2;
+    } else if (name == "nx") {
+        return NORMAL_OFFSET;
+    } else if (name == "ny") {
+        return NORMAL_OFFSET + 1;
+    } else if (name == "nz") {
+        return NORMAL_OFFSET + 2;
+    } else if ((name == "u") || (name == "s") || (name == "texture_u")) {
+        return TEXCOORD_OFFSET;
+    } else if ((name == "v") || (name == "t") || (name == "texture_v")) {
+        return TEXCOORD_OFFSET + 1;
+    } else {
+        return -1;
+    }
+}
+
+/**
+ * Finishes reading a mesh, computing what the file didn't have and freeing what is no longer needed.
+ *
+ * @param hasNormals Whether the file had normals
+ * @throws runtime_error if the file had no faces
+ */
+void MeshReader::finish(const bool hasNormals) {
+
+    if (indices.empty()) {
+        throw std::runtime_error("[MeshReader] File has no faces!");
+    }
+
+    // Compute normals and bounds
+    if (!hasNormals) {
+        computeNormals();
+    }
+    computeBounds();
+
+    // Free attributes and table
+    std::vector<GLfloat>().swap(positions);
+    std::vector<GLfloat>().swap(coords);
+    std::vector<GLfloat>().swap(normals);
+    std::vector<Slot>().swap(slots);
+    slotsUsed = 0;
+}
+
+/**
+ * Returns the box enclosing the positions of the vertices read last.
+ *
+ * @return Box enclosing the positions of the vertices read last
+ */
+BoundingBox MeshReader::getBounds() const {
+    return bounds;
+}
+
+/**
+ * Returns the indices read last, with three for each triangle.
+ *
+ * @return Indices read last
+ */
+const std::vector<GLuint>& MeshReader::getIndices() const {
+    return indices;
+}
+
+/**
+ * Returns the number of vertices read last.
+ *
+ * @return Number of vertices read last
+ */
+GLsizei MeshReader::getVertexCount() const {
+    return vertices.size() / VERTEX_SIZE;
+}
+
+/**
+ * Returns the vertices read last, laid out as described by `createBufferLayout`.
+ *
+ * @return Vertices read last
+ */
+const std::vector<GLfloat>& MeshReader::getVertices() const {
+    return vertices;
+}
+
+/**
+ * Combines the indices of OBJ attributes into a hash code.
+ */
+size_t MeshReader::hash(const int position, const int coord, const int normal) {
+    return (((size_t) position) * 73856093U) ^ (((size_t) coord) * 19349663U) ^ (((size_t) normal) * 83492791U);
+}
+
+/**
+ * Parses an index into a list of OBJ attributes.
+ *
+ * @param str String to parse, starting with the index
+ * @param end Set to the character after the index
+ * @param count Number of attributes in the list so far
+ * @return Index from zero, converted from one-based or relative to the end of the list
+ * @throws runtime_error if index could not be parsed or is out of range
+ */
+int MeshReader::parseIndex(const char* const str, char** const end, const size_t count) {
+    const long value = std::strtol(str, end, 10);
+    if (*end == str) {
+        throw std::runtime_error("[MeshReader] Could not parse index!");
+    }
+    const long index = (value < 0) ? ((long) count) + value : value - 1;
+    if ((index < 0) || (index >= (long) count)) {
+        throw std::runtime_error("[MeshReader] Index out of range!");
+    }
+    return (int) index;
+}
+
+/**
+ * Parses the vertices of an OBJ face and adds it.
+ *
+ * @param str Rest of the line after _f_
+ * @throws runtime_error if a vertex could not be parsed
+ */
+void MeshReader::parseObjFace(const char* str) {
+
+    const size_t positionCount = positions.size() / 3;
+    const size_t coordCount = coords.size() / 2;
+    const size_t normalCount = normals.size() / 3;
+
+    polygon.clear();
+    while (true) {
+
+        // Skip to next vertex
+        while (std::isspace(*str)) {
+            ++str;
+        }
+        if ((*str == '\0') || (*str == '#')) {
+            break;
+        }
+
+        // Parse `position`, `position/coord`, `position//normal` or `position/coord/normal`
+        char* end;
+        const int position = parseIndex(str, &end, positionCount);
+        int coord = -1;
+        int normal = -1;
+        str = end;
+        if (*str == '/') {
+            ++str;
+            if (*str != '/') {
+                coord = parseIndex(str, &end, coordCount);
+                str = end;
+            }
+            if (*str == '/') {
+                ++str;
+                normal = parseIndex(str, &end, normalCount);
+                str = end;
+            }
+        }
+        polygon.push_back(addVertex(position, coord, normal));
+    }
+
+    addPolygon();
+}
+
+/**
+ * Parses the numbers of an OBJ attribute.
+ *
+ * @param str Rest of the line after the keyword
+ * @param values List to add numbers to
+ * @param count Number of numbers to add, where any missing after the first are zero
+ * @throws runtime_error if the first number could not be parsed
+ */
+void MeshReader::parseObjFloats(const char* str, std::vector<GLfloat>& values, const int count) {
+    for (int i = 0; i < count; ++i) {
+        char* end;
+        const double value = std::strtod(str, &end);
+        if (end == str) {
+            if (i == 0) {
+                throw std::runtime_error("[MeshReader] Could not parse number!");
+            }
+            values.push_back(0.0f);
+        } else {
+            values.push_back((GLfloat) value);
+        }
+        str = end;
+    }
+}
+
+/**
+ * Converts the name of a PLY type to an enumeration.
+ *
+ * @param str Name of type, e.g. _float_ or _float32_
+ * @return Corresponding enumeration
+ * @throws runtime_error if type is not recognized
+ */
+MeshReader::PlyType MeshReader::parsePlyType(const std::string& str) {
+    if ((str == "char") || (str == "int8")) {
+        return PLY_INT8;
+    } else if ((str == "uchar") || (str == "uint8")) {
+        return PLY_UINT8;
+    } else if ((str == "short") || (str == "int16")) {
+        return PLY_INT16;
+    } else if ((str == "ushort") || (str == "uint16")) {
+        return PLY_UINT16;
+    } else if ((str == "int") || (str == "int32")) {
+        return PLY_INT32;
+    } else if ((str == "uint") || (str == "uint32")) {
+        return PLY_UINT32;
+    } else if ((str == "float") || (str == "float32")) {
+        return PLY_FLOAT32;
+    } else if ((str == "double") || (str == "float64")) {
+        return PLY_FLOAT64;
+    } else {
+        throw std::runtime_error("[MeshReader] PLY type unrecognized!");
+    }
+}
+
+/**
+ * Reads a mesh from a file, choosing the format by its extension.
+ *
+ * @param file Path to an _.obj_ or _.ply_ file
+ * @throws runtime_error if file could not be opened, is not an OBJ or PLY file, or is invalid
+ */
+void MeshReader::read(const std::string& file) {
+    const Poco::Path path(file);
+    const std::string extension = path.getExtension();
+    if (Poco::icompare(extension, "obj") == 0) {
+        std::ifstream stream(file.c_str());
+        if (!stream) {
+            throw std::runtime_error("[MeshReader] Could not open file!");
+        }
+        readObj(stream);
+    } else if (Poco::icompare(extension, "ply") == 0) {
+        std::ifstream stream(file.c_str(), std::ios::in | std::ios::binary);
+        if (!stream) {
+            throw std::runtime_error("[MeshReader] Could not open file!");
+        }
+        readPly(stream);
+    } else {
+        throw std::runtime_error("[MeshReader] File type unrecognized!");
+    }
+}
+
+/**
+ * Reads a mesh in the OBJ format.
+ *
+ * Only positions, texture coordinates, normals and faces are used.
+ *
+ * @param stream Stream to read from
+ * @throws runtime_error if stream is not a valid OBJ file with at least one face
+ */
+void MeshReader::readObj(std::istream& stream) {
+
+    clear();
+
+    std::string line;
+    while (std::getline(stream, line)) {
+        const char* str = line.c_str();
+        while ((*str == ' ') || (*str == '\t')) {
+            ++str;
+        }
+        if (str[0] == 'v') {
+            if (std::isspace(str[1])) {
+                parseObjFloats(str + 2, positions, 3);
+            } else if ((str[1] == 't') && std::isspace(str[2])) {
+                parseObjFloats(str + 3, coords, 2);
+            } else if ((str[1] == 'n') && std::isspace(str[2])) {
+                parseObjFloats(str + 3, normals, 3);
+            }
+        } else if ((str[0] == 'f') && std::isspace(str[1])) {
+            parseObjFace(str + 2);
+        }
+    }
+
+    finish(!normals.empty());
+}
+
+/**
+ * Reads a mesh in the binary PLY format.
+ *
+ * Uses the _x_, _y_, _z_, _nx_, _ny_, _nz_ and _u_, _s_ or _texture_u_ and
+ * _v_, _t_ or _texture_v_ properties of the _vertex_ element, and the
+ * _vertex_indices_ or _vertex_index_ property of the _face_ element.  Other
+ * elements and properties are skipped.
+ *
+ * @param stream Stream to read from, opened in binary mode
+ * @throws runtime_error if stream is not a valid binary PLY file with at least one face
+ */
+void MeshReader::readPly(std::istream& stream) {
+
+    clear();
+
+    // Read header and check if bytes need to be swapped
+    bool bigEndian;
+    const std::vector<PlyElement> elements = readPlyHeader(stream, bigEndian);
+    const unsigned short one = 1;
+    const bool swap = ((*((const unsigned char*) &one) == 0) != bigEndian);
+
+    bool hasNormals = false;
+    for (std::vector<PlyElement>::const_iterator element = elements.begin(); element != elements.end(); ++element) {
+        const std::vector<PlyProperty>& properties = element->properties;
+        if (element->name == "vertex") {
+
+            // Find where each property goes in a vertex
+            std::vector<int> offsets;
+            for (std::vector<PlyProperty>::const_iterator it = properties.begin(); it != properties.end(); ++it) {
+                const int offset = (it->countType == PLY_NONE) ? findPlyOffset(it->name) : -1;
+                hasNormals = hasNormals || ((offset >= NORMAL_OFFSET) && (offset < TEXCOORD_OFFSET));
+                offsets.push_back(offset);
+            }
+
+            // Read vertices
+            const size_t first = vertices.size() / VERTEX_SIZE;
+            for (size_t i = 0; i < element->count; ++i) {
+                vertices.resize(vertices.size() + VERTEX_SIZE, 0.0f);
+                GLfloat* const vertex = &vertices[(first + i) * VERTEX_SIZE];
+                for (size_t j = 0; j < properties.size(); ++j) {
+                    const PlyProperty& property = properties[j];
+                    if (property.countType != PLY_NONE) {
+                        const size_t count = readPlyCount(stream, property.countType, swap);
+                        for (size_t k = 0; (k < count) && stream; ++k) {
+                            readPlyValue(stream, property.type, swap);
+                        }
+                    } else if (offsets[j] >= 0) {
+                        vertex[offsets[j]] = (GLfloat) readPlyValue(stream, property.type, swap);
+                    } else {
+                        readPlyValue(stream, property.type, swap);
+                    }
+                }
+                if (!stream) {
+                    throw std::runtime_error("[MeshReader] Unexpected end of file!");
+                }
+            }
+        } else {
+
+            // Read faces, or skip other elements
+            const bool isFace = (element->name == "face");
+            const double vertexCount = vertices.size() / VERTEX_SIZE;
+            for (size_t i = 0; i < element->count; ++i) {
+                for (std::vector<PlyProperty>::const_iterator it = properties.begin(); it != properties.end(); ++it) {
+                    const bool isIndices = isFace && ((it->name == "vertex_indices") || (it->name == "vertex_index"));
+                    if (it->countType == PLY_NONE) {
+                        readPlyValue(stream, it->type, swap);
+                        continue;
+                    }
+                    const size_t count = readPlyCount(stream, it->countType, swap);
+                    polygon.clear();
+                    for (size_t k = 0; (k < count) && stream; ++k) {
+                        const double index = readPlyValue(stream, it->type, swap);
+                        if (isIndices) {
+                            if ((index < 0) || (index >= vertexCount)) {
+                                throw std::runtime_error("[MeshReader] Index out of range!");
+                            }
+                            polygon.push_back((GLuint) index);
+                        }
+                    }
+                    if (!stream) {
+                        throw std::runtime_error("[MeshReader] Unexpected end of file!");
+                    } else if (isIndices) {
+                        addPolygon();
+                    }
+                }
+            }
+        }
+    }
+
+    finish(hasNormals);
+}
+
+/**
+ * Reads the number of values in a list property of a PLY file.
+ *
+ * Values after the count are read one at a time until the stream ends, so a
+ * corrupt but positive count only costs as long as the rest of the file.
+ *
+ * @param stream Stream to read from
+ * @param type Type of count
+ * @param swap Whether to reverse the order of the bytes
+ * @return Number of values in list, or zero if the stream ended
+ * @throws runtime_error if count is negative
+ */
+size_t MeshReader::readPlyCount(std::istream& stream, const PlyType type, const bool swap) {
+    const double count = readPlyValue(stream, type, swap);
+    if (count < 0) {
+        throw std::runtime_error("[MeshReader] List count is negative!");
+    }
+    return (size_t) count;
+}
+
+/**
+ * Reads the header of a PLY file.
+ *
+ * @param stream Stream to read from
+ * @param bigEndian Set to whether values are big-endian
+ * @return Elements declared in the header, in order
+ * @throws runtime_error if the header is invalid or the file is not binary
+ */
+std::vector<MeshReader::PlyElement> MeshReader::readPlyHeader(std::istream& stream, bool& bigEndian) {
+
+    std::vector<PlyElement> elements;
+    bool hasFormat = false;
+    bool hasEnd = false;
+    bool isFirst = true;
+    std::string line;
+    while (!hasEnd && std::getline(stream, line)) {
+
+        // Split into keyword and the rest
+        if (!line.empty() && (line[line.size() - 1] == '\r')) {
+            line.erase(line.size() - 1);
+        }
+        std::istringstream words(line);
+        std::string keyword;
+        words >> keyword;
+
+        // Check magic number
+        if (isFirst) {
+            if (keyword != "ply") {
+                throw std::runtime_error("[MeshReader] File is not a PLY file!");
+            }
+            isFirst = false;
+            continue;
+        }
+
+        if (keyword == "format") {
+            std::string format;
+            words >> format;
+            if (format == "binary_little_endian") {
+                bigEndian = false;
+            } else if (format == "binary_big_endian") {
+                bigEndian = true;
+            } else if (format == "ascii") {
+                throw std::runtime_error("[MeshReader] ASCII PLY files are not supported!");
+            } else {
+                throw std::runtime_error("[MeshReader] PLY format unrecognized!");
+            }
+            hasFormat = true;
+        } else if (keyword == "element") {
+            PlyElement element;
+            words >> element.name >> element.count;
+            if (!words) {
+                throw std::runtime_error("[MeshReader] Element is invalid!");
+            }
+            elements.push_back(element);
+        } else if (keyword == "property") {
+            if (elements.empty()) {
+                throw std::runtime_error("[MeshReader] Property is outside an element!");
+            }
+            PlyProperty property;
+            std::string type;
+            words >> type;
+            if (type == "list") {
+                std::string countType;
+                words >> countType >> type;
+                property.countType = parsePlyType(countType);
+            } else {
+                property.countType = PLY_NONE;
+            }
+            property.type = parsePlyType(type);
+            words >> property.name;
+            if (!words) {
+                throw std::runtime_error("[MeshReader] Property is invalid!");
+            }
+            elements.back().properties.push_back(property);
+        } else if (keyword == "end_header") {
+            hasEnd = true;
+        }
+    }
+
+    if (!hasEnd) {
+        throw std::runtime_error("[MeshReader] Header is incomplete!");
+    } else if (!hasFormat) {
+        throw std::runtime_error("[MeshReader] Format is unspecified!");
+    }
+    return elements;
+}
+
+/**
+ * Reads a binary value from a PLY file.
+ *
+ * @param stream Stream to read from
+ * @param type Type of value
+ * @param swap Whether to reverse the order of the bytes
+ * @return Value read, or zero if the stream ended
+ */
+double MeshReader::readPlyValue(std::istream& stream, const PlyType type, const bool swap) {
+
+    // Read bytes
+    size_t size;
+    switch (type) {
+    case PLY_INT8:
+    case PLY_UINT8:
+        size = 1;
+        break;
+    case PLY_INT16:
+    case PLY_UINT16:
+        size = 2;
+        break;
+    case PLY_FLOAT64:
+        size = 8;
+        break;
+    default:
+        size = 4;
+        break;
+    }
+    unsigned char bytes[8] = { 0 };
+    stream.read((char*) bytes, size);
+    if (swap) {
+        std::reverse(bytes, bytes + size);
+    }
+
+    // Convert to a number
+    switch (type) {
+    case PLY_INT8:
+        return (signed char) bytes[0];
+    case PLY_UINT8:
+        return bytes[0];
+    case PLY_INT16: {
+        int16_t value;
+        std::memcpy(&value, bytes, size);
+        return value;
+    }
+    case PLY_UINT16: {
+        uint16_t value;
+        std::memcpy(&value, bytes, size);
+        return value;
+    }
+    case PLY_INT32: {
+        int32_t value;
+        std::memcpy(&value, bytes, size);
+        return value;
+    }
+    case PLY_UINT32: {
+        uint32_t value;
+        std::memcpy(&value, bytes, size);
+        return value;
+    }
+    case PLY_FLOAT32: {
+        float value;
+        std::memcpy(&value, bytes, size);
+        return value;
+    }
+    case PLY_FLOAT64: {
+        double value;
+        std::memcpy(&value, bytes, size);
+        return value;
+    }
+    default:
+        throw std::runtime_error("[MeshReader] PLY type unrecognized!");
+    }
+}
+
+/**
+ * Changes the size of the table of vertices made from OBJ attributes, keeping what it holds.
+ *
+ * @param count Number of slots, which is a power of two
+ */
+void MeshReader::resizeSlots(const size_t count) {
+
+    // Start with empty table
+    std::vector<Slot> old;
+    old.swap(slots);
+    const Slot empty = { -1, -1, -1, 0 };
+    slots.assign(count, empty);
+
+    // Put back each vertex
+    const size_t mask = count - 1;
+    for (std::vector<Slot>::const_iterator it = old.begin(); it != old.end(); ++it) {
+        if (it->position >= 0) {
+            size_t i = hash(it->position, it->coord, it->normal) & mask;
+            while (slots[i].position >= 0) {
+                i = (i + 1) & mask;
+            }
+            slots[i] = *it;
+        }
+    }
+}
+
+} /* namespace RapidGL */
@@ -0,0 +1,136 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RAPIDGL_MESH_READER_H
+#define RAPIDGL_MESH_READER_H
+#include <istream>
+#include <string>
+#include <vector>
+#include <glycerin/BufferLayout.hxx>
+#include "RapidGL/common.h"
+#include "RapidGL/BoundingBox.h"
+namespace RapidGL {
+
+
+/**
+ * Utility for reading triangle meshes from OBJ and binary PLY files.
+ *
+ * Files are read a line or a record at a time, and each vertex is looked up
+ * in a hash table as it is read, so reading takes time linear in the size of
+ * the file and no more memory than the file's own attributes and the result.
+ * Vertices of an OBJ file that share a position, texture coordinate and
+ * normal are merged, while PLY vertices are used as they are.  Polygons are
+ * split into triangles as fans.
+ *
+ * The result is one array of vertices, each with a position, a normal and a
+ * texture coordinate interleaved as described by `createBufferLayout`, and an
+ * array of indices with three for each triangle.  If the file has no normals,
+ * each vertex is given the average of the normals of the triangles around it.
+ * Missing texture coordinates are zero.
+ */
+class MeshReader {
+public:
+// Methods
+    MeshReader();
+    virtual ~MeshReader();
+    static Glycerin::BufferLayout createBufferLayout(GLsizei count);
+    BoundingBox getBounds() const;
+    const std::vector<GLuint>& getIndices() const;
+    GLsizei getVertexCount() const;
+    const std::vector<GLfloat>& getVertices() const;
+    void read(const std::string& file);
+    void readObj(std::istream& stream);
+    void readPly(std::istream& stream);
+// Constants
+    static const int POSITION_OFFSET = 0;
+    static const int NORMAL_OFFSET = 3;
+    static const int TEXCOORD_OFFSET = 6;
+    static const int VERTEX_SIZE = 8;
+private:
+// Types
+    /**
+     * Type of a value in a PLY file.
+     */
+    enum PlyType {
+        PLY_NONE,
+        PLY_INT8,
+        PLY_UINT8,
+        PLY_INT16,
+        PLY_UINT16,
+        PLY_INT32,
+        PLY_UINT32,
+        PLY_FLOAT32,
+        PLY_FLOAT64
+    };
+    /**
+     * Property of an element in a PLY file.
+     */
+    struct PlyProperty {
+        std::string name;
+        PlyType type;
+        PlyType countType;
+    };
+    /**
+     * Element declared in the header of a PLY file.
+     */
+    struct PlyElement {
+        std::string name;
+        size_t count;
+        std::vector<PlyProperty> properties;
+    };
+    /**
+     * Entry in the table of vertices already made from OBJ attributes.
+     */
+    struct Slot {
+        int position;
+        int coord;
+        int normal;
+        GLuint index;
+    };
+// Constants
+    static const size_t MIN_SLOT_COUNT = 1024;
+// Attributes
+    std::vector<GLfloat> vertices;
+    std::vector<GLuint> indices;
+    BoundingBox bounds;
+    std::vector<GLfloat> positions;
+    std::vector<GLfloat> coords;
+    std::vector<GLfloat> normals;
+    std::vector<Slot> slots;
+    size_t slotsUsed;
+    std::vector<GLuint> polygon;
+// Methods
+    void addPolygon();
+    GLuint addVertex(int position, int coord, int normal);
+    void clear();
+    void computeBounds();
+    void computeNormals();
+    static int findPlyOffset(const std::string& name);
+    void finish(bool hasNormals);
+    static size_t hash(int position, int coord, int normal);
+    static int parseIndex(const char* str, char** end, size_t count);
+    static PlyType parsePlyType(const std::string& str);
+    void parseObjFace(const char* str);
+    static void parseObjFloats(const char* str, std::vector<GLfloat>& values, int count);
+    static size_t readPlyCount(std::istream& stream, PlyType type, bool swap);
+    static std::vector<PlyElement> readPlyHeader(std::istream& stream, bool& bigEndian);
+    static double readPlyValue(std::istream& stream, PlyType type, bool swap);
+    void resizeSlots(size_t count);
+};
+
+} /* namespace RapidGL */
+#endif
@@ -0,0 +1,294 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "RapidGL/MeshReader.h"
+
+
+/**
+ * Unit test for `MeshReader`.
+ */
+class MeshReaderTest : public CppUnit::TestFixture {
+public:
+
+    // Instance to use for testing
+    RapidGL::MeshReader reader;
+
+    /**
+     * Returns the PLY format matching the byte order of this machine.
+     */
+    static std::string getNativeFormat() {
+        const unsigned short one = 1;
+        return (*((const unsigned char*) &one) == 1) ? "binary_little_endian" : "binary_big_endian";
+    }
+
+    /**
+     * Writes the bytes of a value to a stream in the byte order of this machine.
+     *
+     * @param stream Stream to write to
+     * @param value Value to write
+     */
+    template<typename T>
+    static void writeValue(std::ostream& stream, const T value) {
+        stream.write((const char*) &value, sizeof(T));
+    }
+
+    /**
+     * Makes a binary PLY file with a square of two triangles, with normals and coordinates.
+     *
+     * @param withFace Whether to add the face
+     * @param countType Type of the face's vertex count, either _uchar_ or _int_
+     * @param count Vertex count to store for the face, which only has four indices
+     * @return Contents of file
+     */
+    static std::string makePly(const bool withFace = true,
+                               const std::string& countType = "uchar",
+                               const int count = 4) {
+
+        // Header
+        std::ostringstream stream;
+        stream << "ply\n"
+               << "format " << getNativeFormat() << " 1.0\n"
+               << "comment made for testing\n"
+               << "element vertex 4\n"
+               << "property float x\n"
+               << "property float y\n"
+               << "property float z\n"
+               << "property float nx\n"
+               << "property float ny\n"
+               << "property float nz\n"
+               << "property uchar red\n"
+               << "property float s\n"
+               << "property float t\n"
+               << "element face " << (withFace ? 1 : 0) << "\n"
+               << "property list " << countType << " int vertex_indices\n"
+               << "end_header\n";
+
+        // Vertices
+        const float points[4][2] = { { -1, -1 }, { +1, -1 }, { +1, +1 }, { -1, +1 } };
+        for (int i = 0; i < 4; ++i) {
+            writeValue(stream, points[i][0]);
+            writeValue(stream, points[i][1]);
+            writeValue(stream, 0.0f);
+            writeValue(stream, 0.0f);
+            writeValue(stream, 0.0f);
+            writeValue(stream, 1.0f);
+            writeValue(stream, (unsigned char) 255);
+            writeValue(stream, (points[i][0] + 1) / 2);
+            writeValue(stream, (points[i][1] + 1) / 2);
+        }
+
+        // Face
+        if (withFace) {
+            if (countType == "int") {
+                writeValue(stream, count);
+            } else {
+                writeValue(stream, (unsigned char) count);
+            }
+            for (int i = 0; i < 4; ++i) {
+                writeValue(stream, i);
+            }
+        }
+        return stream.str();
+    }
+
+    /**
+     * Ensures `MeshReader::read` throws if the file is not an OBJ or PLY file.
+     */
+    void testReadWithUnknownExtension() {
+        CPPUNIT_ASSERT_THROW(reader.read("mesh.stl"), std::runtime_error);
+    }
+
+    /**
+     * Ensures `MeshReader::readObj` splits a quad into triangles and computes its normals.
+     */
+    void testReadObj() {
+
+        // Read quad without normals
+        std::istringstream stream(
+                "# quad\n"
+                "v -1 -1 0\n"
+                "v +1 -1 0\n"
+                "v +1 +1 0\n"
+                "v -1 +1 0\n"
+                "f 1 2 3 4\n");
+        reader.readObj(stream);
+
+        // Check triangles
+        CPPUNIT_ASSERT_EQUAL((GLsizei) 4, reader.getVertexCount());
+        const std::vector<GLuint>& indices = reader.getIndices();
+        CPPUNIT_ASSERT_EQUAL((size_t) 6, indices.size());
+        CPPUNIT_ASSERT_EQUAL((GLuint) 0, indices[3]);
+        CPPUNIT_ASSERT_EQUAL((GLuint) 2, indices[4]);
+        CPPUNIT_ASSERT_EQUAL((GLuint) 3, indices[5]);
+
+        // Check normal
+        const std::vector<GLfloat>& vertices = reader.getVertices();
+        CPPUNIT_ASSERT_EQUAL(1.0f, vertices[RapidGL::MeshReader::NORMAL_OFFSET + 2]);
+
+        // Check bounds
+        CPPUNIT_ASSERT_EQUAL(-1.0, reader.getBounds().getMin().x);
+        CPPUNIT_ASSERT_EQUAL(+1.0, reader.getBounds().getMax().y);
+    }
+
+    /**
+     * Ensures `MeshReader::readObj` throws if a face refers to a vertex that doesn't exist.
+     */
+    void testReadObjWithIndexOutOfRange() {
+        std::istringstream stream(
+                "v 0 0 0\n"
+                "v 1 0 0\n"
+                "f 1 2 3\n");
+        CPPUNIT_ASSERT_THROW(reader.readObj(stream), std::runtime_error);
+    }
+
+    /**
+     * Ensures `MeshReader::readObj` throws if there are no faces.
+     */
+    void testReadObjWithNoFaces() {
+        std::istringstream stream("v 0 0 0\n");
+        CPPUNIT_ASSERT_THROW(reader.readObj(stream), std::runtime_error);
+    }
+
+    /**
+     * Ensures `MeshReader::readObj` merges vertices with the same attributes and keeps others apart.
+     */
+    void testReadObjWithSharedVertices() {
+
+        // Two triangles sharing an edge, with one corner having a different normal in each
+        std::istringstream stream(
+                "v 0 0 0\r\n"
+                "v 1 0 0\r\n"
+                "v 0 1 0\r\n"
+                "v 1 1 0\r\n"
+                "vt 0 0\r\n"
+                "vt 1 1\r\n"
+                "vn 0 0 1\r\n"
+                "vn 0 1 0\r\n"
+                "f 1/1/1 2/1/1 3/2/1\r\n"
+                "f -3/1/1 -1/2/1 -2/2/2\r\n");
+        reader.readObj(stream);
+
+        // Check vertices were merged
+        CPPUNIT_ASSERT_EQUAL((GLsizei) 5, reader.getVertexCount());
+        const std::vector<GLuint>& indices = reader.getIndices();
+        CPPUNIT_ASSERT_EQUAL((size_t) 6, indices.size());
+        CPPUNIT_ASSERT_EQUAL((GLuint) 1, indices[3]);
+        CPPUNIT_ASSERT_EQUAL((GLuint) 4, indices[5]);
+
+        // Check coordinate and normal of last vertex
+        const std::vector<GLfloat>& vertices = reader.getVertices();
+        const GLfloat* const last = &vertices[4 * RapidGL::MeshReader::VERTEX_SIZE];
+        CPPUNIT_ASSERT_EQUAL(1.0f, last[RapidGL::MeshReader::NORMAL_OFFSET + 1]);
+        CPPUNIT_ASSERT_EQUAL(1.0f, last[RapidGL::MeshReader::TEXCOORD_OFFSET]);
+    }
+
+    /**
+     * Ensures `MeshReader::readPly` reads vertices and faces, skipping other properties.
+     */
+    void testReadPly() {
+
+        std::istringstream stream(makePly());
+        reader.readPly(stream);
+
+        // Check triangles
+        CPPUNIT_ASSERT_EQUAL((GLsizei) 4, reader.getVertexCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 6, reader.getIndices().size());
+
+        // Check last vertex
+        const std::vector<GLfloat>& vertices = reader.getVertices();
+        const GLfloat* const last = &vertices[3 * RapidGL::MeshReader::VERTEX_SIZE];
+        CPPUNIT_ASSERT_EQUAL(-1.0f, last[RapidGL::MeshReader::POSITION_OFFSET]);
+        CPPUNIT_ASSERT_EQUAL(+1.0f, last[RapidGL::MeshReader::POSITION_OFFSET + 1]);
+        CPPUNIT_ASSERT_EQUAL(1.0f, last[RapidGL::MeshReader::NORMAL_OFFSET + 2]);
+        CPPUNIT_ASSERT_EQUAL(0.0f, last[RapidGL::MeshReader::TEXCOORD_OFFSET]);
+        CPPUNIT_ASSERT_EQUAL(1.0f, last[RapidGL::MeshReader::TEXCOORD_OFFSET + 1]);
+    }
+
+    /**
+     * Ensures `MeshReader::readPly` throws for ASCII files.
+     */
+    void testReadPlyWithAscii() {
+        std::istringstream stream(
+                "ply\n"
+                "format ascii 1.0\n"
+                "element vertex 0\n"
+                "end_header\n");
+        CPPUNIT_ASSERT_THROW(reader.readPly(stream), std::runtime_error);
+    }
+
+    /**
+     * Ensures `MeshReader::readPly` throws if a list count is larger than the rest of the file.
+     */
+    void testReadPlyWithLargeCount() {
+        std::istringstream stream(makePly(true, "int", 2000000000));
+        CPPUNIT_ASSERT_THROW(reader.readPly(stream), std::runtime_error);
+    }
+
+    /**
+     * Ensures `MeshReader::readPly` throws if a list count is negative.
+     */
+    void testReadPlyWithNegativeCount() {
+        std::istringstream stream(makePly(true, "int", -4));
+        CPPUNIT_ASSERT_THROW(reader.readPly(stream), std::runtime_error);
+    }
+
+    /**
+     * Ensures `MeshReader::readPly` throws if there are no faces.
+     */
+    void testReadPlyWithNoFaces() {
+        std::istringstream stream(makePly(false));
+        CPPUNIT_ASSERT_THROW(reader.readPly(stream), std::runtime_error);
+    }
+
+    /**
+     * Ensures `MeshReader::readPly` throws if the file ends early.
+     */
+    void testReadPlyWithTruncatedFile() {
+        const std::string contents = makePly();
+        std::istringstream stream(contents.substr(0, contents.size() - 5));
+        CPPUNIT_ASSERT_THROW(reader.readPly(stream), std::runtime_error);
+    }
+
+    CPPUNIT_TEST_SUITE(MeshReaderTest);
+    CPPUNIT_TEST(testReadWithUnknownExtension);
+    CPPUNIT_TEST(testReadObj);
+    CPPUNIT_TEST(testReadObjWithIndexOutOfRange);
+    CPPUNIT_TEST(testReadObjWithNoFaces);
+    CPPUNIT_TEST(testReadObjWithSharedVertices);
+    CPPUNIT_TEST(testReadPly);
+    CPPUNIT_TEST(testReadPlyWithAscii);
+    CPPUNIT_TEST(testReadPlyWithLargeCount);
+    CPPUNIT_TEST(testReadPlyWithNegativeCount);
+    CPPUNIT_TEST(testReadPlyWithNoFaces);
+    CPPUNIT_TEST(testReadPlyWithTruncatedFile);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(MeshReaderTest::suite());
+    runner.run();
+    return 0;
+}
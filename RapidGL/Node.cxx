@@ -88,7 +88,7 @@ Node* findRoot(Node* node) {
  *
  * @param id Unique identifier of node, which may be empty
  */
-Node::Node(const std::string& id) : id(id), parent(NULL) {
+Node::Node(const std::string& id) : boundsValid(false), hooks(ALL_HOOKS), id(id), parent(NULL) {
     // empty
 }
 
@@ -102,6 +102,8 @@ Node::~Node() {
 /**
  * Adds a node as a child of this node.
  *
+ * Fires a node changed event since the structure of the tree changed.
+ *
  * @param node Pointer to the node to add as a child of this node
  * @throws invalid_argument if node is `NULL` or this node
  */
@@ -113,6 +115,7 @@ void Node::addChild(Node* const node) {
     }
     children.push_back(node);
     node->parent = this;
+    fireNodeChangedEvent();
 }
 
 /**
@@ -128,15 +131,71 @@ void Node::addNodeListener(NodeListener* const nodeListener) {
     nodeListeners.push_back(nodeListener);
 }
 
+/**
+ * Computes the bounds of this node and its descendants, in its parent's space.
+ *
+ * By default a node draws nothing itself, so its bounds are just the bounds
+ * of its children.  Nodes that draw should add what they draw, nodes that
+ * transform their children should transform the bounds, and nodes whose
+ * effects reach outside their subtree should return an infinite box.
+ *
+ * @return Box enclosing everything this node and its descendants draw
+ */
+BoundingBox Node::computeBounds() {
+    BoundingBox box;
+    for (std::vector<Node*>::const_iterator it = children.begin(); it != children.end(); ++it) {
+        box.add((*it)->getBounds());
+    }
+    return box;
+}
+
 /**
  * Notifies each registered listener that this node has changed.
+ *
+ * Also forgets the bounds of this node and its ancestors, since the change
+ * may have moved or resized what they enclose.
  */
 void Node::fireNodeChangedEvent() {
+    invalidateBounds();
     for (std::vector<NodeListener*>::const_iterator it = nodeListeners.begin(); it != nodeListeners.end(); ++it) {
         (*it)->nodeChanged(this);
     }
 }
 
+/**
+ * Returns the bounds of this node and its descendants, in its parent's space.
+ *
+ * Bounds are cached, and only computed again after a node changed event is
+ * fired by this node or one of its descendants.  Even then, only the nodes
+ * between it and this node are computed again.
+ *
+ * @return Box enclosing everything this node and its descendants draw
+ */
+BoundingBox Node::getBounds() {
+
+    if (boundsValid) {
+        return bounds;
+    }
+
+    // Find descendants without bounds, which always come after their parents
+    std::vector<Node*> pending(1, this);
+    for (size_t i = 0; i < pending.size(); ++i) {
+        const std::vector<Node*>& children = pending[i]->children;
+        for (std::vector<Node*>::const_iterator it = children.begin(); it != children.end(); ++it) {
+            if (!(*it)->boundsValid) {
+                pending.push_back(*it);
+            }
+        }
+    }
+
+    // Compute them backwards so children are done before their parents, without recursing
+    for (std::vector<Node*>::reverse_iterator it = pending.rbegin(); it != pending.rend(); ++it) {
+        (*it)->bounds = (*it)->computeBounds();
+        (*it)->boundsValid = true;
+    }
+    return bounds;
+}
+
 /**
  * Returns a pair of iterators for accessing this node's children.
  *
@@ -146,6 +205,18 @@ Node::node_range_t Node::getChildren() const {
     return node_range_t(children.begin(), children.end());
 }
 
+/**
+ * Returns the hooks this node does work in when it is traversed.
+ *
+ * Hooks that are not included are no-ops for this node, so callers that
+ * replay a traversal may skip them.
+ *
+ * @return Bitwise combination of `Hook` values
+ */
+int Node::getHooks() const {
+    return hooks;
+}
+
 /**
  * Returns a copy of this node's identifier.
  *
@@ -164,6 +235,20 @@ Node* Node::getParent() const {
     return parent;
 }
 
+/**
+ * Forgets the bounds of this node and its ancestors.
+ *
+ * Whenever a node's bounds are cached, so are all of its descendants', so
+ * once an ancestor is found without bounds, the rest must not have any either.
+ */
+void Node::invalidateBounds() {
+    Node* node = this;
+    while ((node != NULL) && node->boundsValid) {
+        node->boundsValid = false;
+        node = node->parent;
+    }
+}
+
 /**
  * Checks if this node has any children.
  *
@@ -191,6 +276,19 @@ void Node::postVisit(State& state) {
     // empty
 }
 
+/**
+ * Performs one-time setup, like resolving links, before this node is first visited.
+ *
+ * Nodes that only have setup to do before being visited should remove
+ * `PRE_VISIT` from their hooks once prepared, so per-frame traversals skip
+ * them.  Preparing a node again should do nothing.
+ *
+ * @param state State shared between nodes
+ */
+void Node::prepare(State& state) {
+    // empty
+}
+
 /**
  * Performs an action before this node is visited.
  *
@@ -203,6 +301,8 @@ void Node::preVisit(State& state) {
 /**
  * Removes a child from this node.
  *
+ * Fires a node changed event if the child was removed.
+ *
  * @param node Child node to remove
  * @return `true` if child node was successfully removed
  */
@@ -219,8 +319,9 @@ bool Node::removeChild(Node* const node) {
     }
 
     // Remove it
+    node->parent = NULL;
     children.erase(it);
-    (*it)->parent = NULL;
+    fireNodeChangedEvent();
     return true;
 }
 
@@ -248,6 +349,33 @@ bool Node::removeNodeListener(NodeListener* const nodeListener) {
     return true;
 }
 
+/**
+ * Chooses which children are traversed after this node is visited.
+ *
+ * Only called if `SELECT` is in this node's hooks, otherwise every child is
+ * traversed.  The range must stay valid until the traversal leaves this node.
+ *
+ * @param state State shared between nodes, as left by this node's `visit`
+ * @return Range of children to traverse, which may be empty
+ */
+Node::node_range_t Node::select(State& state) {
+    return getChildren();
+}
+
+/**
+ * Changes the hooks this node does work in when it is traversed.
+ *
+ * Fires a node changed event if the hooks changed.
+ *
+ * @param hooks Bitwise combination of `Hook` values
+ */
+void Node::setHooks(const int hooks) {
+    if (this->hooks != hooks) {
+        this->hooks = hooks;
+        fireNodeChangedEvent();
+    }
+}
+
 /**
  * Performs an action.
  *
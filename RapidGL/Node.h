@@ -22,6 +22,7 @@
 #include <stdexcept>
 #include <vector>
 #include "RapidGL/common.h"
+#include "RapidGL/BoundingBox.h"
 #include "RapidGL/NodeListener.h"
 #include "RapidGL/State.h"
 namespace RapidGL {
@@ -35,33 +36,53 @@ public:
 // Types
     typedef std::vector<Node*>::const_iterator node_iterator_t; ///< Node iterator
     typedef Range<node_iterator_t> node_range_t; ///< Pair of node iterators
+    /// Hooks a node may do work in when it is traversed
+    enum Hook {
+        PRE_VISIT = 1,
+        VISIT = 2,
+        POST_VISIT = 4,
+        ALL_HOOKS = PRE_VISIT | VISIT | POST_VISIT,
+        SELECT = 8
+    };
 // Methods
     Node(const std::string& id = "");
     virtual ~Node();
     void addChild(Node* node);
     void addNodeListener(NodeListener* nodeListener);
+    BoundingBox getBounds();
     node_range_t getChildren() const;
+    int getHooks() const;
     std::string getId() const;
     Node* getParent() const;
     bool hasChildren() const;
     bool hasId() const;
     virtual void postVisit(State& state);
+    virtual void prepare(State& state);
     virtual void preVisit(State& state);
     bool removeChild(Node* node);
     bool removeNodeListener(NodeListener* nodeListener);
+    virtual node_range_t select(State& state);
     virtual void visit(State& state) = 0;
 protected:
 // Methods
+    virtual BoundingBox computeBounds();
     void fireNodeChangedEvent();
+    void setHooks(int hooks);
 private:
 // Attributes
+    BoundingBox bounds;
+    bool boundsValid;
     std::vector<Node*> children;
+    int hooks;
     std::string id;
     Node* parent;
     std::vector<NodeListener*> nodeListeners;
 // Methods
     Node(const Node& node);
     Node& operator=(const Node& node);
+    void invalidateBounds();
+// Friends
+    friend class Visitor;
 };
 
 /**
@@ -16,9 +16,12 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "config.h"
+#include <vector>
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include <cppunit/ui/text/TestRunner.h>
+#include <m3d/Vec3.h>
+#include "RapidGL/BoundingBox.h"
 #include "RapidGL/Node.h"
 
 
@@ -51,17 +54,36 @@ public:
     class FooNode : public RapidGL::Node {
     public:
 
-        FooNode(const std::string& id = "") : RapidGL::Node(id) {
+        RapidGL::BoundingBox box;
+        int computeCount;
+
+        FooNode(const std::string& id = "") : RapidGL::Node(id), computeCount(0) {
             // empty
         }
 
+        virtual RapidGL::BoundingBox computeBounds() {
+            ++computeCount;
+            RapidGL::BoundingBox bounds = RapidGL::Node::computeBounds();
+            bounds.add(box);
+            return bounds;
+        }
+
         virtual void visit(RapidGL::State& state) {
             // empty
         }
 
+        void changeHooks(const int hooks) {
+            setHooks(hooks);
+        }
+
         void fire() {
             fireNodeChangedEvent();
         }
+
+        void resize(const RapidGL::BoundingBox& box) {
+            this->box = box;
+            fireNodeChangedEvent();
+        }
     };
 
     /**
@@ -105,6 +127,22 @@ public:
         CPPUNIT_ASSERT_THROW(node.addChild(&node), std::invalid_argument);
     }
 
+    /**
+     * Ensures `Node::addChild(Node*)` fires an event.
+     */
+    void testAddChildFiresEvent() {
+
+        // Make parent and child nodes
+        FooNode parent;
+        BarNode child;
+        FakeNodeListener fakeNodeListener;
+        parent.addNodeListener(&fakeNodeListener);
+
+        // Add child and check listener was notified
+        parent.addChild(&child);
+        CPPUNIT_ASSERT_EQUAL((RapidGL::Node*) &parent, fakeNodeListener.node);
+    }
+
     /**
      * Ensures `Node::addNodeListener` works correctly with a listener that is not `NULL`.
      */
@@ -371,6 +409,88 @@ public:
         CPPUNIT_ASSERT_EQUAL((RapidGL::Node*) &rootNode, RapidGL::findRoot(&rootNode));
     }
 
+    /**
+     * Ensures `Node::getBounds` encloses the node and its children.
+     */
+    void testGetBounds() {
+
+        FooNode parent;
+        FooNode first;
+        FooNode second;
+        parent.addChild(&first);
+        parent.addChild(&second);
+        first.box = RapidGL::BoundingBox(M3d::Vec3(-1, 0, 0), M3d::Vec3(0, 1, 1));
+        second.box = RapidGL::BoundingBox(M3d::Vec3(2, -1, 0), M3d::Vec3(3, 0, 2));
+
+        const RapidGL::BoundingBox bounds = parent.getBounds();
+        CPPUNIT_ASSERT(M3d::Vec3(-1, -1, 0) == bounds.getMin());
+        CPPUNIT_ASSERT(M3d::Vec3(3, 1, 2) == bounds.getMax());
+    }
+
+    /**
+     * Ensures `Node::getBounds` only computes bounds again for nodes affected by a change.
+     */
+    void testGetBoundsAfterChange() {
+
+        // Make a tree like `root(parent(child), sibling)`
+        FooNode root;
+        FooNode parent;
+        FooNode child;
+        FooNode sibling;
+        root.addChild(&parent);
+        parent.addChild(&child);
+        root.addChild(&sibling);
+        child.box = RapidGL::BoundingBox(M3d::Vec3(0, 0, 0), M3d::Vec3(1, 1, 1));
+        sibling.box = RapidGL::BoundingBox(M3d::Vec3(0, 0, 0), M3d::Vec3(1, 1, 1));
+        root.getBounds();
+        root.getBounds();
+        CPPUNIT_ASSERT_EQUAL(1, root.computeCount);
+
+        // Change the child
+        child.resize(RapidGL::BoundingBox(M3d::Vec3(0, 0, 0), M3d::Vec3(4, 1, 1)));
+        CPPUNIT_ASSERT(M3d::Vec3(4, 1, 1) == root.getBounds().getMax());
+        CPPUNIT_ASSERT_EQUAL(2, root.computeCount);
+        CPPUNIT_ASSERT_EQUAL(2, parent.computeCount);
+        CPPUNIT_ASSERT_EQUAL(2, child.computeCount);
+        CPPUNIT_ASSERT_EQUAL(1, sibling.computeCount);
+
+        // Remove it
+        parent.removeChild(&child);
+        CPPUNIT_ASSERT(M3d::Vec3(1, 1, 1) == root.getBounds().getMax());
+    }
+
+    /**
+     * Ensures `Node::getBounds` works on a tree too deep to compute recursively.
+     */
+    void testGetBoundsWithDeepTree() {
+
+        // Make a chain of nodes with a box at the bottom
+        std::vector<FooNode*> nodes;
+        nodes.push_back(new FooNode());
+        for (int i = 1; i < 100000; ++i) {
+            FooNode* node = new FooNode();
+            nodes.back()->addChild(node);
+            nodes.push_back(node);
+        }
+        nodes.back()->box = RapidGL::BoundingBox(M3d::Vec3(0, 0, 0), M3d::Vec3(1, 1, 1));
+
+        // Check the top
+        CPPUNIT_ASSERT(M3d::Vec3(1, 1, 1) == nodes.front()->getBounds().getMax());
+
+        // Clean up
+        for (std::vector<FooNode*>::iterator it = nodes.begin(); it != nodes.end(); ++it) {
+            delete (*it);
+        }
+    }
+
+    /**
+     * Ensures `Node::getHooks` returns all hooks by default.
+     */
+    void testGetHooks() {
+        FooNode fooNode;
+        CPPUNIT_ASSERT_EQUAL((int) RapidGL::Node::ALL_HOOKS, fooNode.getHooks());
+    }
+
     /**
      * Checks that Node::removeChild(Node*) works correctly.
      */
@@ -390,6 +510,23 @@ public:
         CPPUNIT_ASSERT_EQUAL((RapidGL::Node*) NULL, child.getParent());
     }
 
+    /**
+     * Ensures `Node::removeChild` fires an event.
+     */
+    void testRemoveChildFiresEvent() {
+
+        // Make parent and child nodes
+        FooNode parent;
+        BarNode child;
+        parent.addChild(&child);
+        FakeNodeListener fakeNodeListener;
+        parent.addNodeListener(&fakeNodeListener);
+
+        // Remove child and check listener was notified
+        parent.removeChild(&child);
+        CPPUNIT_ASSERT_EQUAL((RapidGL::Node*) &parent, fakeNodeListener.node);
+    }
+
     /**
      * Ensures `Node::removeNodeListener` works correctly with a listener that is not `NULL`.
      */
@@ -416,8 +553,32 @@ public:
         CPPUNIT_ASSERT_THROW(fooNode.removeNodeListener(NULL), std::invalid_argument);
     }
 
+    /**
+     * Ensures `Node::setHooks` fires an event if the hooks changed.
+     */
+    void testSetHooksFiresEvent() {
+        FooNode fooNode;
+        FakeNodeListener fakeNodeListener;
+        fooNode.addNodeListener(&fakeNodeListener);
+        fooNode.changeHooks(RapidGL::Node::VISIT);
+        CPPUNIT_ASSERT_EQUAL((int) RapidGL::Node::VISIT, fooNode.getHooks());
+        CPPUNIT_ASSERT_EQUAL((RapidGL::Node*) &fooNode, fakeNodeListener.node);
+    }
+
+    /**
+     * Ensures `Node::setHooks` does not fire an event if the hooks did not change.
+     */
+    void testSetHooksWithSameHooks() {
+        FooNode fooNode;
+        FakeNodeListener fakeNodeListener;
+        fooNode.addNodeListener(&fakeNodeListener);
+        fooNode.changeHooks(RapidGL::Node::ALL_HOOKS);
+        CPPUNIT_ASSERT_EQUAL((RapidGL::Node*) NULL, fakeNodeListener.node);
+    }
+
     CPPUNIT_TEST_SUITE(NodeTest);
     CPPUNIT_TEST(testAddChild);
+    CPPUNIT_TEST(testAddChildFiresEvent);
     CPPUNIT_TEST(testAddChildWithSelf);
     CPPUNIT_TEST(testAddNodeListenerWithNonNull);
     CPPUNIT_TEST(testAddNodeListenerWithNull);
@@ -440,9 +601,16 @@ public:
     CPPUNIT_TEST(testFindRootWithGrandchild);
     CPPUNIT_TEST(testFindRootWithNull);
     CPPUNIT_TEST(testFindRootWithRoot);
+    CPPUNIT_TEST(testGetBounds);
+    CPPUNIT_TEST(testGetBoundsAfterChange);
+    CPPUNIT_TEST(testGetBoundsWithDeepTree);
+    CPPUNIT_TEST(testGetHooks);
     CPPUNIT_TEST(testRemoveChild);
+    CPPUNIT_TEST(testRemoveChildFiresEvent);
     CPPUNIT_TEST(testRemoveNodeListenerWithNonNull);
     CPPUNIT_TEST(testRemoveNodeListenerWithNull);
+    CPPUNIT_TEST(testSetHooksFiresEvent);
+    CPPUNIT_TEST(testSetHooksWithSameHooks);
     CPPUNIT_TEST_SUITE_END();
 };
 
@@ -0,0 +1,401 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <exception>
+#include <stdexcept>
+#include <Poco/Exception.h>
+#include "RapidGL/FramebufferNode.h"
+#include "RapidGL/GroupNode.h"
+#include "RapidGL/InstanceNode.h"
+#include "RapidGL/ParallelRecorder.h"
+namespace RapidGL {
+
+/**
+ * Constructs a parallel recorder.
+ *
+ * @param threadPool Pool of threads to record jobs with
+ */
+ParallelRecorder::ParallelRecorder(Poco::ThreadPool& threadPool) :
+        threadPool(threadPool),
+        jobCount(0),
+        segmentCount(0),
+        splitting(true) {
+    // empty
+}
+
+/**
+ * Destructs a parallel recorder.
+ */
+ParallelRecorder::~ParallelRecorder() {
+    for (std::vector<Job*>::iterator it = jobs.begin(); it != jobs.end(); ++it) {
+        delete (*it);
+    }
+    for (std::vector<RenderQueue*>::iterator it = segments.begin(); it != segments.end(); ++it) {
+        delete (*it);
+    }
+}
+
+/**
+ * Constructs a job.
+ */
+ParallelRecorder::Job::Job() : node(NULL), visitor(&state), failed(false) {
+    state.setRenderQueue(&queue);
+}
+
+/**
+ * Destructs a job.
+ */
+ParallelRecorder::Job::~Job() {
+    // empty
+}
+
+/**
+ * Records the job's subtree into its queue, keeping any error for later.
+ */
+void ParallelRecorder::Job::run() {
+    try {
+        visitor.visit(node);
+    } catch (std::exception& e) {
+        failed = true;
+        error = e.what();
+    } catch (...) {
+        failed = true;
+        error = "[ParallelRecorder] Unknown error in job!";
+    }
+    done.set();
+}
+
+/**
+ * Starts the jobs held back until the rest of the scene was recorded.
+ *
+ * A job is started on another thread only if its subtree still has the same
+ * nodes it had when it was last recorded on this thread.  Otherwise, or if
+ * preparing it fails, it is recorded on this thread, which also reports any
+ * error like other jobs.
+ */
+void ParallelRecorder::dispatch() {
+    for (std::vector<Job*>::iterator it = pending.begin(); it != pending.end(); ++it) {
+        Job* const job = (*it);
+        Summary& last = recorded[job->node];
+        Summary summary = { 0, false };
+        try {
+            prepare(job->node, job->state, summary);
+        } catch (...) {
+            job->run();
+            continue;
+        }
+        if ((summary.signature == last.signature) && !summary.shared) {
+            try {
+                threadPool.start(*job);
+                continue;
+            } catch (Poco::NoThreadAvailableException& e) {
+                // fall through
+            }
+        }
+        job->run();
+        if (!job->failed) {
+            last = summary;
+        }
+    }
+    pending.clear();
+}
+
+/**
+ * Collects the groups linked to by `InstanceNode`s in a subtree.
+ *
+ * @param node Root of subtree to look in
+ * @param links Set to add identifiers of linked groups to
+ */
+void ParallelRecorder::findLinks(Node* const node, std::set<std::string>& links) {
+    const InstanceNode* const instanceNode = dynamic_cast<InstanceNode*>(node);
+    if (instanceNode != NULL) {
+        links.insert(instanceNode->getLink());
+    }
+    const Node::node_range_t children = node->getChildren();
+    for (Node::node_iterator_t it = children.begin; it != children.end; ++it) {
+        findLinks(*it, links);
+    }
+}
+
+/**
+ * Returns the number of jobs the scene was split into the last time it was recorded.
+ *
+ * @return Number of jobs the scene was split into
+ */
+size_t ParallelRecorder::getJobCount() const {
+    return jobCount;
+}
+
+/**
+ * Forgets which jobs have been seen, so each job is next recorded on the calling thread.
+ */
+void ParallelRecorder::invalidate() {
+    recorded.clear();
+}
+
+/**
+ * Checks if a node's subtree should be recorded as a job.
+ *
+ * @param node Node to check
+ * @return `true` if node is a group or framebuffer node with children
+ */
+bool ParallelRecorder::isJob(Node* const node) {
+    if (!node->hasChildren()) {
+        return false;
+    }
+    return (dynamic_cast<GroupNode*>(node) != NULL) || (dynamic_cast<FramebufferNode*>(node) != NULL);
+}
+
+/**
+ * Appends the queues of the jobs and the segments between them, in scene order.
+ *
+ * @param renderQueue Queue to append to, which holds the first segment
+ */
+void ParallelRecorder::merge(RenderQueue* const renderQueue) {
+    for (std::vector<RenderQueue*>::const_iterator it = parts.begin(); it != parts.end(); ++it) {
+        renderQueue->append(**it);
+    }
+    if (segmentCount > 0) {
+        renderQueue->inherit(*segments[segmentCount - 1]);
+    }
+}
+
+/**
+ * Prepares a subtree and adds its nodes and how they are arranged to a summary.
+ *
+ * @param node Root of subtree to prepare
+ * @param state State to prepare nodes with
+ * @param summary Summary to add subtree to
+ */
+void ParallelRecorder::prepare(Node* const node, State& state, Summary& summary) const {
+
+    // Prepare the node, noting if it may also be visited from outside of the subtree
+    node->prepare(state);
+    if (dynamic_cast<InstanceNode*>(node) != NULL) {
+        summary.shared = true;
+    } else if ((dynamic_cast<GroupNode*>(node) != NULL) && (links.count(node->getId()) > 0)) {
+        summary.shared = true;
+    }
+
+    // Add the node and how many children it has, then the children
+    const Node::node_range_t children = node->getChildren();
+    summary.signature = (summary.signature * 31) + reinterpret_cast<size_t>(node);
+    summary.signature = (summary.signature * 31) + (children.end - children.begin);
+    for (Node::node_iterator_t it = children.begin; it != children.end; ++it) {
+        prepare(*it, state, summary);
+    }
+}
+
+/**
+ * Records a scene into the render queue of a state.
+ *
+ * @param root Root of scene to record
+ * @param state State with render queue to record into
+ * @throws invalid_argument if root is `NULL` or state does not have a render queue
+ * @throws runtime_error if recording a job failed
+ */
+void ParallelRecorder::record(Node* const root, State& state) {
+
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    if (root == NULL) {
+        throw std::invalid_argument("[ParallelRecorder] Root is NULL!");
+    } else if (renderQueue == NULL) {
+        throw std::invalid_argument("[ParallelRecorder] State does not have a render queue!");
+    }
+
+    // Start over
+    jobCount = 0;
+    segmentCount = 0;
+    parts.clear();
+
+    // Only split the scene if jobs would not need anything else from the state
+    splitting = state.getUniformBuffers().empty()
+            && (state.getRingBuffer() == NULL)
+            && (state.getInstanceBatcher() == NULL);
+
+    // Find groups that are instanced, which cannot be recorded on other threads
+    links.clear();
+    findLinks(root, links);
+
+    // Traverse, then start the jobs that were held back
+    try {
+        traverse(root, state);
+        dispatch();
+    } catch (...) {
+        for (std::vector<Job*>::iterator it = pending.begin(); it != pending.end(); ++it) {
+            (*it)->done.set();
+        }
+        pending.clear();
+        wait();
+        state.setRenderQueue(renderQueue);
+        throw;
+    }
+    wait();
+    state.setRenderQueue(renderQueue);
+
+    // Report the first job that failed
+    for (size_t i = 0; i < jobCount; ++i) {
+        if (jobs[i]->failed) {
+            throw std::runtime_error(jobs[i]->error);
+        }
+    }
+
+    // Put the pieces together
+    merge(renderQueue);
+}
+
+/**
+ * Starts recording a subtree as a job, and continues in a new segment.
+ *
+ * @param node Root of subtree
+ * @param state State with the segment currently being recorded into
+ */
+void ParallelRecorder::startJob(Node* const node, State& state) {
+
+    RenderQueue* const renderQueue = state.getRenderQueue();
+
+    // Set up job to start where the traversal is, keeping matrices that did not change so nodes can reuse results
+    if (jobCount == jobs.size()) {
+        jobs.push_back(new Job());
+    }
+    Job* const job = jobs[jobCount];
+    job->node = node;
+    job->failed = false;
+    job->error.clear();
+    if (!(job->state.getSimdModelMatrix() == state.getSimdModelMatrix())) {
+        job->state.setModelMatrix(state.getSimdModelMatrix());
+    }
+    if (!(job->state.getSimdViewMatrix() == state.getSimdViewMatrix())) {
+        job->state.setViewMatrix(state.getSimdViewMatrix());
+    }
+    if (!(job->state.getSimdProjectionMatrix() == state.getSimdProjectionMatrix())) {
+        job->state.setProjectionMatrix(state.getSimdProjectionMatrix());
+    }
+    job->queue.clear();
+    job->queue.inherit(*renderQueue);
+    parts.push_back(&job->queue);
+
+    // Record on this thread the first time or if shared, otherwise hold back for another
+    ++jobCount;
+    const std::map<Node*,Summary>::const_iterator it = recorded.find(node);
+    if ((it == recorded.end()) || it->second.shared) {
+        job->run();
+        if (!job->failed && (it == recorded.end())) {
+            Summary summary = { 0, false };
+            prepare(node, job->state, summary);
+            recorded[node] = summary;
+        }
+    } else {
+        pending.push_back(job);
+    }
+
+    // Continue in a new segment as if the job changed nothing
+    if (segmentCount == segments.size()) {
+        segments.push_back(new RenderQueue());
+    }
+    RenderQueue* const segment = segments[segmentCount++];
+    segment->clear();
+    segment->inherit(*renderQueue);
+    parts.push_back(segment);
+    state.setRenderQueue(segment);
+}
+
+/**
+ * Visits a scene like a `Visitor`, except subtrees that should be jobs are started as jobs when splitting.
+ *
+ * @param node Root of scene
+ * @param state State to visit nodes with
+ */
+void ParallelRecorder::traverse(Node* node, State& state) {
+
+    // Perform actions before being visited, and visit the root
+    int hooks = node->getHooks();
+    if (hooks & Node::PRE_VISIT) {
+        node->preVisit(state);
+    }
+    if (hooks & Node::VISIT) {
+        node->visit(state);
+    }
+    Node::node_range_t children = (hooks & Node::SELECT) ? node->select(state) : node->getChildren();
+    Node::node_iterator_t next = children.begin;
+    Node::node_iterator_t end = children.end;
+    stack.clear();
+
+    while (true) {
+        if (next != end) {
+
+            // Start the next child as a job if it should be one
+            Node* const child = *next;
+            ++next;
+            if (splitting && isJob(child)) {
+                startJob(child, state);
+                continue;
+            }
+
+            // Otherwise visit it
+            hooks = child->getHooks();
+            if (hooks & Node::PRE_VISIT) {
+                child->preVisit(state);
+            }
+            if (hooks & Node::VISIT) {
+                child->visit(state);
+            }
+
+            // Finish it now if it is a leaf, otherwise descend into it
+            children = (hooks & Node::SELECT) ? child->select(state) : child->getChildren();
+            if (children.begin == children.end) {
+                if (hooks & Node::POST_VISIT) {
+                    child->postVisit(state);
+                }
+            } else {
+                const Frame frame = { node, next, end };
+                stack.push_back(frame);
+                node = child;
+                next = children.begin;
+                end = children.end;
+            }
+        } else {
+
+            // Perform actions after being visited
+            if (node->getHooks() & Node::POST_VISIT) {
+                node->postVisit(state);
+            }
+
+            // Go back up to the parent
+            if (stack.empty()) {
+                break;
+            }
+            const Frame frame = stack.back();
+            stack.pop_back();
+            node = frame.node;
+            next = frame.next;
+            end = frame.end;
+        }
+    }
+}
+
+/**
+ * Waits for every job that was started to finish.
+ */
+void ParallelRecorder::wait() {
+    for (size_t i = 0; i < jobCount; ++i) {
+        jobs[i]->done.wait();
+    }
+}
+
+} /* namespace RapidGL */
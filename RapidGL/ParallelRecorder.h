@@ -0,0 +1,148 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RAPIDGL_PARALLEL_RECORDER_H
+#define RAPIDGL_PARALLEL_RECORDER_H
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <Poco/Event.h>
+#include <Poco/Runnable.h>
+#include <Poco/ThreadPool.h>
+#include "RapidGL/common.h"
+#include "RapidGL/Node.h"
+#include "RapidGL/RenderQueue.h"
+#include "RapidGL/State.h"
+#include "RapidGL/Visitor.h"
+namespace RapidGL {
+
+
+/**
+ * Utility for recording a scene into a render queue using several threads.
+ *
+ * The scene is traversed on the calling thread until a `GroupNode` or
+ * `FramebufferNode` with children is reached.  That subtree becomes a job,
+ * which is recorded on a thread from the pool into its own queue and state,
+ * starting from the matrices, program, textures and uniform values in effect
+ * where it was reached.  The calling thread carries on with the rest of the
+ * scene as if the subtree had left everything as it found it.  Once every job
+ * is done, the queues are appended to the state's queue in scene order, so
+ * the result does not depend on which thread finished first.
+ *
+ * Only recording is done on other threads.  The queue must still be submitted
+ * on the thread with the OpenGL context.  Since nodes may make OpenGL calls the
+ * first time they are visited, like looking up uniform locations or making
+ * vertex array objects, each job is recorded on the calling thread the first
+ * time it is seen.
+ *
+ * Nodes keep caches that are changed while they are visited without any
+ * locking, like the values and locations of uniform nodes, the vertex array
+ * objects of geometry nodes, the world matrices of transform nodes and the
+ * tables of `UniformTable`.  So a node must only ever be visited by one
+ * thread at a time.  A job is therefore always recorded on the calling thread
+ * if its subtree contains an `InstanceNode`, or a group that an `InstanceNode`
+ * anywhere in the scene links to, since those nodes can be reached from other
+ * jobs or from the rest of the scene.
+ *
+ * Other jobs are only started on other threads once the calling thread has
+ * finished the rest of the scene, so nothing it does can race with them.
+ * Before a job is started, its subtree is prepared on the calling thread and
+ * compared with the nodes it had when it was last recorded there.  If nodes
+ * were added, removed or moved since, it is recorded on the calling thread
+ * again instead.  Changes that do not add, remove or move nodes but make a
+ * node need new OpenGL objects, like giving a texture node another file,
+ * should be followed by `invalidate`.
+ *
+ * Jobs are given their own states with only the matrices of the calling
+ * thread's state.  If the state has uniform buffers, a ring buffer or an
+ * instance batcher, which nodes would write to, the whole scene is recorded
+ * on the calling thread instead.
+ *
+ * Unlike a `Visitor`, uniform values and texture bindings set inside a job
+ * are not seen by the nodes after it.
+ */
+class ParallelRecorder {
+public:
+// Methods
+    ParallelRecorder(Poco::ThreadPool& threadPool = Poco::ThreadPool::defaultPool());
+    virtual ~ParallelRecorder();
+    size_t getJobCount() const;
+    void invalidate();
+    void record(Node* root, State& state);
+private:
+// Types
+    /**
+     * Subtree recorded on its own, with its own state and queue.
+     */
+    class Job : public Poco::Runnable {
+    public:
+    // Methods
+        Job();
+        virtual ~Job();
+        virtual void run();
+    // Attributes
+        Node* node;
+        State state;
+        RenderQueue queue;
+        Visitor visitor;
+        Poco::Event done;
+        bool failed;
+        std::string error;
+    };
+    /**
+     * Nodes of a job's subtree when it was last recorded on the calling thread.
+     */
+    struct Summary {
+        size_t signature;
+        bool shared;
+    };
+    /**
+     * Ancestor being traversed and the children it has left to traverse.
+     */
+    struct Frame {
+        Node* node;
+        Node::node_iterator_t next;
+        Node::node_iterator_t end;
+    };
+// Attributes
+    Poco::ThreadPool& threadPool;
+    std::vector<Job*> jobs;
+    size_t jobCount;
+    std::vector<RenderQueue*> segments;
+    size_t segmentCount;
+    std::vector<RenderQueue*> parts;
+    std::vector<Job*> pending;
+    std::map<Node*,Summary> recorded;
+    std::set<std::string> links;
+    bool splitting;
+    std::vector<Frame> stack;
+// Methods
+    ParallelRecorder(const ParallelRecorder&);
+    ParallelRecorder& operator=(const ParallelRecorder&);
+    void dispatch();
+    static void findLinks(Node* node, std::set<std::string>& links);
+    static bool isJob(Node* node);
+    void merge(RenderQueue* renderQueue);
+    void prepare(Node* node, State& state, Summary& summary) const;
+    void startJob(Node* node, State& state);
+    void traverse(Node* root, State& state);
+    void wait();
+};
+
+} /* namespace RapidGL */
+#endif
@@ -0,0 +1,345 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <cppunit/extensions/HelperMacros.h>
+#include <GL/glfw.h>
+#include <glycerin/Color.hxx>
+#include <m3d/Vec4.h>
+#include <Poco/Thread.h>
+#include "RapidGL/AttributeNode.h"
+#include "RapidGL/ClearNode.h"
+#include "RapidGL/CubeNode.h"
+#include "RapidGL/GroupNode.h"
+#include "RapidGL/InstanceBatcher.h"
+#include "RapidGL/InstanceNode.h"
+#include "RapidGL/ParallelRecorder.h"
+#include "RapidGL/ProgramNode.h"
+#include "RapidGL/RenderQueue.h"
+#include "RapidGL/SceneNode.h"
+#include "RapidGL/ShaderNode.h"
+#include "RapidGL/State.h"
+#include "RapidGL/UseNode.h"
+#include "RapidGL/Vec4UniformNode.h"
+#include "RapidGL/Visitor.h"
+
+
+/**
+ * Unit test for `ParallelRecorder`.
+ */
+class ParallelRecorderTest {
+public:
+
+    /**
+     * Node that notes if it was ever visited on a thread other than the main one.
+     */
+    class ThreadCheckNode : public RapidGL::Node {
+    public:
+
+        bool visitedOnOtherThread;
+
+        ThreadCheckNode() : visitedOnOtherThread(false) {
+            setHooks(VISIT);
+        }
+
+        virtual void visit(RapidGL::State& state) {
+            if (Poco::Thread::current() != NULL) {
+                visitedOnOtherThread = true;
+            }
+        }
+    };
+
+    /**
+     * Returns the source code for the vertex shader.
+     */
+    static std::string getVertexShaderSource() {
+        return
+                "#version 140\n"
+                "in vec4 MCVertex;\n"
+                "void main() {\n"
+                "  gl_Position = MCVertex;\n"
+                "}\n";
+    }
+
+    /**
+     * Returns the source code for the fragment shader.
+     */
+    static std::string getFragmentShaderSource() {
+        return
+                "#version 140\n"
+                "uniform vec4 Color = vec4(1);\n"
+                "out vec4 FragColor;\n"
+                "void main() {\n"
+                "  FragColor = Color;\n"
+                "}\n";
+    }
+
+    /**
+     * Adds a program node with shaders and an attribute to a scene.
+     *
+     * @param scene Scene to add program node to
+     * @param id Identifier of program node
+     */
+    static void addProgramNode(RapidGL::Node* scene, const std::string& id) {
+        RapidGL::ProgramNode* programNode = new RapidGL::ProgramNode(id);
+        programNode->addChild(new RapidGL::ShaderNode(GL_VERTEX_SHADER, getVertexShaderSource()));
+        programNode->addChild(new RapidGL::ShaderNode(GL_FRAGMENT_SHADER, getFragmentShaderSource()));
+        programNode->addChild(new RapidGL::AttributeNode("MCVertex", RapidGL::AttributeNode::POSITION, 0));
+        scene->addChild(programNode);
+    }
+
+    /**
+     * Adds a group with a use node, a color and a cube to a scene.
+     *
+     * @param scene Scene to add group node to
+     * @param id Identifier of program node to use
+     * @param color Color to draw cube with
+     */
+    static void addGroupNode(RapidGL::Node* scene, const std::string& id, const M3d::Vec4& color) {
+        RapidGL::GroupNode* groupNode = new RapidGL::GroupNode("group");
+        RapidGL::UseNode* useNode = new RapidGL::UseNode(id);
+        useNode->addChild(new RapidGL::Vec4UniformNode("Color", color));
+        useNode->addChild(new RapidGL::CubeNode());
+        groupNode->addChild(useNode);
+        scene->addChild(groupNode);
+    }
+
+    /**
+     * Ensures `ParallelRecorder::record` records the same draws as a `Visitor`, and sorts them the same.
+     */
+    void testRecord() {
+
+        // Make scene with a group per cube
+        RapidGL::SceneNode scene;
+        addProgramNode(&scene, "red");
+        addProgramNode(&scene, "blue");
+        addGroupNode(&scene, "red", M3d::Vec4(1, 0, 0, 1));
+        addGroupNode(&scene, "blue", M3d::Vec4(0, 0, 1, 1));
+        addGroupNode(&scene, "red", M3d::Vec4(1, 0, 0, 1));
+        addGroupNode(&scene, "blue", M3d::Vec4(0, 0, 1, 1));
+
+        // Record it twice, so the second time uses other threads
+        RapidGL::RenderQueue renderQueue;
+        RapidGL::State state;
+        state.setRenderQueue(&renderQueue);
+        RapidGL::ParallelRecorder recorder;
+        recorder.record(&scene, state);
+        renderQueue.submit(state);
+        recorder.record(&scene, state);
+        CPPUNIT_ASSERT_EQUAL((size_t) 4, recorder.getJobCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 4, renderQueue.getSize());
+
+        // Submit and check program only changed once per program
+        renderQueue.submit(state);
+        glfwSwapBuffers();
+        CPPUNIT_ASSERT_EQUAL((size_t) 4, renderQueue.getDrawCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, renderQueue.getProgramChangeCount());
+        CPPUNIT_ASSERT_EQUAL((GLenum) GL_NO_ERROR, glGetError());
+    }
+
+    /**
+     * Ensures `ParallelRecorder::record` keeps draws in jobs on the same side of a barrier.
+     */
+    void testRecordWithBarrier() {
+
+        // Make scene with a clear in the middle
+        RapidGL::SceneNode scene;
+        addProgramNode(&scene, "red");
+        addProgramNode(&scene, "blue");
+        addGroupNode(&scene, "red", M3d::Vec4(1, 0, 0, 1));
+        addGroupNode(&scene, "blue", M3d::Vec4(0, 0, 1, 1));
+        addGroupNode(&scene, "red", M3d::Vec4(1, 0, 0, 1));
+        scene.addChild(new RapidGL::ClearNode(GL_COLOR_BUFFER_BIT, Glycerin::Color(0, 0, 0, 1), 1));
+        addGroupNode(&scene, "blue", M3d::Vec4(0, 0, 1, 1));
+        addGroupNode(&scene, "red", M3d::Vec4(1, 0, 0, 1));
+
+        // Record it twice, so the second time uses other threads
+        RapidGL::RenderQueue renderQueue;
+        RapidGL::State state;
+        state.setRenderQueue(&renderQueue);
+        RapidGL::ParallelRecorder recorder;
+        recorder.record(&scene, state);
+        renderQueue.submit(state);
+        recorder.record(&scene, state);
+        CPPUNIT_ASSERT_EQUAL((size_t) 5, recorder.getJobCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 6, renderQueue.getSize());
+
+        // Submit and check each side of the clear was sorted on its own
+        renderQueue.submit(state);
+        glfwSwapBuffers();
+        CPPUNIT_ASSERT_EQUAL((size_t) 5, renderQueue.getDrawCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 4, renderQueue.getProgramChangeCount());
+        CPPUNIT_ASSERT_EQUAL((GLenum) GL_NO_ERROR, glGetError());
+    }
+
+    /**
+     * Ensures `ParallelRecorder::record` records a job on the calling thread again after nodes are added to it.
+     */
+    void testRecordWithChangedScene() {
+
+        // Make scene with one group and record it twice, so the second time uses another thread
+        RapidGL::SceneNode scene;
+        addProgramNode(&scene, "red");
+        addGroupNode(&scene, "red", M3d::Vec4(1, 0, 0, 1));
+        RapidGL::RenderQueue renderQueue;
+        RapidGL::State state;
+        state.setRenderQueue(&renderQueue);
+        RapidGL::ParallelRecorder recorder;
+        recorder.record(&scene, state);
+        renderQueue.submit(state);
+        recorder.record(&scene, state);
+        renderQueue.submit(state);
+
+        // Add a node to the group without invalidating, and record it again
+        RapidGL::Node* const groupNode = *(scene.getChildren().end - 1);
+        ThreadCheckNode* const checkNode = new ThreadCheckNode();
+        groupNode->addChild(checkNode);
+        recorder.record(&scene, state);
+        CPPUNIT_ASSERT(!checkNode->visitedOnOtherThread);
+
+        // Submit and check the cube was still drawn
+        renderQueue.submit(state);
+        glfwSwapBuffers();
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, renderQueue.getDrawCount());
+        CPPUNIT_ASSERT_EQUAL((GLenum) GL_NO_ERROR, glGetError());
+    }
+
+    /**
+     * Ensures `ParallelRecorder::record` records everything on the calling thread if the state has an instance batcher.
+     */
+    void testRecordWithInstanceBatcher() {
+
+        // Make scene with a group
+        RapidGL::SceneNode scene;
+        RapidGL::GroupNode* const groupNode = new RapidGL::GroupNode("group");
+        ThreadCheckNode* const checkNode = new ThreadCheckNode();
+        groupNode->addChild(checkNode);
+        scene.addChild(groupNode);
+
+        // Record it twice, which would use another thread without the batcher
+        RapidGL::RenderQueue renderQueue;
+        RapidGL::InstanceBatcher instanceBatcher;
+        RapidGL::State state;
+        state.setRenderQueue(&renderQueue);
+        state.setInstanceBatcher(&instanceBatcher);
+        RapidGL::ParallelRecorder recorder;
+        recorder.record(&scene, state);
+        recorder.record(&scene, state);
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, recorder.getJobCount());
+        CPPUNIT_ASSERT(!checkNode->visitedOnOtherThread);
+    }
+
+    /**
+     * Ensures `ParallelRecorder::record` keeps jobs with instanced groups or instance nodes on the calling thread.
+     */
+    void testRecordWithInstancedGroup() {
+
+        // Make scene with a group that is instanced by another group
+        RapidGL::SceneNode scene;
+        addProgramNode(&scene, "red");
+        RapidGL::GroupNode* sharedNode = new RapidGL::GroupNode("shared");
+        ThreadCheckNode* sharedCheckNode = new ThreadCheckNode();
+        RapidGL::UseNode* useNode = new RapidGL::UseNode("red");
+        useNode->addChild(new RapidGL::Vec4UniformNode("Color", M3d::Vec4(1, 0, 0, 1)));
+        useNode->addChild(sharedCheckNode);
+        useNode->addChild(new RapidGL::CubeNode());
+        sharedNode->addChild(useNode);
+        scene.addChild(sharedNode);
+        RapidGL::GroupNode* instancingNode = new RapidGL::GroupNode("instancing");
+        ThreadCheckNode* instancingCheckNode = new ThreadCheckNode();
+        instancingNode->addChild(instancingCheckNode);
+        instancingNode->addChild(new RapidGL::InstanceNode("shared"));
+        scene.addChild(instancingNode);
+
+        // Record it twice, which would use other threads if the groups were not shared
+        RapidGL::RenderQueue renderQueue;
+        RapidGL::State state;
+        state.setRenderQueue(&renderQueue);
+        RapidGL::ParallelRecorder recorder;
+        recorder.record(&scene, state);
+        renderQueue.submit(state);
+        recorder.record(&scene, state);
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, recorder.getJobCount());
+        CPPUNIT_ASSERT(!sharedCheckNode->visitedOnOtherThread);
+        CPPUNIT_ASSERT(!instancingCheckNode->visitedOnOtherThread);
+
+        // Submit and check both cubes were drawn
+        renderQueue.submit(state);
+        glfwSwapBuffers();
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, renderQueue.getDrawCount());
+        CPPUNIT_ASSERT_EQUAL((GLenum) GL_NO_ERROR, glGetError());
+    }
+
+    /**
+     * Ensures `ParallelRecorder::record` throws if the state does not have a render queue.
+     */
+    void testRecordWithNoRenderQueue() {
+        RapidGL::SceneNode scene;
+        RapidGL::State state;
+        RapidGL::ParallelRecorder recorder;
+        CPPUNIT_ASSERT_THROW(recorder.record(&scene, state), std::invalid_argument);
+    }
+
+    /**
+     * Ensures `ParallelRecorder::record` throws if passed `NULL`.
+     */
+    void testRecordWithNull() {
+        RapidGL::RenderQueue renderQueue;
+        RapidGL::State state;
+        state.setRenderQueue(&renderQueue);
+        RapidGL::ParallelRecorder recorder;
+        CPPUNIT_ASSERT_THROW(recorder.record(NULL, state), std::invalid_argument);
+    }
+};
+
+int main(int argc, char* argv[]) {
+
+    // Initialize GLFW
+    if (!glfwInit()) {
+        throw std::runtime_error("Could not initialize GLFW!");
+    }
+
+    // Open window
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MAJOR, 3);
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MINOR, 2);
+    glfwOpenWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (!glfwOpenWindow(512, 512, 0, 0, 0, 0, 0, 0, GLFW_WINDOW)) {
+        throw std::runtime_error("Could not open GLFW window!");
+    }
+
+    // Run test
+    try {
+        ParallelRecorderTest test;
+        test.testRecord();
+        test.testRecordWithBarrier();
+        test.testRecordWithChangedScene();
+        test.testRecordWithInstanceBatcher();
+        test.testRecordWithInstancedGroup();
+        test.testRecordWithNoRenderQueue();
+        test.testRecordWithNull();
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        throw;
+    }
+
+    // Exit
+    glfwTerminate();
+    return 0;
+}
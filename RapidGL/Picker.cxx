@@ -0,0 +1,621 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <m3d/Vec4.h>
+#include "RapidGL/Picker.h"
+#include "RapidGL/TransformNode.h"
+namespace RapidGL {
+
+// Relative amount to loosen limits by when testing packets
+const double Picker::LIMIT_TOLERANCE = 1e-5;
+
+/**
+ * Constructs a picker for a scene.
+ *
+ * The scene is not walked until the first pick or `update`.
+ *
+ * @param root Root of scene to pick from
+ * @throws invalid_argument if root is `NULL`
+ */
+Picker::Picker(Node* const root) : root(root), dirty(true), walkCount(0) {
+    if (root == NULL) {
+        throw std::invalid_argument("[Picker] Root is NULL!");
+    }
+}
+
+/**
+ * Destructs a picker, no longer listening to the nodes in the scene.
+ */
+Picker::~Picker() {
+    for (std::map<Node*,Placement>::const_iterator it = placements.begin(); it != placements.end(); ++it) {
+        it->first->removeNodeListener(this);
+    }
+}
+
+/**
+ * Constructs a comparator.
+ *
+ * @param items Items to compare the centers of
+ * @param axis Index of axis to compare along
+ */
+Picker::CenterComparator::CenterComparator(const std::vector<Item>& items, const int axis) :
+        items(&items),
+        axis(axis) {
+    // empty
+}
+
+/**
+ * Checks if one item's center is before another's along the axis.
+ *
+ * @param a Index of first item
+ * @param b Index of second item
+ * @return `true` if the first item's center is before the second's
+ */
+bool Picker::CenterComparator::operator()(const size_t a, const size_t b) const {
+    return (*items)[a].center[axis] < (*items)[b].center[axis];
+}
+
+/**
+ * Builds part of the hierarchy over a range of items, splitting them at the median of the longest axis.
+ *
+ * Branches are added parents first, so a branch's first child always follows it.
+ *
+ * @param first Index in order of first item
+ * @param count Number of items
+ * @return Index of branch enclosing the items
+ */
+size_t Picker::build(const size_t first, const size_t count) {
+
+    // Enclose the items and their centers
+    const size_t index = branches.size();
+    branches.push_back(Branch());
+    BoundingBox box;
+    double low[3], high[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        low[axis] = std::numeric_limits<double>::infinity();
+        high[axis] = -std::numeric_limits<double>::infinity();
+    }
+    for (size_t i = first; i < first + count; ++i) {
+        const Item& item = items[order[i]];
+        box.add(item.box);
+        for (int axis = 0; axis < 3; ++axis) {
+            low[axis] = std::min(low[axis], item.center[axis]);
+            high[axis] = std::max(high[axis], item.center[axis]);
+        }
+    }
+    branches[index].box = box;
+
+    // Make a leaf if there are only a few items
+    if (count <= LEAF_SIZE) {
+        branches[index].right = 0;
+        branches[index].first = first;
+        branches[index].count = count;
+        branches[index].axis = 0;
+        return index;
+    }
+
+    // Otherwise split at the median along the axis the centers are most spread out on
+    int axis = 0;
+    for (int i = 1; i < 3; ++i) {
+        if ((high[i] - low[i]) > (high[axis] - low[axis])) {
+            axis = i;
+        }
+    }
+    const size_t half = count / 2;
+    std::nth_element(
+            order.begin() + first,
+            order.begin() + first + half,
+            order.begin() + first + count,
+            CenterComparator(items, axis));
+    build(first, half);
+    const size_t right = build(first + half, count - half);
+    branches[index].right = right;
+    branches[index].first = 0;
+    branches[index].count = 0;
+    branches[index].axis = axis;
+    return index;
+}
+
+/**
+ * Walks the scene, boxing each intersectable in world space and listening to every node.
+ *
+ * @return `true` if the same intersectables were found in the same order as last time
+ */
+bool Picker::collect() {
+
+    std::map<Node*,Placement> found;
+    size_t count = 0;
+    size_t index = 0;
+    bool same = true;
+
+    pending.clear();
+    const Pending start = { root, M3d::Mat4(1), false };
+    pending.push_back(start);
+    while (!pending.empty()) {
+
+        const Pending current = pending.back();
+        pending.pop_back();
+        Node* const node = current.node;
+
+        // Note where its descendants end once they have been walked
+        if (current.leaving) {
+            found[node].end = index;
+            continue;
+        }
+
+        // Listen to it and remember where it is
+        if (placements.count(node) == 0) {
+            node->addNodeListener(this);
+        }
+        Placement& placement = found[node];
+        placement.matrix = current.matrix;
+        placement.index = index++;
+        placement.item = count;
+        ++walkCount;
+
+        // Box it if it is intersectable
+        const Intersectable* const intersectable = dynamic_cast<const Intersectable*>(node);
+        if (intersectable != NULL) {
+            if (count == items.size()) {
+                items.push_back(Item());
+                same = false;
+            } else if (items[count].node != node) {
+                same = false;
+            }
+            Item& item = items[count++];
+            item.node = node;
+            item.intersectable = intersectable;
+            place(item, current.matrix);
+        }
+
+        // Walk children in order, then come back to it
+        const M3d::Mat4 matrix = transform(node, current.matrix);
+        const Pending leaving = { node, matrix, true };
+        pending.push_back(leaving);
+        const Node::node_range_t children = node->getChildren();
+        for (Node::node_iterator_t it = children.end; it != children.begin; ) {
+            --it;
+            const Pending child = { *it, matrix, false };
+            pending.push_back(child);
+        }
+    }
+    if (count != items.size()) {
+        items.resize(count);
+        same = false;
+    }
+
+    // Stop listening to nodes no longer in the scene
+    for (std::map<Node*,Placement>::const_iterator it = placements.begin(); it != placements.end(); ++it) {
+        if (found.count(it->first) == 0) {
+            it->first->removeNodeListener(this);
+        }
+    }
+    placements.swap(found);
+
+    return same;
+}
+
+/**
+ * Returns the number of intersectables found the last time the scene was walked.
+ *
+ * @return Number of intersectables found the last time the scene was walked
+ */
+size_t Picker::getIntersectableCount() const {
+    return items.size();
+}
+
+/**
+ * Returns the number of nodes walked the last time the picker was updated.
+ *
+ * @return Number of nodes walked the last time the picker was updated
+ */
+size_t Picker::getWalkCount() const {
+    return walkCount;
+}
+
+/**
+ * Returns the root of the scene this picker picks from.
+ *
+ * @return Root of the scene this picker picks from
+ */
+Node* Picker::getRoot() const {
+    return root;
+}
+
+/**
+ * Computes where a ray enters a box.
+ *
+ * @param box Box to intersect
+ * @param origin Origin of ray
+ * @param inverseDirection Reciprocal of each component of the ray's direction
+ * @return Distance along ray where it enters box, zero if it starts inside, or infinity if it misses
+ */
+double Picker::intersect(const BoundingBox& box, const M3d::Vec3& origin, const M3d::Vec3& inverseDirection) {
+
+    if (box.isInfinite()) {
+        return 0;
+    } else if (box.isEmpty()) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    const M3d::Vec3 min = box.getMin();
+    const M3d::Vec3 max = box.getMax();
+    double near = 0;
+    double far = std::numeric_limits<double>::infinity();
+
+    // Clip against each pair of slabs
+    const double x1 = (min.x - origin.x) * inverseDirection.x;
+    const double x2 = (max.x - origin.x) * inverseDirection.x;
+    near = std::max(near, std::min(x1, x2));
+    far = std::min(far, std::max(x1, x2));
+    const double y1 = (min.y - origin.y) * inverseDirection.y;
+    const double y2 = (max.y - origin.y) * inverseDirection.y;
+    near = std::max(near, std::min(y1, y2));
+    far = std::min(far, std::max(y1, y2));
+    const double z1 = (min.z - origin.z) * inverseDirection.z;
+    const double z2 = (max.z - origin.z) * inverseDirection.z;
+    near = std::max(near, std::min(z1, z2));
+    far = std::min(far, std::max(z1, z2));
+
+    return (near <= far) ? near : std::numeric_limits<double>::infinity();
+}
+
+/**
+ * Marks a node as changed so its subtree is walked again before the next pick.
+ *
+ * @param node Node that changed
+ */
+void Picker::nodeChanged(Node* const node) {
+    changed.insert(node);
+    dirty = true;
+}
+
+/**
+ * Finds the nearest intersectable node hit by a ray.
+ *
+ * Rays are in world space, and are transformed into each intersectable's
+ * space before it is tested.  The direction is not normalized, so distances
+ * are in multiples of its length.
+ *
+ * @param ray Ray in world space
+ * @return Nearest node hit and how far along the ray it was hit
+ */
+Picker::Hit Picker::pick(const Glycerin::Ray& ray) {
+
+    if (dirty) {
+        update();
+    }
+
+    Hit hit = { NULL, -1 };
+    if (branches.empty()) {
+        return hit;
+    }
+
+    const M3d::Vec3 origin(ray.origin.x, ray.origin.y, ray.origin.z);
+    const M3d::Vec3 inverseDirection(1 / ray.direction.x, 1 / ray.direction.y, 1 / ray.direction.z);
+    double best = std::numeric_limits<double>::infinity();
+
+    stack.clear();
+    const double distance = intersect(branches[0].box, origin, inverseDirection);
+    if (distance < best) {
+        stack.push_back(std::make_pair((size_t) 0, distance));
+    }
+    while (!stack.empty()) {
+
+        // Skip branches further than the nearest hit so far
+        const std::pair<size_t,double> entry = stack.back();
+        stack.pop_back();
+        if (entry.second >= best) {
+            continue;
+        }
+        const size_t index = entry.first;
+        const Branch& branch = branches[index];
+
+        // Test items in a leaf
+        if (branch.right == 0) {
+            for (size_t i = branch.first; i < branch.first + branch.count; ++i) {
+                const Item& item = items[order[i]];
+                if (intersect(item.box, origin, inverseDirection) >= best) {
+                    continue;
+                }
+                const Glycerin::Ray localRay(
+                        item.inverseMatrix * ray.origin,
+                        item.inverseMatrix * ray.direction);
+                const double t = item.intersectable->intersect(localRay);
+                if ((t >= 0) && (t < best)) {
+                    best = t;
+                    hit.node = item.node;
+                    hit.distance = t;
+                }
+            }
+            continue;
+        }
+
+        // Otherwise descend into the children it hits, nearest first
+        const size_t left = index + 1;
+        const size_t right = branch.right;
+        const double leftDistance = intersect(branches[left].box, origin, inverseDirection);
+        const double rightDistance = intersect(branches[right].box, origin, inverseDirection);
+        if (leftDistance < rightDistance) {
+            if (rightDistance < best) {
+                stack.push_back(std::make_pair(right, rightDistance));
+            }
+            stack.push_back(std::make_pair(left, leftDistance));
+        } else {
+            if (leftDistance < best) {
+                stack.push_back(std::make_pair(left, leftDistance));
+            }
+            if (rightDistance < best) {
+                stack.push_back(std::make_pair(right, rightDistance));
+            }
+        }
+    }
+
+    return hit;
+}
+
+/**
+ * Finds the nearest intersectable node hit by each of several rays.
+ *
+ * Rays are picked in packets, so a box is tested against a whole packet at
+ * once.  Rays near each other, like those through neighbouring pixels, share
+ * the most work.
+ *
+ * @param rays Rays in world space
+ * @param hits Nearest node hit by each ray and how far along it was hit, resized to match rays
+ */
+void Picker::pick(const std::vector<Glycerin::Ray>& rays, std::vector<Hit>& hits) {
+
+    if (dirty) {
+        update();
+    }
+
+    hits.resize(rays.size());
+    for (size_t first = 0; first < rays.size(); first += RayPacket::CAPACITY) {
+        const size_t count = std::min(RayPacket::CAPACITY, rays.size() - first);
+        packet.clear();
+        for (size_t i = first; i < first + count; ++i) {
+            packet.add(rays[i]);
+        }
+        pickPacket(&rays[first], &hits[first]);
+    }
+}
+
+/**
+ * Finds the nearest intersectable node hit by each ray in the packet.
+ *
+ * Branches are skipped once none of the rays hit them before their nearest
+ * hit so far.  Items are tested against the packet first, and only rays that
+ * hit an item's box are tested against the item itself.
+ *
+ * @param rays Rays in the packet
+ * @param hits Where to store the nearest hit of each ray
+ */
+void Picker::pickPacket(const Glycerin::Ray* const rays, Hit* const hits) {
+
+    const size_t size = packet.getSize();
+    float best[RayPacket::CAPACITY];
+    float distances[RayPacket::CAPACITY];
+    for (size_t i = 0; i < RayPacket::CAPACITY; ++i) {
+        best[i] = std::numeric_limits<float>::infinity();
+    }
+    for (size_t i = 0; i < size; ++i) {
+        hits[i].node = NULL;
+        hits[i].distance = -1;
+    }
+    if (branches.empty()) {
+        return;
+    }
+
+    packetStack.clear();
+    packetStack.push_back(0);
+    while (!packetStack.empty()) {
+
+        // Skip branches none of the rays hit in time
+        const size_t index = packetStack.back();
+        packetStack.pop_back();
+        const Branch& branch = branches[index];
+        if (packet.intersect(branch.box, best, distances) == 0) {
+            continue;
+        }
+
+        // Descend into children, starting with the one the first ray reaches first
+        if (branch.right != 0) {
+            const M3d::Vec4& direction = rays[0].direction;
+            const double component = (branch.axis == 0) ? direction.x : (branch.axis == 1) ? direction.y : direction.z;
+            if (component < 0) {
+                packetStack.push_back(index + 1);
+                packetStack.push_back(branch.right);
+            } else {
+                packetStack.push_back(branch.right);
+                packetStack.push_back(index + 1);
+            }
+            continue;
+        }
+
+        // Test items in a leaf against the rays that hit their boxes
+        for (size_t i = branch.first; i < branch.first + branch.count; ++i) {
+            const Item& item = items[order[i]];
+            const int mask = packet.intersect(item.box, best, distances);
+            for (size_t j = 0; j < size; ++j) {
+                if ((mask & (1 << j)) == 0) {
+                    continue;
+                }
+                const Glycerin::Ray localRay(
+                        item.inverseMatrix * rays[j].origin,
+                        item.inverseMatrix * rays[j].direction);
+                const double t = item.intersectable->intersect(localRay);
+                if ((t >= 0) && ((hits[j].node == NULL) || (t < hits[j].distance))) {
+
+                    // Loosen the limit a little since boxes are tested in single precision
+                    best[j] = (float) (t * (1 + LIMIT_TOLERANCE) + LIMIT_TOLERANCE);
+                    hits[j].node = item.node;
+                    hits[j].distance = t;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Boxes an item in world space.
+ *
+ * @param item Item to box, with its node set
+ * @param matrix Model matrix of the node's parent
+ */
+void Picker::place(Item& item, const M3d::Mat4& matrix) {
+    item.inverseMatrix = M3d::inverse(matrix);
+    const BoundingBox bounds = item.node->getBounds();
+    item.box = bounds.isEmpty() ? BoundingBox::infinite() : bounds.transform(matrix);
+    for (int axis = 0; axis < 3; ++axis) {
+        item.center[axis] = 0;
+    }
+    if (!item.box.isInfinite()) {
+        const M3d::Vec3 min = item.box.getMin();
+        const M3d::Vec3 max = item.box.getMax();
+        item.center[0] = (min.x + max.x) * 0.5;
+        item.center[1] = (min.y + max.y) * 0.5;
+        item.center[2] = (min.z + max.z) * 0.5;
+    }
+}
+
+/**
+ * Fits the boxes of the hierarchy around the items again after they moved.
+ */
+void Picker::refit() {
+    for (size_t i = branches.size(); i > 0; --i) {
+        Branch& branch = branches[i - 1];
+        BoundingBox box;
+        if (branch.right == 0) {
+            for (size_t j = branch.first; j < branch.first + branch.count; ++j) {
+                box.add(items[order[j]].box);
+            }
+        } else {
+            box.add(branches[i].box);
+            box.add(branches[branch.right].box);
+        }
+        branch.box = box;
+    }
+}
+
+/**
+ * Computes the model matrix a node's children are walked with.
+ *
+ * @param node Node to apply
+ * @param matrix Model matrix of the node's parent
+ * @return Model matrix after applying the node if it is a `TransformNode`, otherwise the same matrix
+ */
+M3d::Mat4 Picker::transform(Node* const node, const M3d::Mat4& matrix) {
+    if (dynamic_cast<TransformNode*>(node) == NULL) {
+        return matrix;
+    }
+    state.setModelMatrix(matrix);
+    node->visit(state);
+    return state.getModelMatrix();
+}
+
+/**
+ * Walks the subtrees of nodes that changed, or the whole scene if nodes were added or removed.
+ *
+ * The hierarchy is refit if the same intersectables were found, otherwise it is rebuilt.
+ */
+void Picker::update() {
+
+    // Walk just what changed if it is all still where it was
+    walkCount = 0;
+    bool walked = !changed.empty();
+    for (std::set<Node*>::const_iterator it = changed.begin(); walked && (it != changed.end()); ++it) {
+        walked = walk(*it);
+    }
+    changed.clear();
+    dirty = false;
+    if (walked) {
+        refit();
+        return;
+    }
+
+    // Otherwise walk everything
+    walkCount = 0;
+    if (collect()) {
+        refit();
+    } else {
+        order.resize(items.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        branches.clear();
+        if (!items.empty()) {
+            build(0, items.size());
+        }
+    }
+}
+
+/**
+ * Walks the subtree of a node again, boxing the intersectables in it.
+ *
+ * @param node Root of subtree to walk
+ * @return `true` if the subtree had the same nodes in the same order as the last time the scene was walked
+ */
+bool Picker::walk(Node* const node) {
+
+    const std::map<Node*,Placement>::const_iterator it = placements.find(node);
+    if (it == placements.end()) {
+        return false;
+    }
+    size_t index = it->second.index;
+    const size_t end = it->second.end;
+
+    pending.clear();
+    const Pending start = { node, it->second.matrix, false };
+    pending.push_back(start);
+    while (!pending.empty()) {
+
+        const Pending current = pending.back();
+        pending.pop_back();
+
+        // Stop if it was not found here last time
+        const std::map<Node*,Placement>::iterator found = placements.find(current.node);
+        if ((found == placements.end()) || (found->second.index != index)) {
+            return false;
+        }
+        Placement& placement = found->second;
+        placement.matrix = current.matrix;
+        ++index;
+        ++walkCount;
+
+        // Box it again if it is intersectable
+        if (dynamic_cast<const Intersectable*>(current.node) != NULL) {
+            place(items[placement.item], current.matrix);
+        }
+
+        // Walk children in order
+        const M3d::Mat4 matrix = transform(current.node, current.matrix);
+        const Node::node_range_t children = current.node->getChildren();
+        for (Node::node_iterator_t child = children.end; child != children.begin; ) {
+            --child;
+            const Pending next = { *child, matrix, false };
+            pending.push_back(next);
+        }
+    }
+    return index == end;
+}
+
+} /* namespace RapidGL */
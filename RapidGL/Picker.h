@@ -0,0 +1,160 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RAPIDGL_PICKER_H
+#define RAPIDGL_PICKER_H
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+#include <glycerin/Ray.hxx>
+#include <m3d/Mat4.h>
+#include <m3d/Vec3.h>
+#include "RapidGL/common.h"
+#include "RapidGL/BoundingBox.h"
+#include "RapidGL/Intersectable.h"
+#include "RapidGL/Node.h"
+#include "RapidGL/NodeListener.h"
+#include "RapidGL/RayPacket.h"
+#include "RapidGL/State.h"
+namespace RapidGL {
+
+
+/**
+ * Utility for finding the nearest node in a scene hit by a ray.
+ *
+ * Keeps a bounding volume hierarchy over every `Intersectable` node in the
+ * scene, boxed in world space using the transformations of their ancestor
+ * `TransformNode`s.  Picking descends only into boxes the ray hits, nearest
+ * first, so it takes logarithmic time in the number of intersectables.
+ * Many rays can be picked at once, in which case they are grouped into
+ * `RayPacket`s that descend the hierarchy together.
+ *
+ * The picker listens to every node in the scene.  After some of them change,
+ * the next pick walks just the subtrees of the nodes that changed, boxing the
+ * intersectables in them again, and refits the boxes of the hierarchy around
+ * the items.  Refitting still touches every box in the hierarchy, but only
+ * takes a union of two boxes for each, so moving one object costs much less
+ * than walking the scene.  If nodes were added or removed, the whole scene is
+ * walked again and the hierarchy is rebuilt.  Nodes removed from the scene
+ * should be kept alive until the next pick or `update`, when the picker stops
+ * listening to them, and the picker should be destroyed before the scene.
+ * Groups revisited by `InstanceNode`s are only picked where they are in the
+ * scene.
+ */
+class Picker : public NodeListener {
+public:
+// Types
+    /**
+     * Nearest node hit by a ray.
+     */
+    struct Hit {
+        Node* node;        ///< Node hit, or `NULL` if nothing was hit
+        double distance;   ///< Distance along ray in multiples of its direction, or -1 if nothing was hit
+    };
+// Methods
+    Picker(Node* root);
+    virtual ~Picker();
+    size_t getIntersectableCount() const;
+    size_t getWalkCount() const;
+    Node* getRoot() const;
+    virtual void nodeChanged(Node* node);
+    Hit pick(const Glycerin::Ray& ray);
+    void pick(const std::vector<Glycerin::Ray>& rays, std::vector<Hit>& hits);
+    void update();
+private:
+// Types
+    /**
+     * Intersectable node and where it is in the world.
+     */
+    struct Item {
+        Node* node;
+        const Intersectable* intersectable;
+        M3d::Mat4 inverseMatrix;
+        BoundingBox box;
+        double center[3];
+    };
+    /**
+     * Box in the hierarchy, either enclosing two other boxes or a few items.
+     */
+    struct Branch {
+        BoundingBox box;
+        size_t right;      ///< Index of second child, the first being next, or zero for a leaf
+        size_t first;      ///< Index of first item in a leaf
+        size_t count;      ///< Number of items in a leaf
+        int axis;          ///< Axis items were split along, the second child's being further along it
+    };
+    /**
+     * Orders items by the center of their boxes along one axis.
+     */
+    class CenterComparator {
+    public:
+        CenterComparator(const std::vector<Item>& items, int axis);
+        bool operator()(size_t a, size_t b) const;
+    private:
+        const std::vector<Item>* items;
+        int axis;
+    };
+    /**
+     * Node waiting to be walked and the model matrix of its parent.
+     */
+    struct Pending {
+        Node* node;
+        M3d::Mat4 matrix;
+        bool leaving;      ///< Whether the node's descendants have already been walked
+    };
+    /**
+     * Where a node was found the last time the scene was walked.
+     */
+    struct Placement {
+        M3d::Mat4 matrix;  ///< Model matrix of its parent
+        size_t index;      ///< Index of the node in the order the scene was walked
+        size_t end;        ///< Index after the last of its descendants
+        size_t item;       ///< Index of the first item in its subtree
+    };
+// Constants
+    static const size_t LEAF_SIZE = 4;
+    static const double LIMIT_TOLERANCE;
+// Attributes
+    Node* const root;
+    bool dirty;
+    std::vector<Item> items;
+    std::vector<size_t> order;
+    std::vector<Branch> branches;
+    std::map<Node*,Placement> placements;
+    std::set<Node*> changed;
+    size_t walkCount;
+    std::vector<Pending> pending;
+    std::vector<std::pair<size_t,double> > stack;
+    RayPacket packet;
+    std::vector<size_t> packetStack;
+    State state;
+// Methods
+    Picker(const Picker&);
+    Picker& operator=(const Picker&);
+    size_t build(size_t first, size_t count);
+    bool collect();
+    static double intersect(const BoundingBox& box, const M3d::Vec3& origin, const M3d::Vec3& inverseDirection);
+    void pickPacket(const Glycerin::Ray* rays, Hit* hits);
+    static void place(Item& item, const M3d::Mat4& matrix);
+    void refit();
+    M3d::Mat4 transform(Node* node, const M3d::Mat4& matrix);
+    bool walk(Node* node);
+};
+
+} /* namespace RapidGL */
+#endif
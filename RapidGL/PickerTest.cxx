@@ -0,0 +1,281 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include <glycerin/Ray.hxx>
+#include <m3d/Vec3.h>
+#include <m3d/Vec4.h>
+#include "RapidGL/BoundingBox.h"
+#include "RapidGL/GroupNode.h"
+#include "RapidGL/Intersectable.h"
+#include "RapidGL/Node.h"
+#include "RapidGL/Picker.h"
+#include "RapidGL/State.h"
+#include "RapidGL/TranslateNode.h"
+
+
+/**
+ * Unit test for `Picker`.
+ */
+class PickerTest : public CppUnit::TestFixture {
+public:
+
+    // Threshold for floating-point comparisons
+    static const double TOLERANCE = 1e-6;
+
+    /**
+     * Fake intersectable node shaped like a ball with a diameter of one.
+     */
+    class BallNode : public RapidGL::Node, public RapidGL::Intersectable {
+    public:
+
+        virtual double intersect(const Glycerin::Ray& ray) const {
+            const M3d::Vec4& o = ray.origin;
+            const M3d::Vec4& d = ray.direction;
+            const double a = (d.x * d.x) + (d.y * d.y) + (d.z * d.z);
+            const double b = 2 * ((o.x * d.x) + (o.y * d.y) + (o.z * d.z));
+            const double c = (o.x * o.x) + (o.y * o.y) + (o.z * o.z) - 0.25;
+            const double discriminant = (b * b) - (4 * a * c);
+            if (discriminant < 0) {
+                return -1;
+            }
+            const double t = (-b - std::sqrt(discriminant)) / (2 * a);
+            return (t >= 0) ? t : -1;
+        }
+
+        virtual void visit(RapidGL::State& state) {
+            // empty
+        }
+
+    protected:
+
+        virtual RapidGL::BoundingBox computeBounds() {
+            RapidGL::BoundingBox box = RapidGL::Node::computeBounds();
+            box.add(RapidGL::BoundingBox(M3d::Vec3(-0.5, -0.5, -0.5), M3d::Vec3(0.5, 0.5, 0.5)));
+            return box;
+        }
+    };
+
+    // Root of scene
+    RapidGL::GroupNode root;
+
+    // Nodes in scene
+    std::vector<RapidGL::TranslateNode*> translateNodes;
+    std::vector<BallNode*> ballNodes;
+
+    /**
+     * Constructs the test.
+     */
+    PickerTest() : root("root") {
+        // empty
+    }
+
+    /**
+     * Deletes the nodes in the scene.
+     */
+    virtual ~PickerTest() {
+        for (size_t i = 0; i < ballNodes.size(); ++i) {
+            delete ballNodes[i];
+            delete translateNodes[i];
+        }
+    }
+
+    /**
+     * Adds a ball to the scene.
+     *
+     * @param position Position of ball
+     * @return Node translating the ball
+     */
+    RapidGL::TranslateNode* addBall(const M3d::Vec3& position) {
+        RapidGL::TranslateNode* const translateNode = new RapidGL::TranslateNode(position);
+        BallNode* const ballNode = new BallNode();
+        translateNode->addChild(ballNode);
+        root.addChild(translateNode);
+        translateNodes.push_back(translateNode);
+        ballNodes.push_back(ballNode);
+        return translateNode;
+    }
+
+    /**
+     * Adds a grid of balls to the scene, spaced two apart.
+     *
+     * @param size Number of balls along each side of the grid
+     */
+    void addGrid(const int size) {
+        for (int i = 0; i < size; ++i) {
+            for (int j = 0; j < size; ++j) {
+                for (int k = 0; k < size; ++k) {
+                    addBall(M3d::Vec3(i * 2, j * 2, k * 2));
+                }
+            }
+        }
+    }
+
+    /**
+     * Ensures `Picker::pick` finds the nearest ball in a grid.
+     */
+    void testPick() {
+
+        addGrid(10);
+        RapidGL::Picker picker(&root);
+
+        // Shoot down through the column at (4, 6)
+        const Glycerin::Ray ray(M3d::Vec4(4, 6, 100, 1), M3d::Vec4(0, 0, -1, 0));
+        const RapidGL::Picker::Hit hit = picker.pick(ray);
+        CPPUNIT_ASSERT_EQUAL((size_t) 1000, picker.getIntersectableCount());
+        CPPUNIT_ASSERT_EQUAL((RapidGL::Node*) ballNodes[(2 * 100) + (3 * 10) + 9], hit.node);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(100 - 18 - 0.5, hit.distance, TOLERANCE);
+    }
+
+    /**
+     * Ensures `Picker::pick` finds the same balls as testing every one of them.
+     */
+    void testPickAgainstEveryBall() {
+
+        addGrid(8);
+        RapidGL::Picker picker(&root);
+
+        srand(7);
+        for (int i = 0; i < 200; ++i) {
+
+            // Make a ray from somewhere around the grid towards somewhere in it
+            const M3d::Vec4 origin(rand() % 40 - 12, rand() % 40 - 12, rand() % 40 - 12, 1);
+            const M3d::Vec4 target(rand() % 15, rand() % 15, rand() % 15, 1);
+            const Glycerin::Ray ray(origin, target - origin);
+
+            // Find nearest by testing every ball
+            double best = -1;
+            for (size_t j = 0; j < ballNodes.size(); ++j) {
+                const M3d::Vec3 position = translateNodes[j]->getTranslation();
+                const M3d::Vec4 offset(position.x, position.y, position.z, 0);
+                const double t = ballNodes[j]->intersect(Glycerin::Ray(origin - offset, ray.direction));
+                if ((t >= 0) && ((best < 0) || (t < best))) {
+                    best = t;
+                }
+            }
+
+            // Compare
+            const RapidGL::Picker::Hit hit = picker.pick(ray);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(best, hit.distance, TOLERANCE);
+        }
+    }
+
+    /**
+     * Ensures `Picker::pick` finds a ball added after the last pick.
+     */
+    void testPickAfterAddChild() {
+
+        addGrid(2);
+        RapidGL::Picker picker(&root);
+        const Glycerin::Ray ray(M3d::Vec4(10, 10, 100, 1), M3d::Vec4(0, 0, -1, 0));
+        CPPUNIT_ASSERT(picker.pick(ray).node == NULL);
+
+        addBall(M3d::Vec3(10, 10, 0));
+        const RapidGL::Picker::Hit hit = picker.pick(ray);
+        CPPUNIT_ASSERT_EQUAL((size_t) 9, picker.getIntersectableCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 19, picker.getWalkCount());
+        CPPUNIT_ASSERT_EQUAL((RapidGL::Node*) ballNodes.back(), hit.node);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(99.5, hit.distance, TOLERANCE);
+    }
+
+    /**
+     * Ensures `Picker::pick` finds a ball moved after the last pick, walking only the nodes that moved.
+     */
+    void testPickAfterSetTranslation() {
+
+        addGrid(4);
+        RapidGL::Picker picker(&root);
+        const Glycerin::Ray ray(M3d::Vec4(20, 20, 100, 1), M3d::Vec4(0, 0, -1, 0));
+        CPPUNIT_ASSERT(picker.pick(ray).node == NULL);
+
+        translateNodes[5]->setTranslation(M3d::Vec3(20, 20, 3));
+        const RapidGL::Picker::Hit hit = picker.pick(ray);
+        CPPUNIT_ASSERT_EQUAL((RapidGL::Node*) ballNodes[5], hit.node);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(96.5, hit.distance, TOLERANCE);
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, picker.getWalkCount());
+    }
+
+    /**
+     * Ensures `Picker::pick` finds the same nodes for many rays at once as for each ray alone.
+     */
+    void testPickWithRays() {
+
+        addGrid(8);
+        RapidGL::Picker picker(&root);
+
+        // Make rays from around the grid towards somewhere in it
+        srand(11);
+        std::vector<Glycerin::Ray> rays;
+        for (int i = 0; i < 101; ++i) {
+            const M3d::Vec4 origin(rand() % 40 - 12, rand() % 40 - 12, rand() % 40 - 12, 1);
+            const M3d::Vec4 target(rand() % 15, rand() % 15, rand() % 15, 1);
+            rays.push_back(Glycerin::Ray(origin, target - origin));
+        }
+
+        // Compare
+        std::vector<RapidGL::Picker::Hit> hits;
+        picker.pick(rays, hits);
+        CPPUNIT_ASSERT_EQUAL(rays.size(), hits.size());
+        for (size_t i = 0; i < rays.size(); ++i) {
+            const RapidGL::Picker::Hit hit = picker.pick(rays[i]);
+            CPPUNIT_ASSERT_EQUAL(hit.node, hits[i].node);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(hit.distance, hits[i].distance, TOLERANCE);
+        }
+    }
+
+    /**
+     * Ensures `Picker::pick` returns no node if the ray misses everything.
+     */
+    void testPickWithMiss() {
+        addGrid(3);
+        RapidGL::Picker picker(&root);
+        const RapidGL::Picker::Hit hit = picker.pick(Glycerin::Ray(M3d::Vec4(0, 0, 100, 1), M3d::Vec4(0, 0, 1, 0)));
+        CPPUNIT_ASSERT(hit.node == NULL);
+        CPPUNIT_ASSERT_EQUAL(-1.0, hit.distance);
+    }
+
+    /**
+     * Ensures `Picker::Picker` throws if passed `NULL`.
+     */
+    void testPickerWithNull() {
+        CPPUNIT_ASSERT_THROW(RapidGL::Picker(NULL), std::invalid_argument);
+    }
+
+    CPPUNIT_TEST_SUITE(PickerTest);
+    CPPUNIT_TEST(testPick);
+    CPPUNIT_TEST(testPickAgainstEveryBall);
+    CPPUNIT_TEST(testPickAfterAddChild);
+    CPPUNIT_TEST(testPickAfterSetTranslation);
+    CPPUNIT_TEST(testPickWithMiss);
+    CPPUNIT_TEST(testPickWithRays);
+    CPPUNIT_TEST(testPickerWithNull);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(PickerTest::suite());
+    runner.run();
+    return 0;
+}
@@ -30,6 +30,7 @@ PolygonModeNode::PolygonModeNode(const GLenum mode) : mode(mode) {
     if (!isMode(mode)) {
         throw std::invalid_argument("[PolygonModeNode] Mode is invalid!");
     }
+    setHooks(VISIT);
 }
 
 /**
@@ -39,6 +40,15 @@ PolygonModeNode::~PolygonModeNode() {
     // empty
 }
 
+/**
+ * Returns an infinite box, since the polygon mode affects everything drawn after this node.
+ *
+ * @return Infinite box
+ */
+BoundingBox PolygonModeNode::computeBounds() {
+    return BoundingBox::infinite();
+}
+
 /**
  * Returns the mode this node applies.
  *
@@ -69,7 +79,13 @@ bool PolygonModeNode::isMode(const GLenum enumeration) {
  * Applies this node's polygon mode.
  */
 void PolygonModeNode::visit(State& state) {
-    glPolygonMode(GL_FRONT_AND_BACK, mode);
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    if (renderQueue != NULL) {
+        renderQueue->addBarrier(this, VISIT);
+        return;
+    }
+
+    state.getGLStateCache().setPolygonMode(mode);
 }
 
 } /* namespace RapidGL */
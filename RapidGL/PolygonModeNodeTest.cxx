@@ -82,6 +82,7 @@ public:
      */
     void testVisitWithFill() {
         glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+        state.getGLStateCache().invalidate();
         RapidGL::PolygonModeNode node(GL_FILL);
         node.visit(state);
         CPPUNIT_ASSERT_EQUAL((GLenum) GL_FILL, getPolygonMode());
@@ -92,6 +93,7 @@ public:
      */
     void testVisitWithLine() {
         glPolygonMode(GL_FRONT_AND_BACK, GL_POINT);
+        state.getGLStateCache().invalidate();
         RapidGL::PolygonModeNode node(GL_LINE);
         node.visit(state);
         CPPUNIT_ASSERT_EQUAL((GLenum) GL_LINE, getPolygonMode());
@@ -102,6 +104,7 @@ public:
      */
     void testVisitWithPoint() {
         glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        state.getGLStateCache().invalidate();
         RapidGL::PolygonModeNode node(GL_POINT);
         node.visit(state);
         CPPUNIT_ASSERT_EQUAL((GLenum) GL_POINT, getPolygonMode());
@@ -54,13 +54,13 @@ map<string,GLenum> PolygonModeNodeUnmarshaller::createModes() {
 }
 
 /**
- * Returns the value of the _mode_ attribute in a map.
+ * Returns the value of the _mode_ attribute.
  *
- * @param attributes Map of attributes to look in
+ * @param attributes Attributes to look in
  * @return Value of attribute
  * @throws std::runtime_error if mode is unspecified or invalid
  */
-GLenum PolygonModeNodeUnmarshaller::getMode(const map<string,string>& attributes) {
+GLenum PolygonModeNodeUnmarshaller::getMode(const AttributeView& attributes) {
 
     // Get the value
     const string value = findValue(attributes, "mode");
@@ -78,7 +78,7 @@ GLenum PolygonModeNodeUnmarshaller::getMode(const map<string,string>& attributes
     }
 }
 
-Node* PolygonModeNodeUnmarshaller::unmarshal(const std::map<std::string,std::string>& attributes) {
+Node* PolygonModeNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
     const GLenum mode = getMode(attributes);
     return new PolygonModeNode(mode);
 }
@@ -34,13 +34,13 @@ public:
 // Methods
     PolygonModeNodeUnmarshaller();
     virtual ~PolygonModeNodeUnmarshaller();
-    virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+    virtual Node* unmarshal(const AttributeView& attributes);
 private:
 // Constants
     static const std::map<std::string,GLenum> MODES;
 // Methods
     static std::map<std::string,GLenum> createModes();
-    static GLenum getMode(const std::map<std::string,std::string>& attributes);
+    static GLenum getMode(const AttributeView& attributes);
 };
 
 } /* namespace RapidGL */
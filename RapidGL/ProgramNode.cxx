@@ -18,6 +18,7 @@
 #include "config.h"
 #include <stdexcept>
 #include "RapidGL/ProgramNode.h"
+#include "RapidGL/UniformTable.h"
 namespace RapidGL {
 
 /**
@@ -31,12 +32,14 @@ ProgramNode::ProgramNode(const std::string& id) : Node(id), program(Gloop::Progr
     if (id.empty()) {
         throw std::invalid_argument("[ProgramNode] Identifier is empty!");
     }
+    setHooks(PRE_VISIT);
 }
 
 /**
  * Destructs this program node.
  */
 ProgramNode::~ProgramNode() {
+    UniformTable::release(program);
     program.dispose();
 }
 
@@ -77,7 +80,7 @@ Gloop::Program ProgramNode::getProgram() const {
     return program;
 }
 
-void ProgramNode::preVisit(State& state) {
+void ProgramNode::prepare(State& state) {
 
     // Skip if already prepared
     if (prepared) {
@@ -125,8 +128,19 @@ void ProgramNode::preVisit(State& state) {
         }
     }
 
+    // Look up uniforms once for every uniform node
+    UniformTable::create(program);
+
     // Successfully prepared
     prepared = true;
+    setHooks(getHooks() & ~PRE_VISIT);
+}
+
+/**
+ * Prepares this node if it was not prepared before being visited.
+ */
+void ProgramNode::preVisit(State& state) {
+    prepare(state);
 }
 
 void ProgramNode::visit(State& state) {
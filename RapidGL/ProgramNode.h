@@ -35,6 +35,7 @@ public:
     ProgramNode(const std::string& id);
     virtual ~ProgramNode();
     Gloop::Program getProgram() const;
+    virtual void prepare(State& state);
     virtual void preVisit(State& state);
     virtual void visit(State& state);
 private:
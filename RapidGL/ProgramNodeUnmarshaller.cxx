@@ -26,7 +26,7 @@ ProgramNodeUnmarshaller::ProgramNodeUnmarshaller() {
     // empty
 }
 
-std::string ProgramNodeUnmarshaller::getId(const std::map<std::string,std::string>& attributes) {
+std::string ProgramNodeUnmarshaller::getId(const AttributeView& attributes) {
     const std::string id = findValue(attributes, "id");
     if (id.empty()) {
         throw std::runtime_error("[ProgramNodeUnmarshaller] ID is unspecified!");
@@ -34,7 +34,7 @@ std::string ProgramNodeUnmarshaller::getId(const std::map<std::string,std::strin
     return id;
 }
 
-Node* ProgramNodeUnmarshaller::unmarshal(const std::map<std::string,std::string>& attributes) {
+Node* ProgramNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
     const std::string id = getId(attributes);
     return new ProgramNode(id);
 }
@@ -29,10 +29,10 @@ namespace RapidGL {
 class ProgramNodeUnmarshaller : public Unmarshaller {
 public:
     ProgramNodeUnmarshaller();
-    Node* unmarshal(const std::map<std::string,std::string>& attributes);
+    Node* unmarshal(const AttributeView& attributes);
 private:
 // Methods
-    static std::string getId(const std::map<std::string,std::string>& attributes);
+    static std::string getId(const AttributeView& attributes);
 };
 
 } /* namespace RapidGL */
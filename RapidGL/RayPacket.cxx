@@ -0,0 +1,217 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+#include "RapidGL/RayPacket.h"
+namespace RapidGL {
+
+// Defined here too since it is passed by reference, e.g. to `std::min`
+const size_t RayPacket::CAPACITY;
+
+/**
+ * Constructs an empty packet.
+ */
+RayPacket::RayPacket() {
+    clear();
+}
+
+/**
+ * Adds a ray to this packet.
+ *
+ * @param ray Ray to add
+ * @throws length_error if packet is full
+ */
+void RayPacket::add(const Glycerin::Ray& ray) {
+    if (size == CAPACITY) {
+        throw std::length_error("[RayPacket] Packet is full!");
+    }
+    originX[size] = (float) ray.origin.x;
+    originY[size] = (float) ray.origin.y;
+    originZ[size] = (float) ray.origin.z;
+    inverseDirectionX[size] = (float) (1 / ray.direction.x);
+    inverseDirectionY[size] = (float) (1 / ray.direction.y);
+    inverseDirectionZ[size] = (float) (1 / ray.direction.z);
+    ++size;
+}
+
+/**
+ * Removes all the rays from this packet.
+ */
+void RayPacket::clear() {
+    size = 0;
+    std::fill(originX, originX + CAPACITY, 0.0f);
+    std::fill(originY, originY + CAPACITY, 0.0f);
+    std::fill(originZ, originZ + CAPACITY, 0.0f);
+    std::fill(inverseDirectionX, inverseDirectionX + CAPACITY, 0.0f);
+    std::fill(inverseDirectionY, inverseDirectionY + CAPACITY, 0.0f);
+    std::fill(inverseDirectionZ, inverseDirectionZ + CAPACITY, 0.0f);
+}
+
+/**
+ * Returns the name of the instructions used to test boxes.
+ *
+ * @return "AVX", "SSE" or "scalar"
+ */
+const char* RayPacket::getKernelName() {
+#if defined(__AVX__)
+    return "AVX";
+#elif defined(__SSE__)
+    return "SSE";
+#else
+    return "scalar";
+#endif
+}
+
+/**
+ * Returns the number of rays in this packet.
+ *
+ * @return Number of rays in this packet
+ */
+size_t RayPacket::getSize() const {
+    return size;
+}
+
+/**
+ * Tests a box against every ray in this packet.
+ *
+ * @param box Box to test
+ * @param limits Furthest distance along each ray to look, `CAPACITY` of them
+ * @param distances Where each ray enters the box, `CAPACITY` of them, only meaningful for rays that hit
+ * @return Bit mask of rays that hit the box within their limits, with the first ray in the lowest bit
+ */
+int RayPacket::intersect(const BoundingBox& box, const float* const limits, float* const distances) const {
+
+    if (box.isEmpty() || (size == 0)) {
+        return 0;
+    } else if (box.isInfinite()) {
+        int mask = 0;
+        for (size_t i = 0; i < size; ++i) {
+            distances[i] = 0;
+            if (limits[i] >= 0) {
+                mask |= (1 << i);
+            }
+        }
+        return mask;
+    }
+
+    const M3d::Vec3 min = box.getMin();
+    const M3d::Vec3 max = box.getMax();
+    int mask = 0;
+
+#if defined(__AVX__)
+    const __m256 minX = _mm256_set1_ps((float) min.x);
+    const __m256 minY = _mm256_set1_ps((float) min.y);
+    const __m256 minZ = _mm256_set1_ps((float) min.z);
+    const __m256 maxX = _mm256_set1_ps((float) max.x);
+    const __m256 maxY = _mm256_set1_ps((float) max.y);
+    const __m256 maxZ = _mm256_set1_ps((float) max.z);
+    const __m256 zero = _mm256_setzero_ps();
+    for (size_t i = 0; i < size; i += 8) {
+        const __m256 ox = _mm256_loadu_ps(originX + i);
+        const __m256 oy = _mm256_loadu_ps(originY + i);
+        const __m256 oz = _mm256_loadu_ps(originZ + i);
+        const __m256 ix = _mm256_loadu_ps(inverseDirectionX + i);
+        const __m256 iy = _mm256_loadu_ps(inverseDirectionY + i);
+        const __m256 iz = _mm256_loadu_ps(inverseDirectionZ + i);
+        const __m256 x1 = _mm256_mul_ps(_mm256_sub_ps(minX, ox), ix);
+        const __m256 x2 = _mm256_mul_ps(_mm256_sub_ps(maxX, ox), ix);
+        const __m256 y1 = _mm256_mul_ps(_mm256_sub_ps(minY, oy), iy);
+        const __m256 y2 = _mm256_mul_ps(_mm256_sub_ps(maxY, oy), iy);
+        const __m256 z1 = _mm256_mul_ps(_mm256_sub_ps(minZ, oz), iz);
+        const __m256 z2 = _mm256_mul_ps(_mm256_sub_ps(maxZ, oz), iz);
+        const __m256 near = _mm256_max_ps(
+                _mm256_max_ps(_mm256_min_ps(x1, x2), _mm256_min_ps(y1, y2)),
+                _mm256_max_ps(_mm256_min_ps(z1, z2), zero));
+        const __m256 far = _mm256_min_ps(
+                _mm256_min_ps(_mm256_max_ps(x1, x2), _mm256_max_ps(y1, y2)),
+                _mm256_min_ps(_mm256_max_ps(z1, z2), _mm256_loadu_ps(limits + i)));
+        _mm256_storeu_ps(distances + i, near);
+        mask |= _mm256_movemask_ps(_mm256_cmp_ps(near, far, _CMP_LE_OQ)) << i;
+    }
+#elif defined(__SSE__)
+    const __m128 minX = _mm_set1_ps((float) min.x);
+    const __m128 minY = _mm_set1_ps((float) min.y);
+    const __m128 minZ = _mm_set1_ps((float) min.z);
+    const __m128 maxX = _mm_set1_ps((float) max.x);
+    const __m128 maxY = _mm_set1_ps((float) max.y);
+    const __m128 maxZ = _mm_set1_ps((float) max.z);
+    const __m128 zero = _mm_setzero_ps();
+    for (size_t i = 0; i < size; i += 4) {
+        const __m128 ox = _mm_loadu_ps(originX + i);
+        const __m128 oy = _mm_loadu_ps(originY + i);
+        const __m128 oz = _mm_loadu_ps(originZ + i);
+        const __m128 ix = _mm_loadu_ps(inverseDirectionX + i);
+        const __m128 iy = _mm_loadu_ps(inverseDirectionY + i);
+        const __m128 iz = _mm_loadu_ps(inverseDirectionZ + i);
+        const __m128 x1 = _mm_mul_ps(_mm_sub_ps(minX, ox), ix);
+        const __m128 x2 = _mm_mul_ps(_mm_sub_ps(maxX, ox), ix);
+        const __m128 y1 = _mm_mul_ps(_mm_sub_ps(minY, oy), iy);
+        const __m128 y2 = _mm_mul_ps(_mm_sub_ps(maxY, oy), iy);
+        const __m128 z1 = _mm_mul_ps(_mm_sub_ps(minZ, oz), iz);
+        const __m128 z2 = _mm_mul_ps(_mm_sub_ps(maxZ, oz), iz);
+        const __m128 near = _mm_max_ps(
+                _mm_max_ps(_mm_min_ps(x1, x2), _mm_min_ps(y1, y2)),
+                _mm_max_ps(_mm_min_ps(z1, z2), zero));
+        const __m128 far = _mm_min_ps(
+                _mm_min_ps(_mm_max_ps(x1, x2), _mm_max_ps(y1, y2)),
+                _mm_min_ps(_mm_max_ps(z1, z2), _mm_loadu_ps(limits + i)));
+        _mm_storeu_ps(distances + i, near);
+        mask |= _mm_movemask_ps(_mm_cmple_ps(near, far)) << i;
+    }
+#else
+    for (size_t i = 0; i < size; ++i) {
+        const float x1 = ((float) min.x - originX[i]) * inverseDirectionX[i];
+        const float x2 = ((float) max.x - originX[i]) * inverseDirectionX[i];
+        const float y1 = ((float) min.y - originY[i]) * inverseDirectionY[i];
+        const float y2 = ((float) max.y - originY[i]) * inverseDirectionY[i];
+        const float z1 = ((float) min.z - originZ[i]) * inverseDirectionZ[i];
+        const float z2 = ((float) max.z - originZ[i]) * inverseDirectionZ[i];
+        const float near = std::max(
+                std::max(std::min(x1, x2), std::min(y1, y2)),
+                std::max(std::min(z1, z2), 0.0f));
+        const float far = std::min(
+                std::min(std::max(x1, x2), std::max(y1, y2)),
+                std::min(std::max(z1, z2), limits[i]));
+        distances[i] = near;
+        if (near <= far) {
+            mask |= (1 << i);
+        }
+    }
+#endif
+
+    // Ignore slots past the last ray
+    return mask & ((1 << size) - 1);
+}
+
+/**
+ * Checks if this packet cannot hold any more rays.
+ *
+ * @return `true` if this packet holds `CAPACITY` rays
+ */
+bool RayPacket::isFull() const {
+    return size == CAPACITY;
+}
+
+} /* namespace RapidGL */
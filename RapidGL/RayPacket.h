@@ -0,0 +1,59 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RAPIDGL_RAY_PACKET_H
+#define RAPIDGL_RAY_PACKET_H
+#include <glycerin/Ray.hxx>
+#include "RapidGL/common.h"
+#include "RapidGL/BoundingBox.h"
+namespace RapidGL {
+
+
+/**
+ * Group of rays tested against boxes all at once.
+ *
+ * Origins and reciprocal directions are stored in single precision, one array
+ * per component, so a box can be tested against several rays in one
+ * instruction.  Eight rays at a time are tested with AVX, four at a time with
+ * SSE, and one at a time otherwise, depending on what the compiler targets.
+ * Packets hold up to `CAPACITY` rays, and unused slots are ignored.
+ */
+class RayPacket {
+public:
+// Methods
+    RayPacket();
+    void add(const Glycerin::Ray& ray);
+    void clear();
+    static const char* getKernelName();
+    size_t getSize() const;
+    int intersect(const BoundingBox& box, const float* limits, float* distances) const;
+    bool isFull() const;
+// Constants
+    static const size_t CAPACITY = 16;
+private:
+// Attributes
+    size_t size;
+    float originX[CAPACITY];
+    float originY[CAPACITY];
+    float originZ[CAPACITY];
+    float inverseDirectionX[CAPACITY];
+    float inverseDirectionY[CAPACITY];
+    float inverseDirectionZ[CAPACITY];
+};
+
+} /* namespace RapidGL */
+#endif
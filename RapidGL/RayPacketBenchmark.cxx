@@ -0,0 +1,241 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include <Poco/Stopwatch.h>
+#include <glycerin/AxisAlignedBoundingBox.hxx>
+#include <glycerin/Ray.hxx>
+#include <m3d/Vec3.h>
+#include <m3d/Vec4.h>
+#include "RapidGL/BoundingBox.h"
+#include "RapidGL/GroupNode.h"
+#include "RapidGL/Intersectable.h"
+#include "RapidGL/Node.h"
+#include "RapidGL/Picker.h"
+#include "RapidGL/RayPacket.h"
+#include "RapidGL/State.h"
+#include "RapidGL/TranslateNode.h"
+
+
+/**
+ * Benchmark comparing `RayPacket` with testing one ray at a time.
+ *
+ * First every ray is tested against every box, once with
+ * `Glycerin::AxisAlignedBoundingBox::intersect` like `CubeNode::intersect`
+ * does, and once in packets.  Then a scene of boxes is picked from with
+ * `Picker`, once ray by ray and once with all the rays together.
+ */
+class RayPacketBenchmark {
+public:
+
+    /**
+     * Intersectable node shaped like a cube, tested the same way as `CubeNode`.
+     */
+    class BoxNode : public RapidGL::Node, public RapidGL::Intersectable {
+    public:
+
+        BoxNode() : boundingBox(M3d::Vec4(-0.5, -0.5, -0.5, 1), M3d::Vec4(0.5, 0.5, 0.5, 1)) {
+            // empty
+        }
+
+        virtual double intersect(const Glycerin::Ray& ray) const {
+            return boundingBox.intersect(ray);
+        }
+
+        virtual void visit(RapidGL::State& state) {
+            // empty
+        }
+
+    protected:
+
+        virtual RapidGL::BoundingBox computeBounds() {
+            return RapidGL::BoundingBox(M3d::Vec3(-0.5, -0.5, -0.5), M3d::Vec3(0.5, 0.5, 0.5));
+        }
+
+    private:
+        const Glycerin::AxisAlignedBoundingBox boundingBox;
+    };
+
+    // Number of rays to fire
+    static const int RAY_COUNT = 4096;
+
+    // Number of boxes to test every ray against
+    static const int BOX_COUNT = 256;
+
+    // Number of boxes along each side of the scene
+    static const int GRID_SIZE = 20;
+
+    // Rays to fire
+    std::vector<Glycerin::Ray> rays;
+
+    // Nodes in the scene
+    std::vector<RapidGL::Node*> nodes;
+
+    /**
+     * Destructs the benchmark, deleting the scene.
+     */
+    ~RayPacketBenchmark() {
+        for (std::vector<RapidGL::Node*>::iterator it = nodes.begin(); it != nodes.end(); ++it) {
+            delete (*it);
+        }
+    }
+
+    /**
+     * Returns a random number between zero and a maximum.
+     *
+     * @param max Largest number to return
+     * @return Random number between zero and max
+     */
+    static double random(const double max) {
+        return (((double) rand()) / RAND_MAX) * max;
+    }
+
+    /**
+     * Makes rays pointing from in front of the scene into it, neighbours close together like pixels.
+     */
+    void makeRays() {
+        const double size = GRID_SIZE * 2;
+        const M3d::Vec4 origin(size / 2, size / 2, size * 2, 1);
+        for (int i = 0; i < RAY_COUNT; ++i) {
+            const double x = ((i % 64) / 64.0) * size;
+            const double y = ((i / 64) / 64.0) * size;
+            const M3d::Vec4 target(x, y, 0, 1);
+            rays.push_back(Glycerin::Ray(origin, target - origin));
+        }
+    }
+
+    /**
+     * Prints how many rays were fired per second.
+     *
+     * @param name Description of what was timed
+     * @param stopwatch Stopwatch that timed it
+     */
+    static void report(const std::string& name, const Poco::Stopwatch& stopwatch) {
+        const double seconds = ((double) stopwatch.elapsed()) / 1000000;
+        std::cout << "  " << name << ": " << (RAY_COUNT / seconds) << " rays per second" << std::endl;
+    }
+
+    /**
+     * Times testing every ray against a set of boxes.
+     */
+    void runBoxes() {
+
+        // Make boxes
+        std::vector<Glycerin::AxisAlignedBoundingBox> aabbs;
+        std::vector<RapidGL::BoundingBox> boxes;
+        for (int i = 0; i < BOX_COUNT; ++i) {
+            const M3d::Vec3 min(random(GRID_SIZE * 2), random(GRID_SIZE * 2), random(GRID_SIZE * 2));
+            const M3d::Vec3 max = min + M3d::Vec3(1, 1, 1);
+            aabbs.push_back(Glycerin::AxisAlignedBoundingBox(M3d::Vec4(min, 1), M3d::Vec4(max, 1)));
+            boxes.push_back(RapidGL::BoundingBox(min, max));
+        }
+        Poco::Stopwatch stopwatch;
+        std::cout << "Every ray against " << BOX_COUNT << " boxes" << std::endl;
+
+        // One at a time
+        int hits = 0;
+        stopwatch.restart();
+        for (int i = 0; i < RAY_COUNT; ++i) {
+            for (int j = 0; j < BOX_COUNT; ++j) {
+                if (aabbs[j].intersect(rays[i]) >= 0) {
+                    ++hits;
+                }
+            }
+        }
+        stopwatch.stop();
+        report("per ray", stopwatch);
+
+        // In packets
+        RapidGL::RayPacket packet;
+        float limits[RapidGL::RayPacket::CAPACITY];
+        float distances[RapidGL::RayPacket::CAPACITY];
+        for (size_t i = 0; i < RapidGL::RayPacket::CAPACITY; ++i) {
+            limits[i] = std::numeric_limits<float>::infinity();
+        }
+        int packetHits = 0;
+        stopwatch.restart();
+        for (int i = 0; i < RAY_COUNT; i += RapidGL::RayPacket::CAPACITY) {
+            packet.clear();
+            for (size_t j = 0; j < RapidGL::RayPacket::CAPACITY; ++j) {
+                packet.add(rays[i + j]);
+            }
+            for (int j = 0; j < BOX_COUNT; ++j) {
+                const int mask = packet.intersect(boxes[j], limits, distances);
+                for (size_t k = 0; k < RapidGL::RayPacket::CAPACITY; ++k) {
+                    packetHits += (mask >> k) & 1;
+                }
+            }
+        }
+        stopwatch.stop();
+        report(std::string("packets (") + RapidGL::RayPacket::getKernelName() + ")", stopwatch);
+        std::cout << "  hits: " << hits << " per ray, " << packetHits << " in packets" << std::endl;
+    }
+
+    /**
+     * Times picking from a scene.
+     */
+    void runPicker() {
+
+        // Make a grid of boxes
+        RapidGL::GroupNode* const root = new RapidGL::GroupNode("root");
+        nodes.push_back(root);
+        for (int i = 0; i < GRID_SIZE; ++i) {
+            for (int j = 0; j < GRID_SIZE; ++j) {
+                for (int k = 0; k < GRID_SIZE; ++k) {
+                    RapidGL::TranslateNode* const translateNode = new RapidGL::TranslateNode(M3d::Vec3(i * 2, j * 2, k * 2));
+                    BoxNode* const boxNode = new BoxNode();
+                    translateNode->addChild(boxNode);
+                    root->addChild(translateNode);
+                    nodes.push_back(translateNode);
+                    nodes.push_back(boxNode);
+                }
+            }
+        }
+        RapidGL::Picker picker(root);
+        picker.update();
+        Poco::Stopwatch stopwatch;
+        std::cout << "Picking from " << picker.getIntersectableCount() << " boxes" << std::endl;
+
+        // One at a time
+        stopwatch.restart();
+        for (int i = 0; i < RAY_COUNT; ++i) {
+            picker.pick(rays[i]);
+        }
+        stopwatch.stop();
+        report("per ray", stopwatch);
+
+        // All at once
+        std::vector<RapidGL::Picker::Hit> hits;
+        stopwatch.restart();
+        picker.pick(rays, hits);
+        stopwatch.stop();
+        report(std::string("packets (") + RapidGL::RayPacket::getKernelName() + ")", stopwatch);
+    }
+};
+
+int main(int argc, char* argv[]) {
+    RayPacketBenchmark benchmark;
+    benchmark.makeRays();
+    benchmark.runBoxes();
+    benchmark.runPicker();
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <limits>
+#include <stdexcept>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include <glycerin/Ray.hxx>
+#include <m3d/Vec3.h>
+#include <m3d/Vec4.h>
+#include "RapidGL/BoundingBox.h"
+#include "RapidGL/RayPacket.h"
+
+
+/**
+ * Unit test for `RayPacket`.
+ */
+class RayPacketTest : public CppUnit::TestFixture {
+public:
+
+    // Threshold for floating-point comparisons
+    static const double TOLERANCE = 1e-5;
+
+    // Limits that do not limit anything
+    float limits[RapidGL::RayPacket::CAPACITY];
+
+    // Distances found by the last test
+    float distances[RapidGL::RayPacket::CAPACITY];
+
+    /**
+     * Constructs the test.
+     */
+    RayPacketTest() {
+        for (size_t i = 0; i < RapidGL::RayPacket::CAPACITY; ++i) {
+            limits[i] = std::numeric_limits<float>::infinity();
+        }
+    }
+
+    /**
+     * Makes a ray pointing down from above.
+     *
+     * @param x Position of ray along X axis
+     * @return Ray starting at (x, 0, 10) pointing down negative Z
+     */
+    static Glycerin::Ray makeRay(const double x) {
+        return Glycerin::Ray(M3d::Vec4(x, 0, 10, 1), M3d::Vec4(0, 0, -1, 0));
+    }
+
+    /**
+     * Ensures `RayPacket::add` throws if the packet is full.
+     */
+    void testAddWhenFull() {
+        RapidGL::RayPacket packet;
+        for (size_t i = 0; i < RapidGL::RayPacket::CAPACITY; ++i) {
+            packet.add(makeRay(0));
+        }
+        CPPUNIT_ASSERT(packet.isFull());
+        CPPUNIT_ASSERT_THROW(packet.add(makeRay(0)), std::length_error);
+    }
+
+    /**
+     * Ensures `RayPacket::intersect` finds which rays hit a box and where.
+     */
+    void testIntersect() {
+
+        // Make a full packet of rays spread out along X
+        RapidGL::RayPacket packet;
+        for (size_t i = 0; i < RapidGL::RayPacket::CAPACITY; ++i) {
+            packet.add(makeRay(i));
+        }
+
+        // Only rays over the box should hit it
+        const RapidGL::BoundingBox box(M3d::Vec3(2.5, -1, -1), M3d::Vec3(5.5, 1, 1));
+        const int mask = packet.intersect(box, limits, distances);
+        CPPUNIT_ASSERT_EQUAL((1 << 3) | (1 << 4) | (1 << 5), mask);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(9, distances[3], TOLERANCE);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(9, distances[5], TOLERANCE);
+    }
+
+    /**
+     * Ensures `RayPacket::intersect` ignores empty slots and handles empty and infinite boxes.
+     */
+    void testIntersectWithEmptyAndInfinite() {
+        RapidGL::RayPacket packet;
+        packet.add(makeRay(0));
+        packet.add(makeRay(100));
+        CPPUNIT_ASSERT_EQUAL(0, packet.intersect(RapidGL::BoundingBox(), limits, distances));
+        CPPUNIT_ASSERT_EQUAL(3, packet.intersect(RapidGL::BoundingBox::infinite(), limits, distances));
+    }
+
+    /**
+     * Ensures `RayPacket::intersect` misses boxes beyond each ray's limit.
+     */
+    void testIntersectWithLimits() {
+        RapidGL::RayPacket packet;
+        packet.add(makeRay(0));
+        packet.add(makeRay(0));
+        limits[0] = 5;
+        const RapidGL::BoundingBox box(M3d::Vec3(-1, -1, -1), M3d::Vec3(1, 1, 1));
+        CPPUNIT_ASSERT_EQUAL(2, packet.intersect(box, limits, distances));
+    }
+
+    CPPUNIT_TEST_SUITE(RayPacketTest);
+    CPPUNIT_TEST(testAddWhenFull);
+    CPPUNIT_TEST(testIntersect);
+    CPPUNIT_TEST(testIntersectWithEmptyAndInfinite);
+    CPPUNIT_TEST(testIntersectWithLimits);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(RayPacketTest::suite());
+    runner.run();
+    return 0;
+}
@@ -50,16 +50,38 @@ void Reader::addUnmarshaller(const std::string& name, Unmarshaller* unmarshaller
         throw std::invalid_argument("Unmarshaller is NULL!");
     }
 
-    unmarshallers[name] = unmarshaller;
+    // Give the name an ID if it does not have one
+    const int id = findId(name);
+    if (id < 0) {
+        idsByName[name] = (int) unmarshallers.size();
+        unmarshallers.push_back(unmarshaller);
+    } else {
+        unmarshallers[id] = unmarshaller;
+    }
 }
 
 void Reader::endElement(const std::string& uri, const std::string& localName, const std::string& qname) {
-    std::map<std::string,Unmarshaller*>::const_iterator it = unmarshallers.find(localName);
-    if ((it != unmarshallers.end()) && !nodeStack.empty()) {
-        nodeStack.pop();
+    if (elementStack.empty()) {
+        return;
+    }
+    const int id = elementStack.back();
+    elementStack.pop_back();
+    if ((id >= 0) && !nodeStack.empty()) {
+        nodeStack.pop_back();
     }
 }
 
+/**
+ * Finds the ID of an element name.
+ *
+ * @param name Name of XML element
+ * @return ID of element name, or `-1` if no unmarshaller was added for it
+ */
+int Reader::findId(const std::string& name) const {
+    const std::map<std::string,int>::const_iterator it = idsByName.find(name);
+    return (it == idsByName.end()) ? -1 : it->second;
+}
+
 /**
  * Reads a scene from a stream.
  *
@@ -70,9 +92,8 @@ Node* Reader::read(std::istream& stream) {
 
     // Reset
     rootNode = NULL;
-    while (!nodeStack.empty()) {
-        nodeStack.pop();
-    }
+    elementStack.clear();
+    nodeStack.clear();
 
     // Parse the stream
     Poco::XML::InputSource source(stream);
@@ -87,24 +108,16 @@ void Reader::startElement(const std::string& uri,
                           const std::string& qname,
                           const Poco::XML::Attributes& attrList) {
 
-    // Find the unmarshaller
-    std::map<std::string,Unmarshaller*>::const_iterator it = unmarshallers.find(localName);
-    if (it == unmarshallers.end()) {
+    // Find the unmarshaller, remembering the element for when it ends
+    const int id = findId(localName);
+    elementStack.push_back(id);
+    if (id < 0) {
         return;
     }
-    Unmarshaller* const unmarshaller = it->second;
-
-    // Convert the attributes list to a map
-    std::map<std::string,std::string> attrMap;
-    const int len = attrList.getLength();
-    for (int i = 0; i < len; ++i ) {
-        const std::string key = attrList.getLocalName(i);
-        const std::string value = attrList.getValue(i);
-        attrMap[key] = value;
-    }
+    Unmarshaller* const unmarshaller = unmarshallers[id];
 
-    // Unmarshal the node
-    Node* const node = unmarshaller->unmarshal(attrMap);
+    // Unmarshal the node from a view of the attributes
+    Node* const node = unmarshaller->unmarshal(AttributeView(attrList));
     if (node == NULL) {
         throw std::runtime_error("[Reader] Unmarshaller returned NULL!");
     }
@@ -117,12 +130,12 @@ void Reader::startElement(const std::string& uri,
             throw std::runtime_error("[Reader] Multiple roots detected!");
         }
     } else {
-        Node* const parent = nodeStack.top();
+        Node* const parent = nodeStack.back();
         parent->addChild(node);
     }
 
     // Store node on the stack
-    nodeStack.push(node);
+    nodeStack.push_back(node);
 }
 
 } /* namespace RapidGL */
@@ -19,14 +19,15 @@
 #define RAPIDGL_READER_H
 #include <iostream>
 #include <map>
-#include <stack>
 #include <string>
+#include <vector>
 #include "Poco/SAX/Attributes.h"
 #include "Poco/SAX/DefaultHandler.h"
 #include "Poco/SAX/InputSource.h"
 #include "Poco/SAX/Locator.h"
 #include "Poco/SAX/SAXParser.h"
 #include "RapidGL/common.h"
+#include "RapidGL/AttributeView.h"
 #include "RapidGL/Node.h"
 #include "RapidGL/Unmarshaller.h"
 namespace RapidGL {
@@ -34,6 +35,11 @@ namespace RapidGL {
 
 /**
  * Utility for reading a scene from a stream.
+ *
+ * Element names are given IDs when unmarshallers are added, so each element
+ * is looked up once when it starts, and its ID is kept on a stack for when it
+ * ends.  Unmarshallers are given an `AttributeView` of the parser's attributes
+ * instead of a copy of them.
  */
 class Reader : public Poco::XML::DefaultHandler {
 public:
@@ -46,10 +52,14 @@ public:
     Node* read(std::istream& stream);
 private:
 // Attributes
-    std::map<std::string,Unmarshaller*> unmarshallers;
-    std::stack<Node*> nodeStack;
+    std::map<std::string,int> idsByName;
+    std::vector<Unmarshaller*> unmarshallers;
+    std::vector<int> elementStack;
+    std::vector<Node*> nodeStack;
     Poco::XML::SAXParser parser;
     Node* rootNode;
+// Methods
+    int findId(const std::string& name) const;
 };
 
 } /* namespace RapidGL */
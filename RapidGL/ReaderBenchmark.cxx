@@ -0,0 +1,207 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <Poco/Stopwatch.h>
+#include "Poco/SAX/Attributes.h"
+#include "Poco/SAX/DefaultHandler.h"
+#include "Poco/SAX/InputSource.h"
+#include "Poco/SAX/SAXParser.h"
+#include "RapidGL/AttributeView.h"
+#include "RapidGL/GroupNode.h"
+#include "RapidGL/Node.h"
+#include "RapidGL/Reader.h"
+#include "RapidGL/Unmarshaller.h"
+
+
+/**
+ * Benchmark comparing `Reader` with a handler that copies attributes into a map for each element.
+ *
+ * The copying handler does what `Reader` did before it used `AttributeView`s.
+ * Both make the same nodes with the same unmarshaller, and a handler that
+ * does nothing shows how much of the time is the parser itself.
+ */
+class ReaderBenchmark {
+public:
+
+    // Number of elements in the scene
+    static const int SIZE = 500000;
+
+    /**
+     * Unmarshaller making a group for each element.
+     */
+    class GroupUnmarshaller : public RapidGL::Unmarshaller {
+    public:
+        virtual RapidGL::Node* unmarshal(const RapidGL::AttributeView& attributes) {
+            return new RapidGL::GroupNode(findValue(attributes, "id"));
+        }
+    };
+
+    /**
+     * Handler that does nothing with the elements.
+     */
+    class EmptyHandler : public Poco::XML::DefaultHandler {
+        // empty
+    };
+
+    /**
+     * Handler that copies attributes into a map and looks up unmarshallers by name for each element.
+     */
+    class CopyingHandler : public Poco::XML::DefaultHandler {
+    public:
+
+        CopyingHandler(RapidGL::Unmarshaller* unmarshaller) : root(NULL) {
+            unmarshallers["group"] = unmarshaller;
+            unmarshallers["item"] = unmarshaller;
+        }
+
+        void endElement(const std::string& uri, const std::string& localName, const std::string& qname) {
+            if ((unmarshallers.find(localName) != unmarshallers.end()) && !stack.empty()) {
+                stack.pop_back();
+            }
+        }
+
+        void startElement(const std::string& uri,
+                          const std::string& localName,
+                          const std::string& qname,
+                          const Poco::XML::Attributes& attributes) {
+            const std::map<std::string,RapidGL::Unmarshaller*>::const_iterator it = unmarshallers.find(localName);
+            if (it == unmarshallers.end()) {
+                return;
+            }
+            std::map<std::string,std::string> map;
+            for (int i = 0; i < attributes.getLength(); ++i) {
+                map[attributes.getLocalName(i)] = attributes.getValue(i);
+            }
+            RapidGL::Node* const node = it->second->unmarshal(map);
+            if (stack.empty()) {
+                root = node;
+            } else {
+                stack.back()->addChild(node);
+            }
+            stack.push_back(node);
+        }
+
+        std::map<std::string,RapidGL::Unmarshaller*> unmarshallers;
+        std::vector<RapidGL::Node*> stack;
+        RapidGL::Node* root;
+    };
+
+    // Scene being parsed
+    std::string scene;
+
+    /**
+     * Makes a scene with a group holding many items.
+     */
+    ReaderBenchmark() {
+        std::stringstream stream;
+        stream << "<group id=\"root\">\n";
+        for (int i = 0; i < SIZE; ++i) {
+            stream << "  <item id=\"item" << i << "\" value=\"1.0 2.0 3.0\" usage=\"model\" />\n";
+        }
+        stream << "</group>\n";
+        scene = stream.str();
+    }
+
+    /**
+     * Deletes a scene made by parsing.
+     *
+     * @param root Root of scene
+     */
+    static void destroy(RapidGL::Node* root) {
+        if (root == NULL) {
+            return;
+        }
+        const RapidGL::Node::node_range_t children = root->getChildren();
+        std::vector<RapidGL::Node*> nodes(children.begin, children.end);
+        for (std::vector<RapidGL::Node*>::iterator it = nodes.begin(); it != nodes.end(); ++it) {
+            delete (*it);
+        }
+        delete root;
+    }
+
+    /**
+     * Parses the scene with a handler.
+     *
+     * @param handler Handler to give the elements to
+     */
+    void parse(Poco::XML::DefaultHandler* handler) {
+        std::istringstream stream(scene);
+        Poco::XML::InputSource source(stream);
+        Poco::XML::SAXParser parser;
+        parser.setContentHandler(handler);
+        parser.parse(&source);
+    }
+
+    /**
+     * Prints how long parsing took and how many elements were parsed per second.
+     *
+     * @param name Description of what parsed the scene
+     * @param stopwatch Stopwatch that timed it
+     */
+    static void print(const std::string& name, const Poco::Stopwatch& stopwatch) {
+        const double seconds = ((double) stopwatch.elapsed()) / Poco::Stopwatch::resolution();
+        std::cout << "  " << name << ": " << (seconds * 1000) << " ms, " << (SIZE / seconds) << " elements per second" << std::endl;
+    }
+
+    /**
+     * Times parsing the scene each way and prints the results.
+     */
+    void run() {
+
+        GroupUnmarshaller unmarshaller;
+        Poco::Stopwatch stopwatch;
+        std::cout << "Parse (" << SIZE << " elements)" << std::endl;
+
+        // Parser alone
+        EmptyHandler emptyHandler;
+        stopwatch.restart();
+        parse(&emptyHandler);
+        stopwatch.stop();
+        print("parser only", stopwatch);
+
+        // Copying attributes
+        CopyingHandler copyingHandler(&unmarshaller);
+        stopwatch.restart();
+        parse(&copyingHandler);
+        stopwatch.stop();
+        print("copying", stopwatch);
+        destroy(copyingHandler.root);
+
+        // Reader
+        RapidGL::Reader reader;
+        reader.addUnmarshaller("group", &unmarshaller);
+        reader.addUnmarshaller("item", &unmarshaller);
+        std::istringstream stream(scene);
+        stopwatch.restart();
+        RapidGL::Node* const root = reader.read(stream);
+        stopwatch.stop();
+        print("reader", stopwatch);
+        destroy(root);
+    }
+};
+
+int main(int argc, char* argv[]) {
+    ReaderBenchmark benchmark;
+    benchmark.run();
+    return 0;
+}
@@ -20,6 +20,7 @@
 #include <cppunit/extensions/HelperMacros.h>
 #include <cppunit/ui/text/TestRunner.h>
 #include <sstream>
+#include "RapidGL/AttributeView.h"
 #include "RapidGL/Node.h"
 #include "RapidGL/Reader.h"
 
@@ -50,12 +51,12 @@ public:
      */
     class FakeNodeUnmarshaller : public RapidGL::Unmarshaller {
     public:
-        virtual RapidGL::Node* unmarshal(const std::map<std::string,std::string>& attributes) {
-            const std::map<std::string,std::string>::const_iterator id = attributes.find("id");
-            if (id == attributes.end()) {
+        virtual RapidGL::Node* unmarshal(const RapidGL::AttributeView& attributes) {
+            const std::string* const id = attributes.find("id");
+            if (id == NULL) {
                 return new FakeNode("");
             } else {
-                return new FakeNode(id->second);
+                return new FakeNode(*id);
             }
         }
     };
@@ -0,0 +1,304 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <stdexcept>
+#include "RapidGL/RenderList.h"
+namespace RapidGL {
+
+/**
+ * Constructs an empty render list.
+ */
+RenderList::RenderList() : root(NULL), visitor(NULL) {
+    // empty
+}
+
+/**
+ * Destructs a render list, deregistering it from the nodes it compiled.
+ */
+RenderList::~RenderList() {
+    if (root != NULL) {
+        forget(root);
+    }
+    delete visitor;
+}
+
+/**
+ * Compiles a tree of nodes into this list, replacing what was in it.
+ *
+ * @param root Root of tree to compile
+ * @throws invalid_argument if root is `NULL`
+ */
+void RenderList::compile(Node* const root) {
+
+    if (root == NULL) {
+        throw std::invalid_argument("[RenderList] Root is NULL!");
+    }
+
+    // Forget previous tree
+    if (this->root != NULL) {
+        forget(this->root);
+    }
+    commands.clear();
+    dirty.clear();
+
+    // Flatten new tree
+    this->root = root;
+    flatten(root, commands);
+    reindex(root, 0);
+}
+
+/**
+ * Adds commands for a subtree to a list and starts listening to its nodes.
+ *
+ * @param node Root of subtree to add commands for
+ * @param commands List to add commands to
+ */
+void RenderList::flatten(Node* const node, std::vector<Command>& commands) {
+
+    // Record what the node looks like now
+    const int hooks = node->getHooks();
+    const Node::node_range_t children = node->getChildren();
+    Span& span = spans[node];
+    span.hooks = hooks;
+    span.children.assign(children.begin, children.end);
+    node->addNodeListener(this);
+
+    // Add commands for the node and its children
+    if (hooks & Node::PRE_VISIT) {
+        commands.push_back(Command(node, Node::PRE_VISIT));
+    }
+    if (hooks & Node::VISIT) {
+        commands.push_back(Command(node, Node::VISIT));
+    }
+    if (hooks & Node::SELECT) {
+        commands.push_back(Command(node, Node::SELECT));
+    } else {
+        for (Node::node_iterator_t it = children.begin; it != children.end; ++it) {
+            flatten(*it, commands);
+        }
+    }
+    if (hooks & Node::POST_VISIT) {
+        commands.push_back(Command(node, Node::POST_VISIT));
+    }
+}
+
+/**
+ * Stops tracking a subtree that was compiled, as it was compiled.
+ *
+ * @param node Root of subtree to stop tracking
+ */
+void RenderList::forget(Node* const node) {
+
+    // Skip if already forgotten
+    const std::map<Node*,Span>::iterator it = spans.find(node);
+    if (it == spans.end()) {
+        return;
+    }
+
+    // Forget children, then the node itself
+    const std::vector<Node*>& children = it->second.children;
+    for (std::vector<Node*>::const_iterator child = children.begin(); child != children.end(); ++child) {
+        forget(*child);
+    }
+    spans.erase(it);
+    node->removeNodeListener(this);
+}
+
+/**
+ * Returns the number of hooks that will be called when this list is replayed.
+ *
+ * @return Number of hooks that will be called when this list is replayed
+ */
+size_t RenderList::getSize() const {
+    return commands.size();
+}
+
+/**
+ * Checks if part of this list needs to be recompiled.
+ *
+ * @return `true` if part of this list will be recompiled on the next update
+ */
+bool RenderList::isDirty() const {
+    return !dirty.empty();
+}
+
+/**
+ * Marks the subtree of a node for recompiling if its children or hooks changed.
+ *
+ * Children that were removed are forgotten right away, while they still exist.
+ *
+ * @param node Node that changed
+ */
+void RenderList::nodeChanged(Node* const node) {
+
+    // Skip nodes that are not part of the list
+    const std::map<Node*,Span>::iterator it = spans.find(node);
+    if (it == spans.end()) {
+        return;
+    }
+
+    // Skip if only a value changed
+    const Span& span = it->second;
+    const Node::node_range_t children = node->getChildren();
+    const size_t count = children.end - children.begin;
+    if ((span.hooks == node->getHooks())
+            && (span.children.size() == count)
+            && std::equal(children.begin, children.end, span.children.begin())) {
+        return;
+    }
+
+    // Forget children that were removed
+    for (std::vector<Node*>::const_iterator child = span.children.begin(); child != span.children.end(); ++child) {
+        if (std::find(children.begin, children.end, *child) == children.end) {
+            forget(*child);
+        }
+    }
+
+    // Recompile on next update
+    if (std::find(dirty.begin(), dirty.end(), node) == dirty.end()) {
+        dirty.push_back(node);
+    }
+}
+
+/**
+ * Replaces the commands for a subtree with new ones.
+ *
+ * @param node Root of subtree to recompile
+ */
+void RenderList::recompile(Node* const node) {
+
+    // Skip if removed along with an ancestor
+    const std::map<Node*,Span>::iterator it = spans.find(node);
+    if (it == spans.end()) {
+        return;
+    }
+
+    // Flatten the subtree again
+    const size_t begin = it->second.begin;
+    const size_t end = it->second.end;
+    std::vector<Command> replacement;
+    forget(node);
+    flatten(node, replacement);
+
+    // Splice it in, only moving other spans if its length changed
+    if (replacement.size() == (end - begin)) {
+        std::copy(replacement.begin(), replacement.end(), commands.begin() + begin);
+        reindex(node, begin);
+    } else {
+        commands.erase(commands.begin() + begin, commands.begin() + end);
+        commands.insert(commands.begin() + begin, replacement.begin(), replacement.end());
+        reindex(root, 0);
+    }
+}
+
+/**
+ * Recomputes where the spans of a subtree are in the list.
+ *
+ * @param node Root of subtree
+ * @param begin Index of first command of subtree
+ * @return Index after last command of subtree
+ */
+size_t RenderList::reindex(Node* const node, const size_t begin) {
+
+    Span& span = spans[node];
+    size_t end = begin;
+
+    if (span.hooks & Node::PRE_VISIT) {
+        ++end;
+    }
+    if (span.hooks & Node::VISIT) {
+        ++end;
+    }
+    if (span.hooks & Node::SELECT) {
+        ++end;
+    } else {
+        for (std::vector<Node*>::const_iterator it = span.children.begin(); it != span.children.end(); ++it) {
+            end = reindex(*it, end);
+        }
+    }
+    if (span.hooks & Node::POST_VISIT) {
+        ++end;
+    }
+
+    span.begin = begin;
+    span.end = end;
+    return end;
+}
+
+/**
+ * Calls each hook in this list in order, updating it first if needed.
+ *
+ * @param state State shared between nodes
+ */
+void RenderList::replay(State& state) {
+    update();
+    for (std::vector<Command>::const_iterator it = commands.begin(); it != commands.end(); ++it) {
+        switch (it->hook) {
+        case Node::PRE_VISIT:
+            it->node->preVisit(state);
+            break;
+        case Node::VISIT:
+            it->node->visit(state);
+            break;
+        case Node::POST_VISIT:
+            it->node->postVisit(state);
+            break;
+        case Node::SELECT:
+            select(it->node, state);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+/**
+ * Traverses the children a node chooses, as a `Visitor` would.
+ *
+ * @param node Node with `SELECT` in its hooks
+ * @param state State shared between nodes
+ */
+void RenderList::select(Node* const node, State& state) {
+
+    // Make a visitor for the state if needed
+    if ((visitor == NULL) || (visitor->getState() != &state)) {
+        delete visitor;
+        visitor = NULL;
+        visitor = new Visitor(&state);
+    }
+
+    // Visit each child chosen
+    const Node::node_range_t children = node->select(state);
+    for (Node::node_iterator_t it = children.begin; it != children.end; ++it) {
+        visitor->visit(*it);
+    }
+}
+
+/**
+ * Recompiles the subtrees of nodes whose children or hooks changed.
+ */
+void RenderList::update() {
+    std::vector<Node*> nodes;
+    nodes.swap(dirty);
+    for (std::vector<Node*>::const_iterator it = nodes.begin(); it != nodes.end(); ++it) {
+        recompile(*it);
+    }
+}
+
+} /* namespace RapidGL */
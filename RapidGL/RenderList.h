@@ -0,0 +1,98 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RAPIDGL_RENDER_LIST_H
+#define RAPIDGL_RENDER_LIST_H
+#include <map>
+#include <vector>
+#include "RapidGL/common.h"
+#include "RapidGL/Node.h"
+#include "RapidGL/NodeListener.h"
+#include "RapidGL/State.h"
+#include "RapidGL/Visitor.h"
+namespace RapidGL {
+
+
+/**
+ * Flattened list of the hooks a traversal of a tree of nodes would call.
+ *
+ * `RenderList` walks a tree once and records, in order, each hook a `Visitor`
+ * would call on it, leaving out hooks the nodes report as no-ops.  Replaying
+ * the list then calls the same hooks in the same order without recursing or
+ * walking children.
+ *
+ * The list registers itself as a listener of every node it compiled.  When a
+ * node's children or hooks change, only the part of the list belonging to
+ * that node's subtree is recompiled, on the next replay.  Changes to values,
+ * like a new uniform value, do not need a recompile since nodes are replayed
+ * with their current values.
+ *
+ * Nodes with `SELECT` in their hooks choose their children again on every
+ * replay, so their subtrees are not flattened.  The chosen children are
+ * traversed with a `Visitor` instead.
+ *
+ * Nodes must outlive the list, or the list must be compiled with another tree
+ * before they are destroyed.
+ */
+class RenderList : public NodeListener {
+public:
+// Methods
+    RenderList();
+    virtual ~RenderList();
+    void compile(Node* root);
+    size_t getSize() const;
+    bool isDirty() const;
+    virtual void nodeChanged(Node* node);
+    void replay(State& state);
+    void update();
+private:
+// Types
+    /**
+     * Call of one hook on one node.
+     */
+    struct Command {
+        Node* node;
+        Node::Hook hook;
+        Command(Node* node, Node::Hook hook) : node(node), hook(hook) { }
+    };
+    /**
+     * Part of the list belonging to the subtree of a node, as it was compiled.
+     */
+    struct Span {
+        size_t begin;
+        size_t end;
+        int hooks;
+        std::vector<Node*> children;
+    };
+// Attributes
+    Node* root;
+    std::vector<Command> commands;
+    std::map<Node*,Span> spans;
+    std::vector<Node*> dirty;
+    Visitor* visitor;
+// Methods
+    RenderList(const RenderList&);
+    RenderList& operator=(const RenderList&);
+    void flatten(Node* node, std::vector<Command>& commands);
+    void forget(Node* node);
+    size_t reindex(Node* node, size_t begin);
+    void recompile(Node* node);
+    void select(Node* node, State& state);
+};
+
+} /* namespace RapidGL */
+#endif
@@ -0,0 +1,261 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "RapidGL/Node.h"
+#include "RapidGL/RenderList.h"
+#include "RapidGL/State.h"
+#include "RapidGL/Visitor.h"
+
+
+/**
+ * Unit test for `RenderList`.
+ */
+class RenderListTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Fake node that records which of its hooks were called.
+     */
+    class FakeNode : public RapidGL::Node {
+    public:
+
+        std::vector<std::string>* calls;
+
+        FakeNode(const std::string& id,
+                 std::vector<std::string>* calls,
+                 int hooks = ALL_HOOKS) : RapidGL::Node(id), calls(calls) {
+            setHooks(hooks);
+        }
+
+        virtual void postVisit(RapidGL::State& state) {
+            calls->push_back("postVisit " + getId());
+        }
+
+        virtual void preVisit(RapidGL::State& state) {
+            calls->push_back("preVisit " + getId());
+        }
+
+        virtual node_range_t select(RapidGL::State& state) {
+            const node_range_t children = getChildren();
+            return node_range_t(children.end - 1, children.end);
+        }
+
+        virtual void visit(RapidGL::State& state) {
+            calls->push_back("visit " + getId());
+        }
+
+        void fire() {
+            fireNodeChangedEvent();
+        }
+    };
+
+    // Calls made on nodes
+    std::vector<std::string> calls;
+
+    // Nodes
+    FakeNode a;
+    FakeNode b;
+    FakeNode c;
+    FakeNode d;
+
+    /**
+     * Constructs the test, making a tree like `a(b(c), d)`.
+     */
+    RenderListTest() : a("a", &calls), b("b", &calls), c("c", &calls), d("d", &calls) {
+        a.addChild(&b);
+        b.addChild(&c);
+        a.addChild(&d);
+    }
+
+    /**
+     * Records the calls a visitor makes on a tree.
+     *
+     * @param root Root of tree to visit
+     * @return Calls the visitor made
+     */
+    std::vector<std::string> getVisitorCalls(RapidGL::Node* root) {
+        RapidGL::State state;
+        RapidGL::Visitor visitor(&state);
+        calls.clear();
+        visitor.visit(root);
+        return calls;
+    }
+
+    /**
+     * Records the calls a render list makes on a tree.
+     *
+     * @param renderList Render list to replay
+     * @return Calls the render list made
+     */
+    std::vector<std::string> getRenderListCalls(RapidGL::RenderList& renderList) {
+        RapidGL::State state;
+        calls.clear();
+        renderList.replay(state);
+        return calls;
+    }
+
+    /**
+     * Ensures `RenderList::compile` throws if passed `NULL`.
+     */
+    void testCompileWithNull() {
+        RapidGL::RenderList renderList;
+        CPPUNIT_ASSERT_THROW(renderList.compile(NULL), std::invalid_argument);
+    }
+
+    /**
+     * Ensures `RenderList::nodeChanged` does not mark the list dirty when only a value changed.
+     */
+    void testNodeChangedWithValue() {
+        RapidGL::RenderList renderList;
+        renderList.compile(&a);
+        c.fire();
+        CPPUNIT_ASSERT(!renderList.isDirty());
+    }
+
+    /**
+     * Ensures `RenderList::replay` calls hooks in the same order as a visitor.
+     */
+    void testReplay() {
+        RapidGL::RenderList renderList;
+        renderList.compile(&a);
+        CPPUNIT_ASSERT_EQUAL((size_t) 12, renderList.getSize());
+        const std::vector<std::string> expected = getVisitorCalls(&a);
+        const std::vector<std::string> actual = getRenderListCalls(renderList);
+        CPPUNIT_ASSERT(expected == actual);
+    }
+
+    /**
+     * Ensures `RenderList::replay` picks up a child added after compiling.
+     */
+    void testReplayAfterAddChild() {
+
+        // Compile, then add a child
+        RapidGL::RenderList renderList;
+        renderList.compile(&a);
+        FakeNode e("e", &calls);
+        c.addChild(&e);
+        CPPUNIT_ASSERT(renderList.isDirty());
+
+        // Replay and compare to visitor
+        const std::vector<std::string> actual = getRenderListCalls(renderList);
+        const std::vector<std::string> expected = getVisitorCalls(&a);
+        CPPUNIT_ASSERT(expected == actual);
+        CPPUNIT_ASSERT_EQUAL((size_t) 15, renderList.getSize());
+        c.removeChild(&e);
+    }
+
+    /**
+     * Ensures `RenderList::replay` leaves out a child removed after compiling.
+     */
+    void testReplayAfterRemoveChild() {
+
+        // Compile, then remove a child
+        RapidGL::RenderList renderList;
+        renderList.compile(&a);
+        a.removeChild(&b);
+        CPPUNIT_ASSERT(renderList.isDirty());
+
+        // Replay and compare to visitor
+        const std::vector<std::string> actual = getRenderListCalls(renderList);
+        const std::vector<std::string> expected = getVisitorCalls(&a);
+        CPPUNIT_ASSERT(expected == actual);
+        CPPUNIT_ASSERT_EQUAL((size_t) 6, renderList.getSize());
+
+        // Changes to removed nodes should be ignored
+        b.addChild(&d);
+        CPPUNIT_ASSERT(!renderList.isDirty());
+    }
+
+    /**
+     * Ensures `RenderList::replay` skips hooks a node does not do work in.
+     */
+    void testReplayWithHooks() {
+
+        // Make tree with nodes that only do work in some hooks
+        FakeNode x("x", &calls, 0);
+        FakeNode y("y", &calls, RapidGL::Node::VISIT);
+        FakeNode z("z", &calls, RapidGL::Node::PRE_VISIT | RapidGL::Node::POST_VISIT);
+        x.addChild(&y);
+        x.addChild(&z);
+
+        // Compile and replay
+        RapidGL::RenderList renderList;
+        renderList.compile(&x);
+        const std::vector<std::string> actual = getRenderListCalls(renderList);
+
+        // Check calls
+        CPPUNIT_ASSERT_EQUAL((size_t) 3, actual.size());
+        CPPUNIT_ASSERT_EQUAL(std::string("visit y"), actual[0]);
+        CPPUNIT_ASSERT_EQUAL(std::string("preVisit z"), actual[1]);
+        CPPUNIT_ASSERT_EQUAL(std::string("postVisit z"), actual[2]);
+    }
+
+    /**
+     * Ensures `RenderList::replay` visits the children a node selects when it is replayed.
+     */
+    void testReplayWithSelect() {
+
+        // Make tree whose root only selects its last child
+        FakeNode x("x", &calls, RapidGL::Node::VISIT | RapidGL::Node::SELECT);
+        FakeNode y("y", &calls);
+        FakeNode z("z", &calls);
+        FakeNode w("w", &calls);
+        x.addChild(&y);
+        x.addChild(&z);
+        z.addChild(&w);
+
+        // Compile and replay
+        RapidGL::RenderList renderList;
+        renderList.compile(&x);
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, renderList.getSize());
+        std::vector<std::string> actual = getRenderListCalls(renderList);
+        std::vector<std::string> expected = getVisitorCalls(&x);
+        CPPUNIT_ASSERT_EQUAL((size_t) 7, actual.size());
+        CPPUNIT_ASSERT(expected == actual);
+
+        // Replay after changing the selected subtree, which is not compiled
+        z.removeChild(&w);
+        CPPUNIT_ASSERT(!renderList.isDirty());
+        actual = getRenderListCalls(renderList);
+        expected = getVisitorCalls(&x);
+        CPPUNIT_ASSERT(expected == actual);
+    }
+
+    CPPUNIT_TEST_SUITE(RenderListTest);
+    CPPUNIT_TEST(testCompileWithNull);
+    CPPUNIT_TEST(testNodeChangedWithValue);
+    CPPUNIT_TEST(testReplay);
+    CPPUNIT_TEST(testReplayAfterAddChild);
+    CPPUNIT_TEST(testReplayAfterRemoveChild);
+    CPPUNIT_TEST(testReplayWithHooks);
+    CPPUNIT_TEST(testReplayWithSelect);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(RenderListTest::suite());
+    runner.run();
+    return 0;
+}
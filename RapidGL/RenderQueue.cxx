@@ -0,0 +1,896 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <m3d/Mat4.h>
+#include "RapidGL/RenderQueue.h"
+#include "RapidGL/SimdMat4.h"
+#include "RapidGL/UniformBuffer.h"
+namespace RapidGL {
+
+/**
+ * Constructs an empty render queue.
+ */
+RenderQueue::RenderQueue() :
+        pass(0),
+        program(-1),
+        textureSet(-1),
+        sortable(true),
+        drawCount(0),
+        programChangeCount(0),
+        textureChangeCount(0),
+        vertexArrayChangeCount(0) {
+    // empty
+}
+
+/**
+ * Destructs a render queue.
+ */
+RenderQueue::~RenderQueue() {
+    // empty
+}
+
+/**
+ * Constructs a texture binding.
+ *
+ * @param unit Texture unit the texture is bound on
+ * @param target Target the texture is bound to
+ * @param texture Texture that is bound
+ */
+RenderQueue::TextureBinding::TextureBinding(const Gloop::TextureUnit& unit,
+                                            const Gloop::TextureTarget& target,
+                                            const Gloop::TextureObject& texture) :
+        unit(unit), target(target), texture(texture) {
+    // empty
+}
+
+/**
+ * Checks if this binding binds the same texture on the same unit as another.
+ *
+ * @param binding Binding to compare to
+ * @return `true` if both bind the same texture on the same unit
+ */
+bool RenderQueue::TextureBinding::operator==(const TextureBinding& binding) const {
+    return (unit.toOrdinal() == binding.unit.toOrdinal()) && (texture.id() == binding.texture.id());
+}
+
+/**
+ * Checks if this binding should be ordered before another, consistently with `operator==`.
+ *
+ * @param binding Binding to compare to
+ * @return `true` if this binding's unit, or else texture, is less than the other's
+ */
+bool RenderQueue::TextureBinding::operator<(const TextureBinding& binding) const {
+    const GLint ordinal = unit.toOrdinal();
+    const GLint otherOrdinal = binding.unit.toOrdinal();
+    if (ordinal != otherOrdinal) {
+        return ordinal < otherOrdinal;
+    }
+    return texture.id() < binding.texture.id();
+}
+
+/**
+ * Checks if this item should be submitted before another.
+ *
+ * @param item Item to compare to
+ * @return `true` if this item's key is less than the other's
+ */
+bool RenderQueue::Item::operator<(const Item& item) const {
+    return key < item.key;
+}
+
+/**
+ * Adds a call to one of a node's hooks that must stay in scene order.
+ *
+ * Draws recorded before the barrier are all submitted before it, and draws
+ * recorded after it are all submitted after it.
+ *
+ * @param node Node to call hook on when submitted
+ * @param hook Hook to call, e.g. `Node::VISIT`
+ * @throws invalid_argument if node is `NULL`
+ */
+void RenderQueue::addBarrier(Node* const node, const Node::Hook hook) {
+
+    if (node == NULL) {
+        throw std::invalid_argument("[RenderQueue] Node is NULL!");
+    }
+
+    // Submit in recorded order if passes no longer fit in keys
+    if (pass >= (1U << PASS_BITS) - 1) {
+        sortable = false;
+    }
+
+    // Make key that sorts after every draw in the pass
+    Item item;
+    item.key = makeBarrierKey(pass);
+    item.node = node;
+    item.hook = hook;
+    item.program = -1;
+    item.textures = -1;
+    item.vao = -1;
+    item.mode = 0;
+    item.first = 0;
+    item.count = 0;
+    item.type = GL_NONE;
+    item.instanceCount = 0;
+    item.uniformsBegin = 0;
+    item.uniformsEnd = 0;
+    item.buffersBegin = 0;
+    item.buffersEnd = 0;
+    items.push_back(item);
+
+    // Start next pass
+    ++pass;
+}
+
+/**
+ * Adds a draw using the current program, textures and uniform values.
+ *
+ * The state's uniform buffers are uploaded if they changed, and the draw binds
+ * the ranges holding their current values.  They should be uploaded into the
+ * state's ring buffer, otherwise every draw sees the values they have when
+ * the queue is submitted.
+ *
+ * @param vao Vertex array object to draw with
+ * @param mode Kind of primitives to draw, e.g. `GL_TRIANGLES`
+ * @param first Index of first vertex to draw
+ * @param count Number of vertices to draw
+ * @param state State to get depth of draw and uniform buffers from
+ * @param instanceCount Number of instances to draw at once, or zero to draw without instancing
+ * @throws runtime_error if no program is in use, or the ring buffer has no space left
+ */
+void RenderQueue::addDraw(const Gloop::VertexArrayObject& vao,
+                          const GLenum mode,
+                          const GLint first,
+                          const GLsizei count,
+                          const State& state,
+                          const GLsizei instanceCount) {
+
+    if (program < 0) {
+        throw std::runtime_error("[RenderQueue] No program in use!");
+    }
+
+    // Capture state
+    Item item;
+    item.node = NULL;
+    item.hook = Node::VISIT;
+    item.program = program;
+    item.textures = findTextureSet();
+    item.vao = findVertexArray(vao);
+    item.mode = mode;
+    item.first = first;
+    item.count = count;
+    item.type = GL_NONE;
+    item.instanceCount = instanceCount;
+
+    // Capture uniform values, unless they have not changed since the program's last draw
+    Snapshot& snapshot = snapshotsByProgram[program];
+    if (!snapshot.valid) {
+        const std::vector<UniformValue>& values = uniformsByProgram[program];
+        snapshot.begin = uniforms.size();
+        uniforms.insert(uniforms.end(), values.begin(), values.end());
+        snapshot.end = uniforms.size();
+        snapshot.valid = true;
+    }
+    item.uniformsBegin = snapshot.begin;
+    item.uniformsEnd = snapshot.end;
+
+    // Capture uniform buffers
+    const std::vector<UniformBuffer*>& uniformBuffers = state.getUniformBuffers();
+    item.buffersBegin = bufferBindings.size();
+    for (std::vector<UniformBuffer*>::const_iterator it = uniformBuffers.begin(); it != uniformBuffers.end(); ++it) {
+        const UniformBuffer::Range range = (*it)->flush(state.getRingBuffer());
+        if (range.size > 0) {
+            const BufferBinding binding = { (*it)->getBinding(), range.buffer, range.offset, range.size };
+            bufferBindings.push_back(binding);
+        }
+    }
+    item.buffersEnd = bufferBindings.size();
+
+    // Make key, using distance in front of the camera for depth
+    const SimdMat4& modelViewMatrix = state.getSimdModelViewMatrix();
+    const unsigned int depth = quantizeDepth(-modelViewMatrix[3][2]);
+    item.key = makeDrawKey(pass, item.program, item.textures, item.vao, depth);
+    items.push_back(item);
+}
+
+/**
+ * Adds a draw of indexed vertices using the current program, textures and uniform values.
+ *
+ * The indices are read from the start of the element array buffer bound to the vertex array object.
+ *
+ * @param vao Vertex array object to draw with, which has an element array buffer
+ * @param mode Kind of primitives to draw, e.g. `GL_TRIANGLES`
+ * @param count Number of indices to draw
+ * @param type Type of the indices, e.g. `GL_UNSIGNED_SHORT`
+ * @param state State to get depth of draw and uniform buffers from
+ * @param instanceCount Number of instances to draw at once, or zero to draw without instancing
+ * @throws runtime_error if no program is in use, or the ring buffer has no space left
+ */
+void RenderQueue::addDrawElements(const Gloop::VertexArrayObject& vao,
+                                  const GLenum mode,
+                                  const GLsizei count,
+                                  const GLenum type,
+                                  const State& state,
+                                  const GLsizei instanceCount) {
+    addDraw(vao, mode, 0, count, state, instanceCount);
+    items.back().type = type;
+}
+
+/**
+ * Adds the draws and barriers of another queue after the ones in this queue.
+ *
+ * The other queue's passes follow this queue's, so its draws are only sorted
+ * with draws recorded in this queue after its last barrier.  This queue's
+ * current program, textures and uniform values are not changed.
+ *
+ * @param queue Queue to add draws and barriers from
+ * @throws invalid_argument if queue is this queue
+ */
+void RenderQueue::append(const RenderQueue& queue) {
+
+    if (&queue == this) {
+        throw std::invalid_argument("[RenderQueue] Cannot append queue to itself!");
+    }
+
+    // Submit in recorded order if passes no longer fit in keys, or the other queue could not be sorted
+    if ((pass + queue.pass >= (1U << PASS_BITS) - 1) || !queue.sortable) {
+        sortable = false;
+    }
+
+    // Map the other queue's programs, texture sets and vertex array objects to ours
+    std::vector<int> programMap;
+    for (std::vector<Gloop::Program>::const_iterator it = queue.programs.begin(); it != queue.programs.end(); ++it) {
+        programMap.push_back(findProgram(*it));
+    }
+    std::vector<int> textureSetMap;
+    for (std::vector< std::vector<TextureBinding> >::const_iterator it = queue.textureSets.begin(); it != queue.textureSets.end(); ++it) {
+        textureSetMap.push_back(findTextureSet(*it));
+    }
+    std::vector<int> vaoMap;
+    for (std::vector<Gloop::VertexArrayObject>::const_iterator it = queue.vaos.begin(); it != queue.vaos.end(); ++it) {
+        vaoMap.push_back(findVertexArray(*it));
+    }
+
+    // Copy uniform values and buffer bindings
+    const size_t offset = uniforms.size();
+    uniforms.insert(uniforms.end(), queue.uniforms.begin(), queue.uniforms.end());
+    const size_t buffersOffset = bufferBindings.size();
+    bufferBindings.insert(bufferBindings.end(), queue.bufferBindings.begin(), queue.bufferBindings.end());
+
+    // Copy items, remapping indices and moving them to our passes
+    const uint64_t depthMask = (((uint64_t) 1) << DEPTH_BITS) - 1;
+    for (std::vector<Item>::const_iterator it = queue.items.begin(); it != queue.items.end(); ++it) {
+        Item item = *it;
+        const unsigned int itemPass = pass + (unsigned int) (it->key >> (64 - PASS_BITS));
+        if (item.node != NULL) {
+            item.key = makeBarrierKey(itemPass);
+        } else {
+            item.program = programMap[it->program];
+            item.textures = textureSetMap[it->textures];
+            item.vao = vaoMap[it->vao];
+            item.uniformsBegin += offset;
+            item.uniformsEnd += offset;
+            item.buffersBegin += buffersOffset;
+            item.buffersEnd += buffersOffset;
+            item.key = makeDrawKey(itemPass, item.program, item.textures, item.vao, it->key & depthMask);
+        }
+        items.push_back(item);
+    }
+
+    // Continue after the other queue's passes
+    pass += queue.pass;
+}
+
+/**
+ * Binds a texture on a texture unit, replacing the one previously bound there.
+ *
+ * @param unit Texture unit to bind texture on
+ * @param target Target to bind texture to
+ * @param texture Texture to bind
+ */
+void RenderQueue::bindTexture(const Gloop::TextureUnit& unit,
+                              const Gloop::TextureTarget& target,
+                              const Gloop::TextureObject& texture) {
+
+    const TextureBinding binding(unit, target, texture);
+    const GLint ordinal = unit.toOrdinal();
+
+    // Keep bindings sorted by unit so equal sets compare equal
+    std::vector<TextureBinding>::iterator it = textures.begin();
+    while ((it != textures.end()) && (it->unit.toOrdinal() < ordinal)) {
+        ++it;
+    }
+    if ((it != textures.end()) && (it->unit.toOrdinal() == ordinal)) {
+        if (*it == binding) {
+            return;
+        }
+        *it = binding;
+    } else {
+        textures.insert(it, binding);
+    }
+
+    // Set changed
+    textureSet = -1;
+}
+
+/**
+ * Removes all items from this queue, keeping texture bindings and uniform values.
+ */
+void RenderQueue::clear() {
+    items.clear();
+    uniforms.clear();
+    bufferBindings.clear();
+    pass = 0;
+    program = -1;
+    sortable = true;
+    for (std::vector<Snapshot>::iterator it = snapshotsByProgram.begin(); it != snapshotsByProgram.end(); ++it) {
+        it->valid = false;
+    }
+    prune();
+}
+
+/**
+ * Stops using a program, as `glUseProgram(0)` would.
+ */
+void RenderQueue::clearProgram() {
+    program = -1;
+}
+
+/**
+ * Finds or adds a program.
+ *
+ * @param program Program to find
+ * @return Index of program
+ */
+int RenderQueue::findProgram(const Gloop::Program& program) {
+
+    const GLuint id = program.id();
+    const std::map<GLuint,int>::const_iterator it = programsById.find(id);
+    if (it != programsById.end()) {
+        return it->second;
+    }
+
+    const int index = programs.size();
+    programs.push_back(program);
+    programsById[id] = index;
+    uniformsByProgram.push_back(std::vector<UniformValue>());
+    const Snapshot snapshot = { 0, 0, false };
+    snapshotsByProgram.push_back(snapshot);
+    return index;
+}
+
+/**
+ * Finds or adds the set of textures that are currently bound.
+ *
+ * @return Index of set of textures that are currently bound
+ */
+int RenderQueue::findTextureSet() {
+
+    // Use last one if textures have not changed
+    if (textureSet < 0) {
+        textureSet = findTextureSet(textures);
+    }
+    return textureSet;
+}
+
+/**
+ * Finds or adds a set of textures.
+ *
+ * @param bindings Textures in the set, sorted by unit
+ * @return Index of set of textures
+ */
+int RenderQueue::findTextureSet(const std::vector<TextureBinding>& bindings) {
+
+    // Look for an equal set
+    const std::map<std::vector<TextureBinding>,int>::const_iterator it = textureSetsByBindings.find(bindings);
+    if (it != textureSetsByBindings.end()) {
+        return it->second;
+    }
+
+    // Add a new one
+    const int index = textureSets.size();
+    textureSets.push_back(bindings);
+    textureSetsByBindings[bindings] = index;
+    return index;
+}
+
+/**
+ * Finds or adds a vertex array object.
+ *
+ * @param vao Vertex array object to find
+ * @return Index of vertex array object
+ */
+int RenderQueue::findVertexArray(const Gloop::VertexArrayObject& vao) {
+
+    const GLuint id = vao.id();
+    const std::map<GLuint,int>::const_iterator it = vaosById.find(id);
+    if (it != vaosById.end()) {
+        return it->second;
+    }
+
+    const int index = vaos.size();
+    vaos.push_back(vao);
+    vaosById[id] = index;
+    return index;
+}
+
+/**
+ * Finds or adds the value of a uniform in the current program.
+ *
+ * @param location Location of uniform in current program
+ * @param type Type of value, e.g. `GL_FLOAT_VEC3`
+ * @return Reference to value of uniform
+ * @throws runtime_error if no program is in use
+ */
+RenderQueue::UniformValue& RenderQueue::findUniform(const GLint location, const GLenum type) {
+
+    if (program < 0) {
+        throw std::runtime_error("[RenderQueue] No program in use!");
+    }
+
+    // Values are about to change, so the next draw needs a new snapshot
+    snapshotsByProgram[program].valid = false;
+
+    // Look for existing value
+    std::vector<UniformValue>& values = uniformsByProgram[program];
+    for (std::vector<UniformValue>::iterator it = values.begin(); it != values.end(); ++it) {
+        if (it->location == location) {
+            it->type = type;
+            return *it;
+        }
+    }
+
+    // Add a new one
+    UniformValue value;
+    value.location = location;
+    value.type = type;
+    value.integer = 0;
+    values.push_back(value);
+    return values.back();
+}
+
+/**
+ * Returns the number of draws made in the last submit.
+ *
+ * @return Number of draws made in the last submit
+ */
+size_t RenderQueue::getDrawCount() const {
+    return drawCount;
+}
+
+/**
+ * Returns the program currently in use.
+ *
+ * @return Program currently in use
+ * @throws runtime_error if no program is in use
+ */
+Gloop::Program RenderQueue::getProgram() const {
+    if (program < 0) {
+        throw std::runtime_error("[RenderQueue] No program in use!");
+    }
+    return programs[program];
+}
+
+/**
+ * Returns the number of times the program was changed in the last submit.
+ *
+ * @return Number of times the program was changed in the last submit
+ */
+size_t RenderQueue::getProgramChangeCount() const {
+    return programChangeCount;
+}
+
+/**
+ * Returns the number of draws and barriers in this queue.
+ *
+ * @return Number of draws and barriers in this queue
+ */
+size_t RenderQueue::getSize() const {
+    return items.size();
+}
+
+/**
+ * Returns the number of times the set of textures was changed in the last submit.
+ *
+ * @return Number of times the set of textures was changed in the last submit
+ */
+size_t RenderQueue::getTextureChangeCount() const {
+    return textureChangeCount;
+}
+
+/**
+ * Returns the number of times the vertex array object was changed in the last submit.
+ *
+ * @return Number of times the vertex array object was changed in the last submit
+ */
+size_t RenderQueue::getVertexArrayChangeCount() const {
+    return vertexArrayChangeCount;
+}
+
+/**
+ * Checks if a program is in use.
+ *
+ * @return `true` if a program is in use
+ */
+bool RenderQueue::hasProgram() const {
+    return program >= 0;
+}
+
+/**
+ * Continues from the program, texture bindings and uniform values of another queue.
+ *
+ * Used to record part of a scene in a separate queue as if it were being
+ * recorded in the other queue.  Draws and barriers are not copied.
+ *
+ * @param queue Queue to continue from
+ */
+void RenderQueue::inherit(const RenderQueue& queue) {
+
+    if (&queue == this) {
+        return;
+    }
+
+    // Copy uniform values of each program
+    for (size_t i = 0; i < queue.programs.size(); ++i) {
+        const int index = findProgram(queue.programs[i]);
+        std::vector<UniformValue>& values = uniformsByProgram[index];
+        snapshotsByProgram[index].valid = false;
+        const std::vector<UniformValue>& others = queue.uniformsByProgram[i];
+        for (std::vector<UniformValue>::const_iterator it = others.begin(); it != others.end(); ++it) {
+            std::vector<UniformValue>::iterator value = values.begin();
+            while ((value != values.end()) && (value->location != it->location)) {
+                ++value;
+            }
+            if (value == values.end()) {
+                values.push_back(*it);
+            } else {
+                *value = *it;
+            }
+        }
+    }
+
+    // Copy texture bindings
+    textures = queue.textures;
+    textureSet = -1;
+
+    // Copy program
+    program = (queue.program < 0) ? -1 : findProgram(queue.programs[queue.program]);
+}
+
+/**
+ * Makes the key of a barrier, which sorts after every draw in its pass.
+ *
+ * @param pass Pass the barrier ends
+ * @return Key of barrier
+ */
+uint64_t RenderQueue::makeBarrierKey(const unsigned int pass) {
+    const uint64_t ones = ~((uint64_t) 0);
+    return (((uint64_t) pass) << (64 - PASS_BITS)) | (ones >> PASS_BITS);
+}
+
+/**
+ * Makes the key of a draw, noting if an index does not fit in it.
+ *
+ * @param pass Pass the draw is in
+ * @param program Index of program the draw uses
+ * @param textures Index of set of textures the draw uses
+ * @param vao Index of vertex array object the draw uses
+ * @param depth Quantized depth of the draw
+ * @return Key of draw
+ */
+uint64_t RenderQueue::makeDrawKey(const unsigned int pass,
+                                  const int program,
+                                  const int textures,
+                                  const int vao,
+                                  const unsigned int depth) {
+
+    // Submit in recorded order if keys would collide
+    if ((program >= (1 << PROGRAM_BITS)) || (textures >= (1 << TEXTURES_BITS)) || (vao >= (1 << VAO_BITS))) {
+        sortable = false;
+    }
+
+    uint64_t key = pass;
+    key = pack(key, program, PROGRAM_BITS);
+    key = pack(key, textures, TEXTURES_BITS);
+    key = pack(key, vao, VAO_BITS);
+    key = pack(key, depth, DEPTH_BITS);
+    return key;
+}
+
+/**
+ * Shifts a key over and puts the low bits of a value in the space.
+ *
+ * @param key Key to add value to
+ * @param value Value to add
+ * @param bits Number of bits to use for value
+ * @return Key with value added
+ */
+uint64_t RenderQueue::pack(const uint64_t key, const uint64_t value, const int bits) {
+    const uint64_t mask = (((uint64_t) 1) << bits) - 1;
+    return (key << bits) | (value & mask);
+}
+
+/**
+ * Forgets sets of textures and vertex array objects, and programs without uniform values.
+ *
+ * Must only be called when no items refer to them.
+ */
+void RenderQueue::prune() {
+
+    // Sets of textures and vertex array objects are found again as draws are added
+    textureSets.clear();
+    textureSetsByBindings.clear();
+    textureSet = -1;
+    vaos.clear();
+    vaosById.clear();
+
+    // Keep programs whose uniform values must carry over
+    size_t kept = 0;
+    for (size_t i = 0; i < programs.size(); ++i) {
+        if (uniformsByProgram[i].empty()) {
+            continue;
+        }
+        if (kept != i) {
+            programs[kept] = programs[i];
+            uniformsByProgram[kept].swap(uniformsByProgram[i]);
+            snapshotsByProgram[kept] = snapshotsByProgram[i];
+        }
+        ++kept;
+    }
+    if (kept == programs.size()) {
+        return;
+    }
+    programs.erase(programs.begin() + kept, programs.end());
+    uniformsByProgram.erase(uniformsByProgram.begin() + kept, uniformsByProgram.end());
+    snapshotsByProgram.erase(snapshotsByProgram.begin() + kept, snapshotsByProgram.end());
+    programsById.clear();
+    for (size_t i = 0; i < programs.size(); ++i) {
+        programsById[programs[i].id()] = i;
+    }
+}
+
+/**
+ * Converts a depth to an integer that sorts in the same order.
+ *
+ * Uses the high bits of the depth as a float, which sort like integers for
+ * positive numbers.
+ *
+ * @param depth Distance in front of the camera
+ * @return Integer that sorts like the depth, using `DEPTH_BITS` bits
+ */
+unsigned int RenderQueue::quantizeDepth(const double depth) {
+    const float value = (depth > 0) ? ((float) depth) : 0.0f;
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits >> (32 - DEPTH_BITS);
+}
+
+/**
+ * Sets the value of a floating-point uniform in the current program.
+ *
+ * @param location Location of uniform in current program
+ * @param type Type of uniform, e.g. `GL_FLOAT_VEC4`
+ * @param values Values of uniform, with matrices in column-major order
+ * @throws invalid_argument if type is not supported
+ * @throws runtime_error if no program is in use
+ */
+void RenderQueue::setUniform(const GLint location, const GLenum type, const GLfloat* const values) {
+
+    // Find number of values
+    size_t count;
+    switch (type) {
+    case GL_FLOAT:
+        count = 1;
+        break;
+    case GL_FLOAT_VEC2:
+        count = 2;
+        break;
+    case GL_FLOAT_VEC3:
+        count = 3;
+        break;
+    case GL_FLOAT_VEC4:
+        count = 4;
+        break;
+    case GL_FLOAT_MAT3:
+        count = 9;
+        break;
+    case GL_FLOAT_MAT4:
+        count = 16;
+        break;
+    default:
+        throw std::invalid_argument("[RenderQueue] Unsupported uniform type!");
+    }
+
+    // Store them
+    UniformValue& value = findUniform(location, type);
+    std::copy(values, values + count, value.floats);
+}
+
+/**
+ * Sets the value of an integer or sampler uniform in the current program.
+ *
+ * @param location Location of uniform in current program
+ * @param value Value of uniform
+ * @throws runtime_error if no program is in use
+ */
+void RenderQueue::setUniform(const GLint location, const GLint value) {
+    findUniform(location, GL_INT).integer = value;
+}
+
+/**
+ * Issues the draws and barriers in this queue sorted by key, then empties it.
+ *
+ * Items are already in pass order as recorded, so if any key could not hold
+ * its indices the items are issued in that order instead.
+ *
+ * Programs, textures and vertex array objects are only bound when they differ
+ * from the previous draw's, and then through the state's `GLStateCache`.
+ * Uniform values are only loaded when a draw's snapshot differs from the one
+ * last loaded into its program.  Barriers are run with the queue taken off the
+ * state so they issue their OpenGL calls directly.
+ *
+ * @param state State to run barriers with
+ */
+void RenderQueue::submit(State& state) {
+
+    // Sort draws between barriers by the state they need, unless keys collided
+    if (sortable) {
+        std::stable_sort(items.begin(), items.end());
+    }
+
+    // Reset counts
+    drawCount = 0;
+    programChangeCount = 0;
+    textureChangeCount = 0;
+    vertexArrayChangeCount = 0;
+
+    // Issue items
+    GLStateCache& glStateCache = state.getGLStateCache();
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    state.setRenderQueue(NULL);
+    int currentProgram = -1;
+    int currentTextures = -1;
+    int currentVao = -1;
+    const size_t none = (size_t) -1;
+    std::vector<size_t> loadedSnapshots(programs.size(), none);
+    try {
+        for (std::vector<Item>::const_iterator it = items.begin(); it != items.end(); ++it) {
+
+            // Run barriers, which may load uniforms themselves
+            if (it->node != NULL) {
+                if (it->hook == Node::POST_VISIT) {
+                    it->node->postVisit(state);
+                } else if (it->hook == Node::PRE_VISIT) {
+                    it->node->preVisit(state);
+                } else {
+                    it->node->visit(state);
+                }
+                std::fill(loadedSnapshots.begin(), loadedSnapshots.end(), none);
+                continue;
+            }
+
+            // Change program
+            if (it->program != currentProgram) {
+                glStateCache.useProgram(programs[it->program]);
+                currentProgram = it->program;
+                ++programChangeCount;
+            }
+
+            // Load uniforms, which uniform nodes did not load themselves, unless the program has them already
+            if ((it->uniformsBegin < it->uniformsEnd) && (loadedSnapshots[it->program] != it->uniformsBegin)) {
+                for (size_t i = it->uniformsBegin; i < it->uniformsEnd; ++i) {
+                    uploadUniform(uniforms[i]);
+                }
+                loadedSnapshots[it->program] = it->uniformsBegin;
+                glStateCache.invalidateUniforms();
+            }
+            for (size_t i = it->buffersBegin; i < it->buffersEnd; ++i) {
+                const BufferBinding& binding = bufferBindings[i];
+                glStateCache.bindUniformBuffer(binding.index, binding.buffer, binding.offset, binding.size);
+            }
+
+            // Change textures
+            if (it->textures != currentTextures) {
+                const std::vector<TextureBinding>& bindings = textureSets[it->textures];
+                for (std::vector<TextureBinding>::const_iterator b = bindings.begin(); b != bindings.end(); ++b) {
+                    glStateCache.bindTexture(b->unit, b->target, b->texture);
+                }
+                currentTextures = it->textures;
+                ++textureChangeCount;
+            }
+
+            // Change vertex array object
+            if (it->vao != currentVao) {
+                glStateCache.bindVertexArray(vaos[it->vao]);
+                currentVao = it->vao;
+                ++vertexArrayChangeCount;
+            }
+
+            // Draw
+            if (it->type != GL_NONE) {
+                if (it->instanceCount > 0) {
+                    glDrawElementsInstanced(it->mode, it->count, it->type, NULL, it->instanceCount);
+                } else {
+                    glDrawElements(it->mode, it->count, it->type, NULL);
+                }
+            } else if (it->instanceCount > 0) {
+                glDrawArraysInstanced(it->mode, it->first, it->count, it->instanceCount);
+            } else {
+                glDrawArrays(it->mode, it->first, it->count);
+            }
+            ++drawCount;
+        }
+    } catch (...) {
+        state.setRenderQueue(renderQueue);
+        throw;
+    }
+
+    // Leave OpenGL how a traversal would have
+    if (currentProgram >= 0) {
+        glStateCache.clearProgram();
+    }
+    state.setRenderQueue(renderQueue);
+
+    // Start over
+    clear();
+}
+
+/**
+ * Loads a uniform value into the current OpenGL program.
+ *
+ * @param uniform Uniform value to load
+ */
+void RenderQueue::uploadUniform(const UniformValue& uniform) {
+    switch (uniform.type) {
+    case GL_INT:
+        glUniform1i(uniform.location, uniform.integer);
+        break;
+    case GL_FLOAT:
+        glUniform1fv(uniform.location, 1, uniform.floats);
+        break;
+    case GL_FLOAT_VEC2:
+        glUniform2fv(uniform.location, 1, uniform.floats);
+        break;
+    case GL_FLOAT_VEC3:
+        glUniform3fv(uniform.location, 1, uniform.floats);
+        break;
+    case GL_FLOAT_VEC4:
+        glUniform4fv(uniform.location, 1, uniform.floats);
+        break;
+    case GL_FLOAT_MAT3:
+        glUniformMatrix3fv(uniform.location, 1, false, uniform.floats);
+        break;
+    case GL_FLOAT_MAT4:
+        glUniformMatrix4fv(uniform.location, 1, false, uniform.floats);
+        break;
+    }
+}
+
+/**
+ * Uses a program for the draws added after this call.
+ *
+ * @param program Program to use
+ */
+void RenderQueue::useProgram(const Gloop::Program& program) {
+    this->program = findProgram(program);
+}
+
+} /* namespace RapidGL */
@@ -0,0 +1,205 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RAPIDGL_RENDER_QUEUE_H
+#define RAPIDGL_RENDER_QUEUE_H
+#include <map>
+#include <stdint.h>
+#include <vector>
+#include <gloop/Program.hxx>
+#include <gloop/TextureObject.hxx>
+#include <gloop/TextureTarget.hxx>
+#include <gloop/TextureUnit.hxx>
+#include <gloop/VertexArrayObject.hxx>
+#include "RapidGL/common.h"
+#include "RapidGL/Node.h"
+#include "RapidGL/State.h"
+namespace RapidGL {
+
+
+/**
+ * Collection of draws that are submitted sorted by the state they need.
+ *
+ * When a render queue is set on the `State`, built-in nodes record into it
+ * instead of issuing OpenGL calls.  `UseNode`, `TextureNode` and uniform nodes
+ * update the queue's current program, textures and uniform values, and
+ * geometry nodes add a draw capturing them.  Nodes whose effects must stay in
+ * scene order, like `ClearNode` and `FramebufferNode`, are recorded as
+ * barriers instead.
+ *
+ * Each draw gets a 64-bit key packing, from most to least significant, its
+ * pass, program, set of textures, vertex array object and depth.  The pass
+ * advances at every barrier, so sorting by key only reorders draws between
+ * barriers.  Draws with equal keys keep the order they were recorded in.
+ * If more passes, programs, sets of textures or vertex array objects are used
+ * between two calls to `clear` than fit in a key, the draws are submitted in
+ * the order they were recorded instead.
+ *
+ * Uniform values are captured once for every draw recorded with a program
+ * until one of them changes, so draws share snapshots of them.  A snapshot is
+ * only loaded when a draw needs a different one from the last loaded into its
+ * program, or after a barrier, which may have loaded uniforms itself.
+ *
+ * Sets of textures and vertex array objects are forgotten when the queue is
+ * cleared, and so are programs that have no uniform values stored for them.
+ *
+ * Nodes that do not know about the queue still run immediately while the
+ * scene is being recorded.
+ */
+class RenderQueue {
+public:
+// Methods
+    RenderQueue();
+    virtual ~RenderQueue();
+    void addBarrier(Node* node, Node::Hook hook);
+    void addDraw(const Gloop::VertexArrayObject& vao,
+                 GLenum mode,
+                 GLint first,
+                 GLsizei count,
+                 const State& state,
+                 GLsizei instanceCount = 0);
+    void addDrawElements(const Gloop::VertexArrayObject& vao,
+                         GLenum mode,
+                         GLsizei count,
+                         GLenum type,
+                         const State& state,
+                         GLsizei instanceCount = 0);
+    void append(const RenderQueue& queue);
+    void bindTexture(const Gloop::TextureUnit& unit,
+                     const Gloop::TextureTarget& target,
+                     const Gloop::TextureObject& texture);
+    void clear();
+    void clearProgram();
+    size_t getDrawCount() const;
+    Gloop::Program getProgram() const;
+    size_t getProgramChangeCount() const;
+    size_t getSize() const;
+    size_t getTextureChangeCount() const;
+    size_t getVertexArrayChangeCount() const;
+    bool hasProgram() const;
+    void inherit(const RenderQueue& queue);
+    void setUniform(GLint location, GLenum type, const GLfloat* values);
+    void setUniform(GLint location, GLint value);
+    void submit(State& state);
+    void useProgram(const Gloop::Program& program);
+private:
+// Types
+    /**
+     * Texture bound to a texture unit.
+     */
+    struct TextureBinding {
+        Gloop::TextureUnit unit;
+        Gloop::TextureTarget target;
+        Gloop::TextureObject texture;
+        TextureBinding(const Gloop::TextureUnit& unit,
+                       const Gloop::TextureTarget& target,
+                       const Gloop::TextureObject& texture);
+        bool operator==(const TextureBinding& binding) const;
+        bool operator<(const TextureBinding& binding) const;
+    };
+    /**
+     * Value of a uniform in a program.
+     */
+    struct UniformValue {
+        GLint location;
+        GLenum type;
+        GLint integer;
+        GLfloat floats[16];
+    };
+    /**
+     * Uniform values of a program captured for the draws recorded since they last changed.
+     */
+    struct Snapshot {
+        size_t begin;
+        size_t end;
+        bool valid;
+    };
+    /**
+     * Range of a uniform buffer bound to a binding point.
+     */
+    struct BufferBinding {
+        GLuint index;
+        GLuint buffer;
+        GLintptr offset;
+        GLsizeiptr size;
+    };
+    /**
+     * Draw or barrier recorded in the queue.
+     */
+    struct Item {
+        uint64_t key;
+        Node* node;
+        Node::Hook hook;
+        int program;
+        int textures;
+        int vao;
+        GLenum mode;
+        GLint first;
+        GLsizei count;
+        GLenum type;
+        GLsizei instanceCount;
+        size_t uniformsBegin;
+        size_t uniformsEnd;
+        size_t buffersBegin;
+        size_t buffersEnd;
+        bool operator<(const Item& item) const;
+    };
+// Constants
+    static const int PASS_BITS = 16;
+    static const int PROGRAM_BITS = 10;
+    static const int TEXTURES_BITS = 10;
+    static const int VAO_BITS = 12;
+    static const int DEPTH_BITS = 16;
+// Attributes
+    std::vector<Item> items;
+    std::vector<UniformValue> uniforms;
+    std::vector<BufferBinding> bufferBindings;
+    unsigned int pass;
+    int program;
+    std::vector<Gloop::Program> programs;
+    std::map<GLuint,int> programsById;
+    std::vector< std::vector<UniformValue> > uniformsByProgram;
+    std::vector<Snapshot> snapshotsByProgram;
+    std::vector<TextureBinding> textures;
+    std::vector< std::vector<TextureBinding> > textureSets;
+    std::map<std::vector<TextureBinding>,int> textureSetsByBindings;
+    int textureSet;
+    std::vector<Gloop::VertexArrayObject> vaos;
+    std::map<GLuint,int> vaosById;
+    bool sortable;
+    size_t drawCount;
+    size_t programChangeCount;
+    size_t textureChangeCount;
+    size_t vertexArrayChangeCount;
+// Methods
+    RenderQueue(const RenderQueue&);
+    RenderQueue& operator=(const RenderQueue&);
+    int findProgram(const Gloop::Program& program);
+    int findTextureSet();
+    int findTextureSet(const std::vector<TextureBinding>& bindings);
+    int findVertexArray(const Gloop::VertexArrayObject& vao);
+    static uint64_t makeBarrierKey(unsigned int pass);
+    uint64_t makeDrawKey(unsigned int pass, int program, int textures, int vao, unsigned int depth);
+    static uint64_t pack(uint64_t key, uint64_t value, int bits);
+    void prune();
+    static unsigned int quantizeDepth(double depth);
+    UniformValue& findUniform(GLint location, GLenum type);
+    static void uploadUniform(const UniformValue& uniform);
+};
+
+} /* namespace RapidGL */
+#endif
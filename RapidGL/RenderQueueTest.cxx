@@ -0,0 +1,285 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <cppunit/extensions/HelperMacros.h>
+#include <GL/glfw.h>
+#include <glycerin/Color.hxx>
+#include <m3d/Vec4.h>
+#include "RapidGL/AttributeNode.h"
+#include "RapidGL/ClearNode.h"
+#include "RapidGL/CubeNode.h"
+#include "RapidGL/ProgramNode.h"
+#include "RapidGL/RenderQueue.h"
+#include "RapidGL/SceneNode.h"
+#include "RapidGL/ShaderNode.h"
+#include "RapidGL/State.h"
+#include "RapidGL/UseNode.h"
+#include "RapidGL/Vec4UniformNode.h"
+#include "RapidGL/Visitor.h"
+
+
+/**
+ * Unit test for `RenderQueue`.
+ */
+class RenderQueueTest {
+public:
+
+    /**
+     * Returns the source code for the vertex shader.
+     */
+    static std::string getVertexShaderSource() {
+        return
+                "#version 140\n"
+                "in vec4 MCVertex;\n"
+                "void main() {\n"
+                "  gl_Position = MCVertex;\n"
+                "}\n";
+    }
+
+    /**
+     * Returns the source code for the fragment shader.
+     */
+    static std::string getFragmentShaderSource() {
+        return
+                "#version 140\n"
+                "uniform vec4 Color = vec4(1);\n"
+                "out vec4 FragColor;\n"
+                "void main() {\n"
+                "  FragColor = Color;\n"
+                "}\n";
+    }
+
+    /**
+     * Adds a program node with shaders and an attribute to a scene.
+     *
+     * @param scene Scene to add program node to
+     * @param id Identifier of program node
+     */
+    static void addProgramNode(RapidGL::Node* scene, const std::string& id) {
+        RapidGL::ProgramNode* programNode = new RapidGL::ProgramNode(id);
+        programNode->addChild(new RapidGL::ShaderNode(GL_VERTEX_SHADER, getVertexShaderSource()));
+        programNode->addChild(new RapidGL::ShaderNode(GL_FRAGMENT_SHADER, getFragmentShaderSource()));
+        programNode->addChild(new RapidGL::AttributeNode("MCVertex", RapidGL::AttributeNode::POSITION, 0));
+        scene->addChild(programNode);
+    }
+
+    /**
+     * Adds a use node with a color and a cube to a scene.
+     *
+     * @param scene Scene to add use node to
+     * @param id Identifier of program node to use
+     * @param color Color to draw cube with
+     */
+    static void addUseNode(RapidGL::Node* scene, const std::string& id, const M3d::Vec4& color) {
+        RapidGL::UseNode* useNode = new RapidGL::UseNode(id);
+        useNode->addChild(new RapidGL::Vec4UniformNode("Color", color));
+        useNode->addChild(new RapidGL::CubeNode());
+        scene->addChild(useNode);
+    }
+
+    /**
+     * Ensures `RenderQueue::addBarrier` throws if passed `NULL`.
+     */
+    void testAddBarrierWithNull() {
+        RapidGL::RenderQueue renderQueue;
+        CPPUNIT_ASSERT_THROW(renderQueue.addBarrier(NULL, RapidGL::Node::VISIT), std::invalid_argument);
+    }
+
+    /**
+     * Counts how many times it is visited, for use as a barrier.
+     */
+    class CountNode : public RapidGL::Node {
+    public:
+        int count;
+        CountNode() : count(0) { }
+        virtual void visit(RapidGL::State& state) { ++count; }
+    };
+
+    /**
+     * Ensures `RenderQueue::addBarrier` keeps recording once passes no longer fit in keys.
+     */
+    void testAddBarrierWithManyBarriers() {
+        RapidGL::RenderQueue renderQueue;
+        RapidGL::State state;
+        CountNode countNode;
+        for (int i = 0; i < 70000; ++i) {
+            renderQueue.addBarrier(&countNode, RapidGL::Node::VISIT);
+        }
+        renderQueue.submit(state);
+        CPPUNIT_ASSERT_EQUAL(70000, countNode.count);
+    }
+
+    /**
+     * Ensures `RenderQueue::append` adds another queue's draws after a barrier in this queue.
+     */
+    void testAppend() {
+
+        // Make scene with two parts
+        RapidGL::SceneNode scene;
+        addProgramNode(&scene, "red");
+        addProgramNode(&scene, "blue");
+        RapidGL::SceneNode* first = new RapidGL::SceneNode();
+        addUseNode(first, "red", M3d::Vec4(1, 0, 0, 1));
+        first->addChild(new RapidGL::ClearNode(GL_COLOR_BUFFER_BIT, Glycerin::Color(0, 0, 0, 1), 1));
+        addUseNode(first, "blue", M3d::Vec4(0, 0, 1, 1));
+        scene.addChild(first);
+        RapidGL::SceneNode* second = new RapidGL::SceneNode();
+        addUseNode(second, "blue", M3d::Vec4(0, 0, 1, 1));
+        addUseNode(second, "red", M3d::Vec4(1, 0, 0, 1));
+        scene.addChild(second);
+
+        // Record each part into its own queue
+        RapidGL::RenderQueue firstQueue;
+        RapidGL::RenderQueue secondQueue;
+        RapidGL::State state;
+        RapidGL::Visitor visitor(&state);
+        visitor.prepare(&scene);
+        state.setRenderQueue(&firstQueue);
+        visitor.visit(first);
+        state.setRenderQueue(&secondQueue);
+        visitor.visit(second);
+
+        // Append and check draws after the clear were sorted together
+        firstQueue.append(secondQueue);
+        CPPUNIT_ASSERT_EQUAL((size_t) 5, firstQueue.getSize());
+        state.setRenderQueue(&firstQueue);
+        firstQueue.submit(state);
+        glfwSwapBuffers();
+        CPPUNIT_ASSERT_EQUAL((size_t) 4, firstQueue.getDrawCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, firstQueue.getProgramChangeCount());
+        CPPUNIT_ASSERT_EQUAL((GLenum) GL_NO_ERROR, glGetError());
+    }
+
+    /**
+     * Ensures `RenderQueue::append` throws if passed the same queue.
+     */
+    void testAppendWithSelf() {
+        RapidGL::RenderQueue renderQueue;
+        CPPUNIT_ASSERT_THROW(renderQueue.append(renderQueue), std::invalid_argument);
+    }
+
+    /**
+     * Ensures `RenderQueue::getProgram` throws if no program is in use.
+     */
+    void testGetProgramWithNoProgram() {
+        RapidGL::RenderQueue renderQueue;
+        CPPUNIT_ASSERT(!renderQueue.hasProgram());
+        CPPUNIT_ASSERT_THROW(renderQueue.getProgram(), std::runtime_error);
+    }
+
+    /**
+     * Ensures `RenderQueue::submit` groups draws that use the same program.
+     */
+    void testSubmit() {
+
+        // Make scene alternating between two programs
+        RapidGL::SceneNode scene;
+        addProgramNode(&scene, "red");
+        addProgramNode(&scene, "blue");
+        addUseNode(&scene, "red", M3d::Vec4(1, 0, 0, 1));
+        addUseNode(&scene, "blue", M3d::Vec4(0, 0, 1, 1));
+        addUseNode(&scene, "red", M3d::Vec4(1, 0, 0, 1));
+        addUseNode(&scene, "blue", M3d::Vec4(0, 0, 1, 1));
+
+        // Record into queue
+        RapidGL::RenderQueue renderQueue;
+        RapidGL::State state;
+        state.setRenderQueue(&renderQueue);
+        RapidGL::Visitor visitor(&state);
+        visitor.visit(&scene);
+        CPPUNIT_ASSERT_EQUAL((size_t) 4, renderQueue.getSize());
+
+        // Submit and check program only changed once per program
+        renderQueue.submit(state);
+        glfwSwapBuffers();
+        CPPUNIT_ASSERT_EQUAL((size_t) 4, renderQueue.getDrawCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, renderQueue.getProgramChangeCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, renderQueue.getSize());
+        CPPUNIT_ASSERT_EQUAL((GLenum) GL_NO_ERROR, glGetError());
+    }
+
+    /**
+     * Ensures `RenderQueue::submit` does not move draws across a barrier.
+     */
+    void testSubmitWithBarrier() {
+
+        // Make scene with a clear in the middle
+        RapidGL::SceneNode scene;
+        addProgramNode(&scene, "red");
+        addProgramNode(&scene, "blue");
+        addUseNode(&scene, "red", M3d::Vec4(1, 0, 0, 1));
+        addUseNode(&scene, "blue", M3d::Vec4(0, 0, 1, 1));
+        addUseNode(&scene, "red", M3d::Vec4(1, 0, 0, 1));
+        scene.addChild(new RapidGL::ClearNode(GL_COLOR_BUFFER_BIT, Glycerin::Color(0, 0, 0, 1), 1));
+        addUseNode(&scene, "blue", M3d::Vec4(0, 0, 1, 1));
+        addUseNode(&scene, "red", M3d::Vec4(1, 0, 0, 1));
+
+        // Record into queue
+        RapidGL::RenderQueue renderQueue;
+        RapidGL::State state;
+        state.setRenderQueue(&renderQueue);
+        RapidGL::Visitor visitor(&state);
+        visitor.visit(&scene);
+        CPPUNIT_ASSERT_EQUAL((size_t) 6, renderQueue.getSize());
+
+        // Submit and check each side of the clear was sorted on its own
+        renderQueue.submit(state);
+        glfwSwapBuffers();
+        CPPUNIT_ASSERT_EQUAL((size_t) 5, renderQueue.getDrawCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 4, renderQueue.getProgramChangeCount());
+        CPPUNIT_ASSERT_EQUAL((GLenum) GL_NO_ERROR, glGetError());
+    }
+};
+
+int main(int argc, char* argv[]) {
+
+    // Initialize GLFW
+    if (!glfwInit()) {
+        throw std::runtime_error("Could not initialize GLFW!");
+    }
+
+    // Open window
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MAJOR, 3);
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MINOR, 2);
+    glfwOpenWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (!glfwOpenWindow(512, 512, 0, 0, 0, 0, 0, 0, GLFW_WINDOW)) {
+        throw std::runtime_error("Could not open GLFW window!");
+    }
+
+    // Run test
+    try {
+        RenderQueueTest test;
+        test.testAddBarrierWithManyBarriers();
+        test.testAddBarrierWithNull();
+        test.testAppend();
+        test.testAppendWithSelf();
+        test.testGetProgramWithNoProgram();
+        test.testSubmit();
+        test.testSubmitWithBarrier();
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        throw;
+    }
+
+    // Exit
+    glfwTerminate();
+    return 0;
+}
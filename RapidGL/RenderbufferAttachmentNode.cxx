@@ -38,6 +38,9 @@ RenderbufferAttachmentNode::RenderbufferAttachmentNode(const Usage usage, const
     if (link.empty()) {
         throw std::invalid_argument("[RenderbufferAttachmentNode] Link is empty!");
     }
+
+    // Only prepares before being visited
+    setHooks(PRE_VISIT);
 }
 
 /**
@@ -82,7 +85,7 @@ std::string RenderbufferAttachmentNode::getLink() const {
     return link;
 }
 
-void RenderbufferAttachmentNode::preVisit(State& state) {
+void RenderbufferAttachmentNode::prepare(State& state) {
 
     // Skip if already ready
     if (ready) {
@@ -97,6 +100,14 @@ void RenderbufferAttachmentNode::preVisit(State& state) {
 
     // Now ready
     ready = true;
+    setHooks(getHooks() & ~PRE_VISIT);
+}
+
+/**
+ * Prepares this node if it was not prepared before being visited.
+ */
+void RenderbufferAttachmentNode::preVisit(State& state) {
+    prepare(state);
 }
 
 } /* namespace RapidGL */
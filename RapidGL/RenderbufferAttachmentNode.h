@@ -36,6 +36,7 @@ public:
     virtual ~RenderbufferAttachmentNode();
     virtual void attach(GLenum attachment);
     std::string getLink() const;
+    virtual void prepare(State& state);
     virtual void preVisit(State& state);
 private:
 // Attributes
@@ -67,6 +67,9 @@ RenderbufferNode::RenderbufferNode(const std::string& id,
     renderbuffer.bind(rbo);
     renderbuffer.storage(format, width, height);
     renderbuffer.unbind();
+
+    // Nothing to do when traversed
+    setHooks(0);
 }
 
 /**
@@ -54,13 +54,13 @@ std::map<std::string,GLenum> RenderbufferNodeUnmarshaller::createFormats() {
 }
 
 /**
- * Returns the value of the _format_ attribute in a map.
+ * Returns the value of the _format_ attribute.
  *
- * @param attributes Map of attributes to look in
+ * @param attributes Attributes to look in
  * @return Value of the attribute
  * @throws std::runtime_error if format is unspecified
  */
-GLenum RenderbufferNodeUnmarshaller::getFormat(const std::map<std::string,std::string>& attributes) {
+GLenum RenderbufferNodeUnmarshaller::getFormat(const AttributeView& attributes) {
 
     // Get value
     const std::string value = findValue(attributes, "format");
@@ -80,13 +80,13 @@ GLenum RenderbufferNodeUnmarshaller::getFormat(const std::map<std::string,std::s
 }
 
 /**
- * Returns the value of the _height_ attribute in a map.
+ * Returns the value of the _height_ attribute.
  *
- * @param attributes Map of attributes to look in
+ * @param attributes Attributes to look in
  * @return Value of the attribute
  * @throws std::runtime_error if format is unspecified, invalid, or out of range
  */
-GLsizei RenderbufferNodeUnmarshaller::getHeight(const std::map<std::string,std::string>& attributes) {
+GLsizei RenderbufferNodeUnmarshaller::getHeight(const AttributeView& attributes) {
 
     // Get value
     const std::string value = findValue(attributes, "height");
@@ -112,13 +112,13 @@ GLsizei RenderbufferNodeUnmarshaller::getHeight(const std::map<std::string,std::
 }
 
 /**
- * Returns the value of the _height_ attribute in a map.
+ * Returns the value of the _height_ attribute.
  *
- * @param attributes Map of attributes to look in
+ * @param attributes Attributes to look in
  * @return Value of the attribute
  * @throws std::runtime_error if format is unspecified, invalid, or out of range
  */
-std::string RenderbufferNodeUnmarshaller::getId(const std::map<std::string,std::string>& attributes) {
+std::string RenderbufferNodeUnmarshaller::getId(const AttributeView& attributes) {
     const std::string value = findValue(attributes, "id");
     if (value.empty()) {
         throw std::runtime_error("[RenderbufferNodeUnmarshaller] Id is unspecified!");
@@ -138,13 +138,13 @@ GLsizei RenderbufferNodeUnmarshaller::getMaxRenderbufferSize() {
 }
 
 /**
- * Returns the value of the _width_ attribute in a map.
+ * Returns the value of the _width_ attribute.
  *
- * @param attributes Map of attributes to look in
+ * @param attributes Attributes to look in
  * @return Value of the attribute
  * @throws std::runtime_error if format is unspecified, invalid, or out of range
  */
-GLsizei RenderbufferNodeUnmarshaller::getWidth(const std::map<std::string,std::string>& attributes) {
+GLsizei RenderbufferNodeUnmarshaller::getWidth(const AttributeView& attributes) {
 
     // Get value
     const std::string value = findValue(attributes, "width");
@@ -169,7 +169,7 @@ GLsizei RenderbufferNodeUnmarshaller::getWidth(const std::map<std::string,std::s
     return width;
 }
 
-Node* RenderbufferNodeUnmarshaller::unmarshal(const std::map<std::string,std::string>& attributes) {
+Node* RenderbufferNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
     const std::string id = getId(attributes);
     const GLenum format = getFormat(attributes);
     const GLsizei width = getWidth(attributes);
@@ -34,17 +34,17 @@ public:
 // Methods
     RenderbufferNodeUnmarshaller();
     virtual ~RenderbufferNodeUnmarshaller();
-    virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+    virtual Node* unmarshal(const AttributeView& attributes);
 private:
 // Constants
     static const std::map<std::string,GLenum> FORMATS;
 // Methods
     static std::map<std::string,GLenum> createFormats();
-    static GLenum getFormat(const std::map<std::string,std::string>& attributes);
-    static GLsizei getHeight(const std::map<std::string,std::string>& attributes);
-    static std::string getId(const std::map<std::string,std::string>& attributes);
+    static GLenum getFormat(const AttributeView& attributes);
+    static GLsizei getHeight(const AttributeView& attributes);
+    static std::string getId(const AttributeView& attributes);
     static GLsizei getMaxRenderbufferSize();
-    static GLsizei getWidth(const std::map<std::string,std::string>& attributes);
+    static GLsizei getWidth(const AttributeView& attributes);
 };
 
 } /* namespace RapidGL */
@@ -0,0 +1,324 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "RapidGL/RingBuffer.h"
+namespace RapidGL {
+
+// Array buffer target
+const Gloop::BufferTarget RingBuffer::arrayBuffer = Gloop::BufferTarget::arrayBuffer();
+
+/**
+ * Constructs a ring buffer, allocating storage for every frame.
+ *
+ * @param frameSize Number of bytes that can be allocated in each frame
+ * @param frameCount Number of frames that can be in flight at once
+ * @param persistent Whether to map the buffer persistently if the context supports it
+ * @throws invalid_argument if frame size or frame count is not positive
+ * @throws runtime_error if buffer could not be mapped
+ */
+RingBuffer::RingBuffer(const GLsizeiptr frameSize, const int frameCount, const bool persistent) :
+        frameSize(frameSize),
+        frameCount(frameCount),
+        persistent(persistent && isPersistentMappingSupported()),
+        buffer(Gloop::BufferObject::generate()),
+        mapping(NULL),
+        frameBase(NULL),
+        staging(this->persistent ? 0 : std::max(frameSize, (GLsizeiptr) 0)),
+        fences(std::max(frameCount, 0), (GLsync) NULL),
+        frame(frameCount - 1),
+        frameNumber(0),
+        used(0),
+        flushed(0),
+        inFrame(false),
+        waitCount(0) {
+
+    if (frameSize <= 0) {
+        buffer.dispose();
+        throw std::invalid_argument("[RingBuffer] Frame size is not positive!");
+    } else if (frameCount <= 0) {
+        buffer.dispose();
+        throw std::invalid_argument("[RingBuffer] Frame count is not positive!");
+    }
+
+    // Allocate storage, mapping it once and for all if possible
+    arrayBuffer.bind(buffer);
+#ifdef GL_MAP_PERSISTENT_BIT
+    if (this->persistent) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, frameSize * frameCount, NULL, flags);
+        mapping = (char*) glMapBufferRange(GL_ARRAY_BUFFER, 0, frameSize * frameCount, flags);
+        if (mapping == NULL) {
+            arrayBuffer.unbind(buffer);
+            buffer.dispose();
+            throw std::runtime_error("[RingBuffer] Could not map buffer!");
+        }
+    } else {
+        arrayBuffer.data(frameSize * frameCount, NULL, GL_STREAM_DRAW);
+    }
+#else
+    arrayBuffer.data(frameSize * frameCount, NULL, GL_STREAM_DRAW);
+#endif
+    arrayBuffer.unbind(buffer);
+}
+
+/**
+ * Destructs a ring buffer, deleting its buffer and any fences left.
+ */
+RingBuffer::~RingBuffer() {
+    for (std::vector<GLsync>::iterator it = fences.begin(); it != fences.end(); ++it) {
+        if ((*it) != NULL) {
+            glDeleteSync(*it);
+        }
+    }
+    if (mapping != NULL) {
+        arrayBuffer.bind(buffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        arrayBuffer.unbind(buffer);
+    }
+    buffer.dispose();
+}
+
+/**
+ * Allocates space in the current frame.
+ *
+ * @param size Number of bytes to allocate
+ * @param alignment Number the offset of the allocation in the buffer should be a multiple of
+ * @return Pointer to write to and offset of the allocation in the buffer
+ * @throws invalid_argument if size or alignment is not positive
+ * @throws runtime_error if a frame has not begun or there is not enough space left in it
+ */
+RingBuffer::Allocation RingBuffer::allocate(const GLsizeiptr size, const GLsizeiptr alignment) {
+
+    if (size <= 0) {
+        throw std::invalid_argument("[RingBuffer] Size is not positive!");
+    } else if (alignment <= 0) {
+        throw std::invalid_argument("[RingBuffer] Alignment is not positive!");
+    } else if (!inFrame) {
+        throw std::runtime_error("[RingBuffer] Frame has not begun!");
+    }
+
+    // Align the offset in the buffer rather than in the frame
+    const GLintptr start = frame * frameSize;
+    const GLintptr offset = ((start + used + alignment - 1) / alignment) * alignment;
+    if (offset + size > start + frameSize) {
+        throw std::runtime_error("[RingBuffer] Not enough space left in frame!");
+    }
+    used = offset + size - start;
+
+    // Hand out where to write it
+    const Allocation allocation = { frameBase + (offset - start), offset, size };
+    return allocation;
+}
+
+/**
+ * Starts writing the next frame, waiting for the GPU to finish with it if it is still in use.
+ *
+ * @throws runtime_error if a frame has already begun
+ */
+void RingBuffer::beginFrame() {
+
+    if (inFrame) {
+        throw std::runtime_error("[RingBuffer] Frame has already begun!");
+    }
+
+    // Move to the next frame
+    frame = (frame + 1) % frameCount;
+    ++frameNumber;
+    used = 0;
+
+    // Wait on its fence, or orphan the buffer when wrapping around and write into memory
+    if (persistent) {
+        waitForFence(frame);
+        frameBase = mapping + (frame * frameSize);
+    } else {
+        if (frame == 0) {
+            arrayBuffer.bind(buffer);
+            arrayBuffer.data(frameSize * frameCount, NULL, GL_STREAM_DRAW);
+            arrayBuffer.unbind(buffer);
+        }
+        frameBase = &staging[0];
+        flushed = 0;
+    }
+    inFrame = true;
+}
+
+/**
+ * Finishes writing the current frame, after every draw using it has been issued.
+ *
+ * @throws runtime_error if a frame has not begun
+ */
+void RingBuffer::endFrame() {
+
+    if (!inFrame) {
+        throw std::runtime_error("[RingBuffer] Frame has not begun!");
+    }
+
+    // Fence the frame's commands, or upload anything not flushed yet
+    if (persistent) {
+        fences[frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    } else {
+        flush();
+    }
+    frameBase = NULL;
+    inFrame = false;
+}
+
+/**
+ * Uploads what was written into allocations since the last flush, so draws issued after it can read them.
+ *
+ * Does nothing if the buffer is mapped persistently, since writes are then seen by OpenGL directly.
+ */
+void RingBuffer::flush() {
+
+    if (persistent || (used <= flushed)) {
+        return;
+    }
+
+    // Upload from the end of the last flush, since earlier allocations may already be in use
+    arrayBuffer.bind(buffer);
+    glBufferSubData(GL_ARRAY_BUFFER, (frame * frameSize) + flushed, used - flushed, &staging[flushed]);
+    arrayBuffer.unbind(buffer);
+    flushed = used;
+}
+
+/**
+ * Returns the buffer allocations are made in.
+ *
+ * @return Buffer allocations are made in
+ */
+Gloop::BufferObject RingBuffer::getBuffer() const {
+    return buffer;
+}
+
+/**
+ * Returns the number of frames that can be in flight at once.
+ *
+ * @return Number of frames that can be in flight at once
+ */
+int RingBuffer::getFrameCount() const {
+    return frameCount;
+}
+
+/**
+ * Returns the number of frames begun so far, which identifies the current frame.
+ *
+ * @return Number of times `beginFrame` has been called
+ */
+size_t RingBuffer::getFrameNumber() const {
+    return frameNumber;
+}
+
+/**
+ * Returns the number of bytes that can be allocated in each frame.
+ *
+ * @return Number of bytes that can be allocated in each frame
+ */
+GLsizeiptr RingBuffer::getFrameSize() const {
+    return frameSize;
+}
+
+/**
+ * Returns the number of bytes used so far in the current frame, including padding.
+ *
+ * @return Number of bytes used in the current frame
+ */
+GLsizeiptr RingBuffer::getUsed() const {
+    return used;
+}
+
+/**
+ * Returns the number of times `beginFrame` had to wait for the GPU.
+ *
+ * @return Number of times the CPU stalled waiting for a frame to be free
+ */
+size_t RingBuffer::getWaitCount() const {
+    return waitCount;
+}
+
+/**
+ * Checks if the buffer is mapped persistently.
+ *
+ * @return `true` if the buffer is mapped persistently, or `false` if it is orphaned instead
+ */
+bool RingBuffer::isPersistent() const {
+    return persistent;
+}
+
+/**
+ * Checks if the current context supports persistently mapped buffers.
+ *
+ * @return `true` if context is OpenGL 4.4 or later, or supports `ARB_buffer_storage`
+ */
+bool RingBuffer::isPersistentMappingSupported() {
+#ifdef GL_MAP_PERSISTENT_BIT
+
+    // Check version
+    GLint major = 0;
+    GLint minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    if ((major > 4) || ((major == 4) && (minor >= 4))) {
+        return true;
+    }
+
+    // Check extensions
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        const char* const name = (const char*) glGetStringi(GL_EXTENSIONS, i);
+        if ((name != NULL) && (strcmp(name, "GL_ARB_buffer_storage") == 0)) {
+            return true;
+        }
+    }
+#endif
+    return false;
+}
+
+/**
+ * Waits for the GPU to finish the commands fenced in a frame.
+ *
+ * @param frame Index of frame to wait for
+ * @throws runtime_error if waiting failed
+ */
+void RingBuffer::waitForFence(const int frame) {
+
+    const GLsync fence = fences[frame];
+    if (fence == NULL) {
+        return;
+    }
+
+    // Check without waiting first, so stalls can be counted
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        ++waitCount;
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, WAIT_TIMEOUT);
+        } while (result == GL_TIMEOUT_EXPIRED);
+    }
+    glDeleteSync(fence);
+    fences[frame] = NULL;
+
+    if (result == GL_WAIT_FAILED) {
+        throw std::runtime_error("[RingBuffer] Could not wait for frame!");
+    }
+}
+
+} /* namespace RapidGL */
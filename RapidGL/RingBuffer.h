@@ -0,0 +1,106 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RAPIDGL_RING_BUFFER_H
+#define RAPIDGL_RING_BUFFER_H
+#include <vector>
+#include <gloop/BufferObject.hxx>
+#include <gloop/BufferTarget.hxx>
+#include "RapidGL/common.h"
+namespace RapidGL {
+
+
+/**
+ * Buffer divided into per-frame regions that data changing every frame is written into.
+ *
+ * The buffer holds `getFrameCount` frames of `getFrameSize` bytes each, used
+ * in turn.  Call `beginFrame` before drawing a frame, `allocate` to get space
+ * to write uniforms, vertices or instance data into, and `endFrame` once every
+ * draw using the frame's data has been issued.  Allocations are only valid
+ * until the frame ends, and should be read by OpenGL through `getBuffer` at
+ * the offset returned.
+ *
+ * If the context supports `ARB_buffer_storage`, the buffer is mapped once,
+ * persistently and coherently, and `endFrame` places a fence after the
+ * frame's commands.  `beginFrame` only waits on the fence of the frame it is
+ * about to reuse, so with three frames the CPU can get two frames ahead of the
+ * GPU before it stalls.  Otherwise allocations are written into a copy of
+ * the frame in memory, since OpenGL may not read a buffer while it is mapped
+ * without `GL_MAP_PERSISTENT_BIT`.  Call `flush` after writing allocations
+ * and before issuing draws that read them, which uploads everything written
+ * since the last flush with `glBufferSubData`.  `endFrame` flushes too, and
+ * `flush` does nothing when the buffer is mapped persistently, so it is always
+ * safe to call.  The whole buffer is orphaned each time the ring wraps around,
+ * so the driver hands out fresh storage rather than waiting for the GPU.
+ *
+ * Ring buffers must be used on the thread with the OpenGL context.
+ */
+class RingBuffer {
+public:
+// Types
+    /**
+     * Space allocated in the current frame.
+     */
+    struct Allocation {
+        GLvoid* pointer;
+        GLintptr offset;
+        GLsizeiptr size;
+    };
+// Methods
+    RingBuffer(GLsizeiptr frameSize, int frameCount = 3, bool persistent = true);
+    virtual ~RingBuffer();
+    Allocation allocate(GLsizeiptr size, GLsizeiptr alignment = DEFAULT_ALIGNMENT);
+    void beginFrame();
+    void endFrame();
+    void flush();
+    Gloop::BufferObject getBuffer() const;
+    int getFrameCount() const;
+    size_t getFrameNumber() const;
+    GLsizeiptr getFrameSize() const;
+    GLsizeiptr getUsed() const;
+    size_t getWaitCount() const;
+    bool isPersistent() const;
+    static bool isPersistentMappingSupported();
+// Constants
+    static const GLsizeiptr DEFAULT_ALIGNMENT = 256;
+private:
+// Constants
+    static const Gloop::BufferTarget arrayBuffer;
+    static const GLuint64 WAIT_TIMEOUT = 1000000000;
+// Attributes
+    const GLsizeiptr frameSize;
+    const int frameCount;
+    const bool persistent;
+    const Gloop::BufferObject buffer;
+    char* mapping;
+    char* frameBase;
+    std::vector<char> staging;
+    std::vector<GLsync> fences;
+    int frame;
+    size_t frameNumber;
+    GLsizeiptr used;
+    GLsizeiptr flushed;
+    bool inFrame;
+    size_t waitCount;
+// Methods
+    RingBuffer(const RingBuffer&);
+    RingBuffer& operator=(const RingBuffer&);
+    void waitForFence(int frame);
+};
+
+} /* namespace RapidGL */
+#endif
@@ -0,0 +1,231 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <cppunit/extensions/HelperMacros.h>
+#include <GL/glfw.h>
+#include <gloop/BufferObject.hxx>
+#include "RapidGL/RingBuffer.h"
+
+
+/**
+ * Unit test for `RingBuffer`.
+ */
+class RingBufferTest {
+public:
+
+    // Size of each frame
+    static const GLsizeiptr FRAME_SIZE = 1024;
+
+    /**
+     * Reads bytes back from the buffer of a ring buffer.
+     *
+     * @param ringBuffer Ring buffer to read from
+     * @param offset Offset in buffer to read from
+     * @param size Number of bytes to read
+     * @param data Array to read into
+     */
+    static void read(const RapidGL::RingBuffer& ringBuffer, const GLintptr offset, const GLsizeiptr size, GLvoid* data) {
+        glBindBuffer(GL_ARRAY_BUFFER, ringBuffer.getBuffer().id());
+        glGetBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    /**
+     * Ensures allocations are aligned, packed into the frame, and read back as written.
+     *
+     * @param persistent Whether to map the buffer persistently if possible
+     */
+    void checkAllocate(const bool persistent) {
+
+        RapidGL::RingBuffer ringBuffer(FRAME_SIZE, 3, persistent);
+        ringBuffer.beginFrame();
+
+        // Allocate
+        const RapidGL::RingBuffer::Allocation first = ringBuffer.allocate(100, 4);
+        const RapidGL::RingBuffer::Allocation second = ringBuffer.allocate(100, 256);
+        CPPUNIT_ASSERT_EQUAL((GLintptr) 0, first.offset);
+        CPPUNIT_ASSERT_EQUAL((GLintptr) 256, second.offset);
+        CPPUNIT_ASSERT_EQUAL((GLsizeiptr) 356, ringBuffer.getUsed());
+
+        // Write
+        const GLfloat values[] = { 1, 2, 3, 4 };
+        memcpy(first.pointer, values, sizeof(values));
+        memcpy(second.pointer, values, sizeof(values));
+        ringBuffer.endFrame();
+
+        // Read back
+        GLfloat result[4];
+        read(ringBuffer, second.offset, sizeof(result), result);
+        CPPUNIT_ASSERT_EQUAL(4.0f, result[3]);
+        read(ringBuffer, first.offset, sizeof(result), result);
+        CPPUNIT_ASSERT_EQUAL(1.0f, result[0]);
+    }
+
+    /**
+     * Ensures each frame is allocated from in turn.
+     *
+     * @param persistent Whether to map the buffer persistently if possible
+     */
+    void checkBeginFrame(const bool persistent) {
+        RapidGL::RingBuffer ringBuffer(FRAME_SIZE, 3, persistent);
+        for (int i = 0; i < 4; ++i) {
+            ringBuffer.beginFrame();
+            CPPUNIT_ASSERT_EQUAL((GLsizeiptr) 0, ringBuffer.getUsed());
+            CPPUNIT_ASSERT_EQUAL((GLintptr) ((i % 3) * FRAME_SIZE), ringBuffer.allocate(16).offset);
+            ringBuffer.endFrame();
+        }
+    }
+
+    /**
+     * Ensures allocations can be read by OpenGL after a flush, before the frame ends.
+     *
+     * @param persistent Whether to map the buffer persistently if possible
+     */
+    void checkFlush(const bool persistent) {
+
+        RapidGL::RingBuffer ringBuffer(FRAME_SIZE, 3, persistent);
+        ringBuffer.beginFrame();
+
+        // Write two allocations, flushing after each
+        const GLfloat values[] = { 1, 2, 3, 4 };
+        const RapidGL::RingBuffer::Allocation first = ringBuffer.allocate(sizeof(values));
+        memcpy(first.pointer, values, sizeof(values));
+        ringBuffer.flush();
+        const RapidGL::RingBuffer::Allocation second = ringBuffer.allocate(sizeof(values));
+        memcpy(second.pointer, values, sizeof(values));
+        ringBuffer.flush();
+
+        // Read back while the frame is still being written
+        GLfloat result[4];
+        read(ringBuffer, first.offset, sizeof(result), result);
+        CPPUNIT_ASSERT_EQUAL(1.0f, result[0]);
+        read(ringBuffer, second.offset, sizeof(result), result);
+        CPPUNIT_ASSERT_EQUAL(4.0f, result[3]);
+        CPPUNIT_ASSERT_EQUAL(GL_NO_ERROR, (int) glGetError());
+        ringBuffer.endFrame();
+    }
+
+    /**
+     * Ensures `RingBuffer::allocate` works whichever way the buffer is mapped.
+     */
+    void testAllocate() {
+        checkAllocate(true);
+        checkAllocate(false);
+    }
+
+    /**
+     * Ensures `RingBuffer::allocate` throws if the frame doesn't have enough space left.
+     */
+    void testAllocateWithNotEnoughSpace() {
+        RapidGL::RingBuffer ringBuffer(FRAME_SIZE);
+        ringBuffer.beginFrame();
+        ringBuffer.allocate(FRAME_SIZE - 8);
+        CPPUNIT_ASSERT_THROW(ringBuffer.allocate(16, 4), std::runtime_error);
+        ringBuffer.endFrame();
+    }
+
+    /**
+     * Ensures `RingBuffer::allocate` throws if a frame hasn't begun.
+     */
+    void testAllocateWithoutFrame() {
+        RapidGL::RingBuffer ringBuffer(FRAME_SIZE);
+        CPPUNIT_ASSERT_THROW(ringBuffer.allocate(16), std::runtime_error);
+    }
+
+    /**
+     * Ensures `RingBuffer::beginFrame` cycles through frames whichever way the buffer is mapped.
+     */
+    void testBeginFrame() {
+        checkBeginFrame(true);
+        checkBeginFrame(false);
+    }
+
+    /**
+     * Ensures `RingBuffer::beginFrame` throws if a frame has already begun.
+     */
+    void testBeginFrameTwice() {
+        RapidGL::RingBuffer ringBuffer(FRAME_SIZE);
+        ringBuffer.beginFrame();
+        CPPUNIT_ASSERT_THROW(ringBuffer.beginFrame(), std::runtime_error);
+        ringBuffer.endFrame();
+    }
+
+    /**
+     * Ensures `RingBuffer::flush` makes allocations readable whichever way the buffer is mapped.
+     */
+    void testFlush() {
+        checkFlush(true);
+        checkFlush(false);
+    }
+
+    /**
+     * Ensures `RingBuffer` only maps persistently when asked to and supported.
+     */
+    void testIsPersistent() {
+        const bool supported = RapidGL::RingBuffer::isPersistentMappingSupported();
+        CPPUNIT_ASSERT_EQUAL(supported, RapidGL::RingBuffer(FRAME_SIZE, 3, true).isPersistent());
+        CPPUNIT_ASSERT(!RapidGL::RingBuffer(FRAME_SIZE, 3, false).isPersistent());
+    }
+
+    /**
+     * Ensures `RingBuffer` constructor throws for an invalid frame size.
+     */
+    void testRingBufferWithInvalidFrameSize() {
+        CPPUNIT_ASSERT_THROW(RapidGL::RingBuffer(0), std::invalid_argument);
+    }
+};
+
+int main(int argc, char* argv[]) {
+
+    // Initialize
+    if (!glfwInit()) {
+        throw std::runtime_error("Could not initialize GLFW!");
+    }
+
+    // Open window
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MAJOR, 3);
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MINOR, 2);
+    glfwOpenWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (!glfwOpenWindow(512, 512, 0, 0, 0, 0, 0, 0, GLFW_WINDOW)) {
+        throw std::runtime_error("Could not open window!");
+    }
+
+    // Run test
+    try {
+        RingBufferTest test;
+        test.testAllocate();
+        test.testAllocateWithNotEnoughSpace();
+        test.testAllocateWithoutFrame();
+        test.testBeginFrame();
+        test.testBeginFrameTwice();
+        test.testFlush();
+        test.testIsPersistent();
+        test.testRingBufferWithInvalidFrameSize();
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        throw;
+    }
+
+    // Exit
+    glfwTerminate();
+    return 0;
+}
@@ -18,6 +18,7 @@
 #include "config.h"
 #include <m3d/Mat4.h>
 #include "RapidGL/RotateNode.h"
+#include "RapidGL/SimdMat4.h"
 namespace RapidGL {
 
 /**
@@ -43,6 +44,33 @@ RotateNode::~RotateNode() {
     // empty
 }
 
+/**
+ * Computes the bounds of this node's children, transformed by this node.
+ *
+ * @return Box enclosing this node's children after they are transformed
+ */
+BoundingBox RotateNode::computeBounds() {
+    return Node::computeBounds().transform(getMatrix());
+}
+
+/**
+ * Returns the matrix this node post-multiplies the model matrix with, in single precision.
+ *
+ * @return Rotation matrix
+ */
+SimdMat4 RotateNode::computeMatrix() const {
+    return SimdMat4::rotation(rotation);
+}
+
+/**
+ * Returns the matrix this node post-multiplies the model matrix with.
+ *
+ * @return Rotation matrix
+ */
+M3d::Mat4 RotateNode::getMatrix() const {
+    return rotation.toMat4();
+}
+
 /**
  * Returns the rotation this node applies.
  *
@@ -59,22 +87,8 @@ M3d::Quat RotateNode::getRotation() const {
  */
 void RotateNode::setRotation(const M3d::Quat& rotation) {
     this->rotation = rotation;
+    invalidateMatrix();
     fireNodeChangedEvent();
 }
 
-void RotateNode::visit(State& state) {
-
-    // Get model matrix
-    M3d::Mat4 modelMatrix = state.getModelMatrix();
-
-    // Make rotation matrix
-    const M3d::Mat4 rotationMatrix = rotation.toMat4();
-
-    // Post-multiply with model matrix
-    modelMatrix = modelMatrix * rotationMatrix;
-
-    // Store model matrix in state
-    state.setModelMatrix(modelMatrix);
-}
-
 } /* namespace RapidGL */
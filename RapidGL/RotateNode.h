@@ -17,8 +17,10 @@
  */
 #ifndef RAPIDGL_ROTATE_NODE_H
 #define RAPIDGL_ROTATE_NODE_H
+#include <m3d/Mat4.h>
 #include <m3d/Quat.h>
 #include "RapidGL/common.h"
+#include "RapidGL/BoundingBox.h"
 #include "RapidGL/Node.h"
 #include "RapidGL/State.h"
 #include "RapidGL/TransformNode.h"
@@ -34,9 +36,13 @@ public:
     RotateNode();
     RotateNode(const M3d::Quat& rotation);
     virtual ~RotateNode();
+    M3d::Mat4 getMatrix() const;
     M3d::Quat getRotation() const;
     void setRotation(const M3d::Quat& rotation);
-    virtual void visit(State& state);
+protected:
+// Methods
+    virtual BoundingBox computeBounds();
+    virtual SimdMat4 computeMatrix() const;
 private:
 // Atttributes
     M3d::Quat rotation;
@@ -17,7 +17,6 @@
  */
 #include "config.h"
 #include <stdexcept>
-#include <vector>
 #include <m3d/Math.h>
 #include <m3d/Quat.h>
 #include "RapidGL/RotateNodeUnmarshaller.h"
@@ -38,13 +37,13 @@ RotateNodeUnmarshaller::~RotateNodeUnmarshaller() {
 }
 
 /**
- * Finds the value of the _angle_ attribute in a map.
+ * Finds the value of the _angle_ attribute.
  *
- * @param attributes Map of attribute keys and values to look in
+ * @param attributes Attributes to look in
  * @return Value of angle attribute
  * @throws std::runtime_error if value is unspecified or invalid
  */
-double RotateNodeUnmarshaller::getAngle(const std::map<std::string,std::string>& attributes) {
+double RotateNodeUnmarshaller::getAngle(const AttributeView& attributes) {
 
     // Get value
     const std::string value = findValue(attributes,  "angle");
@@ -61,13 +60,13 @@ double RotateNodeUnmarshaller::getAngle(const std::map<std::string,std::string>&
 }
 
 /**
- * Finds the value of the _axis_ attribute in a map.
+ * Finds the value of the _axis_ attribute.
  *
- * @param attributes Map of attribute keys and values to look in
+ * @param attributes Attributes to look in
  * @return Value of axis attribute
  * @throws std::runtime_error if value is unspecified or invalid
  */
-M3d::Vec3 RotateNodeUnmarshaller::getAxis(const std::map<std::string,std::string>& attributes) {
+M3d::Vec3 RotateNodeUnmarshaller::getAxis(const AttributeView& attributes) {
 
     // Get value
     const std::string value = findValue(attributes, "axis");
@@ -75,27 +74,27 @@ M3d::Vec3 RotateNodeUnmarshaller::getAxis(const std::map<std::string,std::string
         throw std::runtime_error("[RotateNodeUnmarshaller] Axis is unspecified!");
     }
 
-    // Tokenize value
-    const std::vector<std::string> tokens = tokenize(value);
-    if (tokens.size() != 3) {
-        throw std::runtime_error("[RotateNodeUnmarshaller] Axis should have three components!");
-    }
-
-    // Parse tokens
-    M3d::Vec3 axis;
+    // Parse value
+    GLfloat arr[3];
+    size_t count;
     try {
-        for (int i = 0; i < 3; ++i) {
-            axis[i] = parseFloat(tokens[i]);
-        }
+        count = parseFloats(value, arr, 3);
     } catch (std::invalid_argument& e) {
         throw std::runtime_error("[RotateNodeUnmarshaller] Invalid value for axis!");
     }
+    if (count != 3) {
+        throw std::runtime_error("[RotateNodeUnmarshaller] Axis should have three components!");
+    }
 
     // Return axis
+    M3d::Vec3 axis;
+    for (int i = 0; i < 3; ++i) {
+        axis[i] = arr[i];
+    }
     return axis;
 }
 
-Node* RotateNodeUnmarshaller::unmarshal(const std::map<std::string,std::string>& attributes) {
+Node* RotateNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
     const M3d::Vec3 axis = getAxis(attributes);
     const double angle = getAngle(attributes);
     const M3d::Quat rotation = M3d::Quat::fromAxisAngle(axis, angle);
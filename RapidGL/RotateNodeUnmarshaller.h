@@ -35,11 +35,11 @@ public:
 // Methods
     RotateNodeUnmarshaller();
     virtual ~RotateNodeUnmarshaller();
-    virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+    virtual Node* unmarshal(const AttributeView& attributes);
 private:
 // Methods
-    static double getAngle(const std::map<std::string,std::string>& attributes);
-    static M3d::Vec3 getAxis(const std::map<std::string,std::string>& attributes);
+    static double getAngle(const AttributeView& attributes);
+    static M3d::Vec3 getAxis(const AttributeView& attributes);
 };
 
 } /* namespace RapidGL */
@@ -35,6 +35,7 @@ Sampler2dUniformNode::Sampler2dUniformNode(const std::string& name, const std::s
     if (link.empty()) {
         throw std::invalid_argument("[Sampler2dUniformNode] Link is empty!");
     }
+    setHooks(PRE_VISIT | VISIT);
 }
 
 /**
@@ -62,7 +63,7 @@ Gloop::TextureUnit Sampler2dUniformNode::getTextureUnit() const {
     return unit;
 }
 
-void Sampler2dUniformNode::preVisit(State& state) {
+void Sampler2dUniformNode::prepare(State& state) {
 
     // Skip if already prepared
     if (prepared) {
@@ -82,15 +83,32 @@ void Sampler2dUniformNode::preVisit(State& state) {
 
     // Store its texture unit
     unit = textureNode->getTextureUnit();
+    invalidateUploads();
 
     // Successfully prepared
     prepared = true;
+    setHooks(getHooks() & ~PRE_VISIT);
+}
+
+/**
+ * Prepares this node if it was not prepared before being visited.
+ */
+void Sampler2dUniformNode::preVisit(State& state) {
+    prepare(state);
 }
 
 void Sampler2dUniformNode::visit(State& state) {
-    const GLint location = getLocationInProgram(Gloop::Program::current());
-    if (location >= 0) {
-        glUniform1i(location, unit.toOrdinal());
+    const GLint location = getLocationInCurrentProgram(state);
+    if (location < 0) {
+        return;
+    }
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    if (renderQueue == NULL) {
+        if (isUploadNeeded(state)) {
+            glUniform1i(location, unit.toOrdinal());
+        }
+    } else {
+        renderQueue->setUniform(location, unit.toOrdinal());
     }
 }
 
@@ -35,6 +35,7 @@ Sampler3dUniformNode::Sampler3dUniformNode(const std::string& name, const std::s
     if (link.empty()) {
         throw std::invalid_argument("[Sampler3dUniformNode] Link is empty!");
     }
+    setHooks(PRE_VISIT | VISIT);
 }
 
 /**
@@ -62,7 +63,7 @@ Gloop::TextureUnit Sampler3dUniformNode::getTextureUnit() const {
     return unit;
 }
 
-void Sampler3dUniformNode::preVisit(State& state) {
+void Sampler3dUniformNode::prepare(State& state) {
 
     // Skip if already prepared
     if (prepared) {
@@ -82,15 +83,32 @@ void Sampler3dUniformNode::preVisit(State& state) {
 
     // Store its texture unit
     unit = textureNode->getTextureUnit();
+    invalidateUploads();
 
     // Successfully prepared
     prepared = true;
+    setHooks(getHooks() & ~PRE_VISIT);
+}
+
+/**
+ * Prepares this node if it was not prepared before being visited.
+ */
+void Sampler3dUniformNode::preVisit(State& state) {
+    prepare(state);
 }
 
 void Sampler3dUniformNode::visit(State& state) {
-    const GLint location = getLocationInProgram(Gloop::Program::current());
-    if (location >= 0) {
-        glUniform1i(location, unit.toOrdinal());
+    const GLint location = getLocationInCurrentProgram(state);
+    if (location < 0) {
+        return;
+    }
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    if (renderQueue == NULL) {
+        if (isUploadNeeded(state)) {
+            glUniform1i(location, unit.toOrdinal());
+        }
+    } else {
+        renderQueue->setUniform(location, unit.toOrdinal());
     }
 }
 
@@ -35,6 +35,7 @@ public:
     virtual ~Sampler3dUniformNode();
     std::string getLink() const;
     Gloop::TextureUnit getTextureUnit() const;
+    virtual void prepare(State& state);
     virtual void preVisit(State& state);
     virtual void visit(State& state);
 private:
@@ -18,6 +18,7 @@
 #include "config.h"
 #include <m3d/Mat4.h>
 #include "RapidGL/ScaleNode.h"
+#include "RapidGL/SimdMat4.h"
 namespace RapidGL {
 
 /**
@@ -43,6 +44,37 @@ ScaleNode::~ScaleNode() {
     // empty
 }
 
+/**
+ * Computes the bounds of this node's children, transformed by this node.
+ *
+ * @return Box enclosing this node's children after they are transformed
+ */
+BoundingBox ScaleNode::computeBounds() {
+    return Node::computeBounds().transform(getMatrix());
+}
+
+/**
+ * Returns the matrix this node post-multiplies the model matrix with, in single precision.
+ *
+ * @return Scale matrix
+ */
+SimdMat4 ScaleNode::computeMatrix() const {
+    return SimdMat4::scaling(scale);
+}
+
+/**
+ * Returns the matrix this node post-multiplies the model matrix with.
+ *
+ * @return Scale matrix
+ */
+M3d::Mat4 ScaleNode::getMatrix() const {
+    M3d::Mat4 matrix(1);
+    matrix[0][0] = scale.x;
+    matrix[1][1] = scale.y;
+    matrix[2][2] = scale.z;
+    return matrix;
+}
+
 /**
  * Returns the scale that this node will apply when it is visited.
  *
@@ -59,25 +91,8 @@ M3d::Vec3 ScaleNode::getScale() const {
  */
 void ScaleNode::setScale(const M3d::Vec3& scale) {
     this->scale = scale;
+    invalidateMatrix();
     fireNodeChangedEvent();
 }
 
-void ScaleNode::visit(State& state) {
-
-    // Get model matrix from state
-    M3d::Mat4 modelMatrix = state.getModelMatrix();
-
-    // Make scale matrix
-    M3d::Mat4 scaleMatrix(1);
-    scaleMatrix[0][0] = scale.x;
-    scaleMatrix[1][1] = scale.y;
-    scaleMatrix[2][2] = scale.z;
-
-    // Post-multiply model matrix with scale matrix
-    modelMatrix = modelMatrix * scaleMatrix;
-
-    // Update state
-    state.setModelMatrix(modelMatrix);
-}
-
 } /* namespace RapidGL */
@@ -17,8 +17,10 @@
  */
 #ifndef RAPIDGL_SCALE_NODE_H
 #define RAPIDGL_SCALE_NODE_H
+#include <m3d/Mat4.h>
 #include <m3d/Vec3.h>
 #include "RapidGL/common.h"
+#include "RapidGL/BoundingBox.h"
 #include "RapidGL/TransformNode.h"
 #include "RapidGL/State.h"
 namespace RapidGL {
@@ -33,9 +35,13 @@ public:
     ScaleNode();
     ScaleNode(const M3d::Vec3& scale);
     virtual ~ScaleNode();
+    M3d::Mat4 getMatrix() const;
     M3d::Vec3 getScale() const;
     void setScale(const M3d::Vec3& scale);
-    virtual void visit(State& state);
+protected:
+// Methods
+    virtual BoundingBox computeBounds();
+    virtual SimdMat4 computeMatrix() const;
 private:
 // Attributes
     M3d::Vec3 scale;
@@ -34,7 +34,7 @@ ScaleNodeUnmarshaller::~ScaleNodeUnmarshaller() {
     // empty
 }
 
-Node* ScaleNodeUnmarshaller::unmarshal(const std::map<std::string,std::string>& attributes) {
+Node* ScaleNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
 
     // Make value
     M3d::Vec3 value(1);
@@ -32,7 +32,7 @@ public:
 // Methods
     ScaleNodeUnmarshaller();
     virtual ~ScaleNodeUnmarshaller();
-    virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+    virtual Node* unmarshal(const AttributeView& attributes);
 };
 
 } /* namespace RapidGL */
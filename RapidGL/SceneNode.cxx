@@ -23,7 +23,7 @@ namespace RapidGL {
  * Constructs a `SceneNode`.
  */
 SceneNode::SceneNode() {
-    // empty
+    setHooks(0);
 }
 
 /**
@@ -33,7 +33,7 @@ SceneNodeUnmarshaller::~SceneNodeUnmarshaller() {
     // empty
 }
 
-Node* SceneNodeUnmarshaller::unmarshal(const std::map<std::string,std::string>& attributes) {
+Node* SceneNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
     return new SceneNode();
 }
 
@@ -34,7 +34,7 @@ public:
 // Methods
     SceneNodeUnmarshaller();
     virtual ~SceneNodeUnmarshaller();
-    virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+    virtual Node* unmarshal(const AttributeView& attributes);
 };
 
 } /* namespace RapidGL */
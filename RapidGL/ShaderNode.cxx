@@ -29,7 +29,7 @@ namespace RapidGL {
  * @throws runtime_error if shader could not be compiled
  */
 ShaderNode::ShaderNode(const GLenum type, const std::string& source) : shader(createShader(type, source)) {
-    // empty
+    setHooks(0);
 }
 
 /**
@@ -57,13 +57,13 @@ std::string ShaderNodeUnmarshaller::copyFile(const std::string& path) {
 }
 
 /**
- * Returns the value of the _file_ attribute in a map.
+ * Returns the value of the _file_ attribute.
  *
- * @param attributes Map of attributes to look in
- * @return Value of _file_ attribute in the map
+ * @param attributes Attributes to look in
+ * @return Value of _file_ attribute
  * @throws runtime_error if _file_ attribute is unspecified
  */
-std::string ShaderNodeUnmarshaller::getFile(const std::map<std::string,std::string>& attributes) {
+std::string ShaderNodeUnmarshaller::getFile(const AttributeView& attributes) {
     const std::string value = findValue(attributes, "file");
     if (value.empty()) {
         throw std::runtime_error("[ShaderNodeUnmarshaller] File is unspecified!");
@@ -73,13 +73,13 @@ std::string ShaderNodeUnmarshaller::getFile(const std::map<std::string,std::stri
 }
 
 /**
- * Returns the value of the _type_ attribute in a map.
+ * Returns the value of the _type_ attribute.
  *
- * @param attributes Map of attributes to look in
- * @return Value of _type_ attribute in the map
+ * @param attributes Attributes to look in
+ * @return Value of _type_ attribute
  * @throws runtime_error if _type_ attribute is unspecified
  */
-GLenum ShaderNodeUnmarshaller::getType(const std::map<std::string,std::string>& attributes) {
+GLenum ShaderNodeUnmarshaller::getType(const AttributeView& attributes) {
 
     // Get the value
     const std::string value = findValue(attributes, "type");
@@ -99,7 +99,7 @@ GLenum ShaderNodeUnmarshaller::getType(const std::map<std::string,std::string>&
     }
 }
 
-Node* ShaderNodeUnmarshaller::unmarshal(const std::map<std::string,std::string>& attributes) {
+Node* ShaderNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
 
     // Get type and file
     const GLenum type = getType(attributes);
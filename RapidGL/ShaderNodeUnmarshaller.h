@@ -30,14 +30,14 @@ class ShaderNodeUnmarshaller : public Unmarshaller {
 public:
 // Methods
     ShaderNodeUnmarshaller();
-    virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+    virtual Node* unmarshal(const AttributeView& attributes);
 private:
 // Constants
     static const int BUFFER_SIZE = 2048;
 // Methods
     static std::string copyFile(const std::string& path);
-    static std::string getFile(const std::map<std::string,std::string>& attributes);
-    static GLenum getType(const std::map<std::string,std::string>& attributes);
+    static std::string getFile(const AttributeView& attributes);
+    static GLenum getType(const AttributeView& attributes);
 };
 
 } /* namespace RapidGL */
@@ -0,0 +1,356 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <stdexcept>
+#include <m3d/Vec4.h>
+#include "RapidGL/SimdMat4.h"
+#if defined(__AVX__)
+#include <immintrin.h>
+#define RAPIDGL_SIMD_AVX
+#define RAPIDGL_SIMD_SSE
+#elif defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define RAPIDGL_SIMD_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RAPIDGL_SIMD_NEON
+#endif
+namespace RapidGL {
+
+// Column of four floats, with the few operations the products need
+namespace {
+#if defined(RAPIDGL_SIMD_SSE)
+typedef __m128 Column;
+inline Column load(const GLfloat* p) { return _mm_loadu_ps(p); }
+inline void store(GLfloat* p, const Column c) { _mm_storeu_ps(p, c); }
+inline Column splat(const GLfloat f) { return _mm_set1_ps(f); }
+inline Column add(const Column a, const Column b) { return _mm_add_ps(a, b); }
+inline Column mul(const Column a, const Column b) { return _mm_mul_ps(a, b); }
+#elif defined(RAPIDGL_SIMD_NEON)
+typedef float32x4_t Column;
+inline Column load(const GLfloat* p) { return vld1q_f32(p); }
+inline void store(GLfloat* p, const Column c) { vst1q_f32(p, c); }
+inline Column splat(const GLfloat f) { return vdupq_n_f32(f); }
+inline Column add(const Column a, const Column b) { return vaddq_f32(a, b); }
+inline Column mul(const Column a, const Column b) { return vmulq_f32(a, b); }
+#else
+struct Column { GLfloat v[4]; };
+inline Column load(const GLfloat* p) { Column c = { { p[0], p[1], p[2], p[3] } }; return c; }
+inline void store(GLfloat* p, const Column& c) { std::copy(c.v, c.v + 4, p); }
+inline Column splat(const GLfloat f) { Column c = { { f, f, f, f } }; return c; }
+inline Column add(const Column& a, const Column& b) {
+    Column c = { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } };
+    return c;
+}
+inline Column mul(const Column& a, const Column& b) {
+    Column c = { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } };
+    return c;
+}
+#endif
+
+// Pair of columns, so AVX can compute two columns of a product at once
+#if defined(RAPIDGL_SIMD_AVX)
+typedef __m256 Pair;
+inline Pair loadPair(const GLfloat* p) { return _mm256_loadu_ps(p); }
+inline Pair loadTwice(const GLfloat* p) { return _mm256_broadcast_ps((const __m128*) p); }
+inline void storePair(GLfloat* p, const Pair c) { _mm256_storeu_ps(p, c); }
+template<int I> inline Pair splatEach(const Pair c) { return _mm256_permute_ps(c, I * 0x55); }
+inline Pair addPair(const Pair a, const Pair b) { return _mm256_add_ps(a, b); }
+inline Pair mulPair(const Pair a, const Pair b) { return _mm256_mul_ps(a, b); }
+#endif
+}
+
+/**
+ * Constructs an identity matrix.
+ */
+SimdMat4::SimdMat4() {
+    std::fill(m, m + 16, 0.0f);
+    m[0] = m[5] = m[10] = m[15] = 1.0f;
+}
+
+/**
+ * Makes a matrix from an array in column-major order.
+ *
+ * @param arr Array of 16 floats in column-major order
+ * @return Matrix with values from the array
+ */
+SimdMat4 SimdMat4::fromArrayInColumnMajor(const GLfloat* const arr) {
+    SimdMat4 mat;
+    std::copy(arr, arr + 16, mat.m);
+    return mat;
+}
+
+/**
+ * Makes a matrix from a double-precision matrix.
+ *
+ * @param mat Matrix to convert
+ * @return Matrix with values of the other matrix rounded to floats
+ */
+SimdMat4 SimdMat4::fromMat4(const M3d::Mat4& mat) {
+    SimdMat4 result;
+    mat.toArrayInColumnMajor(result.m);
+    return result;
+}
+
+/**
+ * Returns the name of the instructions products are computed with.
+ *
+ * @return `AVX`, `SSE`, `NEON` or `none`
+ */
+const char* SimdMat4::getInstructionSet() {
+#if defined(RAPIDGL_SIMD_AVX)
+    return "AVX";
+#elif defined(RAPIDGL_SIMD_SSE)
+    return "SSE";
+#elif defined(RAPIDGL_SIMD_NEON)
+    return "NEON";
+#else
+    return "none";
+#endif
+}
+
+/**
+ * Computes the inverse of this matrix, assuming it is affine.
+ *
+ * The upper 3x3 part is inverted with cross products of its columns, and the
+ * translation is moved back through it.
+ *
+ * @return Inverse of this matrix
+ * @throws runtime_error if this matrix cannot be inverted
+ */
+SimdMat4 SimdMat4::inverseAffine() const {
+
+    // Rows of inverse of upper 3x3 part are cross products of its columns
+    const GLfloat* const a = m;
+    const GLfloat* const b = m + 4;
+    const GLfloat* const c = m + 8;
+    GLfloat rows[3][3] = {
+        { b[1] * c[2] - b[2] * c[1], b[2] * c[0] - b[0] * c[2], b[0] * c[1] - b[1] * c[0] },
+        { c[1] * a[2] - c[2] * a[1], c[2] * a[0] - c[0] * a[2], c[0] * a[1] - c[1] * a[0] },
+        { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] }
+    };
+    const GLfloat determinant = a[0] * rows[0][0] + a[1] * rows[0][1] + a[2] * rows[0][2];
+    if (determinant == 0.0f) {
+        throw std::runtime_error("[SimdMat4] Matrix cannot be inverted!");
+    }
+
+    // Store rows scaled by determinant, and translation moved back through them
+    SimdMat4 result;
+    const GLfloat scale = 1.0f / determinant;
+    const GLfloat* const t = m + 12;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            rows[i][j] *= scale;
+            result.m[j * 4 + i] = rows[i][j];
+        }
+        result.m[12 + i] = -(rows[i][0] * t[0] + rows[i][1] * t[1] + rows[i][2] * t[2]);
+    }
+    return result;
+}
+
+/**
+ * Post-multiplies this matrix by an affine matrix.
+ *
+ * Since the bottom row of the other matrix is `0 0 0 1`, the last column of
+ * this matrix only needs to be added to the translation.
+ *
+ * @param mat Affine matrix to multiply by
+ * @return Product of this matrix and the other matrix
+ */
+SimdMat4 SimdMat4::multiplyAffine(const SimdMat4& mat) const {
+#if defined(RAPIDGL_SIMD_AVX)
+    const Pair a0 = loadTwice(m);
+    const Pair a1 = loadTwice(m + 4);
+    const Pair a2 = loadTwice(m + 8);
+    const Pair t = _mm256_insertf128_ps(_mm256_setzero_ps(), _mm_loadu_ps(m + 12), 1);
+    SimdMat4 result;
+    for (int j = 0; j < 4; j += 2) {
+        const Pair b = loadPair(mat.m + (j * 4));
+        Pair c = mulPair(a0, splatEach<0>(b));
+        c = addPair(c, mulPair(a1, splatEach<1>(b)));
+        c = addPair(c, mulPair(a2, splatEach<2>(b)));
+        if (j == 2) {
+            c = addPair(c, t);
+        }
+        storePair(result.m + (j * 4), c);
+    }
+    return result;
+#else
+    const Column a0 = load(m);
+    const Column a1 = load(m + 4);
+    const Column a2 = load(m + 8);
+    const Column a3 = load(m + 12);
+    SimdMat4 result;
+    for (int j = 0; j < 4; ++j) {
+        const GLfloat* const b = mat.m + (j * 4);
+        Column c = mul(a0, splat(b[0]));
+        c = add(c, mul(a1, splat(b[1])));
+        c = add(c, mul(a2, splat(b[2])));
+        if (j == 3) {
+            c = add(c, a3);
+        }
+        store(result.m + (j * 4), c);
+    }
+    return result;
+#endif
+}
+
+/**
+ * Post-multiplies this matrix by another matrix.
+ *
+ * @param mat Matrix to multiply by
+ * @return Product of this matrix and the other matrix
+ */
+SimdMat4 SimdMat4::operator*(const SimdMat4& mat) const {
+#if defined(RAPIDGL_SIMD_AVX)
+    const Pair a0 = loadTwice(m);
+    const Pair a1 = loadTwice(m + 4);
+    const Pair a2 = loadTwice(m + 8);
+    const Pair a3 = loadTwice(m + 12);
+    SimdMat4 result;
+    for (int j = 0; j < 4; j += 2) {
+        const Pair b = loadPair(mat.m + (j * 4));
+        Pair c = mulPair(a0, splatEach<0>(b));
+        c = addPair(c, mulPair(a1, splatEach<1>(b)));
+        c = addPair(c, mulPair(a2, splatEach<2>(b)));
+        c = addPair(c, mulPair(a3, splatEach<3>(b)));
+        storePair(result.m + (j * 4), c);
+    }
+    return result;
+#else
+    const Column a0 = load(m);
+    const Column a1 = load(m + 4);
+    const Column a2 = load(m + 8);
+    const Column a3 = load(m + 12);
+    SimdMat4 result;
+    for (int j = 0; j < 4; ++j) {
+        const GLfloat* const b = mat.m + (j * 4);
+        Column c = mul(a0, splat(b[0]));
+        c = add(c, mul(a1, splat(b[1])));
+        c = add(c, mul(a2, splat(b[2])));
+        c = add(c, mul(a3, splat(b[3])));
+        store(result.m + (j * 4), c);
+    }
+    return result;
+#endif
+}
+
+/**
+ * Checks if this matrix has exactly the same values as another matrix.
+ *
+ * @param mat Matrix to compare to
+ * @return `true` if every value is equal
+ */
+bool SimdMat4::operator==(const SimdMat4& mat) const {
+    return std::equal(m, m + 16, mat.m);
+}
+
+/**
+ * Returns a column of this matrix.
+ *
+ * @param column Index of column, from zero to three
+ * @return Pointer to the four values of the column
+ */
+const GLfloat* SimdMat4::operator[](const int column) const {
+    return m + (column * 4);
+}
+
+/**
+ * Makes a rotation matrix from a quaternion.
+ *
+ * @param quat Unit quaternion to convert
+ * @return Rotation matrix equivalent to quaternion
+ */
+SimdMat4 SimdMat4::rotation(const M3d::Quat& quat) {
+
+    const double xx = quat.x * quat.x;
+    const double yy = quat.y * quat.y;
+    const double zz = quat.z * quat.z;
+    const double xy = quat.x * quat.y;
+    const double xz = quat.x * quat.z;
+    const double yz = quat.y * quat.z;
+    const double xw = quat.x * quat.w;
+    const double yw = quat.y * quat.w;
+    const double zw = quat.z * quat.w;
+
+    SimdMat4 mat;
+    mat.m[0] = (GLfloat) (1 - 2 * (yy + zz));
+    mat.m[1] = (GLfloat) (2 * (xy + zw));
+    mat.m[2] = (GLfloat) (2 * (xz - yw));
+    mat.m[4] = (GLfloat) (2 * (xy - zw));
+    mat.m[5] = (GLfloat) (1 - 2 * (xx + zz));
+    mat.m[6] = (GLfloat) (2 * (yz + xw));
+    mat.m[8] = (GLfloat) (2 * (xz + yw));
+    mat.m[9] = (GLfloat) (2 * (yz - xw));
+    mat.m[10] = (GLfloat) (1 - 2 * (xx + yy));
+    return mat;
+}
+
+/**
+ * Makes a scaling matrix.
+ *
+ * @param scale Amount to scale by in each direction
+ * @return Scaling matrix
+ */
+SimdMat4 SimdMat4::scaling(const M3d::Vec3& scale) {
+    SimdMat4 mat;
+    mat.m[0] = (GLfloat) scale.x;
+    mat.m[5] = (GLfloat) scale.y;
+    mat.m[10] = (GLfloat) scale.z;
+    return mat;
+}
+
+/**
+ * Copies this matrix into an array in column-major order.
+ *
+ * @param arr Array of 16 floats to copy into
+ */
+void SimdMat4::toArrayInColumnMajor(GLfloat* const arr) const {
+    std::copy(m, m + 16, arr);
+}
+
+/**
+ * Converts this matrix to a double-precision matrix.
+ *
+ * @return Double-precision copy of this matrix
+ */
+M3d::Mat4 SimdMat4::toMat4() const {
+    M3d::Mat4 mat;
+    for (int j = 0; j < 4; ++j) {
+        const GLfloat* const column = m + (j * 4);
+        mat[j] = M3d::Vec4(column[0], column[1], column[2], column[3]);
+    }
+    return mat;
+}
+
+/**
+ * Makes a translation matrix.
+ *
+ * @param translation Amount to move by in each direction
+ * @return Translation matrix
+ */
+SimdMat4 SimdMat4::translation(const M3d::Vec3& translation) {
+    SimdMat4 mat;
+    mat.m[12] = (GLfloat) translation.x;
+    mat.m[13] = (GLfloat) translation.y;
+    mat.m[14] = (GLfloat) translation.z;
+    return mat;
+}
+
+} /* namespace RapidGL */
@@ -0,0 +1,63 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RAPIDGL_SIMD_MAT4_H
+#define RAPIDGL_SIMD_MAT4_H
+#include <m3d/Mat4.h>
+#include <m3d/Quat.h>
+#include <m3d/Vec3.h>
+#include "RapidGL/common.h"
+namespace RapidGL {
+
+
+/**
+ * 4x4 single-precision matrix for transforming nodes, stored in column-major order.
+ *
+ * Products are computed eight floats at a time with AVX, four at a time with
+ * SSE on x86 and NEON on ARM, chosen when compiling, or with plain floats
+ * otherwise.  AVX computes two columns of a product at once.  Since the
+ * values are already floats in column-major order, they can be copied
+ * straight into uniforms and instance buffers.
+ *
+ * Matrices made from a translation, rotation or scale are affine, meaning
+ * their bottom row is `0 0 0 1`.  `multiplyAffine` and `inverseAffine` take
+ * advantage of that to skip work.
+ */
+class SimdMat4 {
+public:
+// Methods
+    SimdMat4();
+    static SimdMat4 fromArrayInColumnMajor(const GLfloat* arr);
+    static SimdMat4 fromMat4(const M3d::Mat4& mat);
+    static const char* getInstructionSet();
+    SimdMat4 inverseAffine() const;
+    SimdMat4 multiplyAffine(const SimdMat4& mat) const;
+    SimdMat4 operator*(const SimdMat4& mat) const;
+    bool operator==(const SimdMat4& mat) const;
+    const GLfloat* operator[](int column) const;
+    static SimdMat4 rotation(const M3d::Quat& quat);
+    static SimdMat4 scaling(const M3d::Vec3& scale);
+    void toArrayInColumnMajor(GLfloat* arr) const;
+    M3d::Mat4 toMat4() const;
+    static SimdMat4 translation(const M3d::Vec3& translation);
+private:
+// Attributes
+    GLfloat m[16];
+};
+
+} /* namespace RapidGL */
+#endif
@@ -0,0 +1,97 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <iostream>
+#include <Poco/Stopwatch.h>
+#include <m3d/Mat4.h>
+#include <m3d/Math.h>
+#include <m3d/Quat.h>
+#include <m3d/Vec3.h>
+#include "RapidGL/SimdMat4.h"
+#include "RapidGL/State.h"
+
+
+/**
+ * Benchmark comparing M3d matrices with `SimdMat4` for the work transform nodes do.
+ *
+ * Each step post-multiplies the model matrix by a rotation, then concatenates
+ * it with the view and projection matrices, like a `RotateNode` followed by a
+ * `Mat4UniformNode` for the model-view-projection matrix.
+ */
+class SimdMat4Benchmark {
+public:
+
+    // Number of times to transform the model matrix
+    static const int ITERATIONS = 1000000;
+
+    /**
+     * Times transforming with both kinds of matrices and prints the results.
+     */
+    void run() {
+
+        const M3d::Quat rotation = M3d::Quat::fromAxisAngle(M3d::Vec3(0, 1, 0), M3d::toRadians(0.01));
+        const M3d::Mat4 viewProjectionMatrix(1);
+        Poco::Stopwatch stopwatch;
+
+        // M3d
+        M3d::Mat4 modelMatrix(1);
+        M3d::Mat4 modelViewProjectionMatrix(1);
+        stopwatch.restart();
+        for (int i = 0; i < ITERATIONS; ++i) {
+            modelMatrix = modelMatrix * rotation.toMat4();
+            modelViewProjectionMatrix = viewProjectionMatrix * modelMatrix;
+        }
+        stopwatch.stop();
+        const double m3dTime = ((double) stopwatch.elapsed()) * 1000 / ITERATIONS;
+
+        // SimdMat4
+        const RapidGL::SimdMat4 simdViewProjectionMatrix = RapidGL::SimdMat4::fromMat4(viewProjectionMatrix);
+        RapidGL::SimdMat4 simdModelMatrix;
+        RapidGL::SimdMat4 simdModelViewProjectionMatrix;
+        stopwatch.restart();
+        for (int i = 0; i < ITERATIONS; ++i) {
+            simdModelMatrix = simdModelMatrix.multiplyAffine(RapidGL::SimdMat4::rotation(rotation));
+            simdModelViewProjectionMatrix = simdViewProjectionMatrix * simdModelMatrix;
+        }
+        stopwatch.stop();
+        const double simdTime = ((double) stopwatch.elapsed()) * 1000 / ITERATIONS;
+
+        // State
+        RapidGL::State state;
+        stopwatch.restart();
+        for (int i = 0; i < ITERATIONS; ++i) {
+            state.multiplyModelMatrix(RapidGL::SimdMat4::rotation(rotation));
+            state.getSimdModelViewProjectionMatrix();
+        }
+        stopwatch.stop();
+        const double stateTime = ((double) stopwatch.elapsed()) * 1000 / ITERATIONS;
+
+        // Print results, using the results so they are not optimized away
+        std::cout << "Rotate and concatenate (" << RapidGL::SimdMat4::getInstructionSet() << ")" << std::endl;
+        std::cout << "  m3d:      " << m3dTime << " ns per step" << std::endl;
+        std::cout << "  simd:     " << simdTime << " ns per step" << std::endl;
+        std::cout << "  state:    " << stateTime << " ns per step" << std::endl;
+        std::cout << "  checksum: " << (modelViewProjectionMatrix[3][3] + simdModelViewProjectionMatrix[3][3]) << std::endl;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    SimdMat4Benchmark benchmark;
+    benchmark.run();
+    return 0;
+}
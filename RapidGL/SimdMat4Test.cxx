@@ -0,0 +1,188 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include <m3d/Mat4.h>
+#include <m3d/Math.h>
+#include <m3d/Quat.h>
+#include <m3d/Vec3.h>
+#include <m3d/Vec4.h>
+#include "RapidGL/SimdMat4.h"
+
+
+/**
+ * Unit test for `SimdMat4`.
+ */
+class SimdMat4Test : public CppUnit::TestFixture {
+public:
+
+    // Threshold for single-precision comparisons
+    static const double TOLERANCE = 1e-5;
+
+    /**
+     * Asserts that a matrix is approximately equal to an M3d matrix.
+     *
+     * @param expected Expected results
+     * @param actual Actual results
+     */
+    static void assertMatricesEqual(const M3d::Mat4& expected, const RapidGL::SimdMat4& actual) {
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                CPPUNIT_ASSERT_DOUBLES_EQUAL(expected[j][i], actual[j][i], TOLERANCE);
+            }
+        }
+    }
+
+    /**
+     * Makes an affine matrix with a rotation, scale and translation.
+     *
+     * @return Affine matrix with every part of the upper three rows filled in
+     */
+    static M3d::Mat4 makeAffineMatrix() {
+        const M3d::Quat rotation = M3d::Quat::fromAxisAngle(M3d::Vec3(1, 2, 3), M3d::toRadians(30));
+        M3d::Mat4 mat = rotation.toMat4();
+        mat[0] = mat[0] * 2.0;
+        mat[3] = M3d::Vec4(4, -5, 6, 1);
+        return mat;
+    }
+
+    /**
+     * Makes a perspective projection matrix, which is not affine.
+     *
+     * @return Matrix with a bottom row other than `0 0 0 1`
+     */
+    static M3d::Mat4 makeProjectionMatrix() {
+        M3d::Mat4 mat(1);
+        mat[2][2] = -1.2;
+        mat[2][3] = -1.0;
+        mat[3][2] = -2.2;
+        mat[3][3] = 0.0;
+        return mat;
+    }
+
+    /**
+     * Ensures a default matrix is the identity matrix.
+     */
+    void testConstructor() {
+        assertMatricesEqual(M3d::Mat4(1), RapidGL::SimdMat4());
+    }
+
+    /**
+     * Ensures `inverseAffine` undoes a rotation, scale and translation.
+     */
+    void testInverseAffine() {
+        const RapidGL::SimdMat4 mat = RapidGL::SimdMat4::fromMat4(makeAffineMatrix());
+        assertMatricesEqual(M3d::Mat4(1), mat * mat.inverseAffine());
+        assertMatricesEqual(M3d::Mat4(1), mat.inverseAffine() * mat);
+    }
+
+    /**
+     * Ensures `inverseAffine` throws if the matrix cannot be inverted.
+     */
+    void testInverseAffineWithSingularMatrix() {
+        const RapidGL::SimdMat4 mat = RapidGL::SimdMat4::scaling(M3d::Vec3(1, 0, 1));
+        CPPUNIT_ASSERT_THROW(mat.inverseAffine(), std::runtime_error);
+    }
+
+    /**
+     * Ensures `multiplyAffine` gives the same result as a full multiplication.
+     */
+    void testMultiplyAffine() {
+        const M3d::Mat4 a = makeProjectionMatrix();
+        const M3d::Mat4 b = makeAffineMatrix();
+        const RapidGL::SimdMat4 simdA = RapidGL::SimdMat4::fromMat4(a);
+        const RapidGL::SimdMat4 simdB = RapidGL::SimdMat4::fromMat4(b);
+        assertMatricesEqual(a * b, simdA.multiplyAffine(simdB));
+    }
+
+    /**
+     * Ensures multiplying gives the same result as M3d.
+     */
+    void testMultiply() {
+        const M3d::Mat4 a = makeProjectionMatrix();
+        const M3d::Mat4 b = makeAffineMatrix();
+        const RapidGL::SimdMat4 simdA = RapidGL::SimdMat4::fromMat4(a);
+        const RapidGL::SimdMat4 simdB = RapidGL::SimdMat4::fromMat4(b);
+        assertMatricesEqual(a * b, simdA * simdB);
+        assertMatricesEqual(b * a, simdB * simdA);
+    }
+
+    /**
+     * Ensures `rotation` gives the same matrix as M3d.
+     */
+    void testRotation() {
+        const M3d::Quat quat = M3d::Quat::fromAxisAngle(M3d::Vec3(0, 1, 1), M3d::toRadians(-45));
+        assertMatricesEqual(quat.toMat4(), RapidGL::SimdMat4::rotation(quat));
+    }
+
+    /**
+     * Ensures `scaling` puts the scale on the diagonal.
+     */
+    void testScaling() {
+        M3d::Mat4 expected(1);
+        expected[0][0] = 2;
+        expected[1][1] = 3;
+        expected[2][2] = 4;
+        assertMatricesEqual(expected, RapidGL::SimdMat4::scaling(M3d::Vec3(2, 3, 4)));
+    }
+
+    /**
+     * Ensures converting to an array and back keeps the values in column-major order.
+     */
+    void testToArrayInColumnMajor() {
+        const RapidGL::SimdMat4 mat = RapidGL::SimdMat4::translation(M3d::Vec3(1, 2, 3));
+        GLfloat arr[16];
+        mat.toArrayInColumnMajor(arr);
+        CPPUNIT_ASSERT_EQUAL(1.0f, arr[12]);
+        CPPUNIT_ASSERT_EQUAL(2.0f, arr[13]);
+        CPPUNIT_ASSERT_EQUAL(3.0f, arr[14]);
+        CPPUNIT_ASSERT_EQUAL(1.0f, arr[15]);
+        assertMatricesEqual(mat.toMat4(), RapidGL::SimdMat4::fromArrayInColumnMajor(arr));
+    }
+
+    /**
+     * Ensures `translation` puts the translation in the last column.
+     */
+    void testTranslation() {
+        M3d::Mat4 expected(1);
+        expected[3] = M3d::Vec4(1, 2, 3, 1);
+        assertMatricesEqual(expected, RapidGL::SimdMat4::translation(M3d::Vec3(1, 2, 3)));
+    }
+
+    CPPUNIT_TEST_SUITE(SimdMat4Test);
+    CPPUNIT_TEST(testConstructor);
+    CPPUNIT_TEST(testInverseAffine);
+    CPPUNIT_TEST(testInverseAffineWithSingularMatrix);
+    CPPUNIT_TEST(testMultiplyAffine);
+    CPPUNIT_TEST(testMultiply);
+    CPPUNIT_TEST(testRotation);
+    CPPUNIT_TEST(testScaling);
+    CPPUNIT_TEST(testToArrayInColumnMajor);
+    CPPUNIT_TEST(testTranslation);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(SimdMat4Test::suite());
+    runner.run();
+    return 0;
+}
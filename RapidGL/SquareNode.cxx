@@ -16,17 +16,18 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "config.h"
+#include <cstring>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 #include <glycerin/BufferLayoutBuilder.hxx>
 #include <glycerin/BufferRegion.hxx>
 #include "RapidGL/SquareNode.h"
-using std::map;
 using std::string;
 namespace RapidGL {
 
-const Gloop::BufferTarget SquareNode::arrayBuffer = Gloop::BufferTarget::arrayBuffer();
-const Glycerin::BufferLayout SquareNode::bufferLayout = createBufferLayout();
+// Name of geometry shared by every square
+const std::string SquareNode::GEOMETRY_NAME = "square";
 
 /**
  * Constructs a square node.
@@ -34,44 +35,29 @@ const Glycerin::BufferLayout SquareNode::bufferLayout = createBufferLayout();
 SquareNode::SquareNode() :
         prepared(false),
         boundingBox(createBoundingBox()),
-        vbo(Gloop::BufferObject::generate()) {
+        geometry(Geometry::acquire(GEOMETRY_NAME, &createGeometry)),
+        vaoCache(geometry) {
 
-    // Bind the VBO
-    arrayBuffer.bind(vbo);
-
-    // Allocate buffer
-    arrayBuffer.data(bufferLayout.sizeInBytes(), NULL, GL_STATIC_DRAW);
-
-    // Add vertices
-    const Glycerin::BufferRegion vertexRegion = *(bufferLayout.find("POSITION"));
-    GLfloat points[COUNT][2] = { { +0.5f, +0.5f },
-                                 { -0.5f, +0.5f },
-                                 { -0.5f, -0.5f },
-                                 { +0.5f, +0.5f },
-                                 { -0.5f, -0.5f },
-                                 { +0.5f, -0.5f } };
-    arrayBuffer.subData(vertexRegion.offset(), vertexRegion.sizeInBytes(), points);
-
-    // Add coordinates
-    const Glycerin::BufferRegion coordRegion = *(bufferLayout.find("TEXCOORD0"));
-    GLfloat coords[COUNT][2] = { { 1.0f, 1.0f },
-                                 { 0.0f, 1.0f },
-                                 { 0.0f, 0.0f },
-                                 { 1.0f, 1.0f },
-                                 { 0.0f, 0.0f },
-                                 { 1.0f, 0.0f } };
-    arrayBuffer.subData(coordRegion.offset(), coordRegion.sizeInBytes(), coords);
-
-    // Unbind the VBO
-    arrayBuffer.unbind(vbo);
+    // Only draws when visited
+    setHooks(VISIT);
 }
 
 /**
  * Destructs this square node.
  */
 SquareNode::~SquareNode() {
-    forEachValue(vaos, &disposeVertexArrayObject);
-    vbo.dispose();
+    Geometry::release(GEOMETRY_NAME);
+}
+
+/**
+ * Computes the bounds of the square and any children of this node.
+ *
+ * @return Box enclosing the square and any children
+ */
+BoundingBox SquareNode::computeBounds() {
+    BoundingBox box = Node::computeBounds();
+    box.add(BoundingBox(M3d::Vec3(-0.5, -0.5, 0), M3d::Vec3(0.5, 0.5, 0)));
+    return box;
 }
 
 /**
@@ -88,93 +74,43 @@ Glycerin::AxisAlignedBoundingBox SquareNode::createBoundingBox() {
  */
 Glycerin::BufferLayout SquareNode::createBufferLayout() {
     return Glycerin::BufferLayoutBuilder()
-        .count(COUNT)
+        .count(CORNER_COUNT)
         .components(2)
         .region("POSITION")
         .region("TEXCOORD0")
         .build();
 }
 
-Gloop::VertexArrayObject SquareNode::createVertexArrayObject(const Gloop::Program& program) {
-
-    // Find the program node for the program
-    const Node* root = findRoot(this);
-    const ProgramNode* programNode = findProgramNode(root, program);
-    if (programNode == NULL) {
-        throw std::runtime_error("[SquareNode] Could not find program node for program!");
-    }
-
-    // Generate a VAO
-    const Gloop::VertexArrayObject vao = Gloop::VertexArrayObject::generate();
-
-    // Look for attributes
-    map<string,string> namesByUsage;
-    node_range_t programNodeChildren = programNode->getChildren();
-    for (node_iterator_t it = programNodeChildren.begin; it != programNodeChildren.end; ++it) {
-        const AttributeNode* attributeNode = dynamic_cast<const AttributeNode*>(*it);
-        if (attributeNode != NULL) {
-            const string name = attributeNode->getName();
-            const string usage = AttributeNode::formatUsage(attributeNode->getUsage());
-            namesByUsage[usage] = name;
-        }
-    }
-
-    // Bind VAO and VBO
-    vao.bind();
-    arrayBuffer.bind(vbo);
-
-    // Set up VAO
-    for (Glycerin::BufferLayout::const_iterator it = bufferLayout.begin(); it != bufferLayout.end(); ++it) {
-        const string usage = it->name();
-        if (containsKey(namesByUsage, usage)) {
-            const string name = getValueOfKey(namesByUsage, usage);
-            const GLint location = program.attribLocation(name);
-            if (location != -1) {
-                vao.enableVertexAttribArray(location);
-                vao.vertexAttribPointer(Gloop::VertexAttribPointer()
-                        .index(location)
-                        .size(it->components())
-                        .type(it->type())
-                        .normalized(it->normalized())
-                        .stride(it->stride())
-                        .offset(it->offset()));
-            }
-        }
-    }
-
-    // Unbind
-    arrayBuffer.unbind(vbo);
-    vao.unbind();
-
-    // Return VAO
-    return vao;
-}
-
 /**
- * Disposes of a vertex array object.
+ * Creates the geometry shared by every square.
  *
- * @param vao Vertex array object to dispose of
+ * @param name Name of geometry
  */
-void SquareNode::disposeVertexArrayObject(const Gloop::VertexArrayObject& vao) {
-    vao.dispose();
-}
+Geometry* SquareNode::createGeometry(const std::string& name) {
 
-Gloop::VertexArrayObject SquareNode::getVertexArrayObject(const Gloop::Program& program) {
+    const Glycerin::BufferLayout layout = createBufferLayout();
+    std::vector<GLfloat> data(layout.sizeInBytes() / sizeof(GLfloat));
 
-    // Check if already made VAO for program
-    std::map<Gloop::Program,Gloop::VertexArrayObject>::const_iterator it = vaos.find(program);
-    if (it != vaos.end()) {
-        return it->second;
-    }
+    // Add points
+    const Glycerin::BufferRegion pointRegion = *(layout.find("POSITION"));
+    GLfloat points[CORNER_COUNT][2] = { { +0.5f, +0.5f },
+                                        { -0.5f, +0.5f },
+                                        { -0.5f, -0.5f },
+                                        { +0.5f, -0.5f } };
+    std::memcpy(&data[pointRegion.offset() / sizeof(GLfloat)], points, pointRegion.sizeInBytes());
 
-    // Otherwise make VAO
-    const Gloop::VertexArrayObject vao = createVertexArrayObject(program);
+    // Add coordinates
+    const Glycerin::BufferRegion coordRegion = *(layout.find("TEXCOORD0"));
+    GLfloat coords[CORNER_COUNT][2] = { { 1.0f, 1.0f },
+                                        { 0.0f, 1.0f },
+                                        { 0.0f, 0.0f },
+                                        { 1.0f, 0.0f } };
+    std::memcpy(&data[coordRegion.offset() / sizeof(GLfloat)], coords, coordRegion.sizeInBytes());
 
-    // Store it for next time
-    vaos.insert(std::pair<Gloop::Program,Gloop::VertexArrayObject>(program, vao));
+    // Split into two triangles
+    const GLushort indices[INDEX_COUNT] = { 0, 1, 2, 0, 2, 3 };
 
-    // Return it
-    return vao;
+    return new Geometry(layout, &data[0], std::vector<GLushort>(indices, indices + INDEX_COUNT));
 }
 
 double SquareNode::intersect(const Glycerin::Ray& ray) const {
@@ -183,18 +119,34 @@ double SquareNode::intersect(const Glycerin::Ray& ray) const {
 
 void SquareNode::visit(State& state) {
 
+    // Draw every instance at once if a batch is being flushed
+    const InstanceBatcher* const instanceBatcher = state.getInstanceBatcher();
+    const GLsizei instanceCount = (instanceBatcher == NULL) ? 0 : instanceBatcher->getInstanceCount();
+
+    // Record into queue if there is one
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    if (renderQueue != NULL) {
+        const Gloop::VertexArrayObject vao = vaoCache.get(
+                this, renderQueue->getProgram(), state.getGLStateCache(), instanceBatcher);
+        renderQueue->addDrawElements(vao, GL_TRIANGLES, INDEX_COUNT, geometry->getIndexType(), state, instanceCount);
+        return;
+    }
+
     // Get current program
     const Gloop::Program program = Gloop::Program::current();
 
     // Get VAO for program and bind it
-    const Gloop::VertexArrayObject vao = getVertexArrayObject(program);
-    vao.bind();
+    GLStateCache& glStateCache = state.getGLStateCache();
+    const Gloop::VertexArrayObject vao = vaoCache.get(this, program, glStateCache, instanceBatcher);
+    glStateCache.bindVertexArray(vao);
+    state.bindUniformBuffers();
 
     // Draw square
-    glDrawArrays(GL_TRIANGLES, 0, COUNT);
-
-    // Unbind VAO
-    vao.unbind();
+    if (instanceCount > 0) {
+        glDrawElementsInstanced(GL_TRIANGLES, INDEX_COUNT, geometry->getIndexType(), NULL, instanceCount);
+    } else {
+        glDrawElements(GL_TRIANGLES, INDEX_COUNT, geometry->getIndexType(), NULL);
+    }
 }
 
 } /* namespace RapidGL */
@@ -18,8 +18,8 @@
 #ifndef RAPIDGL_SQUARENODE_H
 #define RAPIDGL_SQUARENODE_H
 #include <map>
-#include <gloop/BufferObject.hxx>
-#include <gloop/BufferTarget.hxx>
+#include <string>
+#include <utility>
 #include <gloop/Program.hxx>
 #include <gloop/VertexArrayObject.hxx>
 #include <glycerin/AxisAlignedBoundingBox.hxx>
@@ -27,16 +27,24 @@
 #include <glycerin/Ray.hxx>
 #include "RapidGL/common.h"
 #include "RapidGL/AttributeNode.h"
+#include "RapidGL/BoundingBox.h"
+#include "RapidGL/Geometry.h"
+#include "RapidGL/InstanceBatcher.h"
 #include "RapidGL/Intersectable.h"
 #include "RapidGL/Node.h"
 #include "RapidGL/ProgramNode.h"
+#include "RapidGL/RenderQueue.h"
 #include "RapidGL/State.h"
 #include "RapidGL/UseNode.h"
+#include "RapidGL/VertexArrayCache.h"
 namespace RapidGL {
 
 
 /**
  * Node drawing a square.
+ *
+ * Every square shares one `Geometry` holding its four corners and the indices
+ * of its two triangles.
  */
 class SquareNode : public Node, public Intersectable {
 public:
@@ -45,22 +53,23 @@ public:
     virtual ~SquareNode();
     virtual double intersect(const Glycerin::Ray& ray) const;
     virtual void visit(State& state);
+protected:
+// Methods
+    virtual BoundingBox computeBounds();
 private:
 // Constants
-    static const int COUNT = 6;
-    static const Gloop::BufferTarget arrayBuffer;
-    static const Glycerin::BufferLayout bufferLayout;
+    static const int CORNER_COUNT = 4;
+    static const int INDEX_COUNT = 6;
+    static const std::string GEOMETRY_NAME;
 // Attributes
     bool prepared;
     Glycerin::AxisAlignedBoundingBox boundingBox;
-    std::map<Gloop::Program,Gloop::VertexArrayObject> vaos;
-    Gloop::BufferObject vbo;
+    Geometry* const geometry;
+    VertexArrayCache vaoCache;
 // Methods
     static Glycerin::AxisAlignedBoundingBox createBoundingBox();
     static Glycerin::BufferLayout createBufferLayout();
-    Gloop::VertexArrayObject createVertexArrayObject(const Gloop::Program& program);
-    static void disposeVertexArrayObject(const Gloop::VertexArrayObject& vao);
-    Gloop::VertexArrayObject getVertexArrayObject(const Gloop::Program& program);
+    static Geometry* createGeometry(const std::string& name);
 };
 
 } /* namespace RapidGL */
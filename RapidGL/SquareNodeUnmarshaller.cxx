@@ -33,7 +33,7 @@ SquareNodeUnmarshaller::~SquareNodeUnmarshaller() {
     // empty
 }
 
-Node* SquareNodeUnmarshaller::unmarshal(const std::map<std::string,std::string>& attributes) {
+Node* SquareNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
     return new SquareNode();
 }
 
@@ -31,7 +31,7 @@ class SquareNodeUnmarshaller : public Unmarshaller {
 public:
     SquareNodeUnmarshaller();
     virtual ~SquareNodeUnmarshaller();
-    virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+    virtual Node* unmarshal(const AttributeView& attributes);
 };
 
 } /* namespace RapidGL */
@@ -16,14 +16,35 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "config.h"
+#include <algorithm>
+#include <stdexcept>
 #include "RapidGL/State.h"
+#include "RapidGL/UniformBuffer.h"
 namespace RapidGL {
 
+// Number of states made so far, used to give each state its ID
+Poco::AtomicCounter State::stateCount;
+
 /**
  * Constructs a state.
  */
-State::State() {
-    // empty
+State::State() :
+        glStateCache(&defaultGLStateCache),
+        id(++stateCount),
+        instanceBatcher(NULL),
+        modelMatrices(1),
+        modelMatrixVersions(1, 0),
+        projectionMatrices(1),
+        projectionMatrixVersions(1, 0),
+        renderQueue(NULL),
+        ringBuffer(NULL),
+        version(0),
+        viewMatrices(1),
+        viewMatrixVersions(1, 0) {
+    const Product identity = { SimdMat4(), 0, 0, 0 };
+    modelViewProduct = identity;
+    modelViewProjectionProduct = identity;
+    viewProjectionProduct = identity;
 }
 
 /**
@@ -33,13 +54,68 @@ State::~State() {
     // empty
 }
 
+/**
+ * Adds a uniform buffer that uniform nodes should write values into when their program declares its block.
+ *
+ * @param uniformBuffer Uniform buffer to add
+ * @throws invalid_argument if uniform buffer is `NULL`
+ */
+void State::addUniformBuffer(UniformBuffer* const uniformBuffer) {
+    if (uniformBuffer == NULL) {
+        throw std::invalid_argument("[State] Uniform buffer is NULL!");
+    }
+    if (std::find(uniformBuffers.begin(), uniformBuffers.end(), uniformBuffer) == uniformBuffers.end()) {
+        uniformBuffers.push_back(uniformBuffer);
+    }
+}
+
+/**
+ * Uploads any uniform buffers that changed and binds them, before drawing without a render queue.
+ *
+ * Uploads go into the ring buffer if there is one.
+ *
+ * @throws runtime_error if the ring buffer does not have a frame begun or has no space left
+ */
+void State::bindUniformBuffers() {
+    for (std::vector<UniformBuffer*>::const_iterator it = uniformBuffers.begin(); it != uniformBuffers.end(); ++it) {
+        (*it)->bind(*glStateCache, ringBuffer);
+    }
+}
+
+/**
+ * Returns the cache that nodes should change OpenGL state through.
+ *
+ * @return Reference to the cache that nodes should change OpenGL state through
+ */
+GLStateCache& State::getGLStateCache() {
+    return *glStateCache;
+}
+
+/**
+ * Returns a number identifying this state, which no other state will have.
+ *
+ * @return Number identifying this state
+ */
+size_t State::getId() const {
+    return id;
+}
+
+/**
+ * Returns the batcher instance nodes should add themselves to instead of visiting their group.
+ *
+ * @return Batcher instance nodes should add themselves to, or `NULL` if they should visit their group
+ */
+InstanceBatcher* State::getInstanceBatcher() const {
+    return instanceBatcher;
+}
+
 /**
  * Returns a copy of the matrix at the top of the model matrix stack.
  *
  * @return Copy of the matrix at the top of the model matrix stack
  */
 M3d::Mat4 State::getModelMatrix() const {
-    return modelMatrixStack.top();
+    return modelMatrices.back().toMat4();
 }
 
 /**
@@ -48,7 +124,16 @@ M3d::Mat4 State::getModelMatrix() const {
  * @return Number of matrices on the model matrix stack
  */
 size_t State::getModelMatrixStackSize() const {
-    return modelMatrixStack.size();
+    return modelMatrices.size();
+}
+
+/**
+ * Returns the version of the matrix at the top of the model matrix stack.
+ *
+ * @return Version of the matrix at the top of the model matrix stack
+ */
+size_t State::getModelMatrixVersion() const {
+    return modelMatrixVersions.back();
 }
 
 /**
@@ -57,7 +142,7 @@ size_t State::getModelMatrixStackSize() const {
  * @return Concatenation of the model and view matrices
  */
 M3d::Mat4 State::getModelViewMatrix() const {
-    return viewMatrixStack.top() * modelMatrixStack.top();
+    return getSimdModelViewMatrix().toMat4();
 }
 
 /**
@@ -66,7 +151,7 @@ M3d::Mat4 State::getModelViewMatrix() const {
  * @return Concatenation of the model, view, and projection matrices
  */
 M3d::Mat4 State::getModelViewProjectionMatrix() const {
-    return projectionMatrixStack.top() * viewMatrixStack.top() * modelMatrixStack.top();
+    return getSimdModelViewProjectionMatrix().toMat4();
 }
 
 /**
@@ -75,7 +160,7 @@ M3d::Mat4 State::getModelViewProjectionMatrix() const {
  * @return Copy of the matrix at the top of the projection matrix stack
  */
 M3d::Mat4 State::getProjectionMatrix() const {
-    return projectionMatrixStack.top();
+    return projectionMatrices.back().toMat4();
 }
 
 /**
@@ -84,7 +169,122 @@ M3d::Mat4 State::getProjectionMatrix() const {
  * @return Number of matrices on the projection matrix stack
  */
 size_t State::getProjectionMatrixStackSize() const {
-    return projectionMatrixStack.size();
+    return projectionMatrices.size();
+}
+
+/**
+ * Returns the version of the matrix at the top of the projection matrix stack.
+ *
+ * @return Version of the matrix at the top of the projection matrix stack
+ */
+size_t State::getProjectionMatrixVersion() const {
+    return projectionMatrixVersions.back();
+}
+
+/**
+ * Returns the queue nodes should record draws into instead of drawing.
+ *
+ * @return Queue nodes should record draws into, or `NULL` if they should draw immediately
+ */
+RenderQueue* State::getRenderQueue() const {
+    return renderQueue;
+}
+
+/**
+ * Returns the ring buffer nodes should write data changing every frame into.
+ *
+ * @return Ring buffer with a frame begun, or `NULL` if there isn't one
+ */
+RingBuffer* State::getRingBuffer() const {
+    return ringBuffer;
+}
+
+/**
+ * Returns the matrix at the top of the model matrix stack.
+ *
+ * @return Reference to the matrix at the top of the model matrix stack, valid until the stack changes
+ */
+const SimdMat4& State::getSimdModelMatrix() const {
+    return modelMatrices.back();
+}
+
+/**
+ * Returns the result of concatenating the model and view matrices.
+ *
+ * @return Reference to concatenation of the model and view matrices, valid until a matrix changes
+ */
+const SimdMat4& State::getSimdModelViewMatrix() const {
+    const size_t model = modelMatrixVersions.back();
+    const size_t view = viewMatrixVersions.back();
+    if ((modelViewProduct.model != model) || (modelViewProduct.view != view)) {
+        modelViewProduct.matrix = viewMatrices.back() * modelMatrices.back();
+        modelViewProduct.model = model;
+        modelViewProduct.view = view;
+    }
+    return modelViewProduct.matrix;
+}
+
+/**
+ * Returns the result of concatenating the model, view, and projection matrices.
+ *
+ * @return Reference to concatenation of the model, view, and projection matrices, valid until a matrix changes
+ */
+const SimdMat4& State::getSimdModelViewProjectionMatrix() const {
+    const size_t model = modelMatrixVersions.back();
+    const size_t view = viewMatrixVersions.back();
+    const size_t projection = projectionMatrixVersions.back();
+    if ((modelViewProjectionProduct.model != model)
+            || (modelViewProjectionProduct.view != view)
+            || (modelViewProjectionProduct.projection != projection)) {
+        modelViewProjectionProduct.matrix = getSimdViewProjectionMatrix() * modelMatrices.back();
+        modelViewProjectionProduct.model = model;
+        modelViewProjectionProduct.view = view;
+        modelViewProjectionProduct.projection = projection;
+    }
+    return modelViewProjectionProduct.matrix;
+}
+
+/**
+ * Returns the matrix at the top of the projection matrix stack.
+ *
+ * @return Reference to the matrix at the top of the projection matrix stack, valid until the stack changes
+ */
+const SimdMat4& State::getSimdProjectionMatrix() const {
+    return projectionMatrices.back();
+}
+
+/**
+ * Returns the matrix at the top of the view matrix stack.
+ *
+ * @return Reference to the matrix at the top of the view matrix stack, valid until the stack changes
+ */
+const SimdMat4& State::getSimdViewMatrix() const {
+    return viewMatrices.back();
+}
+
+/**
+ * Returns the result of concatenating the view and projection matrices.
+ *
+ * @return Reference to concatenation of the view and projection matrices, valid until a matrix changes
+ */
+const SimdMat4& State::getSimdViewProjectionMatrix() const {
+    const size_t view = viewMatrixVersions.back();
+    const size_t projection = projectionMatrixVersions.back();
+    if ((viewProjectionProduct.view != view) || (viewProjectionProduct.projection != projection)) {
+        viewProjectionProduct.matrix = projectionMatrices.back() * viewMatrices.back();
+        viewProjectionProduct.view = view;
+        viewProjectionProduct.projection = projection;
+    }
+    return viewProjectionProduct.matrix;
+}
+
+/**
+ * Returns the uniform buffers that uniform nodes should write values into when their program declares its block.
+ *
+ * @return Reference to the uniform buffers added to the state
+ */
+const std::vector<UniformBuffer*>& State::getUniformBuffers() const {
+    return uniformBuffers;
 }
 
 /**
@@ -93,7 +293,7 @@ size_t State::getProjectionMatrixStackSize() const {
  * @return Copy of the matrix at the top of the view matrix stack
  */
 M3d::Mat4 State::getViewMatrix() const {
-    return viewMatrixStack.top();
+    return viewMatrices.back().toMat4();
 }
 
 /**
@@ -102,7 +302,16 @@ M3d::Mat4 State::getViewMatrix() const {
  * @return Number of matrices on the view matrix stack
  */
 size_t State::getViewMatrixStackSize() const {
-    return viewMatrixStack.size();
+    return viewMatrices.size();
+}
+
+/**
+ * Returns the version of the matrix at the top of the view matrix stack.
+ *
+ * @return Version of the matrix at the top of the view matrix stack
+ */
+size_t State::getViewMatrixVersion() const {
+    return viewMatrixVersions.back();
 }
 
 /**
@@ -111,7 +320,17 @@ size_t State::getViewMatrixStackSize() const {
  * @return Concatenation of the view and projection matrices
  */
 M3d::Mat4 State::getViewProjectionMatrix() const {
-    return projectionMatrixStack.top() * viewMatrixStack.top();
+    return getSimdViewProjectionMatrix().toMat4();
+}
+
+/**
+ * Post-multiplies the top of the model matrix stack by an affine matrix, like a translation, rotation or scale.
+ *
+ * @param mat Affine matrix to multiply by
+ */
+void State::multiplyModelMatrix(const SimdMat4& mat) {
+    modelMatrices.back() = modelMatrices.back().multiplyAffine(mat);
+    modelMatrixVersions.back() = ++version;
 }
 
 /**
@@ -120,7 +339,11 @@ M3d::Mat4 State::getViewProjectionMatrix() const {
  * @throws std::runtime_error if model matrix stack only has one element
  */
 void State::popModelMatrix() {
-    modelMatrixStack.pop();
+    if (modelMatrices.size() == 1) {
+        throw std::runtime_error("[State] Model matrix stack only has one element!");
+    }
+    modelMatrices.pop_back();
+    modelMatrixVersions.pop_back();
 }
 
 /**
@@ -129,7 +352,11 @@ void State::popModelMatrix() {
  * @throws std::runtime_error if projection matrix stack only has one element
  */
 void State::popProjectionMatrix() {
-    projectionMatrixStack.pop();
+    if (projectionMatrices.size() == 1) {
+        throw std::runtime_error("[State] Projection matrix stack only has one element!");
+    }
+    projectionMatrices.pop_back();
+    projectionMatrixVersions.pop_back();
 }
 
 /**
@@ -138,28 +365,82 @@ void State::popProjectionMatrix() {
  * @throws std::runtime_error if view matrix stack only has one element
  */
 void State::popViewMatrix() {
-    viewMatrixStack.pop();
+    if (viewMatrices.size() == 1) {
+        throw std::runtime_error("[State] View matrix stack only has one element!");
+    }
+    viewMatrices.pop_back();
+    viewMatrixVersions.pop_back();
 }
 
 /**
  * Copies the top of the model matrix stack and adds it.
  */
 void State::pushModelMatrix() {
-    modelMatrixStack.push();
+    const SimdMat4 top = modelMatrices.back();
+    modelMatrices.push_back(top);
+    modelMatrixVersions.push_back(modelMatrixVersions.back());
 }
 
 /**
  * Copies the top of the projection matrix stack and adds it.
  */
 void State::pushProjectionMatrix() {
-    projectionMatrixStack.push();
+    const SimdMat4 top = projectionMatrices.back();
+    projectionMatrices.push_back(top);
+    projectionMatrixVersions.push_back(projectionMatrixVersions.back());
 }
 
 /**
  * Copies the top of the view matrix stack and adds it.
  */
 void State::pushViewMatrix() {
-    viewMatrixStack.push();
+    const SimdMat4 top = viewMatrices.back();
+    viewMatrices.push_back(top);
+    viewMatrixVersions.push_back(viewMatrixVersions.back());
+}
+
+/**
+ * Removes a uniform buffer added before.
+ *
+ * @param uniformBuffer Uniform buffer to remove, which is ignored if it was not added
+ */
+void State::removeUniformBuffer(UniformBuffer* const uniformBuffer) {
+    const std::vector<UniformBuffer*>::iterator it = std::find(uniformBuffers.begin(), uniformBuffers.end(), uniformBuffer);
+    if (it != uniformBuffers.end()) {
+        uniformBuffers.erase(it);
+    }
+}
+
+/**
+ * Puts back a matrix the top of the model matrix stack had before, along with its version.
+ *
+ * Since the version is restored rather than changed, nodes that compare
+ * versions treat the matrix as if it had never changed.
+ *
+ * @param mat Matrix the top of the model matrix stack had before
+ * @param version Version `getModelMatrixVersion` returned for that matrix
+ */
+void State::restoreModelMatrix(const SimdMat4& mat, const size_t version) {
+    modelMatrices.back() = mat;
+    modelMatrixVersions.back() = version;
+}
+
+/**
+ * Changes the cache nodes should change OpenGL state through, so states drawing on one context can share it.
+ *
+ * @param glStateCache Cache shared by every state drawing on the context, or `NULL` for this state's own cache
+ */
+void State::setGLStateCache(GLStateCache* const glStateCache) {
+    this->glStateCache = (glStateCache == NULL) ? &defaultGLStateCache : glStateCache;
+}
+
+/**
+ * Changes the batcher instance nodes should add themselves to instead of visiting their group.
+ *
+ * @param instanceBatcher Batcher to add instances to, or `NULL` to visit groups for each instance
+ */
+void State::setInstanceBatcher(InstanceBatcher* const instanceBatcher) {
+    this->instanceBatcher = instanceBatcher;
 }
 
 /**
@@ -168,7 +449,17 @@ void State::pushViewMatrix() {
  * @param mat Matrix to copy
  */
 void State::setModelMatrix(const M3d::Mat4& mat) {
-    modelMatrixStack.top() = mat;
+    setModelMatrix(SimdMat4::fromMat4(mat));
+}
+
+/**
+ * Modifies the top of the model matrix stack.
+ *
+ * @param mat Matrix to copy
+ */
+void State::setModelMatrix(const SimdMat4& mat) {
+    modelMatrices.back() = mat;
+    modelMatrixVersions.back() = ++version;
 }
 
 /**
@@ -177,7 +468,35 @@ void State::setModelMatrix(const M3d::Mat4& mat) {
  * @param mat Matrix to copy
  */
 void State::setProjectionMatrix(const M3d::Mat4& mat) {
-    projectionMatrixStack.top() = mat;
+    setProjectionMatrix(SimdMat4::fromMat4(mat));
+}
+
+/**
+ * Modifies the top of the projection matrix stack.
+ *
+ * @param mat Matrix to copy
+ */
+void State::setProjectionMatrix(const SimdMat4& mat) {
+    projectionMatrices.back() = mat;
+    projectionMatrixVersions.back() = ++version;
+}
+
+/**
+ * Changes the queue nodes should record draws into instead of drawing.
+ *
+ * @param renderQueue Queue to record draws into, or `NULL` to draw immediately
+ */
+void State::setRenderQueue(RenderQueue* const renderQueue) {
+    this->renderQueue = renderQueue;
+}
+
+/**
+ * Changes the ring buffer nodes should write data changing every frame into.
+ *
+ * @param ringBuffer Ring buffer with a frame begun, or `NULL` for none
+ */
+void State::setRingBuffer(RingBuffer* const ringBuffer) {
+    this->ringBuffer = ringBuffer;
 }
 
 /**
@@ -186,7 +505,17 @@ void State::setProjectionMatrix(const M3d::Mat4& mat) {
  * @param mat Matrix to copy
  */
 void State::setViewMatrix(const M3d::Mat4& mat) {
-    viewMatrixStack.top() = mat;
+    setViewMatrix(SimdMat4::fromMat4(mat));
+}
+
+/**
+ * Modifies the top of the view matrix stack.
+ *
+ * @param mat Matrix to copy
+ */
+void State::setViewMatrix(const SimdMat4& mat) {
+    viewMatrices.back() = mat;
+    viewMatrixVersions.back() = ++version;
 }
 
 } /* namespace RapidGL */
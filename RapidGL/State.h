@@ -17,43 +17,123 @@
  */
 #ifndef RAPIDGL_STATE_H
 #define RAPIDGL_STATE_H
-#include <glycerin/MatrixStack.hxx>
+#include <vector>
+#include <Poco/AtomicCounter.h>
 #include <m3d/Mat4.h>
 #include "RapidGL/common.h"
+#include "RapidGL/GLStateCache.h"
+#include "RapidGL/SimdMat4.h"
 namespace RapidGL {
 
+class InstanceBatcher;
+class RenderQueue;
+class RingBuffer;
+class UniformBuffer;
+
 
 /**
  * Shared state for nodes.
+ *
+ * The top of each matrix stack has a version, which changes whenever the
+ * matrix is set and goes back to what it was when the matrix is popped.  Nodes
+ * can compare versions to tell if a matrix changed without comparing matrices.
+ * The products of the matrices are kept with the versions they were computed
+ * from, and only computed again when one of those versions changes.  Each
+ * state also has an ID that is never reused, so nodes can tell states apart
+ * even if one is made where another was deleted.
+ *
+ * Each state has its own `GLStateCache` unless it is given one with
+ * `setGLStateCache`.  Since OpenGL state, including which node last loaded
+ * each uniform, belongs to the context, states drawing on the same context
+ * should share one cache.
+ *
+ * Matrices are stored as `SimdMat4`s.  The `getSimd` accessors return them
+ * without copying, while the others convert them to double precision.
  */
 class State {
 public:
 // Methods
     State();
     virtual ~State();
+    void addUniformBuffer(UniformBuffer* uniformBuffer);
+    void bindUniformBuffers();
+    GLStateCache& getGLStateCache();
+    size_t getId() const;
+    InstanceBatcher* getInstanceBatcher() const;
     M3d::Mat4 getModelMatrix() const;
     size_t getModelMatrixStackSize() const;
+    size_t getModelMatrixVersion() const;
     M3d::Mat4 getModelViewMatrix() const;
     M3d::Mat4 getModelViewProjectionMatrix() const;
     M3d::Mat4 getProjectionMatrix() const;
     size_t getProjectionMatrixStackSize() const;
+    size_t getProjectionMatrixVersion() const;
+    RenderQueue* getRenderQueue() const;
+    RingBuffer* getRingBuffer() const;
+    const SimdMat4& getSimdModelMatrix() const;
+    const SimdMat4& getSimdModelViewMatrix() const;
+    const SimdMat4& getSimdModelViewProjectionMatrix() const;
+    const SimdMat4& getSimdProjectionMatrix() const;
+    const SimdMat4& getSimdViewMatrix() const;
+    const SimdMat4& getSimdViewProjectionMatrix() const;
+    const std::vector<UniformBuffer*>& getUniformBuffers() const;
     M3d::Mat4 getViewMatrix() const;
     size_t getViewMatrixStackSize() const;
+    size_t getViewMatrixVersion() const;
     M3d::Mat4 getViewProjectionMatrix() const;
+    void multiplyModelMatrix(const SimdMat4& mat);
     void popModelMatrix();
     void popProjectionMatrix();
     void popViewMatrix();
     void pushModelMatrix();
     void pushProjectionMatrix();
     void pushViewMatrix();
+    void removeUniformBuffer(UniformBuffer* uniformBuffer);
+    void restoreModelMatrix(const SimdMat4& mat, size_t version);
+    void setGLStateCache(GLStateCache* glStateCache);
+    void setInstanceBatcher(InstanceBatcher* instanceBatcher);
     void setModelMatrix(const M3d::Mat4& mat);
+    void setModelMatrix(const SimdMat4& mat);
     void setProjectionMatrix(const M3d::Mat4& mat);
+    void setProjectionMatrix(const SimdMat4& mat);
+    void setRenderQueue(RenderQueue* renderQueue);
+    void setRingBuffer(RingBuffer* ringBuffer);
     void setViewMatrix(const M3d::Mat4& mat);
+    void setViewMatrix(const SimdMat4& mat);
 private:
+// Types
+    /**
+     * Product of matrices, with the versions of the matrices it was computed from.
+     */
+    struct Product {
+        SimdMat4 matrix;
+        size_t model;
+        size_t view;
+        size_t projection;
+    };
+// Constants
+    static Poco::AtomicCounter stateCount;
 // Attributes
-    Glycerin::MatrixStack modelMatrixStack;
-    Glycerin::MatrixStack projectionMatrixStack;
-    Glycerin::MatrixStack viewMatrixStack;
+    GLStateCache defaultGLStateCache;
+    GLStateCache* glStateCache;
+    size_t id;
+    InstanceBatcher* instanceBatcher;
+    std::vector<SimdMat4> modelMatrices;
+    std::vector<size_t> modelMatrixVersions;
+    mutable Product modelViewProduct;
+    mutable Product modelViewProjectionProduct;
+    std::vector<SimdMat4> projectionMatrices;
+    std::vector<size_t> projectionMatrixVersions;
+    RenderQueue* renderQueue;
+    RingBuffer* ringBuffer;
+    std::vector<UniformBuffer*> uniformBuffers;
+    size_t version;
+    std::vector<SimdMat4> viewMatrices;
+    std::vector<size_t> viewMatrixVersions;
+    mutable Product viewProjectionProduct;
+// Methods
+    State(const State&);
+    State& operator=(const State&);
 };
 
 } /* namespace RapidGL */
@@ -114,6 +114,36 @@ public:
         assertMatricesEqual(expected, actual);
     }
 
+    /**
+     * Ensures `State::getModelViewMatrix` is computed again after the model matrix is set or popped.
+     */
+    void testGetModelViewMatrixAfterChange() {
+
+        // Make matrices
+        M3d::Mat4 modelMatrix(2);
+        M3d::Mat4 viewMatrix;
+        viewMatrix[0] = M3d::Vec4(10, 20, 30, 40);
+        viewMatrix[1] = M3d::Vec4(50, 60, 70, 80);
+        viewMatrix[2] = M3d::Vec4(90, 100, 110, 120);
+        viewMatrix[3] = M3d::Vec4(130, 140, 150, 160);
+
+        // Get once
+        RapidGL::State state;
+        state.setViewMatrix(viewMatrix);
+        assertMatricesEqual(viewMatrix, state.getModelViewMatrix());
+
+        // Set model matrix
+        state.pushModelMatrix();
+        state.setModelMatrix(modelMatrix);
+        assertMatricesEqual(viewMatrix * modelMatrix, state.getModelViewMatrix());
+        assertMatricesEqual(state.getViewProjectionMatrix() * modelMatrix, state.getModelViewProjectionMatrix());
+
+        // Pop it
+        state.popModelMatrix();
+        assertMatricesEqual(viewMatrix, state.getModelViewMatrix());
+        assertMatricesEqual(state.getViewProjectionMatrix(), state.getModelViewProjectionMatrix());
+    }
+
     /**
      * Ensures `State::getModelViewProjectionMatrix` works correctly.
      */
@@ -152,6 +182,59 @@ public:
         assertMatricesEqual(expected, actual);
     }
 
+    /**
+     * Ensures `State::getModelMatrixVersion` changes when the matrix is set and comes back when it is popped.
+     */
+    void testGetModelMatrixVersion() {
+
+        // Set
+        RapidGL::State state;
+        const size_t original = state.getModelMatrixVersion();
+        state.setModelMatrix(M3d::Mat4(2));
+        const size_t changed = state.getModelMatrixVersion();
+        CPPUNIT_ASSERT(changed != original);
+
+        // Push and set
+        state.pushModelMatrix();
+        CPPUNIT_ASSERT_EQUAL(changed, state.getModelMatrixVersion());
+        state.setModelMatrix(M3d::Mat4(3));
+        CPPUNIT_ASSERT(state.getModelMatrixVersion() != changed);
+        CPPUNIT_ASSERT(state.getModelMatrixVersion() != original);
+
+        // Pop
+        state.popModelMatrix();
+        CPPUNIT_ASSERT_EQUAL(changed, state.getModelMatrixVersion());
+    }
+
+    /**
+     * Ensures `State::getViewMatrixVersion` and `State::getProjectionMatrixVersion` only change with their own matrix.
+     */
+    void testGetViewMatrixVersion() {
+        RapidGL::State state;
+        const size_t view = state.getViewMatrixVersion();
+        const size_t projection = state.getProjectionMatrixVersion();
+        state.setModelMatrix(M3d::Mat4(2));
+        state.setProjectionMatrix(M3d::Mat4(2));
+        CPPUNIT_ASSERT_EQUAL(view, state.getViewMatrixVersion());
+        CPPUNIT_ASSERT(state.getProjectionMatrixVersion() != projection);
+        state.setViewMatrix(M3d::Mat4(2));
+        CPPUNIT_ASSERT(state.getViewMatrixVersion() != view);
+    }
+
+    /**
+     * Ensures `State::setGLStateCache` shares a cache, and `NULL` goes back to the state's own cache.
+     */
+    void testSetGLStateCache() {
+        RapidGL::State first;
+        RapidGL::State second;
+        CPPUNIT_ASSERT(&first.getGLStateCache() != &second.getGLStateCache());
+        RapidGL::GLStateCache& own = second.getGLStateCache();
+        second.setGLStateCache(&first.getGLStateCache());
+        CPPUNIT_ASSERT_EQUAL(&first.getGLStateCache(), &second.getGLStateCache());
+        second.setGLStateCache(NULL);
+        CPPUNIT_ASSERT_EQUAL(&own, &second.getGLStateCache());
+    }
+
     /**
      * Ensures `State::popModelMatrix` throws an exception if trying to pop off bottom.
      */
@@ -211,10 +294,14 @@ public:
     CPPUNIT_TEST(testDefaultProjectionMatrix);
     CPPUNIT_TEST(testDefaultViewMatrix);
     CPPUNIT_TEST(testGetModelViewMatrix);
+    CPPUNIT_TEST(testGetModelViewMatrixAfterChange);
     CPPUNIT_TEST(testGetModelViewProjectionMatrix);
+    CPPUNIT_TEST(testGetModelMatrixVersion);
+    CPPUNIT_TEST(testGetViewMatrixVersion);
     CPPUNIT_TEST(testPopModelMatrixWithBottom);
     CPPUNIT_TEST(testPopProjectionMatrixWithBottom);
     CPPUNIT_TEST(testPopViewMatrixWithBottom);
+    CPPUNIT_TEST(testSetGLStateCache);
     CPPUNIT_TEST(testViewProjectionMatrix);
     CPPUNIT_TEST_SUITE_END();
 };
@@ -34,6 +34,7 @@ TextureAttachmentNode::TextureAttachmentNode(const Usage usage, const std::strin
     if (link.empty()) {
         throw std::invalid_argument("[TextureAttachmentNode] Link is empty!");
     }
+    setHooks(PRE_VISIT);
 }
 
 /**
@@ -92,7 +93,7 @@ std::string TextureAttachmentNode::getLink() const {
 /**
  * Ensures this node's parent is a @ref FramebufferNode.
  */
-void TextureAttachmentNode::preVisit(State& state) {
+void TextureAttachmentNode::prepare(State& state) {
 
     // Skip if already ready
     if (ready) {
@@ -107,6 +108,14 @@ void TextureAttachmentNode::preVisit(State& state) {
 
     // Now ready
     ready = true;
+    setHooks(getHooks() & ~PRE_VISIT);
+}
+
+/**
+ * Prepares this node if it was not prepared before being visited.
+ */
+void TextureAttachmentNode::preVisit(State& state) {
+    prepare(state);
 }
 
 void TextureAttachmentNode::visit(State& state) {
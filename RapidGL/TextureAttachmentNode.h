@@ -37,6 +37,7 @@ public:
     ~TextureAttachmentNode();
     std::string getLink() const;
     virtual void attach(GLenum attachment);
+    virtual void prepare(State& state);
     virtual void preVisit(State& state);
     virtual void visit(State& state);
 private:
@@ -38,6 +38,7 @@ TextureNode::TextureNode(const std::string& id,
     if (id.empty()) {
         throw std::invalid_argument("[TextureNode] Unique identifier is empty!");
     }
+    setHooks(PRE_VISIT | VISIT);
 }
 
 /**
@@ -74,7 +75,7 @@ Gloop::TextureUnit TextureNode::getTextureUnit() const {
     return unit;
 }
 
-void TextureNode::preVisit(State& state) {
+void TextureNode::prepare(State& state) {
 
     // Skip if already prepared
     if (prepared) {
@@ -90,11 +91,23 @@ void TextureNode::preVisit(State& state) {
 
     // Successfully prepared
     prepared = true;
+    setHooks(getHooks() & ~PRE_VISIT);
+}
+
+/**
+ * Prepares this node if it was not prepared before being visited.
+ */
+void TextureNode::preVisit(State& state) {
+    prepare(state);
 }
 
 void TextureNode::visit(State& state) {
-    unit.activate();
-    target.bind(texture);
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    if (renderQueue == NULL) {
+        state.getGLStateCache().bindTexture(unit, target, texture);
+    } else {
+        renderQueue->bindTexture(unit, target, texture);
+    }
 }
 
 } /* namespace RapidGL */
@@ -23,6 +23,8 @@
 #include <string>
 #include "RapidGL/common.h"
 #include "RapidGL/Node.h"
+#include "RapidGL/RenderQueue.h"
+#include "RapidGL/State.h"
 namespace RapidGL {
 
 
@@ -37,6 +39,7 @@ public:
     Gloop::TextureObject getTextureObject() const;
     Gloop::TextureTarget getTextureTarget() const;
     Gloop::TextureUnit getTextureUnit() const;
+    virtual void prepare(State& state);
     virtual void preVisit(State& state);
     virtual void visit(State& state);
 private:
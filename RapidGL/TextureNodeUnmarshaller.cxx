@@ -18,7 +18,6 @@
 #include "config.h"
 #include <gloop/TextureObject.hxx>
 #include <gloop/TextureTarget.hxx>
-#include <gloop/TextureUnit.hxx>
 #include <glycerin/Bitmap.hxx>
 #include <glycerin/BitmapReader.hxx>
 #include <glycerin/Volume.hxx>
@@ -42,11 +41,29 @@ TextureNodeUnmarshaller::~TextureNodeUnmarshaller() {
     /// empty
 }
 
+/**
+ * Saves the active texture unit and the textures bound on the first unit, then activates the first unit.
+ */
+TextureNodeUnmarshaller::SavedBindings::SavedBindings() : unit(GL_TEXTURE0), texture2d(0), texture3d(0) {
+    glGetIntegerv(GL_ACTIVE_TEXTURE, &unit);
+    glActiveTexture(GL_TEXTURE0);
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture2d);
+    glGetIntegerv(GL_TEXTURE_BINDING_3D, &texture3d);
+}
+
+/**
+ * Binds the saved textures on the first unit again, then activates the saved unit.
+ */
+TextureNodeUnmarshaller::SavedBindings::~SavedBindings() {
+    glBindTexture(GL_TEXTURE_2D, texture2d);
+    glBindTexture(GL_TEXTURE_3D, texture3d);
+    glActiveTexture(unit);
+}
+
 Node* TextureNodeUnmarshaller::createNodeFromBitmap(const std::string& id, const Glycerin::Bitmap& bitmap) {
 
-    // Activate texture unit
-    const Gloop::TextureUnit unit = Gloop::TextureUnit::fromEnum(GL_TEXTURE0);
-    unit.activate();
+    // Activate first texture unit, putting back what was bound when done
+    const SavedBindings savedBindings;
 
     // Create texture
     const Gloop::TextureObject texture = bitmap.createTexture();
@@ -72,9 +89,8 @@ Node* TextureNodeUnmarshaller::createNodeFromSize(const std::string& id, const G
     // Generate a new texture
     const Gloop::TextureObject texture = Gloop::TextureObject::generate();
 
-    // Activate texture unit
-    const Gloop::TextureUnit unit = Gloop::TextureUnit::fromEnum(GL_TEXTURE0);
-    unit.activate();
+    // Activate first texture unit, putting back what was bound when done
+    const SavedBindings savedBindings;
 
     // Bind texture
     const Gloop::TextureTarget target = Gloop::TextureTarget::texture2d();
@@ -100,9 +116,8 @@ Node* TextureNodeUnmarshaller::createNodeFromSize(const std::string& id, const G
 
 Node* TextureNodeUnmarshaller::createNodeFromVolume(const std::string& id, const Glycerin::Volume& volume) {
 
-    // Activate texture unit
-    const Gloop::TextureUnit unit = Gloop::TextureUnit::fromEnum(GL_TEXTURE0);
-    unit.activate();
+    // Activate first texture unit, putting back what was bound when done
+    const SavedBindings savedBindings;
 
     // Create texture
     const Gloop::TextureObject texture = volume.createTexture();
@@ -111,11 +126,11 @@ Node* TextureNodeUnmarshaller::createNodeFromVolume(const std::string& id, const
     return new TextureNode(id, Gloop::TextureTarget::texture3d(), texture);
 }
 
-std::string TextureNodeUnmarshaller::getFile(const std::map<std::string,std::string>& attributes) {
+std::string TextureNodeUnmarshaller::getFile(const AttributeView& attributes) {
     return findValue(attributes, "file");
 }
 
-std::string TextureNodeUnmarshaller::getId(const std::map<std::string,std::string>& attributes) {
+std::string TextureNodeUnmarshaller::getId(const AttributeView& attributes) {
     const std::string id = findValue(attributes, "id");
     if (id.empty()) {
         throw std::runtime_error("[TextureNodeUnmarshaller] Must specify 'id'!");
@@ -123,7 +138,7 @@ std::string TextureNodeUnmarshaller::getId(const std::map<std::string,std::strin
     return id;
 }
 
-GLint TextureNodeUnmarshaller::getSize(const std::map<std::string,std::string>& attributes) {
+GLint TextureNodeUnmarshaller::getSize(const AttributeView& attributes) {
 
     // Find value
     const std::string size = findValue(attributes, "size");
@@ -150,7 +165,7 @@ GLint TextureNodeUnmarshaller::getSize(const std::map<std::string,std::string>&
     return value;
 }
 
-Node* TextureNodeUnmarshaller::unmarshal(const std::map<std::string,std::string>& attributes) {
+Node* TextureNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
 
     // Get values
     const std::string id = getId(attributes);
@@ -30,22 +30,42 @@ namespace RapidGL {
 
 /**
  * Functor reading in a `TextureNode` from XML.
+ *
+ * Textures are loaded on the first texture unit with OpenGL directly, so the
+ * active unit and the unit's 2D and 3D textures are put back afterwards.  A
+ * `GLStateCache` in use therefore stays accurate, and scenes can be read while
+ * rendering is already under way.
  */
 class TextureNodeUnmarshaller : public Unmarshaller {
 public:
 // Methods
     TextureNodeUnmarshaller();
     virtual ~TextureNodeUnmarshaller();
-    virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+    virtual Node* unmarshal(const AttributeView& attributes);
 private:
+// Types
+    /**
+     * Texture bindings saved while a texture is loaded, which are put back when destructed.
+     */
+    class SavedBindings {
+    public:
+        SavedBindings();
+        ~SavedBindings();
+    private:
+        GLint unit;
+        GLint texture2d;
+        GLint texture3d;
+        SavedBindings(const SavedBindings&);
+        SavedBindings& operator=(const SavedBindings&);
+    };
 // Methods
     Node* createNodeFromBitmap(const std::string& name, const Glycerin::Bitmap& bitmap);
     Node* createNodeFromFile(const std::string& name, const std::string& file);
     Node* createNodeFromSize(const std::string& name, GLint size);
     Node* createNodeFromVolume(const std::string& name, const Glycerin::Volume& volume);
-    std::string getFile(const std::map<std::string,std::string>& attributes);
-    std::string getId(const std::map<std::string,std::string>& attributes);
-    GLint getSize(const std::map<std::string,std::string>& attributes);
+    std::string getFile(const AttributeView& attributes);
+    std::string getId(const AttributeView& attributes);
+    GLint getSize(const AttributeView& attributes);
 };
 
 } /* namespace RapidGL */
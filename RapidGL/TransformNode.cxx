@@ -22,7 +22,7 @@ namespace RapidGL {
 /**
  * Constructs a `TransformNode`.
  */
-TransformNode::TransformNode() {
+TransformNode::TransformNode() : matrixValid(false), nextWorld(0), computeCount(0) {
     // empty
 }
 
@@ -33,6 +33,44 @@ TransformNode::~TransformNode() {
     // empty
 }
 
+/**
+ * Returns an infinite box, since the transformation is not known.
+ *
+ * @return Infinite box
+ */
+BoundingBox TransformNode::computeBounds() {
+    return BoundingBox::infinite();
+}
+
+/**
+ * Returns the matrix the model matrix is post-multiplied with.
+ *
+ * @return Identity matrix, since the transformation is not known
+ */
+SimdMat4 TransformNode::computeMatrix() const {
+    return SimdMat4();
+}
+
+/**
+ * Returns the number of times the model matrix was multiplied instead of restored.
+ *
+ * @return Number of times the model matrix was multiplied
+ */
+size_t TransformNode::getComputeCount() const {
+    return computeCount;
+}
+
+/**
+ * Makes the node compute its matrix again the next time it is visited.
+ *
+ * Subclasses should call this when anything their matrix depends on changes.
+ */
+void TransformNode::invalidateMatrix() {
+    matrixValid = false;
+    worlds.clear();
+    nextWorld = 0;
+}
+
 /**
  * Pops the model matrix after this node and all its children have been visited.
  *
@@ -51,4 +89,46 @@ void TransformNode::preVisit(State& state) {
     state.pushModelMatrix();
 }
 
+/**
+ * Post-multiplies the model matrix with this node's matrix, or restores the result from before.
+ *
+ * @param state State with model matrix to change
+ */
+void TransformNode::visit(State& state) {
+
+    // Find what was made in the state before
+    const size_t id = state.getId();
+    const size_t parentVersion = state.getModelMatrixVersion();
+    std::vector<World>::iterator it = worlds.begin();
+    while ((it != worlds.end()) && (it->state != id)) {
+        ++it;
+    }
+
+    // Restore it if the model matrix is the same as it was then
+    if ((it != worlds.end()) && (it->parentVersion == parentVersion)) {
+        state.restoreModelMatrix(it->matrix, it->version);
+        return;
+    }
+
+    // Otherwise multiply and remember the result, replacing the oldest state if there are too many
+    if (!matrixValid) {
+        matrix = computeMatrix();
+        matrixValid = true;
+    }
+    state.multiplyModelMatrix(matrix);
+    ++computeCount;
+    if (it == worlds.end()) {
+        if (worlds.size() < MAX_WORLD_COUNT) {
+            it = worlds.insert(worlds.end(), World());
+        } else {
+            it = worlds.begin() + nextWorld;
+            nextWorld = (nextWorld + 1) % MAX_WORLD_COUNT;
+        }
+        it->state = id;
+    }
+    it->parentVersion = parentVersion;
+    it->matrix = state.getSimdModelMatrix();
+    it->version = state.getModelMatrixVersion();
+}
+
 } /* namespace RapidGL */
@@ -17,22 +17,66 @@
  */
 #ifndef RAPIDGL_TRANSFORM_NODE_H
 #define RAPIDGL_TRANSFORM_NODE_H
+#include <vector>
 #include "RapidGL/common.h"
+#include "RapidGL/BoundingBox.h"
 #include "RapidGL/Node.h"
+#include "RapidGL/SimdMat4.h"
 #include "RapidGL/State.h"
 namespace RapidGL {
 
 
 /**
  * Node that applies a transformation to the model matrix.
+ *
+ * Subclasses should override `computeMatrix` to make the matrix the model
+ * matrix is post-multiplied with, and call `invalidateMatrix` when it changes.
+ * They should also override `computeBounds` to transform the bounds of their
+ * children, otherwise the transformation is unknown and the bounds are infinite.
+ *
+ * The matrix is only computed again after it is invalidated.  For each state,
+ * the node also keeps the model matrix it made, along with the version of the
+ * model matrix it started from.  If the node is visited again with the same
+ * version, the kept matrix is restored with its version instead of being
+ * multiplied again.  Since a changed node makes a new version, only the nodes
+ * below it compute their model matrices again, while static parts of a scene
+ * cost a comparison and a copy per transform.  Only a few states are kept,
+ * with the oldest replaced by the next state once there are too many, so the
+ * search stays short and the memory used stays fixed.
  */
 class TransformNode : public Node {
 public:
 // Methods
     TransformNode();
     virtual ~TransformNode();
+    size_t getComputeCount() const;
     virtual void postVisit(State& state);
     virtual void preVisit(State& state);
+    virtual void visit(State& state);
+protected:
+// Constants
+    static const size_t MAX_WORLD_COUNT = 8;
+// Methods
+    virtual BoundingBox computeBounds();
+    virtual SimdMat4 computeMatrix() const;
+    void invalidateMatrix();
+private:
+// Types
+    /**
+     * Model matrix made in a state, with the version of the model matrix it was made from.
+     */
+    struct World {
+        size_t state;
+        size_t parentVersion;
+        SimdMat4 matrix;
+        size_t version;
+    };
+// Attributes
+    SimdMat4 matrix;
+    bool matrixValid;
+    std::vector<World> worlds;
+    size_t nextWorld;
+    size_t computeCount;
 };
 
 } /* namespace RapidGL */
@@ -19,6 +19,8 @@
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include <cppunit/ui/text/TestRunner.h>
+#include <m3d/Vec3.h>
+#include "RapidGL/SimdMat4.h"
 #include "RapidGL/State.h"
 #include "RapidGL/TransformNode.h"
 
@@ -42,6 +44,45 @@ public:
         }
     };
 
+    /**
+     * Fake implementation of `TransformNode` that translates by a changeable amount.
+     */
+    class FakeTranslateNode : public RapidGL::TransformNode {
+    public:
+        FakeTranslateNode(const double x) : x(x) {
+            // empty
+        }
+        void setX(const double x) {
+            this->x = x;
+            invalidateMatrix();
+        }
+    protected:
+        virtual RapidGL::SimdMat4 computeMatrix() const {
+            return RapidGL::SimdMat4::translation(M3d::Vec3(x, 0, 0));
+        }
+    private:
+        double x;
+    };
+
+    /**
+     * Visits a parent and child transform node like a traversal would, then pops back out.
+     *
+     * @param parent Parent node to visit
+     * @param child Child node to visit
+     * @param state State to visit nodes with
+     * @return X coordinate of the translation in the model matrix at the child
+     */
+    static double visitParentAndChild(FakeTranslateNode& parent, FakeTranslateNode& child, RapidGL::State& state) {
+        parent.preVisit(state);
+        parent.visit(state);
+        child.preVisit(state);
+        child.visit(state);
+        const double x = state.getSimdModelMatrix()[3][0];
+        child.postVisit(state);
+        parent.postVisit(state);
+        return x;
+    }
+
     /**
      * Ensures `TransformNode::postVisit` pops the model matrix.
      */
@@ -81,9 +122,120 @@ public:
         CPPUNIT_ASSERT_EQUAL((size_t) 2, state.getModelMatrixStackSize());
     }
 
+    /**
+     * Ensures visiting again with the same model matrix restores the result instead of multiplying.
+     */
+    void testVisitWithUnchangedModelMatrix() {
+
+        FakeTranslateNode parent(1);
+        FakeTranslateNode child(2);
+        RapidGL::State state;
+
+        // Visit twice
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, visitParentAndChild(parent, child, state), TOLERANCE);
+        parent.preVisit(state);
+        parent.visit(state);
+        const size_t version = state.getModelMatrixVersion();
+        parent.postVisit(state);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, visitParentAndChild(parent, child, state), TOLERANCE);
+
+        // Check matrices were only computed once and the version was kept
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, parent.getComputeCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, child.getComputeCount());
+        parent.preVisit(state);
+        parent.visit(state);
+        CPPUNIT_ASSERT_EQUAL(version, state.getModelMatrixVersion());
+        parent.postVisit(state);
+    }
+
+    /**
+     * Ensures changing a node only computes the matrices of that node and the nodes below it.
+     */
+    void testVisitAfterInvalidateMatrix() {
+
+        FakeTranslateNode parent(1);
+        FakeTranslateNode child(2);
+        RapidGL::State state;
+        visitParentAndChild(parent, child, state);
+
+        // Change the child
+        child.setX(5);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(6.0, visitParentAndChild(parent, child, state), TOLERANCE);
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, parent.getComputeCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, child.getComputeCount());
+
+        // Change the parent
+        parent.setX(3);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(8.0, visitParentAndChild(parent, child, state), TOLERANCE);
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, parent.getComputeCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 3, child.getComputeCount());
+    }
+
+    /**
+     * Ensures a changed model matrix above a node makes it multiply again.
+     */
+    void testVisitWithChangedModelMatrix() {
+
+        FakeTranslateNode parent(1);
+        FakeTranslateNode child(2);
+        RapidGL::State state;
+        visitParentAndChild(parent, child, state);
+
+        // Change the model matrix above both
+        state.setModelMatrix(RapidGL::SimdMat4::translation(M3d::Vec3(10, 0, 0)));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(13.0, visitParentAndChild(parent, child, state), TOLERANCE);
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, parent.getComputeCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, child.getComputeCount());
+    }
+
+    /**
+     * Ensures results are not shared between states.
+     */
+    void testVisitWithAnotherState() {
+
+        FakeTranslateNode parent(1);
+        FakeTranslateNode child(2);
+        RapidGL::State state;
+        state.setModelMatrix(RapidGL::SimdMat4::translation(M3d::Vec3(20, 0, 0)));
+        visitParentAndChild(parent, child, state);
+
+        // Visit with a state whose model matrix has the same version but a different value
+        RapidGL::State another;
+        another.setModelMatrix(RapidGL::SimdMat4::translation(M3d::Vec3(10, 0, 0)));
+        CPPUNIT_ASSERT_EQUAL(state.getModelMatrixVersion(), another.getModelMatrixVersion());
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(13.0, visitParentAndChild(parent, child, another), TOLERANCE);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(23.0, visitParentAndChild(parent, child, state), TOLERANCE);
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, parent.getComputeCount());
+    }
+
+    /**
+     * Ensures the oldest state is forgotten once a node has been visited with too many.
+     */
+    void testVisitWithManyStates() {
+
+        FakeTranslateNode parent(1);
+        FakeTranslateNode child(2);
+        RapidGL::State states[9];
+        for (int i = 0; i < 9; ++i) {
+            visitParentAndChild(parent, child, states[i]);
+        }
+        CPPUNIT_ASSERT_EQUAL((size_t) 9, parent.getComputeCount());
+
+        // Visit with the newest state, then the oldest
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, visitParentAndChild(parent, child, states[8]), TOLERANCE);
+        CPPUNIT_ASSERT_EQUAL((size_t) 9, parent.getComputeCount());
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, visitParentAndChild(parent, child, states[0]), TOLERANCE);
+        CPPUNIT_ASSERT_EQUAL((size_t) 10, parent.getComputeCount());
+    }
+
     CPPUNIT_TEST_SUITE(TransformNodeTest);
     CPPUNIT_TEST(testPostVisit);
     CPPUNIT_TEST(testPreVisit);
+    CPPUNIT_TEST(testVisitAfterInvalidateMatrix);
+    CPPUNIT_TEST(testVisitWithAnotherState);
+    CPPUNIT_TEST(testVisitWithChangedModelMatrix);
+    CPPUNIT_TEST(testVisitWithManyStates);
+    CPPUNIT_TEST(testVisitWithUnchangedModelMatrix);
     CPPUNIT_TEST_SUITE_END();
 };
 
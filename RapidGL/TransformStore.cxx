@@ -0,0 +1,447 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <stdexcept>
+#include <Poco/Environment.h>
+#include <Poco/Exception.h>
+#include "RapidGL/TransformStore.h"
+namespace RapidGL {
+
+/**
+ * Constructs an empty transform store.
+ *
+ * @param threadPool Pool of threads to update large hierarchies with
+ * @param parallelThreshold Number of transforms at which updates are split across threads
+ */
+TransformStore::TransformStore(Poco::ThreadPool& threadPool, const size_t parallelThreshold) :
+        threadPool(threadPool),
+        parallelThreshold(parallelThreshold),
+        size(0),
+        version(0),
+        sorted(true),
+        changed(false),
+        jobCount(0) {
+    // empty
+}
+
+/**
+ * Destructs a transform store.
+ */
+TransformStore::~TransformStore() {
+    for (std::vector<Job*>::iterator it = jobs.begin(); it != jobs.end(); ++it) {
+        delete (*it);
+    }
+}
+
+/**
+ * Constructs a job.
+ *
+ * @param store Store whose ranges the job updates
+ */
+TransformStore::Job::Job(TransformStore* const store) : store(store) {
+    // empty
+}
+
+/**
+ * Destructs a job.
+ */
+TransformStore::Job::~Job() {
+    // empty
+}
+
+/**
+ * Updates the world matrices in the job's ranges.
+ */
+void TransformStore::Job::run() {
+    for (std::vector<Range>::const_iterator it = ranges.begin(); it != ranges.end(); ++it) {
+        store->update(it->begin, it->end);
+    }
+    done.set();
+}
+
+/**
+ * Adds a transform.
+ *
+ * Adding transforms in depth-first order, i.e. children right after their
+ * parent and its earlier children, keeps the store from having to reorder.
+ *
+ * @param parent Handle of parent transform, or `NONE` for a root
+ * @param local Matrix to post-multiply the world matrix of the parent with
+ * @return Handle of the new transform
+ * @throws invalid_argument if parent is not `NONE` and is not valid
+ */
+TransformStore::Handle TransformStore::add(const Handle parent, const SimdMat4& local) {
+
+    // Find the parent
+    const int parentIndex = (parent == NONE) ? -1 : findIndex(parent);
+
+    // Pick a handle
+    Handle handle;
+    if (freeHandles.empty()) {
+        handle = (Handle) indices.size();
+        indices.push_back(-1);
+    } else {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+    }
+
+    // Append the transform
+    const size_t index = locals.size();
+    locals.push_back(local);
+    worlds.push_back(local);
+    parents.push_back(parentIndex);
+    ends.push_back(index + 1);
+    childCounts.push_back(0);
+    dirty.push_back(1);
+    versions.push_back(0);
+    handles.push_back(handle);
+    indices[handle] = (int) index;
+    ++size;
+    changed = true;
+
+    // Stay in order if the parent's subtree ended at the back, otherwise reorder later
+    if (parentIndex >= 0) {
+        ++childCounts[parentIndex];
+        if (sorted && (ends[parentIndex] == index)) {
+            for (int i = parentIndex; i >= 0; i = parents[i]) {
+                ends[i] = index + 1;
+            }
+        } else {
+            sorted = false;
+        }
+    }
+    return handle;
+}
+
+/**
+ * Finds where a transform is in the arrays.
+ *
+ * @param handle Handle of transform
+ * @return Index of transform
+ * @throws invalid_argument if handle is not valid
+ */
+int TransformStore::findIndex(const Handle handle) const {
+    if ((handle < 0) || (handle >= (Handle) indices.size()) || (indices[handle] < 0)) {
+        throw std::invalid_argument("[TransformStore] Handle is not valid!");
+    }
+    return indices[handle];
+}
+
+/**
+ * Returns the number of jobs the last update was split into.
+ *
+ * @return Number of jobs, or zero if the last update was done on the calling thread alone
+ */
+size_t TransformStore::getJobCount() const {
+    return jobCount;
+}
+
+/**
+ * Returns the local matrix of a transform.
+ *
+ * @param handle Handle of transform
+ * @return Reference to the local matrix, valid until the store changes
+ * @throws invalid_argument if handle is not valid
+ */
+const SimdMat4& TransformStore::getLocalMatrix(const Handle handle) const {
+    return locals[findIndex(handle)];
+}
+
+/**
+ * Returns the parent of a transform.
+ *
+ * @param handle Handle of transform
+ * @return Handle of parent transform, or `NONE` if the transform is a root
+ * @throws invalid_argument if handle is not valid
+ */
+TransformStore::Handle TransformStore::getParent(const Handle handle) const {
+    const int parentIndex = parents[findIndex(handle)];
+    return (parentIndex < 0) ? NONE : handles[parentIndex];
+}
+
+/**
+ * Returns the number of transforms in the store.
+ *
+ * @return Number of transforms in the store
+ */
+size_t TransformStore::getSize() const {
+    return size;
+}
+
+/**
+ * Returns the world matrix of a transform as of the last update.
+ *
+ * @param handle Handle of transform
+ * @return Reference to the world matrix, valid until the store changes
+ * @throws invalid_argument if handle is not valid
+ */
+const SimdMat4& TransformStore::getWorldMatrix(const Handle handle) const {
+    return worlds[findIndex(handle)];
+}
+
+/**
+ * Returns a number that changes whenever the world matrix of a transform is computed again.
+ *
+ * @param handle Handle of transform
+ * @return Version of the world matrix
+ * @throws invalid_argument if handle is not valid
+ */
+size_t TransformStore::getWorldVersion(const Handle handle) const {
+    return versions[findIndex(handle)];
+}
+
+/**
+ * Removes a transform, freeing its handle to be reused.
+ *
+ * @param handle Handle of transform to remove
+ * @throws invalid_argument if handle is not valid
+ * @throws runtime_error if the transform still has children
+ */
+void TransformStore::remove(const Handle handle) {
+    const int index = findIndex(handle);
+    if (childCounts[index] > 0) {
+        throw std::runtime_error("[TransformStore] Transform still has children!");
+    }
+    if (parents[index] >= 0) {
+        --childCounts[parents[index]];
+    }
+    handles[index] = NONE;
+    indices[handle] = -1;
+    freeHandles.push_back(handle);
+    --size;
+    sorted = false;
+}
+
+/**
+ * Changes the local matrix of a transform, so it and its descendants are computed on the next update.
+ *
+ * @param handle Handle of transform
+ * @param local Matrix to post-multiply the world matrix of the parent with
+ * @throws invalid_argument if handle is not valid
+ */
+void TransformStore::setLocalMatrix(const Handle handle, const SimdMat4& local) {
+    const int index = findIndex(handle);
+    locals[index] = local;
+    dirty[index] = 1;
+    changed = true;
+}
+
+/**
+ * Puts the transforms in depth-first order, dropping removed ones.
+ */
+void TransformStore::sort() {
+
+    // Link children in the order they were added
+    const size_t count = locals.size();
+    std::vector<int> firstChildren(count, -1);
+    std::vector<int> nextSiblings(count, -1);
+    for (size_t i = count; i-- > 0; ) {
+        if ((handles[i] != NONE) && (parents[i] >= 0)) {
+            nextSiblings[i] = firstChildren[parents[i]];
+            firstChildren[parents[i]] = (int) i;
+        }
+    }
+
+    // Walk each root's subtree depth-first without a stack
+    std::vector<int> order;
+    order.reserve(size);
+    for (size_t r = 0; r < count; ++r) {
+        if ((handles[r] == NONE) || (parents[r] >= 0)) {
+            continue;
+        }
+        int i = (int) r;
+        while (true) {
+            order.push_back(i);
+            if (firstChildren[i] >= 0) {
+                i = firstChildren[i];
+                continue;
+            }
+            while ((i != (int) r) && (nextSiblings[i] < 0)) {
+                i = parents[i];
+            }
+            if (i == (int) r) {
+                break;
+            }
+            i = nextSiblings[i];
+        }
+    }
+
+    // Move everything to its new place
+    std::vector<int> newIndices(count, -1);
+    for (size_t i = 0; i < order.size(); ++i) {
+        newIndices[order[i]] = (int) i;
+    }
+    std::vector<SimdMat4> newLocals(order.size());
+    std::vector<SimdMat4> newWorlds(order.size());
+    std::vector<int> newParents(order.size());
+    std::vector<size_t> newChildCounts(order.size());
+    std::vector<char> newDirty(order.size());
+    std::vector<size_t> newVersions(order.size());
+    std::vector<Handle> newHandles(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        const int old = order[i];
+        newLocals[i] = locals[old];
+        newWorlds[i] = worlds[old];
+        newParents[i] = (parents[old] < 0) ? -1 : newIndices[parents[old]];
+        newChildCounts[i] = childCounts[old];
+        newDirty[i] = dirty[old];
+        newVersions[i] = versions[old];
+        newHandles[i] = handles[old];
+        indices[handles[old]] = (int) i;
+    }
+    locals.swap(newLocals);
+    worlds.swap(newWorlds);
+    parents.swap(newParents);
+    childCounts.swap(newChildCounts);
+    dirty.swap(newDirty);
+    versions.swap(newVersions);
+    handles.swap(newHandles);
+
+    // Find where each subtree ends
+    ends.resize(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        ends[i] = i + 1;
+    }
+    for (size_t i = order.size(); i-- > 0; ) {
+        if (parents[i] >= 0) {
+            ends[parents[i]] = std::max(ends[parents[i]], ends[i]);
+        }
+    }
+    sorted = true;
+}
+
+/**
+ * Divides the transforms into jobs of whole subtrees, and transforms above them.
+ *
+ * @param share Most transforms a job should have
+ */
+void TransformStore::split(const size_t share) {
+
+    top.clear();
+    jobCount = 0;
+    size_t filled = 0;
+
+    size_t i = 0;
+    while (i < locals.size()) {
+
+        // Transforms with subtrees too big for a job are computed before the jobs
+        const size_t end = ends[i];
+        if ((end - i) > share) {
+            top.push_back(i);
+            ++i;
+            continue;
+        }
+
+        // Otherwise give the whole subtree to the current job, starting another if it is full
+        if ((jobCount == 0) || (filled + (end - i) > share)) {
+            if (jobCount == jobs.size()) {
+                jobs.push_back(new Job(this));
+            }
+            jobs[jobCount++]->ranges.clear();
+            filled = 0;
+        }
+        std::vector<Range>& ranges = jobs[jobCount - 1]->ranges;
+        if (!ranges.empty() && (ranges.back().end == i)) {
+            ranges.back().end = end;
+        } else {
+            const Range range = { i, end };
+            ranges.push_back(range);
+        }
+        filled += (end - i);
+        i = end;
+    }
+}
+
+/**
+ * Computes the world matrices of transforms whose local matrix or an ancestor changed.
+ *
+ * Call this after changing the store and before reading world matrices.
+ */
+void TransformStore::update() {
+    if (!sorted) {
+        sort();
+    }
+    if (!changed) {
+        jobCount = 0;
+        return;
+    }
+    ++version;
+    if (locals.size() >= parallelThreshold) {
+        updateInParallel();
+    } else {
+        jobCount = 0;
+        update(0, locals.size());
+    }
+    std::fill(dirty.begin(), dirty.end(), 0);
+    changed = false;
+}
+
+/**
+ * Computes the world matrices in a range whose parents outside of it are up to date.
+ *
+ * @param begin Index of first transform in range
+ * @param end One past the index of the last transform in range
+ */
+void TransformStore::update(const size_t begin, const size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        const int parent = parents[i];
+        if (parent < 0) {
+            if (dirty[i]) {
+                worlds[i] = locals[i];
+                versions[i] = version;
+            }
+        } else if (dirty[i] || dirty[parent]) {
+            dirty[i] = 1;
+            worlds[i] = worlds[parent].multiplyAffine(locals[i]);
+            versions[i] = version;
+        }
+    }
+}
+
+/**
+ * Computes the world matrices using the calling thread and threads from the pool.
+ */
+void TransformStore::updateInParallel() {
+
+    // Split into about one job per processor
+    const size_t processorCount = std::max(1U, Poco::Environment::processorCount());
+    split((locals.size() + processorCount - 1) / processorCount);
+
+    // Compute the transforms above the jobs first
+    for (std::vector<size_t>::const_iterator it = top.begin(); it != top.end(); ++it) {
+        update(*it, (*it) + 1);
+    }
+
+    // Run the first job here and the rest on other threads if any are free
+    for (size_t i = 1; i < jobCount; ++i) {
+        try {
+            threadPool.start(*jobs[i]);
+        } catch (Poco::NoThreadAvailableException& e) {
+            jobs[i]->run();
+        }
+    }
+    if (jobCount > 0) {
+        jobs[0]->run();
+    }
+    for (size_t i = 0; i < jobCount; ++i) {
+        jobs[i]->done.wait();
+    }
+}
+
+} /* namespace RapidGL */
@@ -0,0 +1,121 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RAPIDGL_TRANSFORM_STORE_H
+#define RAPIDGL_TRANSFORM_STORE_H
+#include <vector>
+#include <Poco/Event.h>
+#include <Poco/Runnable.h>
+#include <Poco/ThreadPool.h>
+#include "RapidGL/common.h"
+#include "RapidGL/SimdMat4.h"
+namespace RapidGL {
+
+
+/**
+ * Hierarchy of transforms stored in arrays rather than in nodes.
+ *
+ * Each transform has a local matrix, the handle of its parent, and a world
+ * matrix, which is the world matrix of its parent post-multiplied with its
+ * local matrix.  The arrays are kept in depth-first order, so a parent always
+ * comes before its children and every subtree is a contiguous range.  That
+ * lets `update` compute world matrices in one pass from front to back, only
+ * for transforms whose local matrix or an ancestor changed.
+ *
+ * With more transforms than the parallel threshold, subtrees that fit in a
+ * share of the work are handed to threads from the pool, while the few
+ * transforms above them are computed first on the calling thread.
+ *
+ * Handles stay the same when transforms are reordered, and are reused once
+ * their transform is removed.  Local matrices should be affine.
+ */
+class TransformStore {
+public:
+// Types
+    typedef int Handle;
+// Constants
+    static const Handle NONE = -1;
+    static const size_t PARALLEL_THRESHOLD = 100000;
+// Methods
+    TransformStore(Poco::ThreadPool& threadPool = Poco::ThreadPool::defaultPool(),
+            size_t parallelThreshold = PARALLEL_THRESHOLD);
+    virtual ~TransformStore();
+    Handle add(Handle parent, const SimdMat4& local);
+    size_t getJobCount() const;
+    const SimdMat4& getLocalMatrix(Handle handle) const;
+    Handle getParent(Handle handle) const;
+    size_t getSize() const;
+    const SimdMat4& getWorldMatrix(Handle handle) const;
+    size_t getWorldVersion(Handle handle) const;
+    void remove(Handle handle);
+    void setLocalMatrix(Handle handle, const SimdMat4& local);
+    void update();
+private:
+// Types
+    /**
+     * Range of transforms making up whole subtrees.
+     */
+    struct Range {
+        size_t begin;
+        size_t end;
+    };
+    /**
+     * Ranges of transforms updated on one thread.
+     */
+    class Job : public Poco::Runnable {
+    public:
+    // Methods
+        Job(TransformStore* store);
+        virtual ~Job();
+        virtual void run();
+    // Attributes
+        TransformStore* store;
+        std::vector<Range> ranges;
+        Poco::Event done;
+    };
+// Attributes
+    Poco::ThreadPool& threadPool;
+    const size_t parallelThreshold;
+    std::vector<SimdMat4> locals;
+    std::vector<SimdMat4> worlds;
+    std::vector<int> parents;
+    std::vector<size_t> ends;
+    std::vector<size_t> childCounts;
+    std::vector<char> dirty;
+    std::vector<size_t> versions;
+    std::vector<Handle> handles;
+    std::vector<int> indices;
+    std::vector<Handle> freeHandles;
+    size_t size;
+    size_t version;
+    bool sorted;
+    bool changed;
+    std::vector<size_t> top;
+    std::vector<Job*> jobs;
+    size_t jobCount;
+// Methods
+    TransformStore(const TransformStore&);
+    TransformStore& operator=(const TransformStore&);
+    int findIndex(Handle handle) const;
+    void sort();
+    void split(size_t share);
+    void update(size_t begin, size_t end);
+    void updateInParallel();
+};
+
+} /* namespace RapidGL */
+#endif
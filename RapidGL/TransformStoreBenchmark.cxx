@@ -0,0 +1,170 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <Poco/Stopwatch.h>
+#include <Poco/ThreadPool.h>
+#include <m3d/Vec3.h>
+#include "RapidGL/SimdMat4.h"
+#include "RapidGL/State.h"
+#include "RapidGL/TransformStore.h"
+#include "RapidGL/TranslateNode.h"
+#include "RapidGL/Visitor.h"
+
+
+/**
+ * Benchmark comparing `TransformStore` with visiting `TranslateNode`s using a `State`.
+ *
+ * Both hold the same hierarchy, where each transform has up to eight
+ * children.  Each is timed with every transform changed, which is the cost
+ * of animating everything, and with nothing changed, which is the cost of a
+ * static scene.
+ */
+class TransformStoreBenchmark {
+public:
+
+    // Number of transforms in the hierarchy
+    static const int SIZE = 200000;
+
+    // Number of children each transform has
+    static const int BRANCHING = 8;
+
+    // Number of times to update each hierarchy
+    static const int ITERATIONS = 10;
+
+    // Nodes of the hierarchy being visited
+    std::vector<RapidGL::TranslateNode*> nodes;
+
+    /**
+     * Destructs the benchmark, deleting the nodes.
+     */
+    ~TransformStoreBenchmark() {
+        for (std::vector<RapidGL::TranslateNode*>::iterator it = nodes.begin(); it != nodes.end(); ++it) {
+            delete (*it);
+        }
+    }
+
+    /**
+     * Makes the translation of a transform for an iteration.
+     *
+     * @param i Index of transform
+     * @param iteration Index of iteration
+     * @return Translation for that transform and iteration
+     */
+    static M3d::Vec3 makeTranslation(const int i, const int iteration) {
+        return M3d::Vec3((i + iteration) % 7, 1, 0);
+    }
+
+    /**
+     * Prints how long something took per iteration.
+     *
+     * @param name Description of what was timed
+     * @param stopwatch Stopwatch that timed it
+     */
+    static void print(const std::string& name, const Poco::Stopwatch& stopwatch) {
+        std::cout << "  " << name << ": " << (((double) stopwatch.elapsed()) / ITERATIONS) << " us per update" << std::endl;
+    }
+
+    /**
+     * Times updating the hierarchy both ways and prints the results.
+     */
+    void run() {
+
+        // Make the hierarchy as nodes and in stores
+        Poco::ThreadPool threadPool;
+        RapidGL::TransformStore serialStore(threadPool, SIZE + 1);
+        RapidGL::TransformStore parallelStore(threadPool);
+        std::vector<RapidGL::TransformStore::Handle> handles;
+        for (int i = 0; i < SIZE; ++i) {
+            const int parent = (i == 0) ? -1 : ((i - 1) / BRANCHING);
+            const M3d::Vec3 translation = makeTranslation(i, 0);
+            nodes.push_back(new RapidGL::TranslateNode(translation));
+            if (parent >= 0) {
+                nodes[parent]->addChild(nodes[i]);
+            }
+            const RapidGL::TransformStore::Handle parentHandle = (parent >= 0) ? handles[parent] : RapidGL::TransformStore::NONE;
+            handles.push_back(serialStore.add(parentHandle, RapidGL::SimdMat4::translation(translation)));
+            parallelStore.add(parentHandle, RapidGL::SimdMat4::translation(translation));
+        }
+        serialStore.update();
+        parallelStore.update();
+
+        RapidGL::State state;
+        RapidGL::Visitor visitor(&state);
+        visitor.visit(nodes.front());
+        Poco::Stopwatch stopwatch;
+        std::cout << "Everything changed (" << SIZE << " transforms)" << std::endl;
+
+        // Nodes
+        stopwatch.restart();
+        for (int j = 1; j <= ITERATIONS; ++j) {
+            for (int i = 0; i < SIZE; ++i) {
+                nodes[i]->setTranslation(makeTranslation(i, j));
+            }
+            visitor.visit(nodes.front());
+        }
+        stopwatch.stop();
+        print("state", stopwatch);
+
+        // Store on one thread
+        stopwatch.restart();
+        for (int j = 1; j <= ITERATIONS; ++j) {
+            for (int i = 0; i < SIZE; ++i) {
+                serialStore.setLocalMatrix(handles[i], RapidGL::SimdMat4::translation(makeTranslation(i, j)));
+            }
+            serialStore.update();
+        }
+        stopwatch.stop();
+        print("store", stopwatch);
+
+        // Store on several threads
+        stopwatch.restart();
+        for (int j = 1; j <= ITERATIONS; ++j) {
+            for (int i = 0; i < SIZE; ++i) {
+                parallelStore.setLocalMatrix(handles[i], RapidGL::SimdMat4::translation(makeTranslation(i, j)));
+            }
+            parallelStore.update();
+        }
+        stopwatch.stop();
+        print("parallel store", stopwatch);
+        std::cout << "  jobs: " << parallelStore.getJobCount() << std::endl;
+
+        // Nothing changed
+        std::cout << "Nothing changed (" << SIZE << " transforms)" << std::endl;
+        stopwatch.restart();
+        for (int j = 0; j < ITERATIONS; ++j) {
+            visitor.visit(nodes.front());
+        }
+        stopwatch.stop();
+        print("state", stopwatch);
+        stopwatch.restart();
+        for (int j = 0; j < ITERATIONS; ++j) {
+            serialStore.update();
+        }
+        stopwatch.stop();
+        print("store", stopwatch);
+    }
+};
+
+int main(int argc, char* argv[]) {
+    TransformStoreBenchmark benchmark;
+    benchmark.run();
+    return 0;
+}
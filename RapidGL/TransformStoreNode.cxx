@@ -0,0 +1,100 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include "RapidGL/TransformStoreNode.h"
+namespace RapidGL {
+
+/**
+ * Constructs a `TransformStoreNode`.
+ *
+ * @param store Store holding the transform
+ * @param handle Handle of transform in the store
+ * @throws invalid_argument if handle is not valid
+ */
+TransformStoreNode::TransformStoreNode(TransformStore& store, const TransformStore::Handle handle) :
+        store(store),
+        handle(handle),
+        nextEntry(0) {
+
+    // Make sure the handle is valid
+    store.getParent(handle);
+}
+
+/**
+ * Destructs a `TransformStoreNode`, leaving the transform in the store.
+ */
+TransformStoreNode::~TransformStoreNode() {
+    // empty
+}
+
+/**
+ * Returns the handle of the transform this node refers to.
+ *
+ * @return Handle of transform in the store
+ */
+TransformStore::Handle TransformStoreNode::getHandle() const {
+    return handle;
+}
+
+/**
+ * Returns the store holding the transform this node refers to.
+ *
+ * @return Store holding the transform
+ */
+TransformStore& TransformStoreNode::getStore() const {
+    return store;
+}
+
+/**
+ * Sets the model matrix to the world matrix of the transform, or restores it from before.
+ *
+ * @param state State with model matrix to change
+ * @throws invalid_argument if the transform was removed from the store
+ */
+void TransformStoreNode::visit(State& state) {
+
+    // Find what was set in the state before
+    const size_t id = state.getId();
+    const size_t worldVersion = store.getWorldVersion(handle);
+    std::vector<Entry>::iterator it = entries.begin();
+    while ((it != entries.end()) && (it->state != id)) {
+        ++it;
+    }
+
+    // Restore it if the world matrix did not change
+    if ((it != entries.end()) && (it->worldVersion == worldVersion)) {
+        state.restoreModelMatrix(store.getWorldMatrix(handle), it->version);
+        return;
+    }
+
+    // Otherwise set it and remember the version it got, replacing the oldest state if there are too many
+    state.setModelMatrix(store.getWorldMatrix(handle));
+    if (it == entries.end()) {
+        if (entries.size() < MAX_WORLD_COUNT) {
+            it = entries.insert(entries.end(), Entry());
+        } else {
+            it = entries.begin() + nextEntry;
+            nextEntry = (nextEntry + 1) % MAX_WORLD_COUNT;
+        }
+        it->state = id;
+    }
+    it->worldVersion = worldVersion;
+    it->version = state.getModelMatrixVersion();
+}
+
+} /* namespace RapidGL */
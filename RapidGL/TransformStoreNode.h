@@ -0,0 +1,68 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RAPIDGL_TRANSFORM_STORE_NODE_H
+#define RAPIDGL_TRANSFORM_STORE_NODE_H
+#include <vector>
+#include "RapidGL/common.h"
+#include "RapidGL/SimdMat4.h"
+#include "RapidGL/State.h"
+#include "RapidGL/TransformNode.h"
+#include "RapidGL/TransformStore.h"
+namespace RapidGL {
+
+
+/**
+ * Node that sets the model matrix to the world matrix of a transform in a `TransformStore`.
+ *
+ * The node is only a handle, so the hierarchy in the store decides the
+ * matrix rather than the nodes above it.  Update the store before visiting.
+ * If the world matrix did not change since the node was last visited with a
+ * state, the model matrix is restored with the version it had then, so nodes
+ * below can reuse their results.  Like `TransformNode`, only a few states are
+ * kept, with the oldest replaced by the next state once there are too many.
+ */
+class TransformStoreNode : public TransformNode {
+public:
+// Methods
+    TransformStoreNode(TransformStore& store, TransformStore::Handle handle);
+    virtual ~TransformStoreNode();
+    TransformStore::Handle getHandle() const;
+    TransformStore& getStore() const;
+    virtual void visit(State& state);
+private:
+// Types
+    /**
+     * Model matrix version given to a world matrix in a state.
+     */
+    struct Entry {
+        size_t state;
+        size_t worldVersion;
+        size_t version;
+    };
+// Attributes
+    TransformStore& store;
+    const TransformStore::Handle handle;
+    std::vector<Entry> entries;
+    size_t nextEntry;
+// Methods
+    TransformStoreNode(const TransformStoreNode&);
+    TransformStoreNode& operator=(const TransformStoreNode&);
+};
+
+} /* namespace RapidGL */
+#endif
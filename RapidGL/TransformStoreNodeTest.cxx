@@ -0,0 +1,154 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include <m3d/Vec3.h>
+#include "RapidGL/SimdMat4.h"
+#include "RapidGL/State.h"
+#include "RapidGL/TransformStore.h"
+#include "RapidGL/TransformStoreNode.h"
+
+
+/**
+ * Unit test for `TransformStoreNode`.
+ */
+class TransformStoreNodeTest : public CppUnit::TestFixture {
+public:
+
+    // Threshold for single-precision comparisons
+    static const double TOLERANCE = 1e-5;
+
+    /**
+     * Ensures the constructor throws if the handle is not in the store.
+     */
+    void testConstructorWithInvalidHandle() {
+        RapidGL::TransformStore store;
+        CPPUNIT_ASSERT_THROW(RapidGL::TransformStoreNode node(store, 0), std::invalid_argument);
+    }
+
+    /**
+     * Ensures visiting sets the model matrix to the world matrix in the store.
+     */
+    void testVisit() {
+
+        // Make store
+        RapidGL::TransformStore store;
+        const RapidGL::TransformStore::Handle root = store.add(
+                RapidGL::TransformStore::NONE,
+                RapidGL::SimdMat4::translation(M3d::Vec3(1, 0, 0)));
+        const RapidGL::TransformStore::Handle child = store.add(
+                root,
+                RapidGL::SimdMat4::translation(M3d::Vec3(0, 2, 0)));
+        store.update();
+
+        // Visit
+        RapidGL::TransformStoreNode node(store, child);
+        RapidGL::State state;
+        node.preVisit(state);
+        node.visit(state);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, state.getSimdModelMatrix()[3][0], TOLERANCE);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, state.getSimdModelMatrix()[3][1], TOLERANCE);
+        node.postVisit(state);
+    }
+
+    /**
+     * Ensures visiting again restores the version of the model matrix until the world matrix changes.
+     */
+    void testVisitAgain() {
+
+        // Make store
+        RapidGL::TransformStore store;
+        const RapidGL::TransformStore::Handle handle = store.add(
+                RapidGL::TransformStore::NONE,
+                RapidGL::SimdMat4::translation(M3d::Vec3(1, 0, 0)));
+        store.update();
+
+        // Visit twice
+        RapidGL::TransformStoreNode node(store, handle);
+        RapidGL::State state;
+        node.preVisit(state);
+        node.visit(state);
+        const size_t version = state.getModelMatrixVersion();
+        node.postVisit(state);
+        state.setViewMatrix(RapidGL::SimdMat4());
+        node.preVisit(state);
+        node.visit(state);
+        CPPUNIT_ASSERT_EQUAL(version, state.getModelMatrixVersion());
+        node.postVisit(state);
+
+        // Change the store and visit again
+        store.setLocalMatrix(handle, RapidGL::SimdMat4::translation(M3d::Vec3(3, 0, 0)));
+        store.update();
+        node.preVisit(state);
+        node.visit(state);
+        CPPUNIT_ASSERT(version != state.getModelMatrixVersion());
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, state.getSimdModelMatrix()[3][0], TOLERANCE);
+        node.postVisit(state);
+    }
+
+    /**
+     * Ensures the oldest state is forgotten once a node has been visited with too many.
+     */
+    void testVisitWithManyStates() {
+
+        // Make store
+        RapidGL::TransformStore store;
+        const RapidGL::TransformStore::Handle handle = store.add(
+                RapidGL::TransformStore::NONE,
+                RapidGL::SimdMat4::translation(M3d::Vec3(1, 0, 0)));
+        store.update();
+
+        // Visit with more states than are kept
+        RapidGL::TransformStoreNode node(store, handle);
+        RapidGL::State states[9];
+        size_t versions[9];
+        for (int i = 0; i < 9; ++i) {
+            node.preVisit(states[i]);
+            node.visit(states[i]);
+            versions[i] = states[i].getModelMatrixVersion();
+            node.postVisit(states[i]);
+        }
+
+        // Visit with the newest state, then the oldest
+        node.preVisit(states[8]);
+        node.visit(states[8]);
+        CPPUNIT_ASSERT_EQUAL(versions[8], states[8].getModelMatrixVersion());
+        node.postVisit(states[8]);
+        node.preVisit(states[0]);
+        node.visit(states[0]);
+        CPPUNIT_ASSERT(versions[0] != states[0].getModelMatrixVersion());
+        node.postVisit(states[0]);
+    }
+
+    CPPUNIT_TEST_SUITE(TransformStoreNodeTest);
+    CPPUNIT_TEST(testConstructorWithInvalidHandle);
+    CPPUNIT_TEST(testVisit);
+    CPPUNIT_TEST(testVisitAgain);
+    CPPUNIT_TEST(testVisitWithManyStates);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(TransformStoreNodeTest::suite());
+    runner.run();
+    return 0;
+}
@@ -0,0 +1,223 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include <Poco/ThreadPool.h>
+#include <m3d/Vec3.h>
+#include "RapidGL/SimdMat4.h"
+#include "RapidGL/TransformStore.h"
+
+
+/**
+ * Unit test for `TransformStore`.
+ */
+class TransformStoreTest : public CppUnit::TestFixture {
+public:
+
+    // Threshold for single-precision comparisons
+    static const double TOLERANCE = 1e-5;
+
+    /**
+     * Makes a translation along the X axis.
+     *
+     * @param x Distance to translate
+     * @return Translation matrix
+     */
+    static RapidGL::SimdMat4 translateX(const double x) {
+        return RapidGL::SimdMat4::translation(M3d::Vec3(x, 0, 0));
+    }
+
+    /**
+     * Returns how far the world matrix of a transform translates along the X axis.
+     *
+     * @param store Store with transform
+     * @param handle Handle of transform
+     * @return X coordinate of translation in world matrix
+     */
+    static double getWorldX(const RapidGL::TransformStore& store, const RapidGL::TransformStore::Handle handle) {
+        return store.getWorldMatrix(handle)[3][0];
+    }
+
+    /**
+     * Ensures world matrices are the local matrices of each transform and its ancestors multiplied together.
+     */
+    void testUpdate() {
+
+        RapidGL::TransformStore store;
+        const RapidGL::TransformStore::Handle root = store.add(RapidGL::TransformStore::NONE, translateX(1));
+        const RapidGL::TransformStore::Handle child = store.add(root, translateX(2));
+        const RapidGL::TransformStore::Handle grandchild = store.add(child, translateX(4));
+        const RapidGL::TransformStore::Handle sibling = store.add(root, translateX(8));
+        store.update();
+
+        CPPUNIT_ASSERT_EQUAL((size_t) 4, store.getSize());
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, getWorldX(store, root), TOLERANCE);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, getWorldX(store, child), TOLERANCE);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(7.0, getWorldX(store, grandchild), TOLERANCE);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(9.0, getWorldX(store, sibling), TOLERANCE);
+        CPPUNIT_ASSERT_EQUAL(root, store.getParent(sibling));
+        CPPUNIT_ASSERT_EQUAL((RapidGL::TransformStore::Handle) RapidGL::TransformStore::NONE, store.getParent(root));
+    }
+
+    /**
+     * Ensures only a changed transform and its descendants are computed again.
+     */
+    void testUpdateAfterSetLocalMatrix() {
+
+        RapidGL::TransformStore store;
+        const RapidGL::TransformStore::Handle root = store.add(RapidGL::TransformStore::NONE, translateX(1));
+        const RapidGL::TransformStore::Handle child = store.add(root, translateX(2));
+        const RapidGL::TransformStore::Handle grandchild = store.add(child, translateX(4));
+        const RapidGL::TransformStore::Handle sibling = store.add(root, translateX(8));
+        store.update();
+        const size_t rootVersion = store.getWorldVersion(root);
+        const size_t childVersion = store.getWorldVersion(child);
+        const size_t siblingVersion = store.getWorldVersion(sibling);
+
+        // Change the child
+        store.setLocalMatrix(child, translateX(16));
+        store.update();
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(17.0, getWorldX(store, child), TOLERANCE);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(21.0, getWorldX(store, grandchild), TOLERANCE);
+        CPPUNIT_ASSERT_EQUAL(rootVersion, store.getWorldVersion(root));
+        CPPUNIT_ASSERT_EQUAL(siblingVersion, store.getWorldVersion(sibling));
+        CPPUNIT_ASSERT(childVersion != store.getWorldVersion(child));
+        CPPUNIT_ASSERT_EQUAL(store.getWorldVersion(child), store.getWorldVersion(grandchild));
+
+        // Update without changes
+        const size_t grandchildVersion = store.getWorldVersion(grandchild);
+        store.update();
+        CPPUNIT_ASSERT_EQUAL(grandchildVersion, store.getWorldVersion(grandchild));
+    }
+
+    /**
+     * Ensures transforms added after others in a different subtree are reordered correctly.
+     */
+    void testUpdateAfterAddOutOfOrder() {
+
+        RapidGL::TransformStore store;
+        const RapidGL::TransformStore::Handle a = store.add(RapidGL::TransformStore::NONE, translateX(1));
+        const RapidGL::TransformStore::Handle b = store.add(RapidGL::TransformStore::NONE, translateX(10));
+        const RapidGL::TransformStore::Handle aChild = store.add(a, translateX(2));
+        const RapidGL::TransformStore::Handle bChild = store.add(b, translateX(20));
+        const RapidGL::TransformStore::Handle aGrandchild = store.add(aChild, translateX(4));
+        store.update();
+
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, getWorldX(store, aChild), TOLERANCE);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(7.0, getWorldX(store, aGrandchild), TOLERANCE);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(30.0, getWorldX(store, bChild), TOLERANCE);
+        CPPUNIT_ASSERT_EQUAL(aChild, store.getParent(aGrandchild));
+        CPPUNIT_ASSERT_EQUAL(b, store.getParent(bChild));
+
+        // Change one root and make sure its subtree follows
+        store.setLocalMatrix(a, translateX(100));
+        store.update();
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(106.0, getWorldX(store, aGrandchild), TOLERANCE);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(30.0, getWorldX(store, bChild), TOLERANCE);
+    }
+
+    /**
+     * Ensures adding with an invalid parent throws.
+     */
+    void testAddWithInvalidParent() {
+        RapidGL::TransformStore store;
+        CPPUNIT_ASSERT_THROW(store.add(5, translateX(1)), std::invalid_argument);
+    }
+
+    /**
+     * Ensures removing a transform invalidates its handle and lets the handle be reused.
+     */
+    void testRemove() {
+
+        RapidGL::TransformStore store;
+        const RapidGL::TransformStore::Handle root = store.add(RapidGL::TransformStore::NONE, translateX(1));
+        const RapidGL::TransformStore::Handle child = store.add(root, translateX(2));
+        const RapidGL::TransformStore::Handle other = store.add(root, translateX(4));
+
+        // Remove
+        CPPUNIT_ASSERT_THROW(store.remove(root), std::runtime_error);
+        store.remove(child);
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, store.getSize());
+        CPPUNIT_ASSERT_THROW(store.getWorldMatrix(child), std::invalid_argument);
+
+        // Reuse the handle
+        const RapidGL::TransformStore::Handle added = store.add(other, translateX(8));
+        CPPUNIT_ASSERT_EQUAL(child, added);
+        store.update();
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0, getWorldX(store, other), TOLERANCE);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(13.0, getWorldX(store, added), TOLERANCE);
+    }
+
+    /**
+     * Ensures splitting an update across threads gives the same results as doing it on one thread.
+     */
+    void testUpdateInParallel() {
+
+        Poco::ThreadPool threadPool;
+        RapidGL::TransformStore parallelStore(threadPool, 100);
+        RapidGL::TransformStore serialStore(threadPool, 1000000);
+        std::vector<RapidGL::TransformStore::Handle> handles;
+
+        // Make one big root with chains and fans below it, added out of order
+        handles.push_back(parallelStore.add(RapidGL::TransformStore::NONE, translateX(1)));
+        serialStore.add(RapidGL::TransformStore::NONE, translateX(1));
+        for (int i = 1; i < 2000; ++i) {
+            const RapidGL::TransformStore::Handle parent = handles[(i * 7919) % i];
+            handles.push_back(parallelStore.add(parent, translateX(i % 13)));
+            serialStore.add(parent, translateX(i % 13));
+        }
+        parallelStore.update();
+        serialStore.update();
+        CPPUNIT_ASSERT(parallelStore.getJobCount() > 1);
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, serialStore.getJobCount());
+        for (size_t i = 0; i < handles.size(); ++i) {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(getWorldX(serialStore, handles[i]), getWorldX(parallelStore, handles[i]), TOLERANCE);
+        }
+
+        // Change a few and compare again
+        for (size_t i = 0; i < handles.size(); i += 97) {
+            parallelStore.setLocalMatrix(handles[i], translateX(-3));
+            serialStore.setLocalMatrix(handles[i], translateX(-3));
+        }
+        parallelStore.update();
+        serialStore.update();
+        for (size_t i = 0; i < handles.size(); ++i) {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(getWorldX(serialStore, handles[i]), getWorldX(parallelStore, handles[i]), TOLERANCE);
+        }
+    }
+
+    CPPUNIT_TEST_SUITE(TransformStoreTest);
+    CPPUNIT_TEST(testAddWithInvalidParent);
+    CPPUNIT_TEST(testRemove);
+    CPPUNIT_TEST(testUpdate);
+    CPPUNIT_TEST(testUpdateAfterAddOutOfOrder);
+    CPPUNIT_TEST(testUpdateAfterSetLocalMatrix);
+    CPPUNIT_TEST(testUpdateInParallel);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(TransformStoreTest::suite());
+    runner.run();
+    return 0;
+}
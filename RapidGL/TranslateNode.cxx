@@ -18,6 +18,7 @@
 #include "config.h"
 #include <m3d/Mat4.h>
 #include <m3d/Vec4.h>
+#include "RapidGL/SimdMat4.h"
 #include "RapidGL/TranslateNode.h"
 namespace RapidGL {
 
@@ -44,6 +45,35 @@ TranslateNode::~TranslateNode() {
     // empty
 }
 
+/**
+ * Computes the bounds of this node's children, transformed by this node.
+ *
+ * @return Box enclosing this node's children after they are transformed
+ */
+BoundingBox TranslateNode::computeBounds() {
+    return Node::computeBounds().transform(getMatrix());
+}
+
+/**
+ * Returns the matrix this node post-multiplies the model matrix with, in single precision.
+ *
+ * @return Translation matrix
+ */
+SimdMat4 TranslateNode::computeMatrix() const {
+    return SimdMat4::translation(translation);
+}
+
+/**
+ * Returns the matrix this node post-multiplies the model matrix with.
+ *
+ * @return Translation matrix
+ */
+M3d::Mat4 TranslateNode::getMatrix() const {
+    M3d::Mat4 matrix(1);
+    matrix[3] = M3d::Vec4(translation, 1);
+    return matrix;
+}
+
 /**
  * Returns the translation that this node applies.
  *
@@ -60,21 +90,8 @@ M3d::Vec3 TranslateNode::getTranslation() const {
  */
 void TranslateNode::setTranslation(const M3d::Vec3& translation) {
     this->translation = translation;
+    invalidateMatrix();
     fireNodeChangedEvent();
 }
 
-void TranslateNode::visit(State& state) {
-
-    // Get the model matrix
-    M3d::Mat4 modelMatrix = state.getModelMatrix();
-
-    // Make a translation matrix
-    M3d::Mat4 translationMatrix = M3d::Mat4(1);
-    translationMatrix[3] = M3d::Vec4(translation, 1);
-
-    // Multiply it with the model matrix and store it
-    modelMatrix = modelMatrix * translationMatrix;
-    state.setModelMatrix(modelMatrix);
-}
-
 } /* namespace RapidGL */
@@ -17,8 +17,10 @@
  */
 #ifndef RAPIDGL_TRANSLATE_NODE_H
 #define RAPIDGL_TRANSLATE_NODE_H
+#include <m3d/Mat4.h>
 #include <m3d/Vec3.h>
 #include "RapidGL/common.h"
+#include "RapidGL/BoundingBox.h"
 #include "RapidGL/Node.h"
 #include "RapidGL/State.h"
 #include "RapidGL/TransformNode.h"
@@ -34,9 +36,13 @@ public:
     TranslateNode();
     TranslateNode(const M3d::Vec3& translation);
     virtual ~TranslateNode();
+    M3d::Mat4 getMatrix() const;
     M3d::Vec3 getTranslation() const;
-    virtual void visit(State& state);
     void setTranslation(const M3d::Vec3& translation);
+protected:
+// Methods
+    virtual BoundingBox computeBounds();
+    virtual SimdMat4 computeMatrix() const;
 private:
 // Attributes
     M3d::Vec3 translation;
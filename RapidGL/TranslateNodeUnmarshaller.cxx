@@ -34,7 +34,7 @@ TranslateNodeUnmarshaller::~TranslateNodeUnmarshaller() {
     // empty
 }
 
-Node* TranslateNodeUnmarshaller::unmarshal(const std::map<std::string,std::string>& attributes) {
+Node* TranslateNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
 
     // Make value
     M3d::Vec3 value;
@@ -0,0 +1,346 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cstring>
+#include <stdexcept>
+#include "RapidGL/UniformBuffer.h"
+namespace RapidGL {
+
+// Uniform buffer target
+const Gloop::BufferTarget UniformBuffer::uniformBuffer = Gloop::BufferTarget::uniformBuffer();
+
+/**
+ * Constructs a uniform buffer for a block, which learns the block's layout from the first program declaring it.
+ *
+ * @param blockName Name of the uniform block as declared in the shaders
+ * @param binding Binding point to bind the buffer to
+ * @throws invalid_argument if block name is empty
+ */
+UniformBuffer::UniformBuffer(const std::string& blockName, const GLuint binding) :
+        blockName(blockName),
+        binding(binding),
+        buffer(Gloop::BufferObject::generate()),
+        offsetAlignment(1),
+        lastProgram(programs.end()),
+        dirty(false),
+        lastRingBuffer(NULL),
+        lastFrameNumber(0),
+        uploadCount(0) {
+    if (blockName.empty()) {
+        buffer.dispose();
+        throw std::invalid_argument("[UniformBuffer] Block name is empty!");
+    }
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+    range.buffer = 0;
+    range.offset = 0;
+    range.size = 0;
+}
+
+/**
+ * Destructs a uniform buffer, deleting its buffer.
+ */
+UniformBuffer::~UniformBuffer() {
+    buffer.dispose();
+}
+
+/**
+ * Checks if this member has the same type and is in the same place as another.
+ *
+ * @param member Member to compare to
+ * @return `true` if both have the same type, offset and matrix stride
+ */
+bool UniformBuffer::Member::operator==(const Member& member) const {
+    return (type == member.type) && (offset == member.offset) && (matrixStride == member.matrixStride);
+}
+
+/**
+ * Uploads the block if it changed and binds it to its binding point.
+ *
+ * @param glStateCache Cache to bind the block through
+ * @param ringBuffer Ring buffer to upload the block into, or `NULL` to use the buffer's own storage
+ * @throws runtime_error if the ring buffer does not have a frame begun or has no space left
+ */
+void UniformBuffer::bind(GLStateCache& glStateCache, RingBuffer* const ringBuffer) {
+    const Range current = flush(ringBuffer);
+    if (current.size > 0) {
+        glStateCache.bindUniformBuffer(binding, current.buffer, current.offset, current.size);
+    }
+}
+
+/**
+ * Checks if a program declares the block, reading its layout and setting its binding point the first time.
+ *
+ * @param program Program to check
+ * @return `true` if program declares the block
+ * @throws runtime_error if the block is laid out differently in program than in the first program
+ */
+bool UniformBuffer::findBlock(const Gloop::Program& program) {
+
+    // Look at the last program first, since it's usually the same one
+    if ((lastProgram != programs.end()) && (lastProgram->first == program)) {
+        return lastProgram->second;
+    }
+    const std::map<Gloop::Program,bool>::const_iterator it = programs.find(program);
+    if (it != programs.end()) {
+        lastProgram = it;
+        return it->second;
+    }
+
+    // Look for the block, and point it at the binding point if it's there
+    const GLuint blockIndex = glGetUniformBlockIndex(program.id(), blockName.c_str());
+    const bool found = (blockIndex != GL_INVALID_INDEX);
+    if (found) {
+        readLayout(program, blockIndex);
+        glUniformBlockBinding(program.id(), blockIndex, binding);
+    }
+    lastProgram = programs.insert(std::pair<Gloop::Program,bool>(program, found)).first;
+    return found;
+}
+
+/**
+ * Uploads the block if it changed, or if it was last uploaded to an earlier frame of the ring buffer.
+ *
+ * @param ringBuffer Ring buffer to upload the block into, or `NULL` to use the buffer's own storage
+ * @return Range holding the block's current values, which is empty if no program declaring the block has been seen
+ * @throws runtime_error if the ring buffer does not have a frame begun or has no space left
+ */
+UniformBuffer::Range UniformBuffer::flush(RingBuffer* const ringBuffer) {
+
+    if (data.empty()) {
+        return range;
+    }
+
+    // Write to a new range of the ring buffer
+    if (ringBuffer != NULL) {
+        if (dirty || (ringBuffer != lastRingBuffer) || (ringBuffer->getFrameNumber() != lastFrameNumber)) {
+            const RingBuffer::Allocation allocation = ringBuffer->allocate(data.size(), offsetAlignment);
+            memcpy(allocation.pointer, &data[0], data.size());
+            ringBuffer->flush();
+            range.buffer = ringBuffer->getBuffer().id();
+            range.offset = allocation.offset;
+            range.size = data.size();
+            lastRingBuffer = ringBuffer;
+            lastFrameNumber = ringBuffer->getFrameNumber();
+            dirty = false;
+            ++uploadCount;
+        }
+        return range;
+    }
+
+    // Or orphan the buffer's own storage
+    if (dirty || (lastRingBuffer != NULL) || (range.buffer == 0)) {
+        uniformBuffer.bind(buffer);
+        uniformBuffer.data(data.size(), &data[0], GL_STREAM_DRAW);
+        uniformBuffer.unbind(buffer);
+        range.buffer = buffer.id();
+        range.offset = 0;
+        range.size = data.size();
+        lastRingBuffer = NULL;
+        dirty = false;
+        ++uploadCount;
+    }
+    return range;
+}
+
+/**
+ * Returns the binding point the buffer is bound to.
+ *
+ * @return Binding point the buffer is bound to
+ */
+GLuint UniformBuffer::getBinding() const {
+    return binding;
+}
+
+/**
+ * Returns the name of the uniform block.
+ *
+ * @return Name of the uniform block as declared in the shaders
+ */
+std::string UniformBuffer::getBlockName() const {
+    return blockName;
+}
+
+/**
+ * Returns the size of the block.
+ *
+ * @return Size of the block in bytes, or zero if no program declaring the block has been seen
+ */
+GLsizeiptr UniformBuffer::getSize() const {
+    return data.size();
+}
+
+/**
+ * Returns the number of times the block has been uploaded.
+ *
+ * @return Number of times the block has been uploaded
+ */
+size_t UniformBuffer::getUploadCount() const {
+    return uploadCount;
+}
+
+/**
+ * Checks if the block has a member.
+ *
+ * @param name Name of member
+ * @return `true` if a program declaring the block has been seen and the block has the member
+ */
+bool UniformBuffer::hasMember(const std::string& name) const {
+    return members.find(name) != members.end();
+}
+
+/**
+ * Reads the size of the block and the types and offsets of its members from a program.
+ *
+ * Every program after the first must lay the block out exactly the same way,
+ * with the same members at the same offsets, which `layout(std140)` ensures.
+ *
+ * @param program Program declaring the block
+ * @param blockIndex Index of the block in program
+ * @throws runtime_error if the block has already been read from another program and is laid out differently
+ */
+void UniformBuffer::readLayout(const Gloop::Program& program, const GLuint blockIndex) {
+
+    // Get the size and the members
+    const GLuint id = program.id();
+    GLint size = 0;
+    glGetActiveUniformBlockiv(id, blockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &size);
+    GLint count = 0;
+    glGetActiveUniformBlockiv(id, blockIndex, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &count);
+    std::map<std::string,Member> layout;
+    if (count > 0) {
+        std::vector<GLint> indices(count);
+        glGetActiveUniformBlockiv(id, blockIndex, GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES, &indices[0]);
+        const std::vector<GLuint> uindices(indices.begin(), indices.end());
+
+        // Get where they are
+        std::vector<GLint> types(count);
+        std::vector<GLint> offsets(count);
+        std::vector<GLint> matrixStrides(count);
+        glGetActiveUniformsiv(id, count, &uindices[0], GL_UNIFORM_TYPE, &types[0]);
+        glGetActiveUniformsiv(id, count, &uindices[0], GL_UNIFORM_OFFSET, &offsets[0]);
+        glGetActiveUniformsiv(id, count, &uindices[0], GL_UNIFORM_MATRIX_STRIDE, &matrixStrides[0]);
+
+        // Store them by name
+        GLint maxLength = 0;
+        glGetProgramiv(id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+        std::vector<GLchar> name(maxLength + 1);
+        for (GLint i = 0; i < count; ++i) {
+            GLsizei length = 0;
+            glGetActiveUniformName(id, uindices[i], name.size(), &length, &name[0]);
+            const Member member = { (GLenum) types[i], offsets[i], matrixStrides[i] };
+            layout[std::string(&name[0], length)] = member;
+        }
+    }
+
+    // Check it against the first program's layout
+    if (!data.empty()) {
+        if ((size != (GLint) data.size()) || (layout != members)) {
+            throw std::runtime_error("[UniformBuffer] Block is laid out differently in program!");
+        }
+        return;
+    }
+
+    // Otherwise keep it
+    if (layout.empty()) {
+        return;
+    }
+    members.swap(layout);
+    data.assign(size, 0);
+    dirty = true;
+}
+
+/**
+ * Writes the value of a member of the block, if a program declares the block and it has the member.
+ *
+ * Matrices should be in column-major order.
+ *
+ * @param program Program the value is being set for
+ * @param name Name of member
+ * @param type Type of value, e.g. `GL_FLOAT_MAT4`
+ * @param values Components of value
+ * @return `true` if the value was written, or `false` if program does not declare the block or it lacks the member
+ * @throws invalid_argument if type is not a float, vector or matrix type
+ * @throws runtime_error if the member has a different type, or the block is laid out differently in program
+ */
+bool UniformBuffer::setValue(const Gloop::Program& program,
+                             const std::string& name,
+                             const GLenum type,
+                             const GLfloat* const values) {
+
+    // Find member
+    if (!findBlock(program)) {
+        return false;
+    }
+    const std::map<std::string,Member>::const_iterator it = members.find(name);
+    if (it == members.end()) {
+        return false;
+    } else if (it->second.type != type) {
+        throw std::runtime_error("[UniformBuffer] Uniform is of wrong type!");
+    }
+
+    // Write it, one column at a time for matrices
+    const Member& member = it->second;
+    switch (type) {
+    case GL_FLOAT:
+        write(member.offset, values, 1);
+        break;
+    case GL_FLOAT_VEC2:
+        write(member.offset, values, 2);
+        break;
+    case GL_FLOAT_VEC3:
+        write(member.offset, values, 3);
+        break;
+    case GL_FLOAT_VEC4:
+        write(member.offset, values, 4);
+        break;
+    case GL_FLOAT_MAT3:
+        for (int i = 0; i < 3; ++i) {
+            write(member.offset + (i * member.matrixStride), values + (i * 3), 3);
+        }
+        break;
+    case GL_FLOAT_MAT4:
+        for (int i = 0; i < 4; ++i) {
+            write(member.offset + (i * member.matrixStride), values + (i * 4), 4);
+        }
+        break;
+    default:
+        throw std::invalid_argument("[UniformBuffer] Unsupported uniform type!");
+    }
+    return true;
+}
+
+/**
+ * Copies values into the block, marking it as changed if they differ.
+ *
+ * @param offset Offset in block to copy to
+ * @param values Values to copy
+ * @param count Number of values to copy
+ */
+void UniformBuffer::write(const GLint offset, const GLfloat* const values, const int count) {
+    const size_t size = count * sizeof(GLfloat);
+    if ((offset < 0) || (offset + size > data.size())) {
+        return;
+    }
+    char* const destination = &data[offset];
+    if (memcmp(destination, values, size) != 0) {
+        memcpy(destination, values, size);
+        dirty = true;
+    }
+}
+
+} /* namespace RapidGL */
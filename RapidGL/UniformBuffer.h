@@ -0,0 +1,114 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RAPIDGL_UNIFORM_BUFFER_H
+#define RAPIDGL_UNIFORM_BUFFER_H
+#include <map>
+#include <string>
+#include <vector>
+#include <gloop/BufferObject.hxx>
+#include <gloop/BufferTarget.hxx>
+#include <gloop/Program.hxx>
+#include "RapidGL/common.h"
+#include "RapidGL/GLStateCache.h"
+#include "RapidGL/RingBuffer.h"
+namespace RapidGL {
+
+
+/**
+ * Values of a uniform block, packed into a buffer bound to a fixed binding point.
+ *
+ * Uniform nodes whose uniform is not in the default block of the program in
+ * use look through the uniform buffers added to the `State`.  If the program
+ * declares the buffer's block and the block has a member with the node's
+ * name, the value is written into the buffer's copy of the block instead of
+ * being loaded with `glUniform*`.  Each program is told the block is at the
+ * buffer's binding point the first time it is seen, so one buffer serves
+ * every program declaring the block.
+ *
+ * The layout of the block is read from the first program that declares it.
+ * Blocks should be declared with `layout(std140)`, so every program lays them
+ * out the same way.  Values are only marked as changed if their bytes differ,
+ * so matrices shared by every object, like the view and projection matrices,
+ * are uploaded once per frame no matter how many programs set them.
+ *
+ * Before each draw, `bind` uploads the block if it changed and binds it
+ * through the `GLStateCache`.  With a `RingBuffer`, each upload is written to
+ * a new range of the current frame, so every object can have its own values
+ * without waiting for the GPU.  Otherwise the buffer's own storage is
+ * orphaned, which is only correct without a render queue, since queued draws
+ * would all see the last values.
+ */
+class UniformBuffer {
+public:
+// Types
+    /**
+     * Part of a buffer holding the block's current values.
+     */
+    struct Range {
+        GLuint buffer;
+        GLintptr offset;
+        GLsizeiptr size;
+    };
+// Methods
+    UniformBuffer(const std::string& blockName, GLuint binding);
+    virtual ~UniformBuffer();
+    void bind(GLStateCache& glStateCache, RingBuffer* ringBuffer);
+    Range flush(RingBuffer* ringBuffer);
+    GLuint getBinding() const;
+    std::string getBlockName() const;
+    GLsizeiptr getSize() const;
+    size_t getUploadCount() const;
+    bool hasMember(const std::string& name) const;
+    bool setValue(const Gloop::Program& program, const std::string& name, GLenum type, const GLfloat* values);
+private:
+// Types
+    /**
+     * Member of the block and where it is in the buffer.
+     */
+    struct Member {
+        GLenum type;
+        GLint offset;
+        GLint matrixStride;
+        bool operator==(const Member& member) const;
+    };
+// Constants
+    static const Gloop::BufferTarget uniformBuffer;
+// Attributes
+    const std::string blockName;
+    const GLuint binding;
+    const Gloop::BufferObject buffer;
+    GLint offsetAlignment;
+    std::map<std::string,Member> members;
+    std::vector<char> data;
+    std::map<Gloop::Program,bool> programs;
+    std::map<Gloop::Program,bool>::const_iterator lastProgram;
+    bool dirty;
+    Range range;
+    const RingBuffer* lastRingBuffer;
+    size_t lastFrameNumber;
+    size_t uploadCount;
+// Methods
+    UniformBuffer(const UniformBuffer&);
+    UniformBuffer& operator=(const UniformBuffer&);
+    bool findBlock(const Gloop::Program& program);
+    void readLayout(const Gloop::Program& program, GLuint blockIndex);
+    void write(GLint offset, const GLfloat* values, int count);
+};
+
+} /* namespace RapidGL */
+#endif
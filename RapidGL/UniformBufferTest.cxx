@@ -0,0 +1,320 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <cppunit/extensions/HelperMacros.h>
+#include <GL/glfw.h>
+#include <gloop/Program.hxx>
+#include <m3d/Mat4.h>
+#include "RapidGL/Mat4UniformNode.h"
+#include "RapidGL/ProgramNode.h"
+#include "RapidGL/RingBuffer.h"
+#include "RapidGL/SceneNode.h"
+#include "RapidGL/ShaderNode.h"
+#include "RapidGL/State.h"
+#include "RapidGL/UniformBuffer.h"
+#include "RapidGL/UseNode.h"
+#include "RapidGL/Visitor.h"
+
+
+/**
+ * Unit test for `UniformBuffer`.
+ */
+class UniformBufferTest {
+public:
+
+    /**
+     * Returns the source code for the vertex shader, which declares the block.
+     */
+    static std::string getVertexShaderSource() {
+        return
+            "#version 140\n"
+            "layout(std140) uniform Matrices {\n"
+            "  mat4 ViewMatrix;\n"
+            "  vec3 Tint;\n"
+            "  float Alpha;\n"
+            "};\n"
+            "in vec4 MCVertex;\n"
+            "out vec4 Color;\n"
+            "void main() {\n"
+            "  gl_Position = ViewMatrix * MCVertex;\n"
+            "  Color = vec4(Tint, Alpha);\n"
+            "}\n";
+    }
+
+    /**
+     * Returns the source code for the fragment shader.
+     */
+    static std::string getFragmentShaderSource() {
+        return
+            "#version 140\n"
+            "in vec4 Color;\n"
+            "out vec4 FragColor;\n"
+            "void main() {\n"
+            "  FragColor = Color;\n"
+            "}\n";
+    }
+
+    /**
+     * Reads a float back from the range a uniform buffer was last uploaded to.
+     *
+     * @param range Range the buffer was uploaded to
+     * @param offset Offset of float in range
+     * @return Float at offset
+     */
+    static GLfloat readFloat(const RapidGL::UniformBuffer::Range& range, const GLintptr offset) {
+        GLfloat value;
+        glBindBuffer(GL_UNIFORM_BUFFER, range.buffer);
+        glGetBufferSubData(GL_UNIFORM_BUFFER, range.offset + offset, sizeof(GLfloat), &value);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        return value;
+    }
+
+    // Root of scene
+    RapidGL::SceneNode sceneNode;
+
+    // Shader program
+    RapidGL::ProgramNode programNode;
+
+    // Vertex shader in program
+    RapidGL::ShaderNode vertexShaderNode;
+
+    // Fragment shader in program
+    RapidGL::ShaderNode fragmentShaderNode;
+
+    // Usage of program
+    RapidGL::UseNode useNode;
+
+    // Uniform in block
+    RapidGL::Mat4UniformNode uniformNode;
+
+    /**
+     * Constructs the test fixture.
+     */
+    UniformBufferTest() :
+            programNode("foo"),
+            vertexShaderNode(GL_VERTEX_SHADER, getVertexShaderSource()),
+            fragmentShaderNode(GL_FRAGMENT_SHADER, getFragmentShaderSource()),
+            useNode("foo"),
+            uniformNode("ViewMatrix", RapidGL::Mat4UniformNode::VIEW) {
+        sceneNode.addChild(&programNode);
+        programNode.addChild(&vertexShaderNode);
+        programNode.addChild(&fragmentShaderNode);
+        sceneNode.addChild(&useNode);
+        useNode.addChild(&uniformNode);
+    }
+
+    /**
+     * Links the program by visiting the scene without any uniform buffers.
+     */
+    void link() {
+        RapidGL::State state;
+        RapidGL::Visitor visitor(&state);
+        visitor.visit(&sceneNode);
+    }
+
+    /**
+     * Ensures `UniformBuffer::flush` only uploads the block when it changed.
+     */
+    void testFlush() {
+
+        link();
+        RapidGL::UniformBuffer uniformBuffer("Matrices", 0);
+        const GLfloat alpha = 0.5f;
+        uniformBuffer.setValue(programNode.getProgram(), "Alpha", GL_FLOAT, &alpha);
+
+        // Flush twice
+        const RapidGL::UniformBuffer::Range range = uniformBuffer.flush(NULL);
+        uniformBuffer.flush(NULL);
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, uniformBuffer.getUploadCount());
+        CPPUNIT_ASSERT_EQUAL(0.5f, readFloat(range, 76));
+
+        // Set same value, then a different one
+        uniformBuffer.setValue(programNode.getProgram(), "Alpha", GL_FLOAT, &alpha);
+        uniformBuffer.flush(NULL);
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, uniformBuffer.getUploadCount());
+        const GLfloat other = 0.25f;
+        uniformBuffer.setValue(programNode.getProgram(), "Alpha", GL_FLOAT, &other);
+        uniformBuffer.flush(NULL);
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, uniformBuffer.getUploadCount());
+        CPPUNIT_ASSERT_EQUAL(0.25f, readFloat(range, 76));
+    }
+
+    /**
+     * Ensures `UniformBuffer::flush` writes changes to new ranges of a ring buffer, and again each frame.
+     */
+    void testFlushWithRingBuffer() {
+
+        link();
+        RapidGL::RingBuffer ringBuffer(4096);
+        RapidGL::UniformBuffer uniformBuffer("Matrices", 0);
+        const GLfloat alpha = 0.5f;
+        uniformBuffer.setValue(programNode.getProgram(), "Alpha", GL_FLOAT, &alpha);
+
+        // Flush twice, then after a change
+        ringBuffer.beginFrame();
+        const RapidGL::UniformBuffer::Range first = uniformBuffer.flush(&ringBuffer);
+        CPPUNIT_ASSERT_EQUAL(first.offset, uniformBuffer.flush(&ringBuffer).offset);
+        const GLfloat other = 0.25f;
+        uniformBuffer.setValue(programNode.getProgram(), "Alpha", GL_FLOAT, &other);
+        const RapidGL::UniformBuffer::Range second = uniformBuffer.flush(&ringBuffer);
+        CPPUNIT_ASSERT(second.offset > first.offset);
+        CPPUNIT_ASSERT_EQUAL(ringBuffer.getBuffer().id(), second.buffer);
+        ringBuffer.endFrame();
+        CPPUNIT_ASSERT_EQUAL(0.5f, readFloat(first, 76));
+        CPPUNIT_ASSERT_EQUAL(0.25f, readFloat(second, 76));
+
+        // Flush in next frame
+        ringBuffer.beginFrame();
+        uniformBuffer.flush(&ringBuffer);
+        ringBuffer.endFrame();
+        CPPUNIT_ASSERT_EQUAL((size_t) 3, uniformBuffer.getUploadCount());
+    }
+
+    /**
+     * Ensures `UniformBuffer::setValue` reads the std140 layout of the block from the program.
+     */
+    void testSetValue() {
+        link();
+        RapidGL::UniformBuffer uniformBuffer("Matrices", 0);
+        const GLfloat tint[] = { 1, 2, 3 };
+        CPPUNIT_ASSERT(uniformBuffer.setValue(programNode.getProgram(), "Tint", GL_FLOAT_VEC3, tint));
+        CPPUNIT_ASSERT_EQUAL((GLsizeiptr) 80, uniformBuffer.getSize());
+        CPPUNIT_ASSERT(uniformBuffer.hasMember("ViewMatrix"));
+        CPPUNIT_ASSERT_EQUAL(3.0f, readFloat(uniformBuffer.flush(NULL), 72));
+    }
+
+    /**
+     * Ensures `UniformBuffer::setValue` throws if another program lays out the block differently with the same size.
+     */
+    void testSetValueWithDifferentLayout() {
+
+        // Make program declaring the members in another order
+        RapidGL::ShaderNode otherVertexShaderNode(
+                GL_VERTEX_SHADER,
+                "#version 140\n"
+                "layout(std140) uniform Matrices {\n"
+                "  vec3 Tint;\n"
+                "  float Alpha;\n"
+                "  mat4 ViewMatrix;\n"
+                "};\n"
+                "in vec4 MCVertex;\n"
+                "out vec4 Color;\n"
+                "void main() {\n"
+                "  gl_Position = ViewMatrix * MCVertex;\n"
+                "  Color = vec4(Tint, Alpha);\n"
+                "}\n");
+        RapidGL::ShaderNode otherFragmentShaderNode(GL_FRAGMENT_SHADER, getFragmentShaderSource());
+        RapidGL::ProgramNode otherProgramNode("bar");
+        otherProgramNode.addChild(&otherVertexShaderNode);
+        otherProgramNode.addChild(&otherFragmentShaderNode);
+        RapidGL::State state;
+        otherProgramNode.preVisit(state);
+
+        // Set value in first program, then in the other
+        link();
+        const GLfloat alpha = 0.5f;
+        RapidGL::UniformBuffer uniformBuffer("Matrices", 0);
+        CPPUNIT_ASSERT(uniformBuffer.setValue(programNode.getProgram(), "Alpha", GL_FLOAT, &alpha));
+        CPPUNIT_ASSERT_THROW(
+                uniformBuffer.setValue(otherProgramNode.getProgram(), "Alpha", GL_FLOAT, &alpha),
+                std::runtime_error);
+    }
+
+    /**
+     * Ensures `UniformBuffer::setValue` returns `false` for a block or member the program doesn't have.
+     */
+    void testSetValueWithMissingMember() {
+        link();
+        const GLfloat value = 1;
+        RapidGL::UniformBuffer uniformBuffer("Matrices", 0);
+        CPPUNIT_ASSERT(!uniformBuffer.setValue(programNode.getProgram(), "Missing", GL_FLOAT, &value));
+        RapidGL::UniformBuffer otherBuffer("Missing", 1);
+        CPPUNIT_ASSERT(!otherBuffer.setValue(programNode.getProgram(), "Alpha", GL_FLOAT, &value));
+        CPPUNIT_ASSERT_EQUAL((GLsizeiptr) 0, otherBuffer.getSize());
+    }
+
+    /**
+     * Ensures `UniformBuffer::setValue` throws if the member has a different type.
+     */
+    void testSetValueWithWrongType() {
+        link();
+        const GLfloat value[] = { 1, 2, 3, 4 };
+        RapidGL::UniformBuffer uniformBuffer("Matrices", 0);
+        CPPUNIT_ASSERT_THROW(
+                uniformBuffer.setValue(programNode.getProgram(), "Alpha", GL_FLOAT_VEC4, value),
+                std::runtime_error);
+    }
+
+    /**
+     * Ensures a `Mat4UniformNode` for a member of a block writes into the state's uniform buffer.
+     */
+    void testVisit() {
+
+        // Visit with a uniform buffer and a view matrix
+        RapidGL::UniformBuffer uniformBuffer("Matrices", 0);
+        RapidGL::State state;
+        state.addUniformBuffer(&uniformBuffer);
+        M3d::Mat4 viewMatrix(1);
+        viewMatrix[3][0] = 5;
+        state.setViewMatrix(viewMatrix);
+        RapidGL::Visitor visitor(&state);
+        visitor.visit(&sceneNode);
+
+        // Check translation landed in the fourth column
+        CPPUNIT_ASSERT_EQUAL(5.0f, readFloat(uniformBuffer.flush(NULL), 48));
+    }
+};
+
+int main(int argc, char* argv[]) {
+
+    // Initialize
+    if (!glfwInit()) {
+        throw std::runtime_error("Could not initialize GLFW!");
+    }
+
+    // Open window
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MAJOR, 3);
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MINOR, 2);
+    glfwOpenWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (!glfwOpenWindow(512, 512, 0, 0, 0, 0, 0, 0, GLFW_WINDOW)) {
+        throw std::runtime_error("Could not open window!");
+    }
+
+    // Run test
+    try {
+        UniformBufferTest test;
+        test.testFlush();
+        test.testFlushWithRingBuffer();
+        test.testSetValue();
+        test.testSetValueWithDifferentLayout();
+        test.testSetValueWithMissingMember();
+        test.testSetValueWithWrongType();
+        test.testVisit();
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        throw;
+    }
+
+    // Exit
+    glfwTerminate();
+    return 0;
+}
@@ -17,7 +17,9 @@
  */
 #include "config.h"
 #include <stdexcept>
+#include "RapidGL/UniformBuffer.h"
 #include "RapidGL/UniformNode.h"
+#include "RapidGL/UniformTable.h"
 namespace RapidGL {
 
 /**
@@ -27,10 +29,17 @@ namespace RapidGL {
  * @param type Data type of uniform, e.g. `GL_FLOAT` or `GL_FLOAT_VEC2`
  * @throws invalid_argument if name is empty
  */
-UniformNode::UniformNode(const std::string& name, const GLenum type) : name(name), type(type) {
+UniformNode::UniformNode(const std::string& name, const GLenum type) :
+        name(name),
+        slot(UniformTable::getSlot(name)),
+        lastEntry(0),
+        type(type),
+        uploadCount(0),
+        skipCount(0) {
     if (name.empty()) {
         throw std::invalid_argument("[UniformNode] Name is empty!");
     }
+    setHooks(VISIT);
 }
 
 /**
@@ -41,25 +50,39 @@ UniformNode::UniformNode(const std::string& name, const GLenum type) : name(name
  */
 GLint UniformNode::findLocationInProgram(const Gloop::Program& program) const {
 
-    // Get uniforms in program
-    const std::map<std::string,Gloop::Uniform> uniforms = program.activeUniforms();
-
-    // Lookup uniform by name
-    const std::map<std::string,Gloop::Uniform>::const_iterator it = uniforms.find(name);
-    if (it == uniforms.end()) {
+    // Lookup uniform by slot
+    const UniformTable::Uniform* const uniform = UniformTable::forProgram(program).find(slot);
+    if (uniform == NULL) {
         return -1;
     }
 
-    // Store uniform
-    const Gloop::Uniform uniform = it->second;
-
     // Check type
-    if (uniform.type() != type) {
+    if (uniform->type != type) {
         throw std::runtime_error("[UniformNode] Uniform is of wrong type!");
     }
 
     // Return location
-    return uniform.location();
+    return uniform->location;
+}
+
+/**
+ * Returns the location of this uniform in the program currently in use.
+ *
+ * Uses the render queue's program if the state has a render queue.
+ *
+ * @param state State that may have a render queue
+ * @return Location of this uniform in the program, or `-1` if it's not in the program or there is no program
+ * @throws std::runtime_error if uniform is in the program but has the wrong type
+ */
+GLint UniformNode::getLocationInCurrentProgram(const State& state) {
+    const RenderQueue* const renderQueue = state.getRenderQueue();
+    if (renderQueue == NULL) {
+        return getLocationInProgram(Gloop::Program::current());
+    } else if (renderQueue->hasProgram()) {
+        return getLocationInProgram(renderQueue->getProgram());
+    } else {
+        return -1;
+    }
 }
 
 /**
@@ -71,16 +94,24 @@ GLint UniformNode::findLocationInProgram(const Gloop::Program& program) const {
  */
 GLint UniformNode::getLocationInProgram(const Gloop::Program& program) {
 
-    // Look in cache first
-    const std::map<Gloop::Program,GLint>::const_iterator it = locations.find(program);
-    if (it != locations.end()) {
-        return it->second;
+    // Look in cache
+    const GLuint id = program.id();
+    if (id < entriesByProgram.size()) {
+        const int index = entriesByProgram[id];
+        if (index >= 0) {
+            lastEntry = index;
+            return entries[index].location;
+        }
+    } else {
+        entriesByProgram.resize(id + 1, -1);
     }
 
     // If not in cache find it, store it for next time, and then return it
-    const GLint location = findLocationInProgram(program);
-    locations.insert(std::pair<Gloop::Program,GLint>(program, location));
-    return location;
+    const Entry entry = { id, findLocationInProgram(program), 0, { 0, 0, 0 } };
+    lastEntry = entries.size();
+    entriesByProgram[id] = (int) lastEntry;
+    entries.push_back(entry);
+    return entry.location;
 }
 
 /**
@@ -92,6 +123,15 @@ std::string UniformNode::getName() const {
     return name;
 }
 
+/**
+ * Returns the number of times a value was not loaded because the program already had it.
+ *
+ * @return Number of times a value was not loaded because the program already had it
+ */
+size_t UniformNode::getSkipCount() const {
+    return skipCount;
+}
+
 /**
  * Returns the data type of this uniform.
  *
@@ -101,4 +141,109 @@ GLenum UniformNode::getType() const {
     return type;
 }
 
+/**
+ * Returns the number of times a value was loaded into a program without a render queue.
+ *
+ * @return Number of times a value was loaded into a program without a render queue
+ */
+size_t UniformNode::getUploadCount() const {
+    return uploadCount;
+}
+
+/**
+ * Forgets what was loaded into every program, so the value is loaded again the next time.
+ *
+ * Should be called by subclasses when their value changes.
+ */
+void UniformNode::invalidateUploads() {
+    for (std::vector<Entry>::iterator it = entries.begin(); it != entries.end(); ++it) {
+        it->state = 0;
+    }
+}
+
+/**
+ * Checks if a value that does not depend on any matrices should be loaded into the program last looked up.
+ *
+ * @param state State the value would be loaded with
+ * @return `true` if the value should be loaded
+ * @see isUploadNeeded(State&, const Stamp&)
+ */
+bool UniformNode::isUploadNeeded(State& state) {
+    const Stamp stamp = { 0, 0, 0 };
+    return isUploadNeeded(state, stamp);
+}
+
+/**
+ * Checks if a value should be loaded into the program whose location was last looked up.
+ *
+ * The value is not needed if this node loaded it last with the same state and
+ * the same matrix versions, and no other node loaded the uniform since.
+ * Otherwise the value is assumed to be loaded after this call.
+ *
+ * @param state State the value would be loaded with
+ * @param stamp Versions of the matrices the value would be computed from
+ * @return `true` if the value should be loaded
+ */
+bool UniformNode::isUploadNeeded(State& state, const Stamp& stamp) {
+
+    // Check if still in the program
+    Entry& entry = entries[lastEntry];
+    GLStateCache& glStateCache = state.getGLStateCache();
+    const bool claimed = glStateCache.claimUniform(entry.program, entry.location, this);
+    if (claimed
+            && (entry.state == state.getId())
+            && (entry.stamp.model == stamp.model)
+            && (entry.stamp.view == stamp.view)
+            && (entry.stamp.projection == stamp.projection)) {
+        ++skipCount;
+        return false;
+    }
+
+    // Remember what will be loaded
+    entry.state = state.getId();
+    entry.stamp = stamp;
+    ++uploadCount;
+    return true;
+}
+
+/**
+ * Sets the upload and skip counts back to zero.
+ */
+void UniformNode::resetCounts() {
+    uploadCount = 0;
+    skipCount = 0;
+}
+
+/**
+ * Writes a value into the first of the state's uniform buffers whose block has this uniform in the program in use.
+ *
+ * @param state State with uniform buffers and maybe a render queue
+ * @param values Components of value, with matrices in column-major order
+ * @return `true` if a uniform buffer took the value
+ * @throws runtime_error if the uniform is in a block but has the wrong type
+ */
+bool UniformNode::setValueInUniformBuffers(const State& state, const GLfloat* const values) {
+
+    // Check there are any
+    const std::vector<UniformBuffer*>& uniformBuffers = state.getUniformBuffers();
+    if (uniformBuffers.empty()) {
+        return false;
+    }
+
+    // Find the program
+    const RenderQueue* const renderQueue = state.getRenderQueue();
+    if ((renderQueue != NULL) && !renderQueue->hasProgram()) {
+        return false;
+    }
+    const Gloop::Program program = (renderQueue == NULL) ? Gloop::Program::current() : renderQueue->getProgram();
+
+    // Give it to the first buffer that has it
+    for (std::vector<UniformBuffer*>::const_iterator it = uniformBuffers.begin(); it != uniformBuffers.end(); ++it) {
+        if ((*it)->setValue(program, name, type, values)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 } /* namespace RapidGL */
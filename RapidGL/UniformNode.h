@@ -17,12 +17,13 @@
  */
 #ifndef RAPIDGL_UNIFORM_NODE_H
 #define RAPIDGL_UNIFORM_NODE_H
-#include <map>
 #include <string>
+#include <vector>
 #include <gloop/Program.hxx>
 #include "RapidGL/common.h"
 #include "RapidGL/Node.h"
 #include "RapidGL/ProgramNode.h"
+#include "RapidGL/RenderQueue.h"
 #include "RapidGL/State.h"
 #include "RapidGL/UseNode.h"
 namespace RapidGL {
@@ -30,21 +31,67 @@ namespace RapidGL {
 
 /**
  * Node representing a uniform variable in a shader program.
+ *
+ * Locations are found through the program's `UniformTable` the first time the
+ * node is visited with a program, and then kept in an array by program name.
+ *
+ * If the program in use has no uniform with the node's name in its default
+ * block, subclasses hand their value to the state's `UniformBuffer`s, so the
+ * uniform can instead be a member of a uniform block.
+ *
+ * When drawing without a render queue, subclasses only load their value if
+ * it may differ from the value they last loaded into the program.  Each value
+ * is stamped with the versions of the matrices it was computed from, and
+ * subclasses call `invalidateUploads` when their own value changes.  Which
+ * node last loaded each uniform is kept in the state's `GLStateCache`, so
+ * states drawing on one context must share a cache for this to be correct.
  */
 class UniformNode : public Node {
 public:
 // Methods
     UniformNode(const std::string& name, GLenum type);
     std::string getName() const;
+    size_t getSkipCount() const;
     GLenum getType() const;
+    size_t getUploadCount() const;
+    void resetCounts();
 protected:
+// Types
+    /**
+     * Versions of the matrices a value was computed from, or zero for those it does not use.
+     */
+    struct Stamp {
+        size_t model;
+        size_t view;
+        size_t projection;
+    };
 // Methods
+    GLint getLocationInCurrentProgram(const State& state);
     GLint getLocationInProgram(const Gloop::Program& program);
+    void invalidateUploads();
+    bool isUploadNeeded(State& state);
+    bool isUploadNeeded(State& state, const Stamp& stamp);
+    bool setValueInUniformBuffers(const State& state, const GLfloat* values);
 private:
+// Types
+    /**
+     * Location of the uniform in a program, and the identifier of the state and the stamp it was last loaded with.
+     */
+    struct Entry {
+        GLuint program;
+        GLint location;
+        size_t state;
+        Stamp stamp;
+    };
 // Attributes
     std::string name;
-    std::map<Gloop::Program,GLint> locations;
+    size_t slot;
+    std::vector<Entry> entries;
+    std::vector<int> entriesByProgram;
+    size_t lastEntry;
     GLenum type;
+    size_t uploadCount;
+    size_t skipCount;
 // Methods
     GLint findLocationInProgram(const Gloop::Program& program) const;
 };
@@ -17,12 +17,10 @@
  */
 #include "config.h"
 #include <stdexcept>
-#include <vector>
 #include "RapidGL/UniformNodeUnmarshaller.h"
 using std::map;
 using std::runtime_error;
 using std::string;
-using std::vector;
 namespace RapidGL {
 
 // Map of delegates
@@ -62,10 +60,10 @@ map<string,Unmarshaller*> UniformNodeUnmarshaller::createDelegatesByType() {
 /**
  * Creates a `FloatUniformNode`.
  *
- * @param attributes Map of XML attributes
+ * @param attributes Attributes of XML element
  * @return Pointer to the node
  */
-Node* UniformNodeUnmarshaller::FloatUniformNodeUnmarshaller::unmarshal(const map<string,string>& attributes) {
+Node* UniformNodeUnmarshaller::FloatUniformNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
 
     // Get name and value
     const std::string name = getName(attributes);
@@ -89,13 +87,13 @@ Node* UniformNodeUnmarshaller::FloatUniformNodeUnmarshaller::unmarshal(const map
 }
 
 /**
- * Finds the value of the _link_ attribute in a map.
+ * Finds the value of the _link_ attribute.
  *
- * @param attributes Map of attribute keys and values
+ * @param attributes Attributes of XML element
  * @return Value of the _link_ attribute
  * @throws runtime_error if value is unspecified or empty
  */
-string UniformNodeUnmarshaller::getLink(const map<string,string>& attributes) {
+string UniformNodeUnmarshaller::getLink(const AttributeView& attributes) {
     const string link = findValue(attributes, "link");
     if (link.empty()) {
         throw runtime_error("[UniformNodeUnmarshaller] Link is unspecified!");
@@ -104,13 +102,13 @@ string UniformNodeUnmarshaller::getLink(const map<string,string>& attributes) {
 }
 
 /**
- * Finds the value of the _name_ attribute in a map.
+ * Finds the value of the _name_ attribute.
  *
- * @param attributes Map of attribute keys and values
+ * @param attributes Attributes of XML element
  * @return Value of the _name_ attribute
  * @throws runtime_error if value is unspecified or empty
  */
-string UniformNodeUnmarshaller::getName(const map<string,string>& attributes) {
+string UniformNodeUnmarshaller::getName(const AttributeView& attributes) {
     const string name = findValue(attributes, "name");
     if (name.empty()) {
         throw runtime_error("[UniformNodeUnmarshaller] Name is unspecified!");
@@ -119,13 +117,13 @@ string UniformNodeUnmarshaller::getName(const map<string,string>& attributes) {
 }
 
 /**
- * Finds the value of the _type_ attribute in a map.
+ * Finds the value of the _type_ attribute.
  *
- * @param attributes Map of attribute keys and values
+ * @param attributes Attributes of XML element
  * @return Value of the _type_ attribute
  * @throws runtime_error if value is unspecified, empty, or invalid
  */
-string UniformNodeUnmarshaller::getType(const map<string,string>& attributes) {
+string UniformNodeUnmarshaller::getType(const AttributeView& attributes) {
     const string type = findValue(attributes, "type");
     if (type.empty()) {
         throw runtime_error("[UniformNodeUnmarshaller] Type is unspecified!");
@@ -136,13 +134,13 @@ string UniformNodeUnmarshaller::getType(const map<string,string>& attributes) {
 }
 
 /**
- * Finds the value of the _usage_ attribute in a map.
+ * Finds the value of the _usage_ attribute.
  *
- * @param attributes Map of attribute keys and values
+ * @param attributes Attributes of XML element
  * @return Value of the _usage_ attribute
  * @throws std::runtime_error if value is unspecified
  */
-std::string UniformNodeUnmarshaller::getUsage(const map<string,string>& attributes) {
+std::string UniformNodeUnmarshaller::getUsage(const AttributeView& attributes) {
     const std::string value = findValue(attributes, "usage");
     if (value.empty()) {
         throw std::runtime_error("[UniformNodeUnmarshaller] Usage is unspecified!");
@@ -152,12 +150,12 @@ std::string UniformNodeUnmarshaller::getUsage(const map<string,string>& attribut
 }
 
 /**
- * Finds the value of the _value_ attribute in a map.
+ * Finds the value of the _value_ attribute.
  *
- * @param attributes Map of attribute keys and values
+ * @param attributes Attributes of XML element
  * @return Value of the _value_ attribute
  */
-string UniformNodeUnmarshaller::getValue(const map<string,string>& attributes) {
+string UniformNodeUnmarshaller::getValue(const AttributeView& attributes) {
     return findValue(attributes, "value");
 }
 
@@ -175,10 +173,10 @@ bool UniformNodeUnmarshaller::isValidType(const string& str) {
 /**
  * Creates a `Mat3UniformNode`.
  *
- * @param attribute Map of XML attributes
+ * @param attribute Attributes of XML element
  * @return Pointer to the node
  */
-Node* UniformNodeUnmarshaller::Mat3UniformNodeUnmarshaller::unmarshal(const map<string,string>& attributes) {
+Node* UniformNodeUnmarshaller::Mat3UniformNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
 
     // Get name and value
     const std::string name = getName(attributes);
@@ -190,22 +188,20 @@ Node* UniformNodeUnmarshaller::Mat3UniformNodeUnmarshaller::unmarshal(const map<
         return node;
     }
 
-    // Tokenize value
-    const vector<string> tokens = tokenize(value);
-    if (tokens.size() != 9) {
-        throw std::runtime_error("[UniformNodeUnmarshaller] Value should have 9 tokens!");
-    }
-
-    // Parse tokens and set value
+    // Parse value
+    GLfloat arr[9];
+    size_t count;
     try {
-        GLfloat arr[9];
-        for (int i = 0; i < 9; ++i) {
-            arr[i] = parseFloat(tokens[i]);
-        }
-        node->setValue(M3d::Mat3::fromArrayInColumnMajor(arr));
+        count = parseFloats(value, arr, 9);
     } catch (std::invalid_argument& e) {
         throw std::runtime_error("[UniformNodeUnmarshaller] Value is invalid!");
     }
+    if (count != 9) {
+        throw std::runtime_error("[UniformNodeUnmarshaller] Value should have 9 tokens!");
+    }
+
+    // Set value
+    node->setValue(M3d::Mat3::fromArrayInColumnMajor(arr));
 
     // Return the node
     return node;
@@ -214,10 +210,10 @@ Node* UniformNodeUnmarshaller::Mat3UniformNodeUnmarshaller::unmarshal(const map<
 /**
  * Creates a `Mat4UniformNode`.
  *
- * @param attributes Map of XML attributes
+ * @param attributes Attributes of XML element
  * @return Pointer to the node
  */
-Node* UniformNodeUnmarshaller::Mat4UniformNodeUnmarshaller::unmarshal(const map<string,string>& attributes) {
+Node* UniformNodeUnmarshaller::Mat4UniformNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
     try {
         const std::string name = getName(attributes);
         const Mat4UniformNode::Usage usage = Mat4UniformNode::parseUsage(getUsage(attributes));
@@ -230,10 +226,10 @@ Node* UniformNodeUnmarshaller::Mat4UniformNodeUnmarshaller::unmarshal(const map<
 /**
  * Creates a `Sampler2dUniformNode`.
  *
- * @param attributes Map of XML attributes
+ * @param attributes Attributes of XML element
  * @return Pointer to the node
  */
-Node* UniformNodeUnmarshaller::Sampler2dUniformNodeUnmarshaller::unmarshal(const map<string,string>& attributes) {
+Node* UniformNodeUnmarshaller::Sampler2dUniformNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
 
     // Get name and link
     const std::string name = getName(attributes);
@@ -246,10 +242,10 @@ Node* UniformNodeUnmarshaller::Sampler2dUniformNodeUnmarshaller::unmarshal(const
 /**
  * Creates a `Sampler3dUniformNode`.
  *
- * @param attributes Map of XML attributes
+ * @param attributes Attributes of XML element
  * @return Pointer to the node
  */
-Node* UniformNodeUnmarshaller::Sampler3dUniformNodeUnmarshaller::unmarshal(const map<string,string>& attributes) {
+Node* UniformNodeUnmarshaller::Sampler3dUniformNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
 
     // Get name and link
     const std::string name = getName(attributes);
@@ -259,7 +255,7 @@ Node* UniformNodeUnmarshaller::Sampler3dUniformNodeUnmarshaller::unmarshal(const
     return new Sampler3dUniformNode(name, link);
 }
 
-Node* UniformNodeUnmarshaller::unmarshal(const map<string,string>& attributes) {
+Node* UniformNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
     const string type = getType(attributes);
     Unmarshaller* delegate = delegatesByType[type];
     return delegate->unmarshal(attributes);
@@ -268,10 +264,10 @@ Node* UniformNodeUnmarshaller::unmarshal(const map<string,string>& attributes) {
 /**
  * Creates a `Vec3UniformNode`.
  *
- * @param attributes Map of XML attributes
+ * @param attributes Attributes of XML element
  * @return Pointer to the node
  */
-Node* UniformNodeUnmarshaller::Vec3UniformNodeUnmarshaller::unmarshal(const map<string,string>& attributes) {
+Node* UniformNodeUnmarshaller::Vec3UniformNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
 
     // Get name and value
     const std::string name = getName(attributes);
@@ -283,22 +279,24 @@ Node* UniformNodeUnmarshaller::Vec3UniformNodeUnmarshaller::unmarshal(const map<
         return node;
     }
 
-    // Tokenize value
-    const vector<string> tokens = tokenize(value);
-    if (tokens.size() != 3) {
-        throw std::runtime_error("[UniformNodeUnmarshaller] Value should have 3 tokens!");
-    }
-
-    // Parse tokens and set value
+    // Parse value
+    GLfloat arr[3];
+    size_t count;
     try {
-        M3d::Vec3 vec;
-        for (int i = 0; i < 3; ++i) {
-            vec[i] = parseFloat(tokens[i]);
-        }
-        node->setValue(vec);
+        count = parseFloats(value, arr, 3);
     } catch (std::invalid_argument& e) {
         throw std::runtime_error("[UniformNodeUnmarshaller] Component in value could not be parsed!");
     }
+    if (count != 3) {
+        throw std::runtime_error("[UniformNodeUnmarshaller] Value should have 3 tokens!");
+    }
+
+    // Set value
+    M3d::Vec3 vec;
+    for (int i = 0; i < 3; ++i) {
+        vec[i] = arr[i];
+    }
+    node->setValue(vec);
 
     // Return the node
     return node;
@@ -307,10 +305,10 @@ Node* UniformNodeUnmarshaller::Vec3UniformNodeUnmarshaller::unmarshal(const map<
 /**
  * Creates a `Vec4UniformNode`.
  *
- * @param attributes Map of XML attributes
+ * @param attributes Attributes of XML element
  * @return Pointer to the node
  */
-Node* UniformNodeUnmarshaller::Vec4UniformNodeUnmarshaller::unmarshal(const map<string,string>& attributes) {
+Node* UniformNodeUnmarshaller::Vec4UniformNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
 
     // Get name and value
     const std::string name = getName(attributes);
@@ -322,22 +320,24 @@ Node* UniformNodeUnmarshaller::Vec4UniformNodeUnmarshaller::unmarshal(const map<
         return node;
     }
 
-    // Tokenize value
-    const vector<string> tokens = tokenize(value);
-    if (tokens.size() != 4) {
-        throw std::runtime_error("[UniformNodeUnmarshaller] Value should have 4 tokens!");
-    }
-
-    // Parse tokens and set value
+    // Parse value
+    GLfloat arr[4];
+    size_t count;
     try {
-        M3d::Vec4 vec;
-        for (int i = 0; i < 4; ++i) {
-            vec[i] = parseFloat(tokens[i]);
-        }
-        node->setValue(vec);
+        count = parseFloats(value, arr, 4);
     } catch (std::invalid_argument& e) {
         throw std::runtime_error("[UniformNodeUnmarshaller] Value is invalid!");
     }
+    if (count != 4) {
+        throw std::runtime_error("[UniformNodeUnmarshaller] Value should have 4 tokens!");
+    }
+
+    // Set value
+    M3d::Vec4 vec;
+    for (int i = 0; i < 4; ++i) {
+        vec[i] = arr[i];
+    }
+    node->setValue(vec);
 
     // Return the node
     return node;
@@ -38,39 +38,39 @@ class UniformNodeUnmarshaller : public Unmarshaller {
 public:
     UniformNodeUnmarshaller();
     virtual ~UniformNodeUnmarshaller();
-    virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+    virtual Node* unmarshal(const AttributeView& attributes);
 private:
 // Types
     struct FloatUniformNodeUnmarshaller : public Unmarshaller {
-        virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+        virtual Node* unmarshal(const AttributeView& attributes);
     };
     struct Mat3UniformNodeUnmarshaller : public Unmarshaller {
-        virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+        virtual Node* unmarshal(const AttributeView& attributes);
     };
     struct Mat4UniformNodeUnmarshaller : public Unmarshaller {
-        virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+        virtual Node* unmarshal(const AttributeView& attributes);
     };
     struct Sampler2dUniformNodeUnmarshaller : public Unmarshaller {
-        virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+        virtual Node* unmarshal(const AttributeView& attributes);
     };
     struct Sampler3dUniformNodeUnmarshaller : public Unmarshaller {
-        virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+        virtual Node* unmarshal(const AttributeView& attributes);
     };
     struct Vec3UniformNodeUnmarshaller : public Unmarshaller {
-        virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+        virtual Node* unmarshal(const AttributeView& attributes);
     };
     struct Vec4UniformNodeUnmarshaller : public Unmarshaller {
-        virtual Node* unmarshal(const std::map<std::string,std::string>& attributes);
+        virtual Node* unmarshal(const AttributeView& attributes);
     };
 // Constants
     static std::map<std::string,Unmarshaller*> delegatesByType;
 // Methods
     static std::map<std::string,Unmarshaller*> createDelegatesByType();
-    static std::string getLink(const std::map<std::string,std::string>& attributes);
-    static std::string getUsage(const std::map<std::string,std::string>& attributes);
-    static std::string getName(const std::map<std::string,std::string>& attributes);
-    static std::string getType(const std::map<std::string,std::string>& attributes);
-    static std::string getValue(const std::map<std::string,std::string>& attributes);
+    static std::string getLink(const AttributeView& attributes);
+    static std::string getUsage(const AttributeView& attributes);
+    static std::string getName(const AttributeView& attributes);
+    static std::string getType(const AttributeView& attributes);
+    static std::string getValue(const AttributeView& attributes);
     static bool isValidType(const std::string& str);
 };
 
@@ -0,0 +1,138 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include "RapidGL/UniformTable.h"
+namespace RapidGL {
+
+// Slot of each uniform name seen so far
+std::map<std::string,size_t> UniformTable::slotsByName;
+
+// Table of each program, by program name
+std::vector<UniformTable*> UniformTable::tablesByProgram;
+
+/**
+ * Constructs a table by looking up the active uniforms of a program.
+ *
+ * Uniforms in uniform blocks are left out, since they have no location.
+ *
+ * @param program Linked program to look up uniforms in
+ */
+UniformTable::UniformTable(const Gloop::Program& program) : size(0) {
+
+    // Get uniforms in program
+    const std::map<std::string,Gloop::Uniform> uniforms = program.activeUniforms();
+
+    // Store each by the slot of its name
+    for (std::map<std::string,Gloop::Uniform>::const_iterator it = uniforms.begin(); it != uniforms.end(); ++it) {
+        const GLint location = it->second.location();
+        if (location < 0) {
+            continue;
+        }
+        const size_t slot = getSlot(it->first);
+        if (slot >= uniformsBySlot.size()) {
+            const Uniform missing = { -1, GL_NONE };
+            uniformsBySlot.resize(slot + 1, missing);
+        }
+        uniformsBySlot[slot].location = location;
+        uniformsBySlot[slot].type = it->second.type();
+        ++size;
+    }
+}
+
+/**
+ * Makes the table of a program that was just linked, replacing any table made for it before.
+ *
+ * @param program Program that was just linked
+ * @return Reference to table of program
+ */
+const UniformTable& UniformTable::create(const Gloop::Program& program) {
+    release(program);
+    const GLuint id = program.id();
+    if (id >= tablesByProgram.size()) {
+        tablesByProgram.resize(id + 1, NULL);
+    }
+    tablesByProgram[id] = new UniformTable(program);
+    return *tablesByProgram[id];
+}
+
+/**
+ * Finds the uniform with a slot.
+ *
+ * @param slot Slot of uniform's name
+ * @return Pointer to location and type of uniform, or `NULL` if the program does not have it
+ */
+const UniformTable::Uniform* UniformTable::find(const size_t slot) const {
+    if ((slot >= uniformsBySlot.size()) || (uniformsBySlot[slot].location < 0)) {
+        return NULL;
+    }
+    return &uniformsBySlot[slot];
+}
+
+/**
+ * Returns the table of a program, making it if there is not one yet.
+ *
+ * @param program Linked program to get table of
+ * @return Reference to table of program
+ */
+const UniformTable& UniformTable::forProgram(const Gloop::Program& program) {
+    const GLuint id = program.id();
+    if ((id < tablesByProgram.size()) && (tablesByProgram[id] != NULL)) {
+        return *tablesByProgram[id];
+    }
+    return create(program);
+}
+
+/**
+ * Returns the number of uniforms in the table.
+ *
+ * @return Number of uniforms in the table
+ */
+size_t UniformTable::getSize() const {
+    return size;
+}
+
+/**
+ * Returns the slot of a uniform name, giving it the next slot if it has not been seen before.
+ *
+ * @param name Name of uniform as declared in the shader
+ * @return Slot of uniform name
+ */
+size_t UniformTable::getSlot(const std::string& name) {
+    const std::map<std::string,size_t>::const_iterator it = slotsByName.find(name);
+    if (it != slotsByName.end()) {
+        return it->second;
+    }
+    const size_t slot = slotsByName.size();
+    slotsByName.insert(std::pair<std::string,size_t>(name, slot));
+    return slot;
+}
+
+/**
+ * Deletes the table of a program, if it has one.
+ *
+ * @param program Program about to be deleted or linked again
+ */
+void UniformTable::release(const Gloop::Program& program) {
+    const GLuint id = program.id();
+    if (id < tablesByProgram.size()) {
+        delete tablesByProgram[id];
+        tablesByProgram[id] = NULL;
+    }
+}
+
+} /* namespace RapidGL */
@@ -0,0 +1,72 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RAPIDGL_UNIFORM_TABLE_H
+#define RAPIDGL_UNIFORM_TABLE_H
+#include <map>
+#include <string>
+#include <vector>
+#include <gloop/Program.hxx>
+#include "RapidGL/common.h"
+namespace RapidGL {
+
+
+/**
+ * Active uniforms of a linked program, indexed by slot.
+ *
+ * Every uniform name is given a slot, a small integer shared by all programs,
+ * the first time it is seen.  Uniform nodes look up their slot once when they
+ * are constructed, and each program's table is filled in once after the
+ * program is linked, so finding a uniform in a program is an array lookup
+ * rather than a search by name.
+ *
+ * Tables are kept by program name.  `ProgramNode` creates one when it links
+ * its program and releases it when the program is deleted.  Tables for other
+ * programs are created the first time they are asked for.  Like the rest of
+ * the scene, tables should only be created and released on one thread.
+ */
+class UniformTable {
+public:
+// Types
+    /**
+     * Location and type of a uniform in a program.
+     */
+    struct Uniform {
+        GLint location;
+        GLenum type;
+    };
+// Methods
+    static const UniformTable& create(const Gloop::Program& program);
+    const Uniform* find(size_t slot) const;
+    static const UniformTable& forProgram(const Gloop::Program& program);
+    size_t getSize() const;
+    static size_t getSlot(const std::string& name);
+    static void release(const Gloop::Program& program);
+private:
+// Attributes
+    std::vector<Uniform> uniformsBySlot;
+    size_t size;
+    static std::map<std::string,size_t> slotsByName;
+    static std::vector<UniformTable*> tablesByProgram;
+// Methods
+    UniformTable(const Gloop::Program& program);
+    UniformTable(const UniformTable&);
+    UniformTable& operator=(const UniformTable&);
+};
+
+} /* namespace RapidGL */
+#endif
@@ -0,0 +1,163 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include <GL/glfw.h>
+#include <gloop/Program.hxx>
+#include <iostream>
+#include <stdexcept>
+#include "RapidGL/ProgramNode.h"
+#include "RapidGL/SceneNode.h"
+#include "RapidGL/ShaderNode.h"
+#include "RapidGL/State.h"
+#include "RapidGL/UniformTable.h"
+#include "RapidGL/Visitor.h"
+
+
+/**
+ * Unit test for `UniformTable`.
+ */
+class UniformTableTest {
+public:
+
+    /**
+     * Returns the source code for the vertex shader.
+     */
+    static std::string getVertexShaderSource() {
+        return
+            "#version 140\n"
+            "uniform float Scale = 1.0;\n"
+            "in vec4 MCVertex;\n"
+            "void main() {\n"
+            "  gl_Position = vec4(MCVertex.xyz * Scale, 1.0);\n"
+            "}\n";
+    }
+
+    /**
+     * Returns the source code for the fragment shader.
+     */
+    static std::string getFragmentShaderSource() {
+        return
+            "#version 140\n"
+            "uniform vec4 Color = vec4(1);\n"
+            "out vec4 FragColor;\n"
+            "void main() {\n"
+            "  FragColor = Color;\n"
+            "}\n";
+    }
+
+    // Root of scene
+    RapidGL::SceneNode sceneNode;
+
+    // Program with uniforms
+    RapidGL::ProgramNode programNode;
+
+    // Vertex shader for program
+    RapidGL::ShaderNode vertexShaderNode;
+
+    // Fragment shader for program
+    RapidGL::ShaderNode fragmentShaderNode;
+
+    /**
+     * Constructs the test.
+     */
+    UniformTableTest() :
+            programNode("foo"),
+            vertexShaderNode(GL_VERTEX_SHADER, getVertexShaderSource()),
+            fragmentShaderNode(GL_FRAGMENT_SHADER, getFragmentShaderSource()) {
+        sceneNode.addChild(&programNode);
+        programNode.addChild(&vertexShaderNode);
+        programNode.addChild(&fragmentShaderNode);
+        RapidGL::State state;
+        RapidGL::Visitor visitor(&state);
+        visitor.visit(&sceneNode);
+    }
+
+    /**
+     * Ensures `UniformTable::find` returns the location and type of a uniform in the program.
+     */
+    void testFind() {
+        const Gloop::Program program = programNode.getProgram();
+        const RapidGL::UniformTable& table = RapidGL::UniformTable::forProgram(program);
+        const RapidGL::UniformTable::Uniform* const uniform = table.find(RapidGL::UniformTable::getSlot("Color"));
+        CPPUNIT_ASSERT(uniform != NULL);
+        CPPUNIT_ASSERT_EQUAL(program.uniformLocation("Color"), uniform->location);
+        CPPUNIT_ASSERT_EQUAL((GLenum) GL_FLOAT_VEC4, uniform->type);
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, table.getSize());
+    }
+
+    /**
+     * Ensures `UniformTable::find` returns `NULL` for a uniform not in the program.
+     */
+    void testFindWithMissingUniform() {
+        const RapidGL::UniformTable& table = RapidGL::UniformTable::forProgram(programNode.getProgram());
+        CPPUNIT_ASSERT(table.find(RapidGL::UniformTable::getSlot("Missing")) == NULL);
+    }
+
+    /**
+     * Ensures `UniformTable::getSlot` gives the same slot to the same name and different slots to different names.
+     */
+    void testGetSlot() {
+        const size_t first = RapidGL::UniformTable::getSlot("First");
+        const size_t second = RapidGL::UniformTable::getSlot("Second");
+        CPPUNIT_ASSERT(first != second);
+        CPPUNIT_ASSERT_EQUAL(first, RapidGL::UniformTable::getSlot("First"));
+    }
+
+    /**
+     * Ensures `UniformTable::forProgram` makes the table again after it is released.
+     */
+    void testRelease() {
+        const Gloop::Program program = programNode.getProgram();
+        RapidGL::UniformTable::release(program);
+        const RapidGL::UniformTable& table = RapidGL::UniformTable::forProgram(program);
+        CPPUNIT_ASSERT(table.find(RapidGL::UniformTable::getSlot("Scale")) != NULL);
+    }
+};
+
+int main(int argc, char* argv[]) {
+
+    // Initialize GLFW
+    if (!glfwInit()) {
+        throw std::runtime_error("Could not initialize GLFW!");
+    }
+
+    // Open window
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MAJOR, 3);
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MINOR, 2);
+    glfwOpenWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (!glfwOpenWindow(512, 512, 0, 0, 0, 0, 0, 0, GLFW_WINDOW)) {
+        throw std::runtime_error("Could not open GLFW window!");
+    }
+
+    // Run test
+    try {
+        UniformTableTest test;
+        test.testFind();
+        test.testFindWithMissingUniform();
+        test.testGetSlot();
+        test.testRelease();
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        throw;
+    }
+
+    // Exit
+    glfwTerminate();
+    return 0;
+}
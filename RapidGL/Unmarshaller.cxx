@@ -16,8 +16,12 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "config.h"
+#include <cmath>
+#include <limits>
+#include <locale>
 #include <sstream>
 #include <stdexcept>
+#include <stdint.h>
 #include "RapidGL/Unmarshaller.h"
 namespace RapidGL {
 
@@ -38,23 +42,34 @@ Unmarshaller::~Unmarshaller() {
 /**
  * Unmarshals a node from XML attributes.
  *
- * @param attributes Map of attribute keys and values
+ * @param attributes Attributes of XML element
  * @return New node instance for attributes, or `NULL` if could not be unmarshalled
  */
-Node* Unmarshaller::unmarshal(const std::map<std::string,std::string>& attributes) {
+Node* Unmarshaller::unmarshal(const AttributeView& attributes) {
     return NULL;
 }
 
 /**
- * Returns the value of a key in a map.
+ * Returns the value of an attribute.
  *
- * @param map Map of keys to values
- * @param key Key to get value for
- * @return Value of the key in the map, or the empty string if could not be found
+ * @param attributes Attributes to look in
+ * @param key Name of attribute to get value for
+ * @return Reference to the value of the attribute, or to the empty string if could not be found
  */
-std::string Unmarshaller::findValue(const std::map<std::string,std::string>& map, const std::string& key) {
-    const std::map<std::string,std::string>::const_iterator it = map.find(key);
-    return (it == map.end()) ? "" : it->second;
+const std::string& Unmarshaller::findValue(const AttributeView& attributes, const char* const key) {
+    static const std::string EMPTY;
+    const std::string* const value = attributes.find(key);
+    return (value == NULL) ? EMPTY : (*value);
+}
+
+/**
+ * Checks if a character separates tokens.
+ *
+ * @param c Character to check
+ * @return `true` if character is whitespace in the classic locale
+ */
+bool Unmarshaller::isSpace(const char c) {
+    return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\v') || (c == '\f') || (c == '\r');
 }
 
 /**
@@ -65,15 +80,71 @@ std::string Unmarshaller::findValue(const std::map<std::string,std::string>& map
  * @throws invalid_argument if string cannot be parsed as a valid float
  */
 GLfloat Unmarshaller::parseFloat(const std::string& str) {
-    std::stringstream stream(str);
-    stream.unsetf(std::ios_base::skipws);
+    const char* const begin = str.data();
+    return parseFloat(begin, begin + str.size());
+}
+
+/**
+ * Parses a float from a range of characters.
+ *
+ * The whole range must be a decimal number, optionally with a sign, fraction
+ * and exponent.  Leading and trailing whitespace are not allowed, and neither
+ * is a number too large for a float.  The locale is ignored.
+ *
+ * @param begin Pointer to first character
+ * @param end Pointer past last character
+ * @return Float parsed from range
+ * @throws invalid_argument if range cannot be parsed as a valid float
+ */
+GLfloat Unmarshaller::parseFloat(const char* const begin, const char* const end) {
     GLfloat value;
-    stream >> value;
-    if (stream.fail() || !stream.eof()) {
+    if (!toFloat(begin, end, value)) {
         throw std::invalid_argument("[Unmarshaller] String is not a valid float!");
-    } else {
-        return value;
     }
+    return value;
+}
+
+/**
+ * Parses several floats separated by whitespace from a string, without breaking it into tokens first.
+ *
+ * Values are only parsed if the string has the expected number of tokens.
+ *
+ * @param str String to parse
+ * @param values Array to store floats in
+ * @param count Number of floats expected
+ * @return Number of tokens in string, which should be checked against _count_
+ * @throws invalid_argument if string has _count_ tokens and one cannot be parsed as a valid float
+ */
+size_t Unmarshaller::parseFloats(const std::string& str, GLfloat* const values, const size_t count) {
+
+    const char* p = str.data();
+    const char* const end = p + str.size();
+    size_t tokens = 0;
+    bool valid = true;
+
+    // Parse each token while counting them
+    while (true) {
+        while ((p != end) && isSpace(*p)) {
+            ++p;
+        }
+        if (p == end) {
+            break;
+        }
+        const char* const token = p;
+        while ((p != end) && !isSpace(*p)) {
+            ++p;
+        }
+        if (valid && (tokens < count)) {
+            valid = toFloat(token, p, values[tokens]);
+        }
+        ++tokens;
+    }
+
+    // Only complain about values if there were the right number of them
+    if ((tokens == count) && !valid) {
+        throw std::invalid_argument("[Unmarshaller] String is not a valid float!");
+    }
+    return tokens;
 }
 
 /**
@@ -84,15 +155,198 @@ GLfloat Unmarshaller::parseFloat(const std::string& str) {
  * @throws invalid_argument if string cannot be parsed as a valid integer
  */
 GLint Unmarshaller::parseInt(const std::string& str) {
-    std::stringstream stream(str);
-    stream.unsetf(std::ios_base::skipws);
-    GLint value;
-    stream >> value;
-    if (stream.fail() || !stream.eof()) {
+    const char* const begin = str.data();
+    return parseInt(begin, begin + str.size());
+}
+
+/**
+ * Parses an integer from a range of characters.
+ *
+ * The whole range must be decimal digits, optionally with a sign.  Leading and
+ * trailing whitespace are not allowed, and neither is a number out of range.
+ *
+ * @param begin Pointer to first character
+ * @param end Pointer past last character
+ * @return Integer parsed from range
+ * @throws invalid_argument if range cannot be parsed as a valid integer
+ */
+GLint Unmarshaller::parseInt(const char* const begin, const char* const end) {
+
+    const char* p = begin;
+
+    // Sign
+    bool negative = false;
+    if ((p != end) && ((*p == '+') || (*p == '-'))) {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    // Digits, stopping once too large for any integer
+    const uint64_t limit = ((uint64_t) std::numeric_limits<GLint>::max()) + 1;
+    const char* const digits = p;
+    uint64_t magnitude = 0;
+    while ((p != end) && (*p >= '0') && (*p <= '9') && (magnitude <= limit)) {
+        magnitude = (magnitude * 10) + (*p - '0');
+        ++p;
+    }
+
+    // Check the whole range was used and the number fits
+    if ((p == digits) || (p != end) || (magnitude > (negative ? limit : (limit - 1)))) {
         throw std::invalid_argument("[Unmarshaller] String is not a valid integer!");
+    }
+    return negative ? ((GLint) -((int64_t) magnitude)) : ((GLint) magnitude);
+}
+
+/**
+ * Converts a range of characters to a float.
+ *
+ * Numbers with at most 19 significant digits and small exponents are computed
+ * exactly in double precision with a single rounding, and then rounded to a
+ * float.  That can only go wrong when the double lands exactly halfway between
+ * two floats, so those and anything else are given to the slow path.
+ *
+ * @param begin Pointer to first character
+ * @param end Pointer past last character
+ * @param value Float to store result in
+ * @return `true` if range is a valid float
+ */
+bool Unmarshaller::toFloat(const char* const begin, const char* const end, GLfloat& value) {
+
+    // Powers of ten that are exact in double precision
+    static const double POWERS_OF_TEN[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    static const int MAX_POWER_OF_TEN = 22;
+    static const int MAX_SIGNIFICANT_DIGITS = 19;
+    static const uint64_t MAX_EXACT_MANTISSA = ((uint64_t) 1) << 53;
+    static const int MAX_EXPONENT = 100000;
+
+    const char* p = begin;
+
+    // Sign
+    bool negative = false;
+    if ((p != end) && ((*p == '+') || (*p == '-'))) {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    // Integer part
+    uint64_t mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+    while ((p != end) && (*p >= '0') && (*p <= '9')) {
+        if ((mantissa != 0) || (*p != '0')) {
+            if (significantDigits < MAX_SIGNIFICANT_DIGITS) {
+                mantissa = (mantissa * 10) + (*p - '0');
+            } else {
+                ++exponent;
+            }
+            ++significantDigits;
+        }
+        hasDigits = true;
+        ++p;
+    }
+
+    // Fraction
+    if ((p != end) && (*p == '.')) {
+        ++p;
+        while ((p != end) && (*p >= '0') && (*p <= '9')) {
+            if ((mantissa != 0) || (*p != '0')) {
+                if (significantDigits < MAX_SIGNIFICANT_DIGITS) {
+                    mantissa = (mantissa * 10) + (*p - '0');
+                    --exponent;
+                }
+                ++significantDigits;
+            } else {
+                --exponent;
+            }
+            hasDigits = true;
+            ++p;
+        }
+    }
+    if (!hasDigits) {
+        return false;
+    }
+
+    // Exponent
+    if ((p != end) && ((*p == 'e') || (*p == 'E'))) {
+        ++p;
+        bool negativeExponent = false;
+        if ((p != end) && ((*p == '+') || (*p == '-'))) {
+            negativeExponent = (*p == '-');
+            ++p;
+        }
+        const char* const digits = p;
+        int explicitExponent = 0;
+        while ((p != end) && (*p >= '0') && (*p <= '9')) {
+            if (explicitExponent < MAX_EXPONENT) {
+                explicitExponent = (explicitExponent * 10) + (*p - '0');
+            }
+            ++p;
+        }
+        if (p == digits) {
+            return false;
+        }
+        exponent += negativeExponent ? -explicitExponent : explicitExponent;
+    }
+
+    // Must have used the whole range
+    if (p != end) {
+        return false;
+    }
+
+    // Zero
+    if (mantissa == 0) {
+        value = negative ? -0.0f : 0.0f;
+        return true;
+    }
+
+    // Use the slow path if the fast one might not round correctly
+    if ((significantDigits > MAX_SIGNIFICANT_DIGITS)
+            || (mantissa > MAX_EXACT_MANTISSA)
+            || (exponent < -MAX_POWER_OF_TEN)
+            || (exponent > MAX_POWER_OF_TEN)) {
+        return toFloatSlowly(begin, end, value);
+    }
+    double exact = (double) mantissa;
+    if (exponent < 0) {
+        exact /= POWERS_OF_TEN[-exponent];
     } else {
-        return value;
+        exact *= POWERS_OF_TEN[exponent];
     }
+    const GLfloat rounded = (GLfloat) exact;
+    if (((double) rounded) != exact) {
+        const GLfloat other = nextafterf(rounded, (((double) rounded) < exact) ? HUGE_VALF : 0.0f);
+        if ((((double) rounded) + ((double) other)) == (exact * 2)) {
+            return toFloatSlowly(begin, end, value);
+        }
+    }
+
+    // Too large
+    if (rounded > std::numeric_limits<GLfloat>::max()) {
+        return false;
+    }
+
+    value = negative ? -rounded : rounded;
+    return true;
+}
+
+/**
+ * Converts a range of characters to a float using a stream in the classic locale.
+ *
+ * @param begin Pointer to first character
+ * @param end Pointer past last character
+ * @param value Float to store result in
+ * @return `true` if range is a valid float
+ */
+bool Unmarshaller::toFloatSlowly(const char* const begin, const char* const end, GLfloat& value) {
+    std::istringstream stream(std::string(begin, end));
+    stream.imbue(std::locale::classic());
+    stream.unsetf(std::ios_base::skipws);
+    stream >> value;
+    return !stream.fail() && stream.eof();
 }
 
 /**
@@ -103,12 +357,20 @@ GLint Unmarshaller::parseInt(const std::string& str) {
  */
 std::vector<std::string> Unmarshaller::tokenize(const std::string& str) {
     std::vector<std::string> tokens;
-    std::stringstream stream(str);
-    std::string token;
-    stream >> token;
-    while (stream) {
-        tokens.push_back(token);
-        stream >> token;
+    const char* p = str.data();
+    const char* const end = p + str.size();
+    while (true) {
+        while ((p != end) && isSpace(*p)) {
+            ++p;
+        }
+        if (p == end) {
+            break;
+        }
+        const char* const token = p;
+        while ((p != end) && !isSpace(*p)) {
+            ++p;
+        }
+        tokens.push_back(std::string(token, p));
     }
     return tokens;
 }
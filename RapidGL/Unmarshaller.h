@@ -21,6 +21,7 @@
 #include <string>
 #include <vector>
 #include "RapidGL/common.h"
+#include "RapidGL/AttributeView.h"
 #include "RapidGL/Node.h"
 namespace RapidGL {
 
@@ -33,13 +34,21 @@ public:
 // Methods
     Unmarshaller();
     virtual ~Unmarshaller();
-    virtual Node* unmarshal(const std::map<std::string,std::string>& attributes) = 0;
+    virtual Node* unmarshal(const AttributeView& attributes) = 0;
 protected:
 // Methods
-    static std::string findValue(const std::map<std::string,std::string>& map, const std::string& key);
+    static const std::string& findValue(const AttributeView& attributes, const char* key);
     static GLfloat parseFloat(const std::string& str);
+    static GLfloat parseFloat(const char* begin, const char* end);
+    static size_t parseFloats(const std::string& str, GLfloat* values, size_t count);
     static GLint parseInt(const std::string& str);
+    static GLint parseInt(const char* begin, const char* end);
     static std::vector<std::string> tokenize(const std::string& str);
+private:
+// Methods
+    static bool isSpace(char c);
+    static bool toFloat(const char* begin, const char* end, GLfloat& value);
+    static bool toFloatSlowly(const char* begin, const char* end, GLfloat& value);
 // Friends
     friend class UnmarshallerTest;
 };
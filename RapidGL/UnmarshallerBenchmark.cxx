@@ -0,0 +1,158 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <Poco/Stopwatch.h>
+#include "RapidGL/Unmarshaller.h"
+
+
+/**
+ * Benchmark comparing `Unmarshaller`'s parsing with parsing through streams.
+ *
+ * Values look like the _value_ attributes of `mat3` uniforms in generated
+ * scenes, nine floats printed with enough digits to round-trip.
+ */
+class UnmarshallerBenchmark : public RapidGL::Unmarshaller {
+public:
+
+    // Number of values to parse
+    static const int COUNT = 100000;
+
+    // Number of floats in each value
+    static const int FLOATS = 9;
+
+    // Values to parse
+    std::vector<std::string> values;
+
+    /**
+     * Constructs the benchmark, making the values to parse.
+     */
+    UnmarshallerBenchmark() {
+        char buffer[32];
+        for (int i = 0; i < COUNT; ++i) {
+            std::string value;
+            for (int j = 0; j < FLOATS; ++j) {
+                sprintf(buffer, "%.9g ", ((i * FLOATS) + j) * 0.0137 - 500.0);
+                value += buffer;
+            }
+            values.push_back(value);
+        }
+    }
+
+    /**
+     * Does nothing, only here to complete the interface.
+     */
+    virtual RapidGL::Node* unmarshal(const RapidGL::AttributeView& attributes) {
+        return NULL;
+    }
+
+    /**
+     * Parses a float using a stream, the way `Unmarshaller` used to.
+     *
+     * @param str String to parse
+     * @return Float parsed from string
+     */
+    static GLfloat parseFloatWithStream(const std::string& str) {
+        std::stringstream stream(str);
+        stream.unsetf(std::ios_base::skipws);
+        GLfloat value;
+        stream >> value;
+        if (stream.fail() || !stream.eof()) {
+            throw std::invalid_argument("[UnmarshallerBenchmark] String is not a valid float!");
+        }
+        return value;
+    }
+
+    /**
+     * Breaks up a string into tokens using a stream, the way `Unmarshaller` used to.
+     *
+     * @param str String to break up into tokens
+     * @return Vector of tokens
+     */
+    static std::vector<std::string> tokenizeWithStream(const std::string& str) {
+        std::vector<std::string> tokens;
+        std::stringstream stream(str);
+        std::string token;
+        stream >> token;
+        while (stream) {
+            tokens.push_back(token);
+            stream >> token;
+        }
+        return tokens;
+    }
+
+    /**
+     * Times parsing the values each way and prints the results.
+     */
+    void run() {
+
+        Poco::Stopwatch stopwatch;
+        GLfloat arr[FLOATS];
+        GLfloat sum = 0;
+
+        // Streams
+        stopwatch.restart();
+        for (std::vector<std::string>::const_iterator it = values.begin(); it != values.end(); ++it) {
+            const std::vector<std::string> tokens = tokenizeWithStream(*it);
+            for (int i = 0; i < FLOATS; ++i) {
+                arr[i] = parseFloatWithStream(tokens[i]);
+            }
+            sum += arr[0];
+        }
+        stopwatch.stop();
+        const double streamTime = ((double) stopwatch.elapsed()) / 1000;
+
+        // Tokens
+        stopwatch.restart();
+        for (std::vector<std::string>::const_iterator it = values.begin(); it != values.end(); ++it) {
+            const std::vector<std::string> tokens = tokenize(*it);
+            for (int i = 0; i < FLOATS; ++i) {
+                arr[i] = parseFloat(tokens[i]);
+            }
+            sum += arr[0];
+        }
+        stopwatch.stop();
+        const double tokenTime = ((double) stopwatch.elapsed()) / 1000;
+
+        // In place
+        stopwatch.restart();
+        for (std::vector<std::string>::const_iterator it = values.begin(); it != values.end(); ++it) {
+            parseFloats(*it, arr, FLOATS);
+            sum += arr[0];
+        }
+        stopwatch.stop();
+        const double inPlaceTime = ((double) stopwatch.elapsed()) / 1000;
+
+        // Print results
+        std::cout << COUNT << " values of " << FLOATS << " floats (checksum " << sum << ")" << std::endl;
+        std::cout << "  streams:     " << streamTime << " ms" << std::endl;
+        std::cout << "  tokenize:    " << tokenTime << " ms" << std::endl;
+        std::cout << "  parseFloats: " << inPlaceTime << " ms" << std::endl;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    UnmarshallerBenchmark benchmark;
+    benchmark.run();
+    return 0;
+}
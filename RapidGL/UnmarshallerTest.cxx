@@ -1,4 +1,5 @@
 #include "config.h"
+#include <limits>
 #include <map>
 #include <string>
 #include <vector>
@@ -81,6 +82,74 @@ public:
         CPPUNIT_ASSERT_THROW(Unmarshaller::parseFloat("  1.0"), std::invalid_argument);
     }
 
+    /**
+     * Ensures `Unmarshaller::parseFloat` works with a sign, fraction and exponent.
+     */
+    void testParseFloatWithExponent() {
+        CPPUNIT_ASSERT_EQUAL(-1.5e-3f, Unmarshaller::parseFloat("-1.5e-3"));
+        CPPUNIT_ASSERT_EQUAL(250.0f, Unmarshaller::parseFloat("+.25E3"));
+        CPPUNIT_ASSERT_EQUAL(5.0f, Unmarshaller::parseFloat("5."));
+    }
+
+    /**
+     * Ensures `Unmarshaller::parseFloat` throws if passed an incomplete number.
+     */
+    void testParseFloatWithIncomplete() {
+        CPPUNIT_ASSERT_THROW(Unmarshaller::parseFloat(""), std::invalid_argument);
+        CPPUNIT_ASSERT_THROW(Unmarshaller::parseFloat("-"), std::invalid_argument);
+        CPPUNIT_ASSERT_THROW(Unmarshaller::parseFloat("."), std::invalid_argument);
+        CPPUNIT_ASSERT_THROW(Unmarshaller::parseFloat("1e"), std::invalid_argument);
+        CPPUNIT_ASSERT_THROW(Unmarshaller::parseFloat("1e+"), std::invalid_argument);
+        CPPUNIT_ASSERT_THROW(Unmarshaller::parseFloat("1.2.3"), std::invalid_argument);
+    }
+
+    /**
+     * Ensures `Unmarshaller::parseFloat` rounds to the nearest float when the digits are halfway between two.
+     */
+    void testParseFloatWithHalfway() {
+        CPPUNIT_ASSERT_EQUAL(16777216.0f, Unmarshaller::parseFloat("16777217"));
+        CPPUNIT_ASSERT_EQUAL(16777220.0f, Unmarshaller::parseFloat("16777219"));
+        CPPUNIT_ASSERT_EQUAL(1.0f, Unmarshaller::parseFloat("1.00000005960464477539062500"));
+    }
+
+    /**
+     * Ensures `Unmarshaller::parseFloat` throws if passed a number too large for a float.
+     */
+    void testParseFloatWithTooLarge() {
+        CPPUNIT_ASSERT_EQUAL(std::numeric_limits<GLfloat>::max(), Unmarshaller::parseFloat("3.4028235e38"));
+        CPPUNIT_ASSERT_THROW(Unmarshaller::parseFloat("3.4028236e38"), std::invalid_argument);
+        CPPUNIT_ASSERT_THROW(Unmarshaller::parseFloat("1e39"), std::invalid_argument);
+    }
+
+    /**
+     * Ensures `Unmarshaller::parseFloats` parses each token of a string.
+     */
+    void testParseFloatsWithValid() {
+        GLfloat values[3];
+        CPPUNIT_ASSERT_EQUAL((size_t) 3, Unmarshaller::parseFloats(" 1\t-2.5\n3e1 ", values, 3));
+        CPPUNIT_ASSERT_EQUAL(1.0f, values[0]);
+        CPPUNIT_ASSERT_EQUAL(-2.5f, values[1]);
+        CPPUNIT_ASSERT_EQUAL(30.0f, values[2]);
+    }
+
+    /**
+     * Ensures `Unmarshaller::parseFloats` returns the number of tokens if it is not the number expected.
+     */
+    void testParseFloatsWithWrongCount() {
+        GLfloat values[3];
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, Unmarshaller::parseFloats("", values, 3));
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, Unmarshaller::parseFloats("1 x", values, 3));
+        CPPUNIT_ASSERT_EQUAL((size_t) 4, Unmarshaller::parseFloats("1 2 3 x", values, 3));
+    }
+
+    /**
+     * Ensures `Unmarshaller::parseFloats` throws if one of the tokens is not a valid float.
+     */
+    void testParseFloatsWithInvalid() {
+        GLfloat values[3];
+        CPPUNIT_ASSERT_THROW(Unmarshaller::parseFloats("1 2,0 3", values, 3), std::invalid_argument);
+    }
+
     /**
      * Ensures `Unmarshaller::parseInt` works with '1'.
      */
@@ -88,6 +157,17 @@ public:
         CPPUNIT_ASSERT_DOUBLES_EQUAL(1, Unmarshaller::parseInt("1"), TOLERANCE);
     }
 
+    /**
+     * Ensures `Unmarshaller::parseInt` works with the smallest and largest integers, and throws past them.
+     */
+    void testParseIntWithLimits() {
+        CPPUNIT_ASSERT_EQUAL(std::numeric_limits<GLint>::max(), Unmarshaller::parseInt("2147483647"));
+        CPPUNIT_ASSERT_EQUAL(std::numeric_limits<GLint>::min(), Unmarshaller::parseInt("-2147483648"));
+        CPPUNIT_ASSERT_THROW(Unmarshaller::parseInt("2147483648"), std::invalid_argument);
+        CPPUNIT_ASSERT_THROW(Unmarshaller::parseInt("-2147483649"), std::invalid_argument);
+        CPPUNIT_ASSERT_THROW(Unmarshaller::parseInt("99999999999999999999"), std::invalid_argument);
+    }
+
     /**
      * Ensures `Unmarshaller::parseInt` throws if passed '1.0'.
      */
@@ -144,6 +224,16 @@ public:
         CPPUNIT_ASSERT_EQUAL(std::string("5"), tokens[4]);
     }
 
+    /**
+     * Ensures `Unmarshaller::tokenize` skips runs of spaces, tabs and newlines.
+     */
+    void testTokenizeWithWhitespace() {
+        const std::vector<std::string> tokens = Unmarshaller::tokenize("\t 1\n\n2 \r\n");
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, tokens.size());
+        CPPUNIT_ASSERT_EQUAL(std::string("1"), tokens[0]);
+        CPPUNIT_ASSERT_EQUAL(std::string("2"), tokens[1]);
+    }
+
     CPPUNIT_TEST_SUITE(UnmarshallerTest);
     CPPUNIT_TEST(testFindValueWithContained);
     CPPUNIT_TEST(testFindValueWithNotContained);
@@ -153,7 +243,15 @@ public:
     CPPUNIT_TEST(testParseFloatWithOneAndSpaces);
     CPPUNIT_TEST(testParseFloatWithSpaceAndOne);
     CPPUNIT_TEST(testParseFloatWithSpacesAndOne);
+    CPPUNIT_TEST(testParseFloatWithExponent);
+    CPPUNIT_TEST(testParseFloatWithIncomplete);
+    CPPUNIT_TEST(testParseFloatWithHalfway);
+    CPPUNIT_TEST(testParseFloatWithTooLarge);
+    CPPUNIT_TEST(testParseFloatsWithValid);
+    CPPUNIT_TEST(testParseFloatsWithWrongCount);
+    CPPUNIT_TEST(testParseFloatsWithInvalid);
     CPPUNIT_TEST(testParseIntWithOne);
+    CPPUNIT_TEST(testParseIntWithLimits);
     CPPUNIT_TEST(testParseIntWithOnePointZero);
     CPPUNIT_TEST(testParseIntWithOneAndSpace);
     CPPUNIT_TEST(testParseIntWithOneAndSpaces);
@@ -161,6 +259,7 @@ public:
     CPPUNIT_TEST(testParseIntWithSpacesAndOne);
     CPPUNIT_TEST(testTokenizeWithEmptyString);
     CPPUNIT_TEST(testTokenizeWithOneThroughFive);
+    CPPUNIT_TEST(testTokenizeWithWhitespace);
     CPPUNIT_TEST_SUITE_END();
 };
 
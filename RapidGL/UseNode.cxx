@@ -52,17 +52,27 @@ ProgramNode* UseNode::getProgramNode() const {
  * Activates the program that was in use before this node.
  */
 void UseNode::postVisit(State& state) {
-    if (lastUseNode == NULL) {
-        glUseProgram(0);
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    if (renderQueue == NULL) {
+        GLStateCache& glStateCache = state.getGLStateCache();
+        if (lastUseNode == NULL) {
+            glStateCache.clearProgram();
+        } else {
+            glStateCache.useProgram(lastUseNode->programNode->getProgram());
+        }
     } else {
-        lastUseNode->programNode->getProgram().use();
+        if (lastUseNode == NULL) {
+            renderQueue->clearProgram();
+        } else {
+            renderQueue->useProgram(lastUseNode->programNode->getProgram());
+        }
     }
 }
 
 /**
  * Finds the program node to use and the `UseNode` above this one in the scene if any.
  */
-void UseNode::preVisit(State& state) {
+void UseNode::prepare(State& state) {
     
     // Skip if already found program node
     if (programNode != NULL) {
@@ -89,13 +99,28 @@ void UseNode::preVisit(State& state) {
 
     // Find the last use node
     lastUseNode = findAncestor<UseNode>(this);
+
+    // Nothing left to do before being visited
+    setHooks(getHooks() & ~PRE_VISIT);
+}
+
+/**
+ * Prepares this node if it was not prepared before being visited.
+ */
+void UseNode::preVisit(State& state) {
+    prepare(state);
 }
 
 /**
  * Activates the program of the specified `ProgramNode`.
  */
 void UseNode::visit(State& state) {
-    programNode->getProgram().use();
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    if (renderQueue == NULL) {
+        state.getGLStateCache().useProgram(programNode->getProgram());
+    } else {
+        renderQueue->useProgram(programNode->getProgram());
+    }
 }
 
 } /* namespace RapidGL */
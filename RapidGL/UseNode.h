@@ -20,6 +20,7 @@
 #include "RapidGL/common.h"
 #include "RapidGL/Node.h"
 #include "RapidGL/ProgramNode.h"
+#include "RapidGL/RenderQueue.h"
 #include "RapidGL/State.h"
 namespace RapidGL {
 
@@ -34,6 +35,7 @@ public:
     virtual ~UseNode();
     ProgramNode* getProgramNode() const;
     virtual void postVisit(State& state);
+    virtual void prepare(State& state);
     virtual void preVisit(State& state);
     virtual void visit(State& state);
 private:
@@ -144,6 +144,20 @@ public:
         CPPUNIT_ASSERT_EQUAL((GLuint) 0, getCurrentProgram());
     }
 
+    /**
+     * Ensures `UseNode::prepare` removes the pre-visit hook once the program node is found.
+     */
+    void testPrepare() {
+        RapidGL::SceneNode sceneNode;
+        RapidGL::ProgramNode programNode("foo");
+        RapidGL::UseNode useNode("foo");
+        sceneNode.addChild(&programNode);
+        sceneNode.addChild(&useNode);
+        useNode.prepare(state);
+        CPPUNIT_ASSERT_EQUAL((RapidGL::ProgramNode*) &programNode, useNode.getProgramNode());
+        CPPUNIT_ASSERT_EQUAL((int) (RapidGL::Node::VISIT | RapidGL::Node::POST_VISIT), useNode.getHooks());
+    }
+
     /**
      * Ensures `UseNode::preVisit` throws if the node is the root of the scene.
      */
@@ -236,6 +250,7 @@ int main(int argc, char* argv[]) {
     try {
         UseNodeTest test;
         test.testPostVisit();
+        test.testPrepare();
         test.testPreVisitWhenNodeIsRoot();
         test.testPreVisitWhenProgramNodeIdIsNotInScene();
         test.testPreVisitWhenProgramNodeIdIsNotProgram();
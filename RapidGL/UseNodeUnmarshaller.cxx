@@ -33,7 +33,7 @@ UseNodeUnmarshaller::~UseNodeUnmarshaller() {
     // empty
 }
 
-Node* UseNodeUnmarshaller::unmarshal(const std::map<std::string,std::string>& attributes) {
+Node* UseNodeUnmarshaller::unmarshal(const AttributeView& attributes) {
 
     const std::string program = findValue(attributes, "program");
     if (program.empty()) {
@@ -57,13 +57,25 @@ M3d::Vec3 Vec3UniformNode::getValue() const {
  */
 void Vec3UniformNode::setValue(const M3d::Vec3& value) {
     this->value = value;
+    invalidateUploads();
     fireNodeChangedEvent();
 }
 
 void Vec3UniformNode::visit(State& state) {
-    const GLint location = getLocationInProgram(Gloop::Program::current());
-    if (location >= 0) {
-        glUniform3f(location, value.x, value.y, value.z);
+    const GLint location = getLocationInCurrentProgram(state);
+    if (location < 0) {
+        const GLfloat arr[3] = { (GLfloat) value.x, (GLfloat) value.y, (GLfloat) value.z };
+        setValueInUniformBuffers(state, arr);
+        return;
+    }
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    if (renderQueue == NULL) {
+        if (isUploadNeeded(state)) {
+            glUniform3f(location, value.x, value.y, value.z);
+        }
+    } else {
+        const GLfloat arr[3] = { (GLfloat) value.x, (GLfloat) value.y, (GLfloat) value.z };
+        renderQueue->setUniform(location, TYPE, arr);
     }
 }
 
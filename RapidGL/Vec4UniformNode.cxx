@@ -57,13 +57,25 @@ M3d::Vec4 Vec4UniformNode::getValue() const {
  */
 void Vec4UniformNode::setValue(const M3d::Vec4& value) {
     this->value = value;
+    invalidateUploads();
     fireNodeChangedEvent();
 }
 
 void Vec4UniformNode::visit(State& state) {
-    const GLint location = getLocationInProgram(Gloop::Program::current());
-    if (location >= 0) {
-        glUniform4f(location, value.x, value.y, value.z, value.w);
+    const GLint location = getLocationInCurrentProgram(state);
+    if (location < 0) {
+        const GLfloat arr[4] = { (GLfloat) value.x, (GLfloat) value.y, (GLfloat) value.z, (GLfloat) value.w };
+        setValueInUniformBuffers(state, arr);
+        return;
+    }
+    RenderQueue* const renderQueue = state.getRenderQueue();
+    if (renderQueue == NULL) {
+        if (isUploadNeeded(state)) {
+            glUniform4f(location, value.x, value.y, value.z, value.w);
+        }
+    } else {
+        const GLfloat arr[4] = { (GLfloat) value.x, (GLfloat) value.y, (GLfloat) value.z, (GLfloat) value.w };
+        renderQueue->setUniform(location, TYPE, arr);
     }
 }
 
@@ -0,0 +1,169 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <gloop/VertexAttribPointer.hxx>
+#include <glycerin/BufferLayout.hxx>
+#include <glycerin/BufferRegion.hxx>
+#include "RapidGL/AttributeNode.h"
+#include "RapidGL/ProgramNode.h"
+#include "RapidGL/VertexArrayCache.h"
+namespace RapidGL {
+
+/**
+ * Constructs an empty vertex array cache.
+ *
+ * @param geometry Geometry to point attributes at, which must outlive the cache
+ * @throws invalid_argument if geometry is `NULL`
+ */
+VertexArrayCache::VertexArrayCache(const Geometry* const geometry) :
+        geometry(geometry),
+        lastVao(vaos.end()) {
+    if (geometry == NULL) {
+        throw std::invalid_argument("[VertexArrayCache] Geometry is NULL!");
+    }
+}
+
+/**
+ * Destructs a vertex array cache, disposing of its vertex array objects.
+ */
+VertexArrayCache::~VertexArrayCache() {
+    forEachValue(vaos, &dispose);
+}
+
+/**
+ * Makes a vertex array object for a program.
+ *
+ * @param node Node drawing the geometry, whose root the program's node is found under
+ * @param program Program to point attributes of
+ * @param glStateCache Cache to bind the vertex array object through
+ * @return New vertex array object, which is left bound along with the index buffer
+ * @throws runtime_error if the program's node could not be found
+ */
+Gloop::VertexArrayObject VertexArrayCache::create(Node* const node,
+                                                  const Gloop::Program& program,
+                                                  GLStateCache& glStateCache) const {
+
+    // Find program node for program
+    const ProgramNode* const programNode = findProgramNode(findRoot(node), program);
+    if (programNode == NULL) {
+        throw std::runtime_error("[VertexArrayCache] Could not find program node for program!");
+    }
+
+    // Find attribute locations by usage
+    std::map<std::string,GLint> locationsByUsage;
+    const Node::node_range_t children = programNode->getChildren();
+    for (Node::node_iterator_t it = children.begin; it != children.end; ++it) {
+        const AttributeNode* const attributeNode = dynamic_cast<const AttributeNode*>(*it);
+        if (attributeNode != NULL) {
+            const GLint location = program.attribLocation(attributeNode->getName());
+            if (location != -1) {
+                locationsByUsage[AttributeNode::formatUsage(attributeNode->getUsage())] = location;
+            }
+        }
+    }
+
+    // Generate VAO and bind it with the buffers
+    const Gloop::VertexArrayObject vao = Gloop::VertexArrayObject::generate();
+    glStateCache.bindVertexArray(vao);
+    geometry->bind();
+
+    // Point attributes at regions named after their usages
+    const Glycerin::BufferLayout& layout = geometry->getLayout();
+    for (Glycerin::BufferLayout::const_iterator it = layout.begin(); it != layout.end(); ++it) {
+        if (containsKey(locationsByUsage, it->name())) {
+            const GLint location = getValueOfKey(locationsByUsage, it->name());
+            vao.enableVertexAttribArray(location);
+            vao.vertexAttribPointer(Gloop::VertexAttribPointer()
+                    .index(location)
+                    .size(it->components())
+                    .type(it->type())
+                    .normalized(it->normalized())
+                    .stride(it->stride())
+                    .offset(it->offset()));
+        }
+    }
+
+    // Unbind vertex buffer, leaving VAO and index buffer bound
+    geometry->unbind();
+
+    // Return VAO
+    return vao;
+}
+
+/**
+ * Disposes of a vertex array object.
+ *
+ * @param vao Vertex array object to dispose of
+ */
+void VertexArrayCache::dispose(const Gloop::VertexArrayObject& vao) {
+    vao.dispose();
+}
+
+/**
+ * Returns the vertex array object to use for a program, making it if needed.
+ *
+ * @param node Node drawing the geometry, whose root the program's node is found under
+ * @param program Program to find vertex array object for
+ * @param glStateCache Cache to bind a new vertex array object through
+ * @param instanceBatcher Batcher flushing the batch to draw, or `NULL` to draw without instancing
+ * @return Vertex array object for program
+ * @throws runtime_error if the program's node could not be found
+ */
+Gloop::VertexArrayObject VertexArrayCache::get(Node* const node,
+                                               const Gloop::Program& program,
+                                               GLStateCache& glStateCache,
+                                               const InstanceBatcher* const instanceBatcher) {
+
+    // If VAO already made for the program and batch just return it
+    const GLuint buffer = (instanceBatcher == NULL) ? 0 : instanceBatcher->getInstanceBuffer();
+    const std::pair<Gloop::Program,GLuint> key(program, buffer);
+    if ((lastVao != vaos.end()) && (lastVao->first == key)) {
+        return lastVao->second;
+    }
+    const vao_map_t::const_iterator it = vaos.find(key);
+    if (it != vaos.end()) {
+        lastVao = it;
+        return it->second;
+    }
+
+    // Otherwise create it, adding the batch's matrices if there is one
+    const Gloop::VertexArrayObject vao = create(node, program, glStateCache);
+    if (buffer != 0) {
+        instanceBatcher->bindMatrices(vao);
+    }
+
+    // Store it for next time
+    lastVao = vaos.insert(vao_map_t::value_type(key, vao)).first;
+
+    // Return it
+    return vao;
+}
+
+/**
+ * Returns the number of vertex array objects in the cache.
+ *
+ * @return Number of vertex array objects in the cache
+ */
+size_t VertexArrayCache::getCount() const {
+    return vaos.size();
+}
+
+} /* namespace RapidGL */
@@ -0,0 +1,67 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RAPIDGL_VERTEX_ARRAY_CACHE_H
+#define RAPIDGL_VERTEX_ARRAY_CACHE_H
+#include <map>
+#include <utility>
+#include <gloop/Program.hxx>
+#include <gloop/VertexArrayObject.hxx>
+#include "RapidGL/common.h"
+#include "RapidGL/Geometry.h"
+#include "RapidGL/GLStateCache.h"
+#include "RapidGL/InstanceBatcher.h"
+#include "RapidGL/Node.h"
+namespace RapidGL {
+
+
+/**
+ * Vertex array objects pointing a program's attributes at the regions of some geometry.
+ *
+ * A vertex array object is made the first time a program is asked for, with
+ * each attribute of the program's node pointed at the region of the layout
+ * named after its usage, and is kept for next time.  Programs drawing an
+ * instance batch get their own vertex array object for each batch, with the
+ * batch's matrices added to it.  Vertex array objects are disposed of when the
+ * cache is destructed.
+ */
+class VertexArrayCache {
+public:
+// Methods
+    VertexArrayCache(const Geometry* geometry);
+    virtual ~VertexArrayCache();
+    Gloop::VertexArrayObject get(Node* node,
+                                 const Gloop::Program& program,
+                                 GLStateCache& glStateCache,
+                                 const InstanceBatcher* instanceBatcher = NULL);
+    size_t getCount() const;
+private:
+// Types
+    typedef std::map<std::pair<Gloop::Program,GLuint>,Gloop::VertexArrayObject> vao_map_t;
+// Attributes
+    const Geometry* const geometry;
+    vao_map_t vaos;
+    vao_map_t::const_iterator lastVao;
+// Methods
+    VertexArrayCache(const VertexArrayCache&);
+    VertexArrayCache& operator=(const VertexArrayCache&);
+    Gloop::VertexArrayObject create(Node* node, const Gloop::Program& program, GLStateCache& glStateCache) const;
+    static void dispose(const Gloop::VertexArrayObject& vao);
+};
+
+} /* namespace RapidGL */
+#endif
@@ -0,0 +1,176 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <cppunit/extensions/HelperMacros.h>
+#include <GL/glfw.h>
+#include <gloop/Program.hxx>
+#include <gloop/VertexArrayObject.hxx>
+#include <glycerin/BufferLayout.hxx>
+#include <glycerin/BufferLayoutBuilder.hxx>
+#include "RapidGL/AttributeNode.h"
+#include "RapidGL/Geometry.h"
+#include "RapidGL/GLStateCache.h"
+#include "RapidGL/ProgramNode.h"
+#include "RapidGL/SceneNode.h"
+#include "RapidGL/ShaderNode.h"
+#include "RapidGL/State.h"
+#include "RapidGL/VertexArrayCache.h"
+
+
+/**
+ * Unit test for `VertexArrayCache`.
+ */
+class VertexArrayCacheTest {
+public:
+
+    /**
+     * Fake node used for testing.
+     */
+    class FakeNode : public RapidGL::Node {
+    public:
+        FakeNode() { }
+        virtual void visit(RapidGL::State& state) { }
+    };
+
+    /**
+     * Makes geometry for a triangle.
+     */
+    static RapidGL::Geometry* createTriangle() {
+        const Glycerin::BufferLayout layout = Glycerin::BufferLayoutBuilder()
+                .count(3)
+                .components(2)
+                .region("POSITION")
+                .build();
+        const GLfloat points[] = { 0, 0, 1, 0, 0, 1 };
+        std::vector<GLushort> indices;
+        indices.push_back(0);
+        indices.push_back(1);
+        indices.push_back(2);
+        return new RapidGL::Geometry(layout, points, indices);
+    }
+
+    /**
+     * Ensures `VertexArrayCache::get` makes one vertex array object per program and returns it after that.
+     */
+    void testGet() {
+
+        // Create shaders and attribute
+        RapidGL::ShaderNode vertexShaderNode(
+                GL_VERTEX_SHADER,
+                "#version 140\n"
+                "in vec4 MCVertex;\n"
+                "void main() {\n"
+                "    gl_Position = MCVertex;\n"
+                "}\n");
+        RapidGL::ShaderNode fragmentShaderNode(
+                GL_FRAGMENT_SHADER,
+                "#version 140\n"
+                "out vec4 FragColor;\n"
+                "void main() {\n"
+                "    FragColor = vec4(1);\n"
+                "}\n");
+        RapidGL::AttributeNode attributeNode("MCVertex", RapidGL::AttributeNode::POSITION, -1);
+
+        // Create scene with program and a node drawing the geometry
+        RapidGL::SceneNode sceneNode;
+        RapidGL::ProgramNode programNode("foo");
+        FakeNode fakeNode;
+        sceneNode.addChild(&programNode);
+        programNode.addChild(&vertexShaderNode);
+        programNode.addChild(&fragmentShaderNode);
+        programNode.addChild(&attributeNode);
+        sceneNode.addChild(&fakeNode);
+
+        // Link program
+        RapidGL::State state;
+        programNode.preVisit(state);
+        const Gloop::Program program = programNode.getProgram();
+
+        // Get twice
+        RapidGL::Geometry* const geometry = createTriangle();
+        {
+            RapidGL::VertexArrayCache vaoCache(geometry);
+            RapidGL::GLStateCache glStateCache;
+            const Gloop::VertexArrayObject first = vaoCache.get(&fakeNode, program, glStateCache);
+            const Gloop::VertexArrayObject second = vaoCache.get(&fakeNode, program, glStateCache);
+            CPPUNIT_ASSERT_EQUAL(first.id(), second.id());
+            CPPUNIT_ASSERT_EQUAL((size_t) 1, vaoCache.getCount());
+        }
+        delete geometry;
+    }
+
+    /**
+     * Ensures `VertexArrayCache::get` throws if the program's node is not in the tree.
+     */
+    void testGetWhenProgramIsNotInTree() {
+        RapidGL::SceneNode sceneNode;
+        FakeNode fakeNode;
+        sceneNode.addChild(&fakeNode);
+        RapidGL::Geometry* const geometry = createTriangle();
+        {
+            RapidGL::VertexArrayCache vaoCache(geometry);
+            RapidGL::GLStateCache glStateCache;
+            const Gloop::Program program = Gloop::Program::create();
+            CPPUNIT_ASSERT_THROW(vaoCache.get(&fakeNode, program, glStateCache), std::runtime_error);
+            CPPUNIT_ASSERT_EQUAL((size_t) 0, vaoCache.getCount());
+        }
+        delete geometry;
+    }
+
+    /**
+     * Ensures `VertexArrayCache` constructor throws if geometry is `NULL`.
+     */
+    void testVertexArrayCacheWithNullGeometry() {
+        CPPUNIT_ASSERT_THROW(RapidGL::VertexArrayCache(NULL), std::invalid_argument);
+    }
+};
+
+int main(int argc, char* argv[]) {
+
+    // Initialize
+    if (!glfwInit()) {
+        throw std::runtime_error("Could not initialize GLFW!");
+    }
+
+    // Open window
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MAJOR, 3);
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MINOR, 2);
+    glfwOpenWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (!glfwOpenWindow(512, 512, 0, 0, 0, 0, 0, 0, GLFW_WINDOW)) {
+        throw std::runtime_error("Could not open window!");
+    }
+
+    // Run test
+    try {
+        VertexArrayCacheTest test;
+        test.testGet();
+        test.testGetWhenProgramIsNotInTree();
+        test.testVertexArrayCacheWithNullGeometry();
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        throw;
+    }
+
+    // Exit
+    glfwTerminate();
+    return 0;
+}
@@ -17,6 +17,7 @@
  */
 #include "config.h"
 #include <stdexcept>
+#include <m3d/Mat4.h>
 #include "RapidGL/Visitor.h"
 namespace RapidGL {
 
@@ -26,16 +27,155 @@ namespace RapidGL {
  * @param state State shared between nodes
  * @throws invalid_argument if state is `NULL`
  */
-Visitor::Visitor(State* state) {
+Visitor::Visitor(State* state) :
+        stack(INITIAL_STACK_SIZE),
+        depth(0),
+        culling(false),
+        frustum(M3d::Mat4(1)),
+        culledCount(0),
+        visitedCount(0) {
     if (state == NULL) {
         throw std::invalid_argument("State is NULL!");
     }
     this->state = state;
 }
 
+/**
+ * Returns the number of subtrees skipped by the last traversal because they were outside the frustum.
+ *
+ * @return Number of subtrees skipped by the last traversal
+ */
+size_t Visitor::getCulledCount() const {
+    return culledCount;
+}
+
+/**
+ * Returns the state this visitor passes to nodes.
+ *
+ * @return Pointer to the state this visitor passes to nodes
+ */
+State* Visitor::getState() const {
+    return state;
+}
+
+/**
+ * Returns the number of nodes visited by the last traversal.
+ *
+ * @return Number of nodes visited by the last traversal
+ */
+size_t Visitor::getVisitedCount() const {
+    return visitedCount;
+}
+
+/**
+ * Checks if this visitor skips subtrees outside the frustum.
+ *
+ * @return `true` if this visitor skips subtrees outside the frustum
+ */
+bool Visitor::isCulling() const {
+    return culling;
+}
+
+/**
+ * Checks if a node and its descendants are entirely outside the frustum.
+ *
+ * @param node Node to check, whose parent has already been visited
+ * @return `true` if nothing in the subtree could be visible
+ */
+bool Visitor::isOutside(Node* const node) const {
+    const BoundingBox bounds = node->getBounds();
+    if (bounds.isEmpty() || bounds.isInfinite()) {
+        return false;
+    }
+    return frustum.excludes(bounds.transform(state->getModelMatrix()));
+}
+
+/**
+ * Prepares a tree of nodes, parents before their children.
+ *
+ * @param node Root of subtree to prepare
+ * @throws invalid_argument if node is `NULL`
+ */
+void Visitor::prepare(Node* node) {
+
+    if (node == NULL) {
+        throw std::invalid_argument("Node is NULL!");
+    }
+
+    // Leave frames below this traversal alone in case a node called us
+    const size_t base = depth;
+
+    try {
+
+        // Prepare the root
+        node->prepare(*state);
+        Node::node_range_t children = node->getChildren();
+        Node::node_iterator_t next = children.begin;
+        Node::node_iterator_t end = children.end;
+
+        while (true) {
+            if (next != end) {
+
+                // Prepare the next child
+                Node* const child = *next;
+                ++next;
+                child->prepare(*state);
+
+                // Descend into it if it has children
+                children = child->getChildren();
+                if (children.begin != children.end) {
+                    if (depth == stack.size()) {
+                        stack.resize(depth + 1);
+                    }
+                    Frame& frame = stack[depth++];
+                    frame.node = node;
+                    frame.next = next;
+                    frame.end = end;
+                    node = child;
+                    next = children.begin;
+                    end = children.end;
+                }
+            } else {
+
+                // Go back up to the parent
+                if (depth == base) {
+                    break;
+                }
+                const Frame& frame = stack[--depth];
+                node = frame.node;
+                next = frame.next;
+                end = frame.end;
+            }
+        }
+    } catch (...) {
+        depth = base;
+        throw;
+    }
+}
+
+/**
+ * Changes whether this visitor skips subtrees outside the frustum.
+ *
+ * @param culling `true` to skip subtrees outside the frustum
+ */
+void Visitor::setCulling(const bool culling) {
+    this->culling = culling;
+}
+
 /**
  * Traverses a tree of nodes calling each of their hooks in the correct order.
  *
+ * The node being traversed is kept in local variables, and only pushed on the
+ * stack when one of its children has children of its own.  Leaves are finished
+ * without touching the stack at all.  Hooks missing from a node's hooks are
+ * skipped without calling them.  Nodes with `SELECT` in their hooks choose
+ * which of their children are traversed, after being visited.
+ *
+ * When culling, the frustum is taken from the state when the outermost call
+ * starts, and each subtree is tested just before it would be visited, when
+ * the model matrix holds its parent's transformation.  The counts are reset
+ * by the outermost call, so they cover one frame.
+ *
  * @param node Root of subtree to visit
  * @throws invalid_argument if node is `NULL`
  */
@@ -45,18 +185,97 @@ void Visitor::visit(Node* node) {
         throw std::invalid_argument("Node is NULL!");
     }
 
-    // Perform actions before being visited
-    node->preVisit(*state);
+    // Leave frames below this traversal alone in case a node called us
+    const size_t base = depth;
+
+    // Start a new frame unless a node called us
+    if (base == 0) {
+        culledCount = 0;
+        visitedCount = 0;
+        if (culling) {
+            frustum = Frustum(state->getViewProjectionMatrix());
+        }
+    }
 
-    // Visit the node and all its children
-    node->visit(*state);
-    const Node::node_range_t children = node->getChildren();
-    for (Node::node_iterator_t it = children.begin; it != children.end; ++it) {
-        visit(*it);
+    // Skip everything if the root is outside the frustum
+    if (culling && isOutside(node)) {
+        ++culledCount;
+        return;
     }
+    ++visitedCount;
+
+    try {
 
-    // Perform actions after being visited
-    node->postVisit(*state);
+        // Perform actions before being visited, and visit the root
+        if (node->hooks & Node::PRE_VISIT) {
+            node->preVisit(*state);
+        }
+        if (node->hooks & Node::VISIT) {
+            node->visit(*state);
+        }
+        Node::node_range_t children = (node->hooks & Node::SELECT) ? node->select(*state) : node->getChildren();
+        Node::node_iterator_t next = children.begin;
+        Node::node_iterator_t end = children.end;
+
+        while (true) {
+            if (next != end) {
+
+                // Skip the next child if it is outside the frustum
+                Node* const child = *next;
+                ++next;
+                if (culling && isOutside(child)) {
+                    ++culledCount;
+                    continue;
+                }
+                ++visitedCount;
+
+                // Otherwise visit it
+                if (child->hooks & Node::PRE_VISIT) {
+                    child->preVisit(*state);
+                }
+                if (child->hooks & Node::VISIT) {
+                    child->visit(*state);
+                }
+
+                // Finish it now if it is a leaf, otherwise descend into it
+                children = (child->hooks & Node::SELECT) ? child->select(*state) : child->getChildren();
+                if (children.begin == children.end) {
+                    if (child->hooks & Node::POST_VISIT) {
+                        child->postVisit(*state);
+                    }
+                } else {
+                    if (depth == stack.size()) {
+                        stack.resize(depth + 1);
+                    }
+                    Frame& frame = stack[depth++];
+                    frame.node = node;
+                    frame.next = next;
+                    frame.end = end;
+                    node = child;
+                    next = children.begin;
+                    end = children.end;
+                }
+            } else {
+
+                // Perform actions after being visited
+                if (node->hooks & Node::POST_VISIT) {
+                    node->postVisit(*state);
+                }
+
+                // Go back up to the parent
+                if (depth == base) {
+                    break;
+                }
+                const Frame& frame = stack[--depth];
+                node = frame.node;
+                next = frame.next;
+                end = frame.end;
+            }
+        }
+    } catch (...) {
+        depth = base;
+        throw;
+    }
 }
 
 } /* namespace RapidGL */
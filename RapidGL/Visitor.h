@@ -17,7 +17,9 @@
  */
 #ifndef RAPIDGL_VISITOR_H
 #define RAPIDGL_VISITOR_H
+#include <vector>
 #include "RapidGL/common.h"
+#include "RapidGL/Frustum.h"
 #include "RapidGL/Node.h"
 #include "RapidGL/State.h"
 namespace RapidGL {
@@ -25,15 +27,57 @@ namespace RapidGL {
 
 /**
  * Utility for calling all the hooks on a tree of nodes.
+ *
+ * Traverses iteratively using a stack owned by the visitor instead of the call
+ * stack, so deep trees cannot overflow it.  The stack is pre-sized and only
+ * ever grows, so once it is as deep as a tree, visiting that tree again does
+ * not allocate.  A node may use the same visitor to visit another tree from
+ * one of its hooks.
+ *
+ * Hooks a node does not report in `Node::getHooks` are not called.  Calling
+ * `prepare` on a scene before rendering it does one-time setup up front, after
+ * which most nodes no longer need their `preVisit` hook.
+ *
+ * With culling turned on, a subtree whose bounds are entirely outside the
+ * frustum of the state's view and projection matrices is skipped without
+ * calling any of its hooks.  Subtrees with empty or infinite bounds are never
+ * skipped.  Since skipped nodes are not visited at all, culling assumes nodes
+ * outside the frustum do not set uniforms or other state relied on by nodes
+ * outside their subtree.
  */
 class Visitor {
 public:
 // Methods
     Visitor(State* state);
+    size_t getCulledCount() const;
+    State* getState() const;
+    size_t getVisitedCount() const;
+    bool isCulling() const;
+    void prepare(Node* node);
+    void setCulling(bool culling);
     void visit(Node* node);
 private:
+// Types
+    /**
+     * Ancestor being traversed and the children it has left to traverse.
+     */
+    struct Frame {
+        Node* node;
+        Node::node_iterator_t next;
+        Node::node_iterator_t end;
+    };
+// Constants
+    static const size_t INITIAL_STACK_SIZE = 64;
 // Attributes
     State* state;
+    std::vector<Frame> stack;
+    size_t depth;
+    bool culling;
+    Frustum frustum;
+    size_t culledCount;
+    size_t visitedCount;
+// Methods
+    bool isOutside(Node* node) const;
 };
 
 } /* namespace RapidGL */
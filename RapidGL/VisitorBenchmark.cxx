@@ -0,0 +1,168 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <Poco/Stopwatch.h>
+#include "RapidGL/GroupNode.h"
+#include "RapidGL/Node.h"
+#include "RapidGL/State.h"
+#include "RapidGL/Visitor.h"
+
+
+/**
+ * Benchmark comparing `Visitor` with a recursive traversal.
+ *
+ * Trees are made of `GroupNode`s, whose hooks are defined in the library, so
+ * neither traversal can inline them.  Both traversals skip hooks a node does
+ * not report, so only the cost of walking the tree is compared.
+ */
+class VisitorBenchmark {
+public:
+
+    /**
+     * Recursive traversal skipping the same hooks as `Visitor`, for comparison.
+     */
+    class RecursiveVisitor {
+    public:
+
+        RecursiveVisitor(RapidGL::State* state) : state(state) {
+            // empty
+        }
+
+        void visit(RapidGL::Node* node) {
+            const int hooks = node->getHooks();
+            if (hooks & RapidGL::Node::PRE_VISIT) {
+                node->preVisit(*state);
+            }
+            if (hooks & RapidGL::Node::VISIT) {
+                node->visit(*state);
+            }
+            const RapidGL::Node::node_range_t children = node->getChildren();
+            for (RapidGL::Node::node_iterator_t it = children.begin; it != children.end; ++it) {
+                visit(*it);
+            }
+            if (hooks & RapidGL::Node::POST_VISIT) {
+                node->postVisit(*state);
+            }
+        }
+
+    private:
+        RapidGL::State* state;
+    };
+
+    // Number of times to traverse each tree
+    static const int ITERATIONS = 100;
+
+    // Nodes of the tree being traversed
+    std::vector<RapidGL::GroupNode*> nodes;
+
+    /**
+     * Destructs the benchmark, deleting any nodes left.
+     */
+    ~VisitorBenchmark() {
+        clear();
+    }
+
+    /**
+     * Deletes the nodes of the tree.
+     */
+    void clear() {
+        for (std::vector<RapidGL::GroupNode*>::iterator it = nodes.begin(); it != nodes.end(); ++it) {
+            delete (*it);
+        }
+        nodes.clear();
+    }
+
+    /**
+     * Makes a tree where each node has one child.
+     *
+     * @param depth Number of levels in the tree
+     * @return Root of the tree
+     */
+    RapidGL::Node* makeDeepTree(const int depth) {
+        clear();
+        nodes.push_back(new RapidGL::GroupNode("group"));
+        for (int i = 1; i < depth; ++i) {
+            RapidGL::GroupNode* node = new RapidGL::GroupNode("group");
+            nodes.back()->addChild(node);
+            nodes.push_back(node);
+        }
+        return nodes.front();
+    }
+
+    /**
+     * Makes a tree where the root has many children.
+     *
+     * @param width Number of children of the root
+     * @return Root of the tree
+     */
+    RapidGL::Node* makeWideTree(const int width) {
+        clear();
+        nodes.push_back(new RapidGL::GroupNode("group"));
+        for (int i = 0; i < width; ++i) {
+            RapidGL::GroupNode* node = new RapidGL::GroupNode("group");
+            nodes.front()->addChild(node);
+            nodes.push_back(node);
+        }
+        return nodes.front();
+    }
+
+    /**
+     * Times traversing a tree with both visitors and prints the results.
+     *
+     * @param name Description of the tree
+     * @param root Root of the tree
+     */
+    void run(const std::string& name, RapidGL::Node* root) {
+
+        RapidGL::State state;
+        Poco::Stopwatch stopwatch;
+
+        // Recursive
+        RecursiveVisitor recursiveVisitor(&state);
+        stopwatch.restart();
+        for (int i = 0; i < ITERATIONS; ++i) {
+            recursiveVisitor.visit(root);
+        }
+        stopwatch.stop();
+        const double recursiveTime = ((double) stopwatch.elapsed()) / ITERATIONS;
+
+        // Iterative
+        RapidGL::Visitor visitor(&state);
+        stopwatch.restart();
+        for (int i = 0; i < ITERATIONS; ++i) {
+            visitor.visit(root);
+        }
+        stopwatch.stop();
+        const double iterativeTime = ((double) stopwatch.elapsed()) / ITERATIONS;
+
+        // Print results
+        std::cout << name << std::endl;
+        std::cout << "  recursive: " << recursiveTime << " us per traversal" << std::endl;
+        std::cout << "  iterative: " << iterativeTime << " us per traversal" << std::endl;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    VisitorBenchmark benchmark;
+    benchmark.run("Deep tree (10000 levels)", benchmark.makeDeepTree(10000));
+    benchmark.run("Wide tree (100000 siblings)", benchmark.makeWideTree(100000));
+    return 0;
+}
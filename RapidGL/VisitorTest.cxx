@@ -0,0 +1,355 @@
+/*
+ * RapidGL - Rapid prototyping for OpenGL
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include <m3d/Mat4.h>
+#include <m3d/Vec3.h>
+#include <m3d/Vec4.h>
+#include "RapidGL/BoundingBox.h"
+#include "RapidGL/Node.h"
+#include "RapidGL/State.h"
+#include "RapidGL/Visitor.h"
+
+
+/**
+ * Unit test for `Visitor`.
+ */
+class VisitorTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Fake node that records which of its hooks were called.
+     */
+    class FakeNode : public RapidGL::Node {
+    public:
+
+        std::vector<std::string>* calls;
+        RapidGL::Visitor* visitor;
+        RapidGL::Node* other;
+        bool broken;
+        RapidGL::BoundingBox box;
+
+        FakeNode(const std::string& id, std::vector<std::string>* calls) :
+                RapidGL::Node(id), calls(calls), visitor(NULL), other(NULL), broken(false) {
+            // empty
+        }
+
+        void changeHooks(const int hooks) {
+            setHooks(hooks);
+        }
+
+        virtual RapidGL::BoundingBox computeBounds() {
+            RapidGL::BoundingBox bounds = RapidGL::Node::computeBounds();
+            bounds.add(box);
+            return bounds;
+        }
+
+        virtual void postVisit(RapidGL::State& state) {
+            calls->push_back("postVisit " + getId());
+        }
+
+        virtual void prepare(RapidGL::State& state) {
+            calls->push_back("prepare " + getId());
+        }
+
+        virtual void preVisit(RapidGL::State& state) {
+            calls->push_back("preVisit " + getId());
+        }
+
+        virtual void visit(RapidGL::State& state) {
+            calls->push_back("visit " + getId());
+            if (broken) {
+                throw std::runtime_error("Broken!");
+            }
+            if (visitor != NULL) {
+                visitor->visit(other);
+            }
+        }
+    };
+
+    // Calls made on nodes
+    std::vector<std::string> calls;
+
+    // State to pass to nodes
+    RapidGL::State state;
+
+    // Nodes
+    FakeNode a;
+    FakeNode b;
+    FakeNode c;
+    FakeNode d;
+
+    /**
+     * Constructs the test, making a tree like `a(b(c), d)`.
+     */
+    VisitorTest() : a("a", &calls), b("b", &calls), c("c", &calls), d("d", &calls) {
+        a.addChild(&b);
+        b.addChild(&c);
+        a.addChild(&d);
+    }
+
+    /**
+     * Ensures `Visitor::prepare` prepares parents before their children.
+     */
+    void testPrepare() {
+
+        RapidGL::Visitor visitor(&state);
+        visitor.prepare(&a);
+
+        const char* expected[] = { "prepare a", "prepare b", "prepare c", "prepare d" };
+        const size_t count = sizeof(expected) / sizeof(expected[0]);
+        CPPUNIT_ASSERT_EQUAL(count, calls.size());
+        for (size_t i = 0; i < count; ++i) {
+            CPPUNIT_ASSERT_EQUAL(std::string(expected[i]), calls[i]);
+        }
+    }
+
+    /**
+     * Ensures `Visitor::prepare` throws if passed `NULL`.
+     */
+    void testPrepareWithNull() {
+        RapidGL::Visitor visitor(&state);
+        CPPUNIT_ASSERT_THROW(visitor.prepare(NULL), std::invalid_argument);
+    }
+
+    /**
+     * Ensures `Visitor::visit` calls hooks depth first, before and after children.
+     */
+    void testVisit() {
+
+        RapidGL::Visitor visitor(&state);
+        visitor.visit(&a);
+
+        const char* expected[] = {
+            "preVisit a", "visit a",
+            "preVisit b", "visit b",
+            "preVisit c", "visit c", "postVisit c",
+            "postVisit b",
+            "preVisit d", "visit d", "postVisit d",
+            "postVisit a" };
+        const size_t count = sizeof(expected) / sizeof(expected[0]);
+        CPPUNIT_ASSERT_EQUAL(count, calls.size());
+        for (size_t i = 0; i < count; ++i) {
+            CPPUNIT_ASSERT_EQUAL(std::string(expected[i]), calls[i]);
+        }
+    }
+
+    /**
+     * Ensures `Visitor::visit` skips subtrees outside the frustum when culling.
+     */
+    void testVisitWithCulling() {
+
+        // Put `c` outside the frustum, which is the cube from -1 to 1 by default
+        c.box = RapidGL::BoundingBox(M3d::Vec3(4, 0, 0), M3d::Vec3(6, 1, 1));
+        d.box = RapidGL::BoundingBox(M3d::Vec3(0, 0, 0), M3d::Vec3(1, 1, 1));
+        RapidGL::Visitor visitor(&state);
+        visitor.setCulling(true);
+        visitor.visit(&a);
+
+        const char* expected[] = {
+            "preVisit a", "visit a",
+            "preVisit d", "visit d", "postVisit d",
+            "postVisit a" };
+        const size_t count = sizeof(expected) / sizeof(expected[0]);
+        CPPUNIT_ASSERT_EQUAL(count, calls.size());
+        for (size_t i = 0; i < count; ++i) {
+            CPPUNIT_ASSERT_EQUAL(std::string(expected[i]), calls[i]);
+        }
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, visitor.getCulledCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, visitor.getVisitedCount());
+    }
+
+    /**
+     * Ensures `Visitor::visit` tests bounds using the model matrix of the parent.
+     */
+    void testVisitWithCullingAndModelMatrix() {
+
+        // Move `c` back into the frustum
+        c.box = RapidGL::BoundingBox(M3d::Vec3(4, 0, 0), M3d::Vec3(6, 1, 1));
+        M3d::Mat4 modelMatrix(1);
+        modelMatrix[3] = M3d::Vec4(-5, 0, 0, 1);
+        state.setModelMatrix(modelMatrix);
+
+        RapidGL::Visitor visitor(&state);
+        visitor.setCulling(true);
+        visitor.visit(&a);
+        CPPUNIT_ASSERT_EQUAL((size_t) 12, calls.size());
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, visitor.getCulledCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 4, visitor.getVisitedCount());
+        state.setModelMatrix(M3d::Mat4(1));
+    }
+
+    /**
+     * Ensures `Visitor::visit` does not skip anything unless culling is turned on.
+     */
+    void testVisitWithoutCulling() {
+        c.box = RapidGL::BoundingBox(M3d::Vec3(4, 0, 0), M3d::Vec3(6, 1, 1));
+        RapidGL::Visitor visitor(&state);
+        CPPUNIT_ASSERT(!visitor.isCulling());
+        visitor.visit(&a);
+        CPPUNIT_ASSERT_EQUAL((size_t) 12, calls.size());
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, visitor.getCulledCount());
+        CPPUNIT_ASSERT_EQUAL((size_t) 4, visitor.getVisitedCount());
+    }
+
+    /**
+     * Ensures `Visitor::visit` can be called again after a node throws.
+     */
+    void testVisitAfterException() {
+
+        // Visit with a broken node
+        RapidGL::Visitor visitor(&state);
+        c.broken = true;
+        CPPUNIT_ASSERT_THROW(visitor.visit(&a), std::runtime_error);
+        c.broken = false;
+
+        // Visit again
+        calls.clear();
+        visitor.visit(&a);
+        CPPUNIT_ASSERT_EQUAL((size_t) 12, calls.size());
+        CPPUNIT_ASSERT_EQUAL(std::string("postVisit a"), calls.back());
+    }
+
+    /**
+     * Ensures `Visitor::visit` skips hooks a node does not report.
+     */
+    void testVisitWithHooks() {
+
+        b.changeHooks(RapidGL::Node::VISIT);
+        c.changeHooks(RapidGL::Node::PRE_VISIT | RapidGL::Node::POST_VISIT);
+        d.changeHooks(0);
+        RapidGL::Visitor visitor(&state);
+        visitor.visit(&a);
+
+        const char* expected[] = {
+            "preVisit a", "visit a",
+            "visit b",
+            "preVisit c", "postVisit c",
+            "postVisit a" };
+        const size_t count = sizeof(expected) / sizeof(expected[0]);
+        CPPUNIT_ASSERT_EQUAL(count, calls.size());
+        for (size_t i = 0; i < count; ++i) {
+            CPPUNIT_ASSERT_EQUAL(std::string(expected[i]), calls[i]);
+        }
+    }
+
+    /**
+     * Ensures `Visitor::visit` works on a tree too deep to traverse recursively.
+     */
+    void testVisitWithDeepTree() {
+
+        // Make a chain of nodes
+        std::vector<std::string> deepCalls;
+        std::vector<FakeNode*> nodes;
+        nodes.push_back(new FakeNode("0", &deepCalls));
+        for (int i = 1; i < 100000; ++i) {
+            FakeNode* node = new FakeNode("", &deepCalls);
+            nodes.back()->addChild(node);
+            nodes.push_back(node);
+        }
+
+        // Visit it
+        RapidGL::Visitor visitor(&state);
+        visitor.visit(nodes.front());
+        CPPUNIT_ASSERT_EQUAL(nodes.size() * 3, deepCalls.size());
+        CPPUNIT_ASSERT_EQUAL(std::string("postVisit 0"), deepCalls.back());
+
+        // Clean up
+        for (std::vector<FakeNode*>::iterator it = nodes.begin(); it != nodes.end(); ++it) {
+            delete (*it);
+        }
+    }
+
+    /**
+     * Ensures `Visitor::visit` can be called from a node the same visitor is visiting.
+     */
+    void testVisitWithNestedVisit() {
+
+        // Make a separate tree like `x(y)`
+        FakeNode x("x", &calls);
+        FakeNode y("y", &calls);
+        x.addChild(&y);
+
+        // Have `c` visit it with the same visitor
+        RapidGL::Visitor visitor(&state);
+        c.visitor = &visitor;
+        c.other = &x;
+        visitor.visit(&a);
+        c.visitor = NULL;
+
+        // Check calls
+        const char* expected[] = {
+            "preVisit a", "visit a",
+            "preVisit b", "visit b",
+            "preVisit c", "visit c",
+            "preVisit x", "visit x",
+            "preVisit y", "visit y", "postVisit y",
+            "postVisit x",
+            "postVisit c",
+            "postVisit b",
+            "preVisit d", "visit d", "postVisit d",
+            "postVisit a" };
+        const size_t count = sizeof(expected) / sizeof(expected[0]);
+        CPPUNIT_ASSERT_EQUAL(count, calls.size());
+        for (size_t i = 0; i < count; ++i) {
+            CPPUNIT_ASSERT_EQUAL(std::string(expected[i]), calls[i]);
+        }
+    }
+
+    /**
+     * Ensures `Visitor::visit` throws if passed `NULL`.
+     */
+    void testVisitWithNull() {
+        RapidGL::Visitor visitor(&state);
+        CPPUNIT_ASSERT_THROW(visitor.visit(NULL), std::invalid_argument);
+    }
+
+    /**
+     * Ensures `Visitor::Visitor` throws if passed `NULL`.
+     */
+    void testVisitorWithNull() {
+        CPPUNIT_ASSERT_THROW(RapidGL::Visitor(NULL), std::invalid_argument);
+    }
+
+    CPPUNIT_TEST_SUITE(VisitorTest);
+    CPPUNIT_TEST(testPrepare);
+    CPPUNIT_TEST(testPrepareWithNull);
+    CPPUNIT_TEST(testVisit);
+    CPPUNIT_TEST(testVisitAfterException);
+    CPPUNIT_TEST(testVisitWithCulling);
+    CPPUNIT_TEST(testVisitWithCullingAndModelMatrix);
+    CPPUNIT_TEST(testVisitWithDeepTree);
+    CPPUNIT_TEST(testVisitWithHooks);
+    CPPUNIT_TEST(testVisitWithNestedVisit);
+    CPPUNIT_TEST(testVisitWithNull);
+    CPPUNIT_TEST(testVisitWithoutCulling);
+    CPPUNIT_TEST(testVisitorWithNull);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(VisitorTest::suite());
+    runner.run();
+    return 0;
+}